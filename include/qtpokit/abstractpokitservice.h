@@ -11,8 +11,11 @@
 
 #include "qtpokit_global.h"
 
+#include <QBluetoothUuid>
+#include <QHash>
 #include <QLowEnergyService>
 #include <QObject>
+#include <QVector>
 
 class QLowEnergyController;
 
@@ -25,6 +28,37 @@ class QTPOKIT_EXPORT AbstractPokitService : public QObject
     Q_OBJECT
 
 public:
+    struct QTPOKIT_EXPORT LatencyHistogram {
+        static const int subBucketBits = 4; ///< Linear sub-buckets (as bits) per power of two.
+        QVector<quint64> buckets; ///< Counts of recorded values, by bucketIndex().
+        quint64 count;            ///< Number of recorded values.
+        qint64 min;               ///< Smallest recorded value, in microseconds.
+        qint64 max;               ///< Largest recorded value, in microseconds.
+        qint64 total;             ///< Sum of all recorded values, in microseconds.
+
+        LatencyHistogram();
+        void record(const qint64 microseconds);
+        qint64 mean() const;
+        qint64 percentile(const double percent) const;
+
+        static int bucketIndex(const qint64 microseconds);
+        static qint64 bucketUpperBound(const int index);
+    };
+
+    struct CharacteristicStatistics {
+        quint64 reads;                         ///< Number of completed reads.
+        quint64 bytesRead;                     ///< Total bytes read.
+        LatencyHistogram readLatency;          ///< Read request to read completion times.
+        quint64 writes;                        ///< Number of completed writes.
+        quint64 bytesWritten;                  ///< Total bytes written.
+        LatencyHistogram writeLatency;         ///< Write request to write completion times.
+        quint64 notifications;                 ///< Number of notifications received.
+        quint64 bytesNotified;                 ///< Total bytes notified.
+        LatencyHistogram notificationInterval; ///< Times between consecutive notifications.
+    };
+
+    typedef QHash<QBluetoothUuid, CharacteristicStatistics> Statistics; ///< Statistics by UUID.
+
     AbstractPokitService() = delete;
     virtual ~AbstractPokitService();
 
@@ -33,6 +67,14 @@ public:
     bool autoDiscover() const;
     void setAutoDiscover(const bool discover = true);
 
+    bool skipValueDiscovery() const;
+    void setSkipValueDiscovery(const bool skip = true);
+
+    bool statisticsEnabled() const;
+    void setStatisticsEnabled(const bool enabled = true);
+    Statistics statistics() const;
+    void resetStatistics();
+
     QLowEnergyService * service();
     const QLowEnergyService * service() const;
 
@@ -49,6 +91,7 @@ protected:
 private:
     Q_DECLARE_PRIVATE(AbstractPokitService)
     Q_DISABLE_COPY(AbstractPokitService)
+    friend class PokitSimulatorPrivate;
     friend class TestAbstractPokitService;
 };
 
@@ -0,0 +1,91 @@
+// SPDX-FileCopyrightText: 2022 Paul Colby <git@colby.id.au>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+/*!
+ * \file
+ * Declares the CaptureArchive class.
+ */
+
+#ifndef QTPOKIT_CAPTUREARCHIVE_H
+#define QTPOKIT_CAPTUREARCHIVE_H
+
+#include "dataloggerservice.h"
+#include "dsoservice.h"
+
+#include <QDateTime>
+#include <QIODevice>
+#include <QObject>
+
+QTPOKIT_BEGIN_NAMESPACE
+
+class CaptureArchivePrivate;
+
+class QTPOKIT_EXPORT CaptureArchive : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum class Source : quint8 {
+        Dso        = 1, ///< Samples captured by a DsoService.
+        DataLogger = 2, ///< Samples fetched from a DataLoggerService.
+    };
+
+    struct Record {
+        char magic[4];           ///< Record marker; always `QTPR`.
+        Source source;           ///< Service the samples were captured by.
+        quint8 status;           ///< Service-specific status, such as DsoService::DsoStatus.
+        quint8 mode;             ///< Service-specific mode, such as DsoService::Mode.
+        quint8 range;            ///< Service-specific range, such as DsoService::VoltageRange.
+        float scale;             ///< Scale to apply to the raw samples.
+        quint32 interval;        ///< DSO sampling window (microseconds), or logger interval (ms).
+        quint32 samplingRate;    ///< DSO sampling rate (Hz), or `0` for data logger captures.
+        quint32 numberOfSamples; ///< Number of raw samples immediately following this record.
+        qint64 timestamp;        ///< Capture time, in milliseconds since the epoch.
+    };
+
+    struct IndexEntry {
+        qint64 offset;           ///< Offset of the capture's Record within the segment file.
+        qint64 timestamp;        ///< Capture time, in milliseconds since the epoch.
+        quint32 numberOfSamples; ///< Number of raw samples in the capture.
+        Source source;           ///< Service the samples were captured by.
+        quint8 reserved[3];      ///< Reserved for future use; always zero.
+    };
+
+    explicit CaptureArchive(const QString &fileName, QObject * const parent = nullptr);
+    virtual ~CaptureArchive();
+
+    QString fileName() const;
+    QString indexFileName() const;
+
+    bool open(const QIODevice::OpenMode mode);
+    void close();
+    bool isOpen() const;
+    bool isWritable() const;
+
+    bool append(const DsoService::Metadata &metadata, const DsoService::Samples &samples,
+                const QDateTime &timestamp = QDateTime());
+    bool append(const DataLoggerService::Metadata &metadata,
+                const DataLoggerService::Samples &samples,
+                const QDateTime &timestamp = QDateTime());
+
+    int count() const;
+    const IndexEntry * index() const;
+    const Record * record(const int index) const;
+    const qint16 * samples(const int index) const;
+    int find(const QDateTime &timestamp) const;
+
+protected:
+    /// \cond internal
+    CaptureArchivePrivate * d_ptr; ///< Internal d-pointer.
+    CaptureArchive(CaptureArchivePrivate * const d, QObject * const parent);
+    /// \endcond
+
+private:
+    Q_DECLARE_PRIVATE(CaptureArchive)
+    Q_DISABLE_COPY(CaptureArchive)
+    friend class TestCaptureArchive;
+};
+
+QTPOKIT_END_NAMESPACE
+
+#endif // QTPOKIT_CAPTUREARCHIVE_H
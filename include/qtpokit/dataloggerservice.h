@@ -106,6 +106,13 @@ public:
     };
 
     typedef QVector<qint16> Samples;
+    typedef QVector<float> ScaledSamples;
+
+    struct CoalescingSettings {
+        bool enabled;   ///< Whether to coalesce samples, instead of emitting them per notification.
+        int chunkSize;  ///< Samples to accumulate per emission, or `0` to emit once per capture.
+        int maxLatency; ///< Milliseconds to hold samples before emitting, or `0` for no deadline.
+    };
 
     DataLoggerService(QLowEnergyController * const pokitDevice, QObject * parent = nullptr);
     ~DataLoggerService() override;
@@ -128,10 +135,15 @@ public:
     bool enableReadingNotifications();
     bool disableReadingNotifications();
 
+    // Sample coalescing.
+    CoalescingSettings coalescingSettings() const;
+    void setCoalescingSettings(const CoalescingSettings &settings);
+
 signals:
     void settingsWritten();
     void metadataRead(const DataLoggerService::Metadata &meta);
     void samplesRead(const DataLoggerService::Samples &samples);
+    void scaledSamplesRead(const DataLoggerService::ScaledSamples &samples);
 
 protected:
     /// \cond internal
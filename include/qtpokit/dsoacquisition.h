@@ -0,0 +1,81 @@
+// SPDX-FileCopyrightText: 2022 Paul Colby <git@colby.id.au>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+/*!
+ * \file
+ * Declares the DsoAcquisition class.
+ */
+
+#ifndef QTPOKIT_DSOACQUISITION_H
+#define QTPOKIT_DSOACQUISITION_H
+
+#include "dsoservice.h"
+
+#include <QObject>
+
+QTPOKIT_BEGIN_NAMESPACE
+
+class DsoAcquisitionPrivate;
+
+class QTPOKIT_EXPORT DsoAcquisition : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Metrics {
+        quint64 captures;             ///< Number of captures completed.
+        quint64 samples;              ///< Number of samples written to the ring buffer.
+        quint64 droppedSamples;       ///< Number of samples discarded because the buffer was full.
+        quint64 droppedNotifications; ///< Number of `Reading` notifications (partially) discarded.
+        quint64 lostSamples;          ///< Number of samples never received from the device.
+        quint64 lostCaptures;         ///< Number of captures abandoned with samples still to go.
+        qint64 lastDeadTime;          ///< Dead time (microseconds) before the most recent capture.
+        qint64 maxDeadTime;           ///< Longest dead time (microseconds) between captures.
+        qint64 totalDeadTime;         ///< Sum of all dead times (microseconds) between captures.
+    };
+
+    explicit DsoAcquisition(DsoService * const service, const int capacity = 65536,
+                            QObject * const parent = nullptr);
+    virtual ~DsoAcquisition();
+
+    DsoService * service();
+    const DsoService * service() const;
+
+    int capacity() const;
+    bool isRunning() const;
+
+    // Ring buffer consumer access (thread-safe for a single consumer thread).
+    int available() const;
+    int read(float * const values, const int maxValues);
+
+    Metrics metrics() const;
+    void resetMetrics();
+
+    int shortfallTimeout() const;
+    void setShortfallTimeout(const int timeout);
+
+public slots:
+    bool start(const DsoService::Settings &settings);
+    void stop();
+
+signals:
+    void started();
+    void stopped();
+    void captureFinished(const DsoService::Metadata &metadata);
+    void samplesAvailable(const int count);
+
+protected:
+    /// \cond internal
+    DsoAcquisitionPrivate * d_ptr; ///< Internal d-pointer.
+    DsoAcquisition(DsoAcquisitionPrivate * const d, QObject * const parent);
+    /// \endcond
+
+private:
+    Q_DECLARE_PRIVATE(DsoAcquisition)
+    Q_DISABLE_COPY(DsoAcquisition)
+    friend class TestDsoAcquisition;
+};
+
+QTPOKIT_END_NAMESPACE
+
+#endif // QTPOKIT_DSOACQUISITION_H
@@ -105,6 +105,13 @@ public:
     };
 
     typedef QVector<qint16> Samples;
+    typedef QVector<float> ScaledSamples;
+
+    struct CoalescingSettings {
+        bool enabled;   ///< Whether to coalesce samples, instead of emitting them per notification.
+        int chunkSize;  ///< Samples to accumulate per emission, or `0` to emit once per capture.
+        int maxLatency; ///< Milliseconds to hold samples before emitting, or `0` for no deadline.
+    };
 
     DsoService(QLowEnergyController * const pokitDevice, QObject * parent = nullptr);
     ~DsoService() override;
@@ -126,10 +133,15 @@ public:
     bool enableReadingNotifications();
     bool disableReadingNotifications();
 
+    // Sample coalescing.
+    CoalescingSettings coalescingSettings() const;
+    void setCoalescingSettings(const CoalescingSettings &settings);
+
 signals:
     void settingsWritten();
     void metadataRead(const DsoService::Metadata &meta);
     void samplesRead(const DsoService::Samples &samples);
+    void scaledSamplesRead(const DsoService::ScaledSamples &samples);
 
 protected:
     /// \cond internal
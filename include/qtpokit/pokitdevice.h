@@ -12,6 +12,7 @@
 #include "qtpokit_global.h"
 
 #include <QBluetoothDeviceInfo>
+#include <QLowEnergyConnectionParameters>
 #include <QObject>
 
 class QLowEnergyController;
@@ -33,6 +34,17 @@ class QTPOKIT_EXPORT PokitDevice : public QObject
     Q_OBJECT
 
 public:
+    enum class ConnectionProfile {
+        Balanced,   ///< Moderate connection intervals; the default, and relaxed, profile.
+        Throughput, ///< Short connection intervals, and no latency, for bulk transfers.
+        LowPower,   ///< Long connection intervals, with latency, to conserve battery.
+    };
+    static QString toString(const ConnectionProfile &profile);
+    static QLowEnergyConnectionParameters profileParameters(const ConnectionProfile &profile);
+
+    static const int defaultMtu = 23; ///< ATT MTU (in bytes) used until a larger one is negotiated.
+    static int maximumNotificationPayload(const int mtu);
+
     explicit PokitDevice(const QBluetoothDeviceInfo &deviceInfo, QObject *parent=nullptr);
     explicit PokitDevice(QLowEnergyController *controller, QObject *parent=nullptr);
     virtual ~PokitDevice();
@@ -48,12 +60,20 @@ public:
     MultimeterService * multimeter();
     StatusService * status();
 
+    ConnectionProfile connectionProfile() const;
+    void setConnectionProfile(const ConnectionProfile profile);
+    QLowEnergyConnectionParameters connectionParameters() const;
+
+    int mtu() const;
+
     static QString serviceToString(const QBluetoothUuid &uuid);
     static QString charcteristicToString(const QBluetoothUuid &uuid);
 
 public slots:
 
 signals:
+    void connectionParametersUpdated(const QLowEnergyConnectionParameters &parameters);
+    void mtuChanged(const int mtu);
 
 protected:
     /// \cond internal
@@ -10,8 +10,11 @@
 #define QTPOKIT_POKITDISCOVERYAGENT_H
 
 #include "qtpokit_global.h"
+#include "rssitracker.h"
 
 #include <QBluetoothDeviceDiscoveryAgent>
+#include <QBluetoothDeviceInfo>
+#include <QDateTime>
 
 QTPOKIT_BEGIN_NAMESPACE
 
@@ -22,6 +25,20 @@ class QTPOKIT_EXPORT PokitDiscoveryAgent : public QBluetoothDeviceDiscoveryAgent
     Q_OBJECT
 
 public:
+    struct PresenceSettings {
+        int scanDuration;  ///< Milliseconds to scan for, in each scan cycle.
+        int scanInterval;  ///< Milliseconds between the starts of consecutive scan cycles.
+        int lostTimeout;   ///< Milliseconds unseen before a device is considered lost.
+        int rssiThreshold; ///< Smoothed RSSI change (in dBm) before a device is considered moved.
+    };
+
+    struct Presence {
+        QBluetoothDeviceInfo info;  ///< Most recently seen device info.
+        QDateTime firstSeen;        ///< When the device (most recently) appeared.
+        QDateTime lastSeen;         ///< When the device was last seen.
+        RssiTracker signalStrength; ///< Smoothed RSSI (aka signal strength).
+    };
+
     explicit PokitDiscoveryAgent(const QBluetoothAddress &deviceAdapter, QObject *parent=nullptr);
     PokitDiscoveryAgent(QObject * parent=nullptr);
     virtual ~PokitDiscoveryAgent();
@@ -29,16 +46,28 @@ public:
     static bool isPokitDevice(const QBluetoothDeviceInfo &info);
     static bool isPokitMeter(const QBluetoothDeviceInfo &info);
     static bool isPokitPro(const QBluetoothDeviceInfo &info);
+    static QString deviceKey(const QBluetoothDeviceInfo &info);
+
+    static PresenceSettings defaultPresenceSettings();
+    PresenceSettings presenceSettings() const;
+    void setPresenceSettings(const PresenceSettings &settings);
+    bool isMonitoring() const;
+    QList<Presence> presentDevices() const;
 
 public slots:
     void start(QBluetoothDeviceDiscoveryAgent::DiscoveryMethods methods);
     void start();
+    void startMonitoring();
+    void stopMonitoring();
 
 signals:
     void pokitDeviceDiscovered(const QBluetoothDeviceInfo &info);
     #if (QT_VERSION >= QT_VERSION_CHECK(5, 12, 0)) // Required signal, and Fields, added in Qt 5.12.
     void pokitDeviceUpdated(const QBluetoothDeviceInfo &info, QBluetoothDeviceInfo::Fields updatedFields);
     #endif
+    void pokitDeviceAppeared(const QBluetoothDeviceInfo &info);
+    void pokitDeviceMoved(const QBluetoothDeviceInfo &info, const qint16 rssi);
+    void pokitDeviceLost(const QBluetoothDeviceInfo &info);
 
 protected:
     /// \cond internal
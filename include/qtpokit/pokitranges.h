@@ -0,0 +1,57 @@
+// SPDX-FileCopyrightText: 2022 Paul Colby <git@colby.id.au>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+/*!
+ * \file
+ * Declares the PokitRanges class.
+ */
+
+#ifndef QTPOKIT_POKITRANGES_H
+#define QTPOKIT_POKITRANGES_H
+
+#include "qtpokit_global.h"
+
+#include <QCoreApplication>
+#include <QString>
+#include <QVariant>
+
+QTPOKIT_BEGIN_NAMESPACE
+
+class QTPOKIT_EXPORT PokitRanges
+{
+    Q_DECLARE_TR_FUNCTIONS(PokitRanges)
+
+public:
+    enum class Quantity : quint8 {
+        Voltage    = 0, ///< AC or DC voltage, in volts.
+        Current    = 1, ///< AC or DC current, in amps.
+        Resistance = 2, ///< Resistance, in ohms.
+    };
+
+    struct Descriptor {
+        quint8 value;       ///< Range's enum value, as used by the relevant service(s).
+        double minimum;     ///< Range's (absolute) lower bound, in SI units.
+        double maximum;     ///< Range's upper bound, in SI units.
+        const char * label; ///< Range's untranslated label, such as "2V to 6V".
+    };
+
+    struct Table {
+        const Descriptor * descriptors; ///< Descriptors, indexed by value, in ascending order.
+        int size;                       ///< Number of descriptors.
+
+        const Descriptor * begin() const { return descriptors; }        ///< Returns first range.
+        const Descriptor * end() const { return descriptors + size; }   ///< Returns past-the-end.
+    };
+
+    static Table table(const Quantity quantity);
+    static const Descriptor * find(const Quantity quantity, const quint8 value);
+    static const Descriptor * lowest(const Quantity quantity, const double maximum);
+
+    static QString label(const Quantity quantity, const quint8 value);
+    static QVariant minValue(const Quantity quantity, const quint8 value);
+    static QVariant maxValue(const Quantity quantity, const quint8 value);
+};
+
+QTPOKIT_END_NAMESPACE
+
+#endif // QTPOKIT_POKITRANGES_H
@@ -0,0 +1,71 @@
+// SPDX-FileCopyrightText: 2022 Paul Colby <git@colby.id.au>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+/*!
+ * \file
+ * Declares the PokitSimulator class.
+ */
+
+#ifndef QTPOKIT_POKITSIMULATOR_H
+#define QTPOKIT_POKITSIMULATOR_H
+
+#include "dataloggerservice.h"
+#include "dsoservice.h"
+#include "multimeterservice.h"
+
+#include <QObject>
+
+QTPOKIT_BEGIN_NAMESPACE
+
+class PokitSimulatorPrivate;
+
+class QTPOKIT_EXPORT PokitSimulator : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct StreamSettings {
+        int notificationsPerSecond; ///< Notification rate, or `0` for as fast as possible.
+        int payloadSize;            ///< Bytes per DSO or Data Logger `Reading` notification.
+        int notificationCount;      ///< Number of `Reading` notifications, or `0` for unlimited.
+    };
+
+    explicit PokitSimulator(QObject * const parent = nullptr);
+    virtual ~PokitSimulator();
+
+    void addStream(MultimeterService * const service, const StreamSettings &settings);
+    void addStream(DsoService * const service, const StreamSettings &settings);
+    void addStream(DataLoggerService * const service, const StreamSettings &settings);
+    void clearStreams();
+
+    bool isActive() const;
+    qint64 notificationCount() const;
+    qint64 bytesNotified() const;
+
+    static QByteArray encodeReading(const MultimeterService::Reading &reading);
+    static QByteArray encodeMetadata(const DsoService::Metadata &metadata);
+    static QByteArray encodeMetadata(const DataLoggerService::Metadata &metadata);
+    static QByteArray encodeSamples(const int numberOfSamples, const int phase = 0);
+
+public slots:
+    void start();
+    void stop();
+
+signals:
+    void finished();
+
+protected:
+    /// \cond internal
+    PokitSimulatorPrivate * d_ptr; ///< Internal d-pointer.
+    PokitSimulator(PokitSimulatorPrivate * const d, QObject * const parent);
+    /// \endcond
+
+private:
+    Q_DECLARE_PRIVATE(PokitSimulator)
+    Q_DISABLE_COPY(PokitSimulator)
+    friend class TestPokitSimulator;
+};
+
+QTPOKIT_END_NAMESPACE
+
+#endif // QTPOKIT_POKITSIMULATOR_H
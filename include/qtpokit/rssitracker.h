@@ -0,0 +1,41 @@
+// SPDX-FileCopyrightText: 2022 Paul Colby <git@colby.id.au>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+/*!
+ * \file
+ * Declares the RssiTracker class.
+ */
+
+#ifndef QTPOKIT_RSSITRACKER_H
+#define QTPOKIT_RSSITRACKER_H
+
+#include "qtpokit_global.h"
+
+QTPOKIT_BEGIN_NAMESPACE
+
+class QTPOKIT_EXPORT RssiTracker
+{
+public:
+    RssiTracker();
+
+    bool isValid() const;
+    double average() const;
+    qint16 latest() const;
+    qint16 minimum() const;
+    qint16 maximum() const;
+    qint16 reported() const;
+
+    bool update(const qint16 rssi, const int threshold);
+
+private:
+    double averageRssi;  ///< Exponentially-weighted moving average, in dBm.
+    qint16 latestRssi;   ///< Most recent value, in dBm.
+    qint16 minimumRssi;  ///< Minimum value seen, in dBm.
+    qint16 maximumRssi;  ///< Maximum value seen, in dBm.
+    qint16 reportedRssi; ///< Rounded average, as at the last reported change, in dBm.
+    bool valid;          ///< Whether any known (non-zero) value has been seen yet.
+};
+
+QTPOKIT_END_NAMESPACE
+
+#endif // QTPOKIT_RSSITRACKER_H
@@ -6,7 +6,19 @@
 #include <qtpokit/pokitdevice.h>
 #include <qtpokit/pokitdiscoveryagent.h>
 
+#include <QDataStream>
+#include <QJsonDocument>
 #include <QLocale>
+#include <QtEndian>
+
+#include <clocale>
+#include <cstdio>
+#include <cstring>
+
+#if defined(Q_OS_WIN)
+#include <fcntl.h>
+#include <io.h>
+#endif
 
 /*!
  * \class AbstractCommand
@@ -17,12 +29,20 @@
 /// \enum AbstractCommand::OutputFormat
 /// \brief Supported output formats.
 
+/// \enum AbstractCommand::BinarySource
+/// \brief Services that OutputFormat::Binary samples may be read from.
+
+/// \struct AbstractCommand::BinaryHeader
+/// \brief Metadata written ahead of OutputFormat::Binary samples; see appendBinaryHeader().
+
 /*!
  * Constructs a new command with \a parent.
  */
 AbstractCommand::AbstractCommand(QObject * const parent) : QObject(parent),
-    discoveryAgent(new PokitDiscoveryAgent(this)), format(OutputFormat::Text)
+    discoveryAgent(new PokitDiscoveryAgent(this)), format(OutputFormat::Text), samplesOutput(0),
+    csvHeaderPending(true), sharedCsvHeaderPending(nullptr)
 {
+    outputBuffer.reserve(4096); // Also marks the capacity as reserved, so flushOutput() keeps it.
     connect(discoveryAgent, &PokitDiscoveryAgent::pokitDeviceDiscovered,
             this, &AbstractCommand::deviceDiscovered);
     connect(discoveryAgent, &PokitDiscoveryAgent::finished,
@@ -110,6 +130,203 @@ QString AbstractCommand::escapeCsvField(const QString &field)
     } else return field;
 }
 
+/*!
+ * Appends the decimal representation of \a value to \a output.
+ *
+ * This is equivalent to `output.append(QString::number(value).toLatin1())`, but without any
+ * temporary QString or QByteArray objects, so is suitable for formatting large batches of samples.
+ */
+void AbstractCommand::appendInteger(QByteArray &output, const qint64 value)
+{
+    char buffer[24];
+    const int length = std::snprintf(buffer, sizeof(buffer), "%lld", static_cast<long long>(value));
+    output.append(buffer, length);
+}
+
+/*!
+ * Appends \a value to \a output, formatted according to \a format (one of `e`, `f` or `g`) and
+ * \a precision.
+ *
+ * The result matches that of `QString::arg(value, 0, format, precision)`, including being
+ * independent of the current locale, but without any temporary QString or QByteArray objects. So
+ * this is suitable for formatting large batches of samples.
+ */
+void AbstractCommand::appendReal(QByteArray &output, const double value, const char format,
+                                 const int precision)
+{
+    if (qIsNaN(value)) {
+        output.append("nan");
+        return;
+    }
+    if (qIsInf(value)) {
+        output.append((value < 0) ? "-inf" : "inf");
+        return;
+    }
+
+    char buffer[512]; // Large enough for DBL_MAX in 'f' format.
+    int length = 0;
+    switch (format) {
+    case 'e': length = std::snprintf(buffer, sizeof(buffer), "%.*e", precision, value); break;
+    case 'f': length = std::snprintf(buffer, sizeof(buffer), "%.*f", precision, value); break;
+    default:  length = std::snprintf(buffer, sizeof(buffer), "%.*g", precision, value); break;
+    }
+    length = qBound(0, length, (int)sizeof(buffer) - 1);
+
+    // QCoreApplication sets the C locale from the environment, so undo any localised decimal point.
+    const char * const point = std::localeconv()->decimal_point;
+    if ((point[0] != '.') || (point[1] != '\0')) {
+        char * const pos = std::strstr(buffer, point);
+        if (pos != nullptr) {
+            const int pointLength = (int)std::strlen(point);
+            *pos = '.';
+            std::memmove(pos + 1, pos + pointLength, length - (pos - buffer) - pointLength + 1);
+            length -= pointLength - 1;
+        }
+    }
+    output.append(buffer, length);
+}
+
+/*!
+ * Appends \a string to \a output as an RFC 8259 JSON string, including the surrounding quotes.
+ */
+void AbstractCommand::appendJsonString(QByteArray &output, const QString &string)
+{
+    static const char hexDigits[] = "0123456789abcdef";
+    const QByteArray utf8 = string.toUtf8();
+    output.append('"');
+    for (const char c: utf8) {
+        switch (c) {
+        case '"':  output.append("\\\""); break;
+        case '\\': output.append("\\\\"); break;
+        case '\b': output.append("\\b"); break;
+        case '\f': output.append("\\f"); break;
+        case '\n': output.append("\\n"); break;
+        case '\r': output.append("\\r"); break;
+        case '\t': output.append("\\t"); break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20) {
+                output.append("\\u00").append(hexDigits[c >> 4]).append(hexDigits[c & 0xF]);
+            } else {
+                output.append(c); // Including all non-ASCII UTF-8 bytes.
+            }
+        }
+    }
+    output.append('"');
+}
+
+/*!
+ * Appends \a value to \a output as an RFC 8259 JSON number, with up to \a precision significant
+ * digits. The default precision of 9 is enough to round-trip any `float` value exactly.
+ *
+ * Since JSON has no representation for infinities or NaN, such values are written as `null`.
+ */
+void AbstractCommand::appendJsonNumber(QByteArray &output, const double value, const int precision)
+{
+    if (!qIsFinite(value)) {
+        output.append("null");
+        return;
+    }
+    appendReal(output, value, 'g', precision);
+}
+
+/*!
+ * Appends \a header to \a output in the OutputFormat::Binary layout. That is, the following 32
+ * bytes, with all multi-byte fields in little-endian byte order:
+ *
+ * | Offset | Size | Field                                                        |
+ * | -----: | ---: | ------------------------------------------------------------ |
+ * |      0 |    4 | Magic bytes `QTPK`                                           |
+ * |      4 |    2 | Header size in bytes (currently `32`)                        |
+ * |      6 |    1 | Format version (currently `1`)                               |
+ * |      7 |    1 | BinaryHeader::source                                         |
+ * |      8 |    1 | BinaryHeader::mode                                           |
+ * |      9 |    1 | BinaryHeader::range                                          |
+ * |     10 |    2 | Size of each sample in bytes (currently `2`)                 |
+ * |     12 |    4 | BinaryHeader::scale, as an IEEE 754 single-precision float   |
+ * |     16 |    4 | BinaryHeader::interval                                       |
+ * |     20 |    4 | BinaryHeader::samplingRate                                   |
+ * |     24 |    4 | BinaryHeader::timestamp                                      |
+ * |     28 |    4 | BinaryHeader::numberOfSamples                                |
+ *
+ * The header is followed by BinaryHeader::numberOfSamples signed 16-bit samples (see
+ * appendRawSamples()), which readers may multiply by BinaryHeader::scale to get Volts or Amps.
+ */
+void AbstractCommand::appendBinaryHeader(QByteArray &output, const BinaryHeader &header)
+{
+    static_assert(sizeof(header.source)          == 1, "Expected to be 1 byte.");
+    static_assert(sizeof(header.scale)           == 4, "Expected to be 4 bytes.");
+    static_assert(sizeof(header.numberOfSamples) == 4, "Expected to be 4 bytes.");
+
+    QByteArray value;
+    QDataStream stream(&value, QIODevice::WriteOnly);
+    stream.setByteOrder(QDataStream::LittleEndian);
+    stream.setFloatingPointPrecision(QDataStream::SinglePrecision); // 32-bit floats, not 64-bit.
+    stream.writeRawData("QTPK", 4);
+    stream << (quint16)32 << (quint8)1 << (quint8)header.source << header.mode << header.range
+           << (quint16)sizeof(qint16) << header.scale << header.interval << header.samplingRate
+           << header.timestamp << header.numberOfSamples;
+
+    Q_ASSERT(value.size() == 32);
+    output.append(value);
+}
+
+/*!
+ * Appends raw \a samples to \a output as signed 16-bit little-endian integers.
+ *
+ * On little-endian hosts, this is a single `memcpy` of the sample data.
+ */
+void AbstractCommand::appendRawSamples(QByteArray &output, const QVector<qint16> &samples)
+{
+    const int offset = output.size();
+    output.resize(offset + samples.size() * (int)sizeof(qint16));
+    qToLittleEndian<qint16>(samples.constData(), samples.size(), output.data() + offset);
+}
+
+/*!
+ * Appends \a lines to \a output, with \a tag inserted into each line as appropriate for \a format.
+ * That is, \a tag is prepended to each line for OutputFormat::Csv and OutputFormat::Text, inserted
+ * after the opening brace of each JSON object for OutputFormat::JsonLines, and after the opening
+ * brace of each (indented) top-level JSON object for OutputFormat::Json. OutputFormat::Binary
+ * content is appended unchanged.
+ *
+ * See setOutputTag() for the \a tag values appropriate to each \a format.
+ */
+void AbstractCommand::appendTagged(QByteArray &output, const QByteArray &lines,
+                                   const OutputFormat format, const QByteArray &tag)
+{
+    if ((format == OutputFormat::Binary) || (tag.isEmpty())) {
+        output.append(lines);
+        return;
+    }
+    for (int begin = 0, end = 0; begin < lines.size(); begin = end) {
+        end = lines.indexOf('\n', begin);
+        end = (end < 0) ? lines.size() : end + 1;
+        const char * const line = lines.constData() + begin;
+        const int length = end - begin;
+        switch (format) {
+        case OutputFormat::Binary: // Handled above.
+        case OutputFormat::Csv:
+        case OutputFormat::Text:
+            output.append(tag).append(line, length);
+            break;
+        case OutputFormat::Json:
+            if ((length >= 1) && (line[0] == '{') && ((length == 1) || (line[1] == '\n'))) {
+                output.append('{').append(tag).append(line + 1, length - 1);
+            } else {
+                output.append(line, length);
+            }
+            break;
+        case OutputFormat::JsonLines:
+            if ((length >= 2) && (line[0] == '{') && (line[1] != '}')) {
+                output.append('{').append(tag).append(line + 1, length - 1);
+            } else {
+                output.append(line, length);
+            }
+            break;
+        }
+    }
+}
+
 /*!
  * Returns \a value as a number of micros, such as microseconds, or microvolts. The string \a value
  * may end with the optional \a unit, such as `V` or `s`, which may also be preceded with a SI unit
@@ -316,10 +533,17 @@ QStringList AbstractCommand::processOptions(const QCommandLineParser &parser)
         (parser.isSet(QLatin1String("output"))))
     {
         const QString output = parser.value(QLatin1String("output")).toLower();
-        if (output == QLatin1String("csv")) {
+        if ((output == QLatin1String("binary")) || (output == QLatin1String("bin"))) {
+            format = OutputFormat::Binary;
+            #if defined(Q_OS_WIN)
+            _setmode(_fileno(stdout), _O_BINARY); // Don't let the CRT translate any '\n' bytes.
+            #endif
+        } else if (output == QLatin1String("csv")) {
             format = OutputFormat::Csv;
         } else if (output == QLatin1String("json")) {
             format = OutputFormat::Json;
+        } else if ((output == QLatin1String("jsonl")) || (output == QLatin1String("ndjson"))) {
+            format = OutputFormat::JsonLines;
         } else if (output == QLatin1String("text")) {
             format = OutputFormat::Text;
         } else {
@@ -350,6 +574,144 @@ QStringList AbstractCommand::processOptions(const QCommandLineParser &parser)
     return errors;
 }
 
+/*!
+ * Sets \a handler to be given all further output, instead of stdout. This allows commands to be run
+ * on behalf of clients other than the console, such as those of a DaemonCommand.
+ */
+void AbstractCommand::setOutputHandler(const OutputHandler &handler)
+{
+    outputHandler = handler;
+}
+
+/*!
+ * Sets \a handler to be given all further error output (see writeError()), instead of stderr.
+ */
+void AbstractCommand::setErrorHandler(const OutputHandler &handler)
+{
+    errorHandler = handler;
+}
+
+/*!
+ * Appends the CSV \a header line to the output, if this command has not already done so.
+ *
+ * If an output tag has been set (see setOutputTag()), then the header gets a column name for the
+ * tag, instead of being tagged itself, and is output only if the (shared) tagged header is still
+ * pending, so that multiplexed output has just the one header.
+ */
+void AbstractCommand::appendCsvHeader(const QString &header)
+{
+    if (!csvHeaderPending) {
+        return;
+    }
+    csvHeaderPending = false;
+    if (outputTag.isEmpty()) {
+        outputBuffer.append(header.toLocal8Bit());
+        return;
+    }
+    if (sharedCsvHeaderPending) {
+        if (!*sharedCsvHeaderPending) {
+            return; // Another of the multiplexed commands has already output the header.
+        }
+        *sharedCsvHeaderPending = false;
+    }
+    taggedBuffer.append(tr("device,").toLocal8Bit()).append(header.toLocal8Bit());
+}
+
+/*!
+ * Writes any batched #outputBuffer content with a single write (see writeOutput()), then empties
+ * the buffer (retaining its capacity, so it may be reused without reallocating). If an output tag
+ * has been set (see setOutputTag()), then each line is tagged via appendTagged() first, following
+ * the (already tagged) CSV header, if pending (see appendCsvHeader()).
+ */
+void AbstractCommand::flushOutput()
+{
+    if (outputBuffer.isEmpty()) {
+        return;
+    }
+    if (outputTag.isEmpty()) {
+        writeOutput(outputBuffer);
+        outputBuffer.resize(0);
+        return;
+    }
+    appendTagged(taggedBuffer, outputBuffer, format, outputTag);
+    writeOutput(taggedBuffer);
+    taggedBuffer.resize(0);
+    outputBuffer.resize(0);
+}
+
+/*!
+ * Writes \a output to the output handler (see setOutputHandler()), if any, otherwise to stdout.
+ */
+void AbstractCommand::writeOutput(const QByteArray &output)
+{
+    if (outputHandler) {
+        outputHandler(output);
+    } else {
+        std::fwrite(output.constData(), 1, output.size(), stdout);
+    }
+}
+
+/*!
+ * Writes \a error to the error handler (see setErrorHandler()), if any, otherwise to stderr.
+ */
+void AbstractCommand::writeError(const QByteArray &error)
+{
+    if (errorHandler) {
+        errorHandler(error);
+    } else {
+        std::fwrite(error.constData(), 1, error.size(), stderr);
+    }
+}
+
+/*!
+ * Sets the \a tag to insert into each line of output, so that output from multiple commands (such
+ * as one per device) may be multiplexed into a single stream. The tag is encoded according to the
+ * current output #format, so this should only be called after processOptions().
+ *
+ * For OutputFormat::Csv and OutputFormat::Text, \a tag becomes the first field of each line. For
+ * the JSON formats, \a tag becomes the `device` property of each top-level object. Binary output
+ * is never tagged.
+ *
+ * If multiplexing CSV output, \a sharedHeaderPending should point to a flag shared by all of the
+ * multiplexed commands, so that only the first of them to output anything writes the CSV header
+ * (see appendCsvHeader()). Otherwise, this command will always write its own header.
+ */
+void AbstractCommand::setOutputTag(const QString &tag, bool * const sharedHeaderPending)
+{
+    sharedCsvHeaderPending = sharedHeaderPending;
+    outputTag.clear();
+    switch (format) {
+    case OutputFormat::Binary:
+        break;
+    case OutputFormat::Csv:
+        outputTag.append(escapeCsvField(tag).toLocal8Bit()).append(',');
+        break;
+    case OutputFormat::Json:
+        outputTag.append("\n    \"device\": ");
+        appendJsonString(outputTag, tag);
+        outputTag.append(',');
+        break;
+    case OutputFormat::JsonLines:
+        outputTag.append("\"device\":");
+        appendJsonString(outputTag, tag);
+        outputTag.append(',');
+        break;
+    case OutputFormat::Text:
+        outputTag.append(tag.toLocal8Bit()).append(": ");
+        break;
+    }
+}
+
+/*!
+ * Returns \a document as text for the selected output #format; that is, indented for
+ * OutputFormat::Json, or as a single compact line for OutputFormat::JsonLines.
+ */
+QByteArray AbstractCommand::formatJson(const QJsonDocument &document) const
+{
+    return (format == OutputFormat::JsonLines)
+        ? document.toJson(QJsonDocument::Compact).append('\n') : document.toJson();
+}
+
 /*!
  * \fn virtual bool AbstractCommand::start()
  *
@@ -9,29 +9,64 @@
 #include <QLoggingCategory>
 #include <QObject>
 
+#include <functional>
+
 class PokitDiscoveryAgent;
+class QJsonDocument;
 
 class AbstractCommand : public QObject
 {
 public:
     enum class OutputFormat {
+        Binary, ///< Compact binary; a metadata header, then raw little-endian samples.
         Csv,  ///< RFC 4180 compliant CSV text.
         Json, ///< RFC 8259 compliant JSON text.
+        JsonLines, ///< JSON Lines (aka NDJSON) text; one compact JSON value per line.
         Text, ///< Plain unstructured text.
     };
 
+    enum class BinarySource : quint8 {
+        Dso        = 1, ///< Samples from a DsoService.
+        DataLogger = 2, ///< Samples from a DataLoggerService.
+    };
+
+    struct BinaryHeader {
+        BinarySource source;     ///< Service the samples were read from.
+        quint8 mode;             ///< Service-specific measurement mode, such as DsoService::Mode.
+        quint8 range;            ///< Service-specific measurement range.
+        float scale;             ///< Scale to apply to the raw samples.
+        quint32 interval;        ///< DSO sampling window (microseconds), or logger interval (ms).
+        quint32 samplingRate;    ///< DSO sampling rate (Hz), or `0` for data logger samples.
+        quint32 timestamp;       ///< Capture start, in seconds since the epoch, or `0` if unknown.
+        quint32 numberOfSamples; ///< Number of raw samples following the header.
+    };
+
+    typedef std::function<void (const QByteArray &output)> OutputHandler;
+
     explicit AbstractCommand(QObject * const parent);
 
     virtual QStringList requiredOptions(const QCommandLineParser &parser) const;
     virtual QStringList supportedOptions(const QCommandLineParser &parser) const;
 
     static QString escapeCsvField(const QString &field);
+    static void appendInteger(QByteArray &output, const qint64 value);
+    static void appendReal(QByteArray &output, const double value, const char format = 'g',
+                           const int precision = 6);
+    static void appendJsonString(QByteArray &output, const QString &string);
+    static void appendJsonNumber(QByteArray &output, const double value, const int precision = 9);
+    static void appendBinaryHeader(QByteArray &output, const BinaryHeader &header);
+    static void appendRawSamples(QByteArray &output, const QVector<qint16> &samples);
+    static void appendTagged(QByteArray &output, const QByteArray &lines, const OutputFormat format,
+                             const QByteArray &tag);
     static quint32 parseMicroValue(const QString &value, const QString &unit,
                                    const quint32 sensibleMinimum=0);
     static quint32 parseMilliValue(const QString &value, const QString &unit,
                                    const quint32 sensibleMinimum=0);
     static quint32 parseWholeValue(const QString &value, const QString &unit);
 
+    void setOutputHandler(const OutputHandler &handler);
+    void setErrorHandler(const OutputHandler &handler);
+
 public slots:
     virtual QStringList processOptions(const QCommandLineParser &parser);
     virtual bool start() = 0;
@@ -39,13 +74,29 @@ public slots:
 protected:
     PokitDiscoveryAgent * discoveryAgent; ///< Agent for Pokit device descovery.
     OutputFormat format; ///< Selected output format.
+    QByteArray outputBuffer; ///< Reusable buffer for batching output before writing to stdout.
+    QByteArray outputTag; ///< Tag (if any) to insert into each output line; see setOutputTag().
+    QByteArray taggedBuffer; ///< Reusable buffer for tagging #outputBuffer lines.
+    quint64 samplesOutput; ///< Number of samples (or readings) output so far.
+    OutputHandler outputHandler; ///< Handler (if any) to write output to, instead of stdout.
+    OutputHandler errorHandler; ///< Handler (if any) to write errors to, instead of stderr.
+    bool csvHeaderPending; ///< Whether the CSV header is yet to be output; see appendCsvHeader().
+    bool * sharedCsvHeaderPending; ///< Header flag shared by tagged commands; see setOutputTag().
     static Q_LOGGING_CATEGORY(lc, "pokit.ui.command", QtInfoMsg); ///< Logging category for UI commands.
 
+    void setOutputTag(const QString &tag, bool * const sharedHeaderPending = nullptr);
+    void appendCsvHeader(const QString &header);
+    void flushOutput();
+    void writeOutput(const QByteArray &output);
+    void writeError(const QByteArray &error);
+    QByteArray formatJson(const QJsonDocument &document) const;
+
 protected slots:
     QString deviceToScanFor; ///< Device (if any) that were passed to processOptions().
     virtual void deviceDiscovered(const QBluetoothDeviceInfo &info) = 0;
     virtual void deviceDiscoveryFinished() = 0;
 
+    friend class MultiDeviceCommand;
     friend class TestAbstractCommand;
 };
 
@@ -0,0 +1,243 @@
+// SPDX-FileCopyrightText: 2022 Paul Colby <git@colby.id.au>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "batchcommand.h"
+
+#include <qtpokit/abstractpokitservice.h>
+#include <qtpokit/pokitdevice.h>
+
+#include <QFile>
+#include <QTimer>
+
+#include <cstdio>
+
+/*!
+ * \class BatchCommand
+ *
+ * The BatchCommand class implements the `batch` CLI command, which runs a script of other device
+ * commands (such as `status`, then `meter`, then `dso`) back-to-back over a single connection to
+ * one Pokit device, instead of each command scanning for, connecting to, and discovering the
+ * device's services itself.
+ *
+ * Each non-empty script line is one command, followed by that command's own options, such as:
+ *
+ * ```
+ * status --output json
+ * meter --mode 'DC Voltage' --samples 10
+ * dso --mode 'AC Voltage' --range 8 --samples 1000
+ * ```
+ *
+ * All lines are parsed (and their options validated) before connecting to the device, so that a
+ * typo late in the script does not waste a connection. Once connected, the services of all
+ * commands are created together, so that their service details are discovered in one pipelined
+ * sequence of GATT requests, while earlier commands run. Commands then run one at a time, in script
+ * order; if any command fails, the remaining commands are skipped, and the batch exits with that
+ * command's exit code.
+ */
+
+/*!
+ * Construct a new BatchCommand object with \a parent, using \a factory to create the command for
+ * each script line.
+ */
+BatchCommand::BatchCommand(const DaemonCommand::Factory &factory, QObject * const parent)
+    : DeviceCommand(parent), factory(factory), current(nullptr)
+{
+
+}
+
+/*!
+ * \copybrief DeviceCommand::supportedOptions
+ *
+ * This implementation extends DeviceCommand::supportedOptions to add the `script` option.
+ */
+QStringList BatchCommand::supportedOptions(const QCommandLineParser &parser) const
+{
+    return DeviceCommand::supportedOptions(parser) + QStringList{
+        QLatin1String("script"),
+    };
+}
+
+/*!
+ * Returns the command line arguments in the script \a line, which are separated by whitespace,
+ * and may be quoted (with single or double quotes) or backslash-escaped, as in a POSIX shell. An
+ * unquoted `#` begins a comment, running to the end of the line. On failure, such as an
+ * unterminated quote, returns an empty list, and sets \a error to a description of the failure.
+ */
+QStringList BatchCommand::parseLine(const QString &line, QString &error)
+{
+    QStringList arguments;
+    QString argument;
+    bool inArgument = false;
+    QChar quote;
+    for (auto iter = line.cbegin(); iter != line.cend(); ++iter) {
+        if (!quote.isNull()) {
+            if (*iter == quote) {
+                quote = QChar();
+            } else if ((*iter == QLatin1Char('\\')) && (quote == QLatin1Char('"')) &&
+                       ((iter + 1) != line.cend()))
+            {
+                argument.append(*(++iter));
+            } else {
+                argument.append(*iter);
+            }
+        } else if (iter->isSpace()) {
+            if (inArgument) {
+                arguments.append(argument);
+                argument.clear();
+                inArgument = false;
+            }
+        } else if ((*iter == QLatin1Char('#')) && (!inArgument)) {
+            break; // The rest of the line is a comment.
+        } else {
+            inArgument = true;
+            if ((*iter == QLatin1Char('\'')) || (*iter == QLatin1Char('"'))) {
+                quote = *iter;
+            } else if ((*iter == QLatin1Char('\\')) && ((iter + 1) != line.cend())) {
+                argument.append(*(++iter));
+            } else {
+                argument.append(*iter);
+            }
+        }
+    }
+    if (!quote.isNull()) {
+        error = tr("Unterminated %1 quote").arg(quote);
+        return QStringList();
+    }
+    if (inArgument) {
+        arguments.append(argument);
+    }
+    return arguments;
+}
+
+/*!
+ * \copybrief DeviceCommand::processOptions
+ *
+ * This implementation extends DeviceCommand::processOptions to load the script given by the
+ * `script` option, or stdin if that option is not set (or is `-`).
+ */
+QStringList BatchCommand::processOptions(const QCommandLineParser &parser)
+{
+    QStringList errors = DeviceCommand::processOptions(parser);
+    if (!errors.isEmpty()) {
+        return errors;
+    }
+
+    const QString fileName = parser.value(QLatin1String("script"));
+    QFile script(fileName);
+    if (((fileName.isEmpty()) || (fileName == QLatin1String("-")))
+        ? (!script.open(stdin, QIODevice::ReadOnly|QIODevice::Text))
+        : (!script.open(QIODevice::ReadOnly|QIODevice::Text)))
+    {
+        errors.append(tr("Failed to open script %1: %2").arg(fileName, script.errorString()));
+        return errors;
+    }
+    errors.append(loadScript(script));
+    if ((errors.isEmpty()) && (commands.isEmpty())) {
+        errors.append(tr("Script contains no commands"));
+    }
+    return errors;
+}
+
+/*!
+ * \copybrief DeviceCommand::getService
+ *
+ * This override creates the services of all batched commands (see prepareService()), so that Qt
+ * discovers all of their details together (pipelined) once the device's services have been
+ * discovered, rather than each command waiting for the previous one to finish first. No command's
+ * signals are connected until that command is attached to the device (see runNextCommand()), so
+ * that commands sharing a service do not react to each other's signals. This returns the first
+ * command's service, so that the batch can begin as soon as that service is ready.
+ */
+AbstractPokitService * BatchCommand::getService()
+{
+    Q_ASSERT(device);
+    Q_ASSERT(!commands.isEmpty());
+    AbstractPokitService * first = nullptr;
+    for (const DeviceCommand * const command: commands) {
+        AbstractPokitService * const service = command->prepareService(device);
+        if (!first) {
+            first = service;
+        }
+    }
+    return first;
+}
+
+/*!
+ * \copybrief DeviceCommand::serviceDetailsDiscovered
+ *
+ * This override begins running the batched commands.
+ */
+void BatchCommand::serviceDetailsDiscovered()
+{
+    DeviceCommand::serviceDetailsDiscovered(); // Just logs consistently.
+    if (!current) {
+        runNextCommand();
+    }
+}
+
+/*!
+ * Creates a command for each line of \a script, and returns any errors, prefixed by line number.
+ */
+QStringList BatchCommand::loadScript(QIODevice &script)
+{
+    QStringList errors;
+    for (int lineNumber = 1; !script.atEnd(); ++lineNumber) {
+        QString error;
+        const QStringList arguments = parseLine(QString::fromLocal8Bit(script.readLine()), error);
+        if ((arguments.isEmpty()) && (error.isEmpty())) {
+            continue; // Blank, or comment-only, line.
+        }
+        QCommandLineParser parser;
+        DeviceCommand * const command = (error.isEmpty())
+            ? factory(arguments, parser, error, this) : nullptr;
+        if (!command) {
+            errors.append(tr("Line %1: %2").arg(lineNumber).arg(error));
+            continue;
+        }
+        const QStringList commandErrors = command->processOptions(parser);
+        for (const QString &commandError: commandErrors) {
+            errors.append(tr("Line %1: %2").arg(lineNumber).arg(commandError));
+        }
+        commands.enqueue(command);
+    }
+    return errors;
+}
+
+/*!
+ * Runs the next batched command, if any, otherwise disconnects from the device.
+ */
+void BatchCommand::runNextCommand()
+{
+    if (commands.isEmpty()) {
+        qCDebug(lc).noquote() << tr("Batch complete.");
+        disconnect(EXIT_SUCCESS);
+        return;
+    }
+    current = commands.dequeue();
+    current->setFinishedHandler([this](DeviceCommand * const command, const int exitCode) {
+        commandFinished(command, exitCode);
+    });
+    current->attachToDevice(device);
+}
+
+/*!
+ * Handles the finishing of the current \a command, by running the next command, or if \a exitCode
+ * indicates failure, skipping the remaining commands, and disconnecting with \a exitCode.
+ */
+void BatchCommand::commandFinished(DeviceCommand * const command, const int exitCode)
+{
+    if (command != current) {
+        return; // Already finished, such as an error, followed by a disconnection.
+    }
+    current->deleteLater();
+    current = nullptr;
+    if (exitCode != EXIT_SUCCESS) {
+        qCWarning(lc).noquote() << tr("Batch command failed with exit code %1; skipping %Ln "
+            "remaining command(s).", nullptr, commands.size()).arg(exitCode);
+        qDeleteAll(commands);
+        commands.clear();
+        disconnect(exitCode);
+        return;
+    }
+    QTimer::singleShot(0, this, &BatchCommand::runNextCommand);
+}
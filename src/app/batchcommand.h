@@ -0,0 +1,43 @@
+// SPDX-FileCopyrightText: 2022 Paul Colby <git@colby.id.au>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#ifndef QTPOKIT_BATCHCOMMAND_H
+#define QTPOKIT_BATCHCOMMAND_H
+
+#include "daemoncommand.h"
+
+#include <QQueue>
+
+class QIODevice;
+
+class BatchCommand : public DeviceCommand
+{
+public:
+    BatchCommand(const DaemonCommand::Factory &factory, QObject * const parent);
+
+    QStringList supportedOptions(const QCommandLineParser &parser) const override;
+
+    static QStringList parseLine(const QString &line, QString &error);
+
+public slots:
+    QStringList processOptions(const QCommandLineParser &parser) override;
+
+protected:
+    AbstractPokitService * getService() override;
+
+protected slots:
+    void serviceDetailsDiscovered() override;
+
+private:
+    DaemonCommand::Factory factory; ///< Factory for creating the command for each script line.
+    QQueue<DeviceCommand *> commands; ///< Commands yet to be run, in script order.
+    DeviceCommand * current; ///< Command currently using the device, if any.
+
+    QStringList loadScript(QIODevice &script);
+    void runNextCommand();
+    void commandFinished(DeviceCommand * const command, const int exitCode);
+
+    friend class TestBatchCommand;
+};
+
+#endif // QTPOKIT_BATCHCOMMAND_H
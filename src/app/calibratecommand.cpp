@@ -71,12 +71,27 @@ AbstractPokitService * CalibrateCommand::getService()
     if (!service) {
         service = device->calibration();
         Q_ASSERT(service);
+        service->setSkipValueDiscovery(); // We never read cached values.
         connect(service, &CalibrationService::temperatureCalibrated,
                 this, &CalibrateCommand::temperatureCalibrated);
     }
     return service;
 }
 
+/*!
+ * \copybrief DeviceCommand::prepareService
+ *
+ * This override returns a pointer to \a pokitDevice's CalibrationService object, with its
+ * value discovery skipped, since this command never reads cached values.
+ */
+AbstractPokitService * CalibrateCommand::prepareService(PokitDevice * const pokitDevice) const
+{
+    CalibrationService * const pokitService = pokitDevice->calibration();
+    Q_ASSERT(pokitService);
+    pokitService->setSkipValueDiscovery(); // We never read cached values.
+    return pokitService;
+}
+
 /*!
  * \copybrief DeviceCommand::serviceDetailsDiscovered
  *
@@ -87,7 +102,7 @@ void CalibrateCommand::serviceDetailsDiscovered()
     DeviceCommand::serviceDetailsDiscovered(); // Just logs consistently.
     qCInfo(lc).noquote() << tr("Calibrating temperature at %1 degrees celcius...").arg(temperature);
     if (!service->calibrateTemperature(0)) {
-        QCoreApplication::exit(EXIT_FAILURE);
+        finish(EXIT_FAILURE);
     }
 }
 
@@ -98,14 +113,17 @@ void CalibrateCommand::temperatureCalibrated()
 {
     switch (format) {
     case OutputFormat::Csv:
-        fputs(qPrintable(tr("calibration_result\nsuccess\n")), stdout);
+        outputBuffer.append(qPrintable(tr("calibration_result\nsuccess\n")));
         break;
     case OutputFormat::Json:
-        fputs(qPrintable(QLatin1String("true\n")), stdout);
+    case OutputFormat::JsonLines:
+        outputBuffer.append(qPrintable(QLatin1String("true\n")));
         break;
+    case OutputFormat::Binary: // Only sample data has a binary form, so use text otherwise.
     case OutputFormat::Text:
-        fputs(qPrintable(tr("Done.\n")), stdout);
+        outputBuffer.append(qPrintable(tr("Done.\n")));
         break;
     }
+    flushOutput();
     disconnect(); // Will exit the application once disconnected.
 }
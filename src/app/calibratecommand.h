@@ -18,6 +18,7 @@ public slots:
 
 protected:
     AbstractPokitService * getService() override;
+    AbstractPokitService * prepareService(PokitDevice * const pokitDevice) const override;
 
 protected slots:
     void serviceDetailsDiscovered() override;
@@ -0,0 +1,510 @@
+// SPDX-FileCopyrightText: 2022 Paul Colby <git@colby.id.au>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "daemoncommand.h"
+
+#include <qtpokit/deviceinfoservice.h>
+#include <qtpokit/pokitdevice.h>
+
+#include <QDataStream>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QtEndian>
+
+#include <cstdio>
+
+/*!
+ * \class DaemonCommand
+ *
+ * The DaemonCommand class implements the `daemon` CLI command, which keeps a Pokit device
+ * connected, and runs other device commands (such as `meter` or `status`) against it on behalf of
+ * clients connecting via a local (Unix domain) socket. This avoids the process startup, device
+ * scanning, connection and service discovery costs that each stand-alone command would otherwise
+ * incur.
+ *
+ * Each client sends a single request, being its command line arguments (excluding the program name)
+ * encoded as a compact JSON array, terminated by a newline (see encodeRequest()). The daemon then
+ * runs the requested command once the device is free, and streams back a sequence of frames (see
+ * encodeFrame()), ending with a FrameType::Exit frame containing the command's exit code. The
+ * forward() function implements the client side of this protocol.
+ *
+ * While a request is running, the daemon's log messages (warnings, errors, and debug output if
+ * enabled), and the command's `--stats` output, are relayed to the client via FrameType::Error
+ * frames, as well as being logged by the daemon itself.
+ *
+ * Requests are run one at a time, in the order received. Any `--device` option in a request is
+ * ignored, since the daemon serves just the one device. If the device disconnects, the current
+ * request fails, and the daemon reconnects before running any further requests. If a client
+ * disconnects while its request is running (such as an interrupted `meter` command), that request
+ * is aborted.
+ */
+
+/*!
+ * Construct a new DaemonCommand object with \a parent, using \a factory to create the command for
+ * each client request.
+ */
+DaemonCommand::DaemonCommand(const Factory &factory, QObject * const parent)
+    : DeviceCommand(parent), factory(factory), server(new QLocalServer(this)),
+      serverName(defaultServerName()), service(nullptr), ready(false), current(nullptr)
+{
+    connect(server, &QLocalServer::newConnection, this, &DaemonCommand::newConnection);
+    reconnectTimer.setInterval(2000);
+    reconnectTimer.setSingleShot(true);
+    connect(&reconnectTimer, &QTimer::timeout, this, &DaemonCommand::reconnect);
+}
+
+/*!
+ * Destroys this DaemonCommand object, restoring the previous message handler if this daemon had
+ * been relaying log messages to its clients.
+ */
+DaemonCommand::~DaemonCommand()
+{
+    if (messageRelay == this) {
+        qInstallMessageHandler(previousMessageHandler);
+        messageRelay = nullptr;
+        previousMessageHandler = nullptr;
+    }
+}
+
+DaemonCommand * DaemonCommand::messageRelay = nullptr;
+QtMessageHandler DaemonCommand::previousMessageHandler = nullptr;
+
+/*!
+ * \copybrief DeviceCommand::supportedOptions
+ *
+ * This implementation extends DeviceCommand::supportedOptions to add the `socket` option.
+ */
+QStringList DaemonCommand::supportedOptions(const QCommandLineParser &parser) const
+{
+    return DeviceCommand::supportedOptions(parser) + QStringList{
+        QLatin1String("socket"),
+    };
+}
+
+/*!
+ * Returns the socket name the daemon listens on when the `socket` option is not set.
+ */
+QString DaemonCommand::defaultServerName()
+{
+    return QStringLiteral("pokit");
+}
+
+/*!
+ * Returns a frame of \a type, containing \a payload. Each frame is a one byte type, followed by a
+ * 32-bit little-endian payload length, then the payload itself.
+ */
+QByteArray DaemonCommand::encodeFrame(const FrameType type, const QByteArray &payload)
+{
+    QByteArray frame;
+    frame.reserve(frameHeaderSize + payload.size());
+    QDataStream stream(&frame, QIODevice::WriteOnly);
+    stream.setByteOrder(QDataStream::LittleEndian);
+    stream << (quint8)type << (quint32)payload.size();
+    stream.writeRawData(payload.constData(), payload.size());
+    return frame;
+}
+
+/*!
+ * Returns a request line for the command line \a arguments, which should exclude the program name.
+ */
+QByteArray DaemonCommand::encodeRequest(const QStringList &arguments)
+{
+    return QJsonDocument(QJsonArray::fromStringList(arguments)).toJson(QJsonDocument::Compact)
+        + '\n';
+}
+
+/*!
+ * Returns the command line arguments encoded in the request \a line. On failure, returns an empty
+ * list, and sets \a error to a description of the failure.
+ */
+QStringList DaemonCommand::parseRequest(const QByteArray &line, QString &error)
+{
+    QJsonParseError parseError;
+    const QJsonDocument document = QJsonDocument::fromJson(line, &parseError);
+    if (parseError.error != QJsonParseError::NoError) {
+        error = tr("Invalid request: %1").arg(parseError.errorString());
+        return QStringList();
+    }
+    if (!document.isArray()) {
+        error = tr("Invalid request: not an array");
+        return QStringList();
+    }
+    QStringList arguments;
+    const QJsonArray array = document.array();
+    for (const QJsonValue &value: array) {
+        if (!value.isString()) {
+            error = tr("Invalid request: non-string argument");
+            return QStringList();
+        }
+        arguments.append(value.toString());
+    }
+    if (arguments.isEmpty()) {
+        error = tr("Invalid request: no arguments");
+    }
+    return arguments;
+}
+
+/*!
+ * Forwards the command line \a arguments (excluding the program name) to the daemon listening on
+ * \a serverName, writing the resulting output to stdout, and any errors to stderr.
+ *
+ * This function blocks until the daemon has finished running the command, and then returns the
+ * command's exit code. If the daemon does not respond within \a timeout milliseconds (or the
+ * connection closes early), then `EXIT_FAILURE` is returned instead. Once the daemon has responded,
+ * this waits for as long as the command runs, since commands such as `meter --interval 90s` may
+ * legitimately go quiet for longer than any fixed timeout between outputs.
+ */
+int DaemonCommand::forward(const QString &serverName, const QStringList &arguments,
+                           const int timeout)
+{
+    QLocalSocket socket;
+    socket.connectToServer(serverName);
+    if (!socket.waitForConnected(1000)) {
+        qCWarning(lc).noquote() << tr("Failed to connect to daemon \"%1\": %2")
+            .arg(serverName, socket.errorString());
+        return EXIT_FAILURE;
+    }
+    socket.write(encodeRequest(arguments));
+    socket.flush();
+
+    QByteArray buffer;
+    int offset = 0;
+    bool responded = false;
+    while (true) {
+        // Process all complete frames.
+        while (buffer.size() - offset >= frameHeaderSize) {
+            const FrameType type = (FrameType)buffer.at(offset);
+            const quint32 size = qFromLittleEndian<quint32>(buffer.constData() + offset + 1);
+            if ((quint32)(buffer.size() - offset - frameHeaderSize) < size) {
+                break; // Wait for the rest of the frame.
+            }
+            const char * const payload = buffer.constData() + offset + frameHeaderSize;
+            switch (type) {
+            case FrameType::Output:
+                std::fwrite(payload, 1, size, stdout);
+                std::fflush(stdout);
+                break;
+            case FrameType::Error:
+                std::fwrite(payload, 1, size, stderr);
+                break;
+            case FrameType::Exit:
+                return (size >= sizeof(qint32)) ? qFromLittleEndian<qint32>(payload) : EXIT_FAILURE;
+            default:
+                qCWarning(lc).noquote() << tr("Ignoring unknown frame type %1").arg((int)type);
+            }
+            offset += frameHeaderSize + size;
+        }
+        buffer.remove(0, offset);
+        offset = 0;
+
+        // Wait for more data; with no timeout, once the daemon has begun responding.
+        if ((socket.bytesAvailable() == 0) &&
+            (!socket.waitForReadyRead((responded) ? -1 : timeout))) {
+            qCWarning(lc).noquote() << ((socket.error() == QLocalSocket::SocketTimeoutError)
+                ? tr("Timed out waiting for daemon.")
+                : tr("Daemon connection closed: %1").arg(socket.errorString()));
+            return EXIT_FAILURE;
+        }
+        buffer.append(socket.readAll());
+        responded = true;
+    }
+}
+
+/*!
+ * \copybrief DeviceCommand::processOptions
+ *
+ * This implementation extends DeviceCommand::processOptions to process the `socket` option.
+ */
+QStringList DaemonCommand::processOptions(const QCommandLineParser &parser)
+{
+    QStringList errors = DeviceCommand::processOptions(parser);
+    if (!errors.isEmpty()) {
+        return errors;
+    }
+    if (parser.isSet(QLatin1String("socket"))) {
+        serverName = parser.value(QLatin1String("socket"));
+    }
+    return errors;
+}
+
+/*!
+ * Begins listening for client connections, and connecting to the Pokit device.
+ */
+bool DaemonCommand::start()
+{
+    if (!messageRelay) {
+        messageRelay = this;
+        previousMessageHandler = qInstallMessageHandler(&DaemonCommand::relayMessage);
+    }
+    return ((listen()) && (DeviceCommand::start()));
+}
+
+/*!
+ * \copybrief DeviceCommand::getService
+ *
+ * This override returns a pointer to a DeviceInfoService object, which the daemon uses only to
+ * know when the device is ready, since that service is present on all Pokit devices.
+ */
+AbstractPokitService * DaemonCommand::getService()
+{
+    Q_ASSERT(device);
+    if (!service) {
+        service = device->deviceInformation();
+        Q_ASSERT(service);
+    }
+    return service;
+}
+
+/*!
+ * \copybrief DeviceCommand::controllerError
+ *
+ * This override fails the current request (if any), and schedules a reconnection, instead of
+ * exiting.
+ */
+void DaemonCommand::controllerError(const QLowEnergyController::Error error)
+{
+    if ((connectingFromCache) || (rescanning)) {
+        DeviceCommand::controllerError(error); // Fall back to scanning.
+        return;
+    }
+    qCWarning(lc).noquote() << tr("Bluetooth controller error:") << error;
+    ready = false;
+    reconnectTimer.start();
+}
+
+/*!
+ * \copybrief DeviceCommand::deviceDisconnected
+ *
+ * This override schedules a reconnection, instead of exiting. The current request (if any) will
+ * fail, via its own disconnection handling.
+ */
+void DaemonCommand::deviceDisconnected()
+{
+    if ((connectingFromCache) || (rescanning)) {
+        DeviceCommand::deviceDisconnected(); // Fall back to scanning.
+        return;
+    }
+    qCWarning(lc).noquote() << tr("Pokit device disconnected; will reconnect.");
+    ready = false;
+    reconnectTimer.start();
+}
+
+/*!
+ * \copybrief DeviceCommand::serviceDetailsDiscovered
+ *
+ * This override marks the device as ready, and begins running any queued requests.
+ */
+void DaemonCommand::serviceDetailsDiscovered()
+{
+    DeviceCommand::serviceDetailsDiscovered(); // Just logs consistently.
+    qCInfo(lc).noquote() << tr("Pokit device ready; serving requests via \"%1\".")
+        .arg(server->fullServerName());
+    ready = true;
+    runNextRequest();
+}
+
+/*!
+ * Begins listening on #serverName, replacing any stale socket left behind by an earlier daemon,
+ * but not one that is still in use. Returns `true` on success, `false` otherwise.
+ */
+bool DaemonCommand::listen()
+{
+    if ((!server->listen(serverName)) &&
+        (server->serverError() == QAbstractSocket::AddressInUseError))
+    {
+        QLocalSocket socket;
+        socket.connectToServer(serverName);
+        if (socket.waitForConnected(1000)) {
+            qCWarning(lc).noquote() << tr("Another daemon is already listening on \"%1\".")
+                .arg(serverName);
+            return false;
+        }
+        qCDebug(lc).noquote() << tr("Removing stale socket \"%1\".").arg(serverName);
+        QLocalServer::removeServer(serverName);
+        server->listen(serverName);
+    }
+    if (!server->isListening()) {
+        qCWarning(lc).noquote() << tr("Failed to listen on \"%1\": %2")
+            .arg(serverName, server->errorString());
+        return false;
+    }
+    qCDebug(lc).noquote() << tr("Listening on \"%1\".").arg(server->fullServerName());
+    return true;
+}
+
+/*!
+ * Handles new client connections, by waiting for each client's request.
+ */
+void DaemonCommand::newConnection()
+{
+    while (QLocalSocket * const socket = server->nextPendingConnection()) {
+        qCDebug(lc).noquote() << tr("Client connected.");
+        connect(socket, &QLocalSocket::readyRead, this, [this, socket]() {
+            readRequest(socket);
+        });
+        connect(socket, &QLocalSocket::disconnected, this, [this, socket]() {
+            clientDisconnected(socket);
+        });
+        connect(socket, &QLocalSocket::disconnected, socket, &QObject::deleteLater);
+        readRequest(socket); // In case the request arrived with the connection.
+    }
+}
+
+/*!
+ * Reads the request (if complete) from \a socket, and queues it to be run.
+ */
+void DaemonCommand::readRequest(QLocalSocket * const socket)
+{
+    if (!socket->canReadLine()) {
+        return; // Wait for the rest of the request.
+    }
+    QObject::disconnect(socket, &QLocalSocket::readyRead, this, nullptr); // One request per client.
+    QString error;
+    const QStringList arguments = parseRequest(socket->readLine(), error);
+    if (!error.isEmpty()) {
+        respond(socket, error);
+        return;
+    }
+    qCDebug(lc).noquote() << tr("Queuing request: %1").arg(arguments.join(QLatin1Char(' ')));
+    requests.enqueue(Request{ socket, arguments });
+    runNextRequest();
+}
+
+/*!
+ * Handles the disconnection of \a socket's client. If that client's request is currently running,
+ * then the request is aborted (see DeviceCommand::abort()), so that the device is freed for the
+ * next request. Queued requests for \a socket will be skipped by runNextRequest().
+ */
+void DaemonCommand::clientDisconnected(QLocalSocket * const socket)
+{
+    if ((!current) || (socket != currentSocket)) {
+        return;
+    }
+    qCInfo(lc).noquote() << tr("Client disconnected; aborting request.");
+    currentSocket.clear();
+    current->abort(); // Finishes via requestFinished().
+}
+
+/*!
+ * Runs the next queued request, if any, and if the device is ready and not already in use.
+ */
+void DaemonCommand::runNextRequest()
+{
+    while ((ready) && (!current) && (!requests.isEmpty())) {
+        const Request request = requests.dequeue();
+        if (!request.socket) {
+            continue; // The client has gone away.
+        }
+
+        QCommandLineParser parser;
+        QString error;
+        DeviceCommand * const command = factory(request.arguments, parser, error, this);
+        if (!command) {
+            respond(request.socket, error);
+            continue;
+        }
+        const QStringList errors = command->processOptions(parser);
+        if (!errors.isEmpty()) {
+            respond(request.socket, errors.join(QLatin1Char('\n')));
+            delete command;
+            continue;
+        }
+
+        qCInfo(lc).noquote() << tr("Running request: %1")
+            .arg(request.arguments.join(QLatin1Char(' ')));
+        const QPointer<QLocalSocket> socket = request.socket;
+        command->setOutputHandler([socket](const QByteArray &output) {
+            if (socket) {
+                socket->write(encodeFrame(FrameType::Output, output));
+            }
+        });
+        command->setErrorHandler([socket](const QByteArray &error) {
+            if (socket) {
+                socket->write(encodeFrame(FrameType::Error, error));
+            }
+        });
+        command->setFinishedHandler([this](DeviceCommand * const command, const int exitCode) {
+            requestFinished(command, exitCode);
+        });
+        current = command;
+        currentSocket = socket;
+        command->attachToDevice(device);
+    }
+}
+
+/*!
+ * Handles the finishing of the current request's \a command, by sending \a exitCode to the client,
+ * then running the next request (if any).
+ */
+void DaemonCommand::requestFinished(DeviceCommand * const command, const int exitCode)
+{
+    if (command != current) {
+        return; // Already finished, such as an error, followed by a disconnection.
+    }
+    qCDebug(lc).noquote() << tr("Request finished with exit code %1.").arg(exitCode);
+    const QPointer<QLocalSocket> socket = currentSocket;
+    current = nullptr; // Before disconnecting, so clientDisconnected() does not abort the command.
+    currentSocket.clear();
+    if (socket) {
+        QByteArray code(sizeof(qint32), '\0');
+        qToLittleEndian<qint32>(exitCode, code.data());
+        socket->write(encodeFrame(FrameType::Exit, code));
+        socket->disconnectFromServer(); // Closes after writing any pending data.
+    }
+    command->deleteLater();
+    QTimer::singleShot(0, this, &DaemonCommand::runNextRequest);
+}
+
+/*!
+ * Replaces the (disconnected) Pokit device with a new one, and begins connecting to it.
+ */
+void DaemonCommand::reconnect()
+{
+    if (current) {
+        reconnectTimer.start(); // Let the current request fail first.
+        return;
+    }
+    qCInfo(lc).noquote() << tr("Reconnecting to Pokit device...");
+    device->deleteLater();
+    device = nullptr;
+    service = nullptr;
+    connectToDevice(deviceInfo);
+}
+
+/*!
+ * Responds to \a socket with \a error, and a failure exit code, then disconnects.
+ */
+void DaemonCommand::respond(QLocalSocket * const socket, const QString &error)
+{
+    qCWarning(lc).noquote() << error;
+    QByteArray code(sizeof(qint32), '\0');
+    qToLittleEndian<qint32>(EXIT_FAILURE, code.data());
+    socket->write(encodeFrame(FrameType::Error, error.toLocal8Bit() + '\n'));
+    socket->write(encodeFrame(FrameType::Exit, code));
+    socket->disconnectFromServer();
+}
+
+/*!
+ * Handles the log message of \a type, with \a context, by relaying the formatted \a message to the
+ * current request's client (if any), then passing it on to the previous message handler, so the
+ * daemon still logs it too.
+ */
+void DaemonCommand::relayMessage(QtMsgType type, const QMessageLogContext &context,
+                                 const QString &message)
+{
+    static bool relaying = false; // Guards against messages logged while relaying.
+    if ((messageRelay) && (messageRelay->currentSocket) && (!relaying)) {
+        relaying = true;
+        messageRelay->currentSocket->write(encodeFrame(FrameType::Error,
+            qFormatLogMessage(type, context, message).toLocal8Bit() + '\n'));
+        relaying = false;
+    }
+    if (previousMessageHandler) {
+        previousMessageHandler(type, context, message);
+    } else {
+        std::fputs(qPrintable(qFormatLogMessage(type, context, message) + QLatin1Char('\n')),
+                   stderr);
+    }
+}
@@ -0,0 +1,91 @@
+// SPDX-FileCopyrightText: 2022 Paul Colby <git@colby.id.au>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#ifndef QTPOKIT_DAEMONCOMMAND_H
+#define QTPOKIT_DAEMONCOMMAND_H
+
+#include "devicecommand.h"
+
+#include <QPointer>
+#include <QQueue>
+#include <QTimer>
+
+#include <functional>
+
+class DeviceInfoService;
+class QLocalServer;
+class QLocalSocket;
+
+class DaemonCommand : public DeviceCommand
+{
+public:
+    typedef std::function<DeviceCommand * (const QStringList &arguments,
+        QCommandLineParser &parser, QString &error, QObject * const parent)> Factory;
+
+    enum class FrameType : quint8 {
+        Output = 1, ///< Command output, to be written to stdout.
+        Error  = 2, ///< Error message, to be written to stderr.
+        Exit   = 3, ///< Command exit code, as a little-endian 32-bit integer; always last.
+    };
+
+    static const int frameHeaderSize = 5; ///< Size of the header preceding each frame's payload.
+    static const int forwardTimeout = 60000; ///< Milliseconds forward() waits for a first response.
+
+    DaemonCommand(const Factory &factory, QObject * const parent);
+    virtual ~DaemonCommand();
+
+    QStringList supportedOptions(const QCommandLineParser &parser) const override;
+
+    static QString defaultServerName();
+    static QByteArray encodeFrame(const FrameType type, const QByteArray &payload);
+    static QByteArray encodeRequest(const QStringList &arguments);
+    static QStringList parseRequest(const QByteArray &line, QString &error);
+    static int forward(const QString &serverName, const QStringList &arguments,
+                       const int timeout = forwardTimeout);
+
+public slots:
+    QStringList processOptions(const QCommandLineParser &parser) override;
+    bool start() override;
+
+protected:
+    AbstractPokitService * getService() override;
+
+protected slots:
+    void controllerError(const QLowEnergyController::Error error) override;
+    void deviceDisconnected() override;
+    void serviceDetailsDiscovered() override;
+
+private:
+    struct Request {
+        QPointer<QLocalSocket> socket; ///< Client connection to respond via.
+        QStringList arguments; ///< Command line arguments the client requested.
+    };
+
+    Factory factory; ///< Factory for creating the command for each request.
+    QLocalServer * server; ///< Server accepting client connections.
+    QString serverName; ///< Name (or path) of the local socket to listen on.
+    DeviceInfoService * service; ///< Service used to confirm that the device is ready.
+    bool ready; ///< Whether the device is connected, and its services discovered.
+    QQueue<Request> requests; ///< Requests waiting for the device.
+    DeviceCommand * current; ///< Command currently using the device, if any.
+    QPointer<QLocalSocket> currentSocket; ///< Client connection for #current.
+    QTimer reconnectTimer; ///< Timer for delaying reconnection attempts.
+
+    static DaemonCommand * messageRelay; ///< Daemon (if any) relaying log messages to its clients.
+    static QtMessageHandler previousMessageHandler; ///< Handler to chain relayed messages to.
+
+    bool listen();
+    void newConnection();
+    void readRequest(QLocalSocket * const socket);
+    void clientDisconnected(QLocalSocket * const socket);
+    void runNextRequest();
+    void requestFinished(DeviceCommand * const command, const int exitCode);
+    void reconnect();
+    static void respond(QLocalSocket * const socket, const QString &error);
+    static void relayMessage(QtMsgType type, const QMessageLogContext &context,
+                             const QString &message);
+
+    friend class TestDaemonCommand;
+};
+
+#endif // QTPOKIT_DAEMONCOMMAND_H
@@ -0,0 +1,145 @@
+// SPDX-FileCopyrightText: 2022 Paul Colby <git@colby.id.au>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "devicecache.h"
+
+#include <QBluetoothAddress>
+#include <QBluetoothUuid>
+#include <QDir>
+#include <QStandardPaths>
+
+/*!
+ * \class DeviceCache
+ *
+ * The DeviceCache class persists the details of Pokit devices that have previously been connected
+ * to, so that later invocations may connect to them directly, without first scanning.
+ *
+ * Entries are keyed by hardware address or, on platforms (such as macOS) that do not expose
+ * addresses, by UUID (see key()), and are ignored once older than maxAge().
+ */
+
+/*!
+ * Constructs a new device cache backed by the INI file \a fileName.
+ */
+DeviceCache::DeviceCache(const QString &fileName)
+    : settings(fileName, QSettings::IniFormat), maxAgeSecs(defaultMaxAge)
+{
+
+}
+
+/*!
+ * Returns the age, in seconds, after which cached entries are ignored.
+ */
+qint64 DeviceCache::maxAge() const
+{
+    return maxAgeSecs;
+}
+
+/*!
+ * Sets the age, in seconds, after which cached entries are ignored to \a seconds.
+ */
+void DeviceCache::setMaxAge(const qint64 seconds)
+{
+    maxAgeSecs = seconds;
+}
+
+/*!
+ * Returns the cached details for \a device, which may be a hardware address or MacOS UUID (but not
+ * a device name, since names need not be unique). Returns an invalid QBluetoothDeviceInfo if
+ * \a device is not cached, or if its entry was last updated more than maxAge() seconds before
+ * \a now.
+ */
+QBluetoothDeviceInfo DeviceCache::lookup(const QString &device, const QDateTime &now) const
+{
+    const QString key = DeviceCache::key(device);
+    if (key.isEmpty()) {
+        return QBluetoothDeviceInfo();
+    }
+
+    settings.beginGroup(key);
+    const QDateTime lastConnected = settings.value(QLatin1String("lastConnected")).toDateTime();
+    const QString name = settings.value(QLatin1String("name")).toString();
+    const QBluetoothAddress address(settings.value(QLatin1String("address")).toString());
+    const QBluetoothUuid uuid(settings.value(QLatin1String("uuid")).toString());
+    settings.endGroup();
+
+    if ((!lastConnected.isValid()) || (lastConnected.secsTo(now) > maxAgeSecs)) {
+        qCDebug(lc).noquote() << ((lastConnected.isValid())
+            ? tr("Ignoring expired cache entry for %1.").arg(key)
+            : tr("No cache entry for %1.").arg(key));
+        return QBluetoothDeviceInfo();
+    }
+
+    QBluetoothDeviceInfo info = (address.isNull())
+        ? QBluetoothDeviceInfo(uuid, name, 0) : QBluetoothDeviceInfo(address, name, 0);
+    if (!address.isNull()) {
+        info.setDeviceUuid(uuid);
+    }
+    info.setCoreConfigurations(QBluetoothDeviceInfo::LowEnergyCoreConfiguration);
+    return info;
+}
+
+/*!
+ * Caches the details of \a info, as last connected to at \a now.
+ */
+void DeviceCache::insert(const QBluetoothDeviceInfo &info, const QDateTime &now)
+{
+    const QString key = DeviceCache::key(info);
+    if (key.isEmpty()) {
+        qCDebug(lc).noquote() << tr("Not caching device \"%1\" with neither address nor UUID.")
+            .arg(info.name());
+        return;
+    }
+    settings.beginGroup(key);
+    settings.setValue(QLatin1String("name"), info.name());
+    settings.setValue(QLatin1String("address"), info.address().toString());
+    settings.setValue(QLatin1String("uuid"), info.deviceUuid().toString());
+    settings.setValue(QLatin1String("lastConnected"), now);
+    settings.endGroup();
+}
+
+/*!
+ * Removes \a device (if present) from the cache.
+ */
+void DeviceCache::remove(const QString &device)
+{
+    const QString key = DeviceCache::key(device);
+    if (!key.isEmpty()) {
+        settings.remove(key);
+    }
+}
+
+/*!
+ * Returns the default cache file name, in the platform's standard cache location.
+ */
+QString DeviceCache::defaultFileName()
+{
+    return QDir(QStandardPaths::writableLocation(QStandardPaths::CacheLocation))
+        .absoluteFilePath(QLatin1String("devices.ini"));
+}
+
+/*!
+ * Returns the cache key for \a device, which is \a device's normalised hardware address, or UUID.
+ * Returns a null string if \a device is neither (such as a device name).
+ */
+QString DeviceCache::key(const QString &device)
+{
+    const QBluetoothAddress address(device);
+    if (!address.isNull()) {
+        return address.toString();
+    }
+    const QBluetoothUuid uuid(device);
+    return (uuid.isNull()) ? QString() : uuid.toString();
+}
+
+/*!
+ * Returns the cache key for \a info, which is \a info's hardware address, or if that is null (such
+ * as on macOS), its UUID. Returns a null string if \a info has neither.
+ */
+QString DeviceCache::key(const QBluetoothDeviceInfo &info)
+{
+    if (!info.address().isNull()) {
+        return info.address().toString();
+    }
+    return (info.deviceUuid().isNull()) ? QString() : info.deviceUuid().toString();
+}
@@ -0,0 +1,45 @@
+// SPDX-FileCopyrightText: 2022 Paul Colby <git@colby.id.au>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#ifndef QTPOKIT_DEVICECACHE_H
+#define QTPOKIT_DEVICECACHE_H
+
+#include <QBluetoothDeviceInfo>
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QLoggingCategory>
+#include <QSettings>
+
+class DeviceCache
+{
+    Q_DECLARE_TR_FUNCTIONS(DeviceCache)
+
+public:
+    static const qint64 defaultMaxAge = 7 * 24 * 60 * 60; ///< Default maximum age, in seconds.
+
+    explicit DeviceCache(const QString &fileName = defaultFileName());
+
+    qint64 maxAge() const;
+    void setMaxAge(const qint64 seconds);
+
+    QBluetoothDeviceInfo lookup(const QString &device,
+                                const QDateTime &now = QDateTime::currentDateTimeUtc()) const;
+    void insert(const QBluetoothDeviceInfo &info,
+                const QDateTime &now = QDateTime::currentDateTimeUtc());
+    void remove(const QString &device);
+
+    static QString defaultFileName();
+    static QString key(const QString &device);
+    static QString key(const QBluetoothDeviceInfo &info);
+
+protected:
+    static Q_LOGGING_CATEGORY(lc, "pokit.ui.cache", QtInfoMsg); ///< Logging category for the cache.
+
+private:
+    mutable QSettings settings; ///< Persistent storage for cached device details.
+    qint64 maxAgeSecs; ///< Age (in seconds) after which cached entries are ignored.
+
+    friend class TestDeviceCache;
+};
+
+#endif // QTPOKIT_DEVICECACHE_H
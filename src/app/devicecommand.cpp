@@ -2,11 +2,18 @@
 // SPDX-License-Identifier: LGPL-3.0-or-later
 
 #include "devicecommand.h"
+#include "devicecache.h"
 
 #include <qtpokit/abstractpokitservice.h>
 #include <qtpokit/pokitdevice.h>
 #include <qtpokit/pokitdiscoveryagent.h>
 
+#include <QMap>
+#include <QTimer>
+
+#include <algorithm>
+#include <iterator>
+
 /*!
  * \class DeviceCommand
  *
@@ -17,74 +24,387 @@
  * Construct a new DeviceCommand object with \a parent.
  */
 DeviceCommand::DeviceCommand(QObject * const parent) : AbstractCommand(parent), device(nullptr),
-    exitCodeOnDisconnect(EXIT_FAILURE)
+    exitCodeOnDisconnect(EXIT_FAILURE), useCache(true),
+    connectingFromCache(false), rescanning(false),
+    printStatistics(false), statisticsService(nullptr), samplesPerNotificationLogged(false)
+{
+
+}
+
+/*!
+ * \copybrief AbstractCommand::supportedOptions
+ *
+ * This implementation extends AbstractCommand::supportedOptions to add the `no-cache` and `stats`
+ * options.
+ */
+QStringList DeviceCommand::supportedOptions(const QCommandLineParser &parser) const
+{
+    return AbstractCommand::supportedOptions(parser) + QStringList{
+        QLatin1String("no-cache"),
+        QLatin1String("stats"),
+    };
+}
+
+/*!
+ * Returns \a statistics as human-readable text, with one line per characteristic operation (read,
+ * write or notification), ordered by characteristic name. Latencies (and notification intervals)
+ * are given in microseconds.
+ *
+ * \see AbstractPokitService::setStatisticsEnabled
+ */
+QString DeviceCommand::formatStatistics(const AbstractPokitService::Statistics &statistics)
+{
+    QMap<QString, AbstractPokitService::CharacteristicStatistics> byName;
+    for (auto iter = statistics.cbegin(); iter != statistics.cend(); ++iter) {
+        const QString name = PokitDevice::charcteristicToString(iter.key());
+        byName.insert((name.isEmpty()) ? iter.key().toString() : name, iter.value());
+    }
+
+    QString text;
+    const auto appendLine = [&text](const QString &name, const QString &operation,
+        const quint64 count, const quint64 bytes, const QString &timing,
+        const AbstractPokitService::LatencyHistogram &histogram)
+    {
+        if (count == 0) {
+            return;
+        }
+        text.append(tr("%1 %2: %L3 (%L4 bytes)").arg(name, operation).arg(count).arg(bytes));
+        if (histogram.count > 0) {
+            text.append(tr("; %1 min %L2, mean %L3, p50 %L4, p90 %L5, p99 %L6, max %L7 us")
+                .arg(timing).arg(histogram.min).arg(histogram.mean())
+                .arg(histogram.percentile(50)).arg(histogram.percentile(90))
+                .arg(histogram.percentile(99)).arg(histogram.max));
+        }
+        text.append(QLatin1Char('\n'));
+    };
+    for (auto iter = byName.cbegin(); iter != byName.cend(); ++iter) {
+        const AbstractPokitService::CharacteristicStatistics &stats = iter.value();
+        appendLine(iter.key(), tr("reads"), stats.reads, stats.bytesRead,
+                   tr("latency"), stats.readLatency);
+        appendLine(iter.key(), tr("writes"), stats.writes, stats.bytesWritten,
+                   tr("latency"), stats.writeLatency);
+        appendLine(iter.key(), tr("notifications"), stats.notifications, stats.bytesNotified,
+                   tr("interval"), stats.notificationInterval);
+    }
+    return text;
+}
+
+/*!
+ * Sets \a handler to be called, with this command and its exit code, once this command has
+ * finished, instead of exiting the application. This allows commands to be run as part of a larger
+ * session, such as a MultiDeviceCommand or DaemonCommand.
+ *
+ * \see finish()
+ */
+void DeviceCommand::setFinishedHandler(const FinishedHandler &handler)
 {
+    finishedHandler = handler;
+}
 
+/*!
+ * \copybrief AbstractCommand::processOptions
+ *
+ * This implementation extends AbstractCommand::processOptions to pre-parse the `device` option(s)
+ * (see DeviceMatcher), and to process the `no-cache` and `stats` options.
+ */
+QStringList DeviceCommand::processOptions(const QCommandLineParser &parser)
+{
+    QStringList errors = AbstractCommand::processOptions(parser);
+    if (!errors.isEmpty()) {
+        return errors;
+    }
+    deviceMatcher = DeviceMatcher(parser.values(QLatin1String("device")));
+    if (!deviceMatcher.errorString().isEmpty()) {
+        errors.append(deviceMatcher.errorString());
+        return errors;
+    }
+    useCache = !parser.isSet(QLatin1String("no-cache"));
+    printStatistics = parser.isSet(QLatin1String("stats"));
+    return errors;
 }
 
 /*!
- * Begins scanning for the Pokit device.
+ * Begins connecting to the Pokit device.
+ *
+ * If a single device was specified by hardware address (or MacOS UUID), and it has been connected
+ * to recently (see DeviceCache), then connects to the device directly. Otherwise, or if that direct
+ * connection fails (see fallBackToDiscovery()), begins scanning for the Pokit device.
  */
 bool DeviceCommand::start()
 {
-    qCInfo(lc).noquote() << ((deviceToScanFor.isNull())
+    const QBluetoothDeviceInfo info = (useCache && (deviceMatcher.size() == 1) &&
+        (!deviceMatcher.hasPatterns()))
+        ? DeviceCache().lookup(deviceToScanFor) : QBluetoothDeviceInfo();
+    if (info.isValid()) {
+        qCInfo(lc).noquote() << tr("Connecting to cached device \"%1\"...").arg(deviceToScanFor);
+        connectingFromCache = true;
+        connectToDevice(info);
+        QTimer::singleShot(cachedConnectTimeout, this, [this]() {
+            if (connectingFromCache) {
+                qCDebug(lc).noquote() << tr("Timed out connecting to cached device.");
+                fallBackToDiscovery();
+            }
+        });
+        return true;
+    }
+
+    qCInfo(lc).noquote() << ((deviceMatcher.isEmpty())
         ? tr("Looking first available Pokit device...")
-        : tr("Looking for device \"%1\"...").arg(deviceToScanFor));
+        : tr("Looking for device \"%1\"...")
+            .arg(deviceMatcher.targets().join(QLatin1String("\" or \""))));
     discoveryAgent->start();
     return true;
 }
 
+/*!
+ * Creates a Pokit device for \a info, attaches this command to it (see attachToDevice()), and
+ * begins connecting to the device.
+ */
+void DeviceCommand::connectToDevice(const QBluetoothDeviceInfo &info)
+{
+    Q_ASSERT(!device);
+    deviceInfo = info;
+    attachToDevice(new PokitDevice(info, this));
+    connect(device->controller(), &QLowEnergyController::connected,
+            this, &DeviceCommand::deviceConnected);
+    qCDebug(lc).noquote() << tr("Connecting to Pokit device \"%1\" (%2) at (%3).")
+        .arg(info.name(), info.deviceUuid().toString(), info.address().toString());
+    device->controller()->connectToDevice();
+}
+
+/*!
+ * Attaches this command to \a pokitDevice. That is, connects the command's service (see
+ * getService()), and the device controller's common signals.
+ *
+ * \a pokitDevice may already be connected, such as one shared by a DaemonCommand, in which case
+ * it remains owned (and connected) by its creator, and disconnect() will simply finish(). If the
+ * service's details have been discovered already, then they are refreshed (see
+ * refreshServiceDetails()) instead.
+ */
+void DeviceCommand::attachToDevice(PokitDevice * const pokitDevice)
+{
+    Q_ASSERT(!device);
+    Q_ASSERT(pokitDevice);
+    device = pokitDevice;
+    connectControllerSignals();
+
+    AbstractPokitService * const service = getService();
+
+    Q_ASSERT(service);
+    if (printStatistics) {
+        service->resetStatistics(); // The service may be shared, such as by a DaemonCommand.
+        service->setStatisticsEnabled();
+        statisticsService = service;
+    }
+    connect(service, &AbstractPokitService::serviceDetailsDiscovered,
+            this, &DeviceCommand::serviceDetailsDiscovered);
+    connect(service, &AbstractPokitService::serviceErrorOccurred,
+            this, &DeviceCommand::serviceError);
+
+    if ((service->service()) && (service->service()->state() == QLowEnergyService::
+        #if (QT_VERSION < QT_VERSION_CHECK(6, 0, 0))
+        ServiceDiscovered
+        #else
+        RemoteServiceDiscovered
+        #endif
+    )) {
+        refreshServiceDetails(service);
+    }
+}
+
+/*!
+ * Connects the #device controller's disconnection and error signals to this command.
+ */
+void DeviceCommand::connectControllerSignals()
+{
+    Q_ASSERT(device);
+    connect(device->controller(), &QLowEnergyController::disconnected,
+            this, &DeviceCommand::deviceDisconnected);
+    connect(device->controller(),
+        #if (QT_VERSION < QT_VERSION_CHECK(6, 2, 0))
+        QOverload<QLowEnergyController::Error>::of(&QLowEnergyController::error),
+        #else
+        &QLowEnergyController::errorOccurred,
+        #endif
+        this, &DeviceCommand::controllerError, Qt::QueuedConnection);
+}
+
+/*!
+ * Aborts this command, such as when the client it is running on behalf of has gone away. That is,
+ * disconnects (see disconnect()) with `EXIT_FAILURE`, which for a shared device, disables this
+ * command's notifications and finishes immediately.
+ */
+void DeviceCommand::abort()
+{
+    qCDebug(lc).noquote() << tr("Aborting command.");
+    if (device) {
+        disconnect(EXIT_FAILURE);
+    } else {
+        finish(EXIT_FAILURE);
+    }
+}
+
 /*!
  * Disconnects the underlying Pokit device, and sets \a exitCode to be return to the OS once the
  * disconnection has taken place.
+ *
+ * If the device is shared (ie was given to attachToDevice() by another object), then it is left
+ * connected, with any notifications this command enabled disabled again (see
+ * disableNotifications()), and its default (relaxed) connection profile restored, and this command
+ * simply finishes with \a exitCode instead.
  */
 void DeviceCommand::disconnect(int exitCode)
 {
-    qCDebug(lc).noquote() << tr("Disconnecting Pokit device...");
     Q_ASSERT(device);
+    if (device->parent() != this) {
+        qCDebug(lc).noquote() << tr("Leaving shared Pokit device connected.");
+        disableNotifications();
+        device->setConnectionProfile(PokitDevice::ConnectionProfile::Balanced);
+        finish(exitCode);
+        return;
+    }
+    qCDebug(lc).noquote() << tr("Disconnecting Pokit device...");
     Q_ASSERT(device->controller());
     exitCodeOnDisconnect = exitCode;
     device->controller()->disconnectFromDevice();
 }
 
+/*!
+ * Finishes this command with \a exitCode. That is, exits the application (via
+ * QCoreApplication::exit) or, if a handler has been set (see setFinishedHandler()), such as by a
+ * multi-device session, calls that handler instead, so that the session may continue.
+ *
+ * If the `stats` option was set, the service's statistics are first written to stderr (see
+ * writeError()).
+ */
+void DeviceCommand::finish(const int exitCode)
+{
+    if (statisticsService) {
+        writeError(formatStatistics(statisticsService->statistics()).toLocal8Bit());
+        statisticsService->setStatisticsEnabled(false);
+        statisticsService = nullptr;
+    }
+    if (finishedHandler) {
+        finishedHandler(this, exitCode);
+    } else {
+        QCoreApplication::exit(exitCode);
+    }
+}
+
+/*!
+ * Returns the maximum number of DSO or Data Logger samples that a single notification can carry,
+ * given the device's negotiated MTU (see PokitDevice::mtu()), or the default MTU if not known.
+ */
+int DeviceCommand::maximumSamplesPerNotification() const
+{
+    return PokitDevice::maximumNotificationPayload((device) ? device->mtu() : -1)
+        / (int)sizeof(qint16);
+}
+
+/*!
+ * Prepares for a stream of DSO or Data Logger samples, by reserving enough #outputBuffer capacity
+ * for a full notification's worth of samples (see maximumSamplesPerNotification()) in the selected
+ * output format, so that formatting never needs to grow the buffer mid-stream.
+ */
+void DeviceCommand::prepareForSamples()
+{
+    const int maxSamples = maximumSamplesPerNotification();
+    int bytesPerSample = 64; // Generous for CSV, JSON Lines and Text.
+    switch (format) {
+    case OutputFormat::Binary: bytesPerSample = sizeof(qint16); break;
+    case OutputFormat::Json:   bytesPerSample = 128; break;
+    default: break;
+    }
+    outputBuffer.reserve(qMax(outputBuffer.capacity(), maxSamples * bytesPerSample));
+    samplesPerNotificationLogged = false;
+    qCDebug(lc).noquote() << tr("MTU %1 allows up to %Ln sample(s) per notification.", nullptr,
+        maxSamples).arg((device) ? device->mtu() : -1);
+}
+
+/*!
+ * Logs (once after each prepareForSamples()) the number of \a samples actually received in a
+ * notification, for comparison with maximumSamplesPerNotification().
+ */
+void DeviceCommand::logSamplesPerNotification(const int samples)
+{
+    if (!samplesPerNotificationLogged) {
+        qCDebug(lc).noquote() << tr("Receiving %Ln sample(s) per notification (of %1 possible).",
+            nullptr, samples).arg(maximumSamplesPerNotification());
+        samplesPerNotificationLogged = true;
+    }
+}
+
 /*!
  * \fn virtual AbstractPokitService * DeviceCommand::getService() = 0
  *
  * Returns a Pokit service object for the derived command class. This will be called by
- * deviceDiscovered() when the requested Pokit device has been found, after which
- * deviceDiscovered() will connect the returned service's common signals, and kick off the
+ * connectToDevice() when the requested Pokit device has been found, after which
+ * connectToDevice() will connect the returned service's common signals, and kick off the
  * device's connection process.
  */
 
 /*!
- * Handles controller error events. This base implementation simply logs \a error and then exits
- * with `EXIT_FAILURE`. Derived classes may override this slot to implement their own error
- * handing if desired.
+ * Returns \a pokitDevice's service object (if any) that this command would use, creating it if
+ * necessary, but without connecting any of its signals to this command, nor setting #device. This
+ * allows the services of commands queued for later (such as by a BatchCommand) to be discovered
+ * early, without those commands reacting to the signals of a service shared by the current
+ * command. This base implementation simply returns `nullptr`.
+ */
+AbstractPokitService * DeviceCommand::prepareService(PokitDevice * const pokitDevice) const
+{
+    Q_UNUSED(pokitDevice);
+    return nullptr;
+}
+
+/*!
+ * Disables any notifications this command has enabled, so that a shared Pokit device (see
+ * attachToDevice()) does not keep streaming to whichever command uses it next. This base
+ * implementation does nothing, since it enables no notifications itself.
+ */
+void DeviceCommand::disableNotifications()
+{
+
+}
+
+/*!
+ * Handles controller error events. This base implementation simply logs \a error and then
+ * finishes (see finish()) with `EXIT_FAILURE`. Derived classes may override this slot to implement
+ * their own error handing if desired.
  */
 void DeviceCommand::controllerError(QLowEnergyController::Error error)
 {
+    if ((connectingFromCache) || (rescanning)) {
+        qCDebug(lc).noquote() << tr("Bluetooth controller error for cached device:") << error;
+        fallBackToDiscovery();
+        return;
+    }
     qCWarning(lc).noquote() << tr("Bluetooth controller error:") << error;
-    QCoreApplication::exit(EXIT_FAILURE);
+    finish(EXIT_FAILURE);
 }
 
 /*!
- * Handles devics disconnection events. This base implementation simply logs and exits the
- * application (via QCoreApplication::exit) with the current exitCodeOnDisconnect value, which is
- * initialise to `EXIT_FAILURE` in the constructor, but should be set to `EXIT_SUCESS` if/when
- * the derived command class has completed its actions and requested the disconnection (as opposed
- * to a spontaneous disconnection on error).
+ * Handles devics disconnection events. This base implementation simply logs and finishes (see
+ * finish()) with the current exitCodeOnDisconnect value, which is initialise to `EXIT_FAILURE` in
+ * the constructor, but should be set to `EXIT_SUCESS` if/when the derived command class has
+ * completed its actions and requested the disconnection (as opposed to a spontaneous disconnection
+ * on error).
  */
 void DeviceCommand::deviceDisconnected()
 {
+    if ((connectingFromCache) || (rescanning)) {
+        fallBackToDiscovery();
+        return;
+    }
     qCDebug(lc).noquote() << tr("Pokit device disconnected. Exiting with code %1.")
         .arg(exitCodeOnDisconnect);
-    QCoreApplication::exit(exitCodeOnDisconnect);
+    finish(exitCodeOnDisconnect);
 }
 
 /*!
- * Handles service error events. This base implementation simply logs \a error and then exits
- * with `EXIT_FAILURE`. Derived classes may override this slot to implement their own error
- * handing if desired.
+ * Handles service error events. This base implementation simply logs \a error, abandons any
+ * service details refresh in progress (see refreshServiceDetails()), and then finishes (see
+ * finish()) with `EXIT_FAILURE`. Derived classes may override this slot to implement their own
+ * error handing if desired.
  *
  * \note As this base class does not construct services (derived classed do), its up to the derived
  * classed to connect this slot to the relevant service's error signal if desired.
@@ -92,7 +412,13 @@ void DeviceCommand::deviceDisconnected()
 void DeviceCommand::serviceError(const QLowEnergyService::ServiceError error)
 {
     qCWarning(lc).noquote() << tr("Bluetooth service error:") << error;
-    QCoreApplication::exit(EXIT_FAILURE);
+    if (!pendingRefreshReads.isEmpty()) {
+        qCWarning(lc).noquote() << tr("Failed to refresh %Ln characteristic(s).", nullptr,
+                                      pendingRefreshReads.size());
+        QObject::disconnect(refreshConnection);
+        pendingRefreshReads.clear();
+    }
+    finish(EXIT_FAILURE);
 }
 
 /*!
@@ -105,48 +431,121 @@ void DeviceCommand::serviceDetailsDiscovered()
     qCDebug(lc).noquote() << tr("Service details discovered.");
 }
 
+/*!
+ * Handles device connection events, by caching the device's details (see DeviceCache) so that
+ * future commands may connect to the device directly.
+ */
+void DeviceCommand::deviceConnected()
+{
+    connectingFromCache = false;
+    DeviceCache().insert(deviceInfo);
+}
+
+/*!
+ * Abandons a failed (or slow) direct connection to a cached device, and begins scanning for the
+ * device instead. Does nothing if no such connection is in progress.
+ *
+ * The controller's signals are disconnected from this command until the device is found again (see
+ * deviceDiscovered()), so that the abandoned connection's (possibly late) disconnection does not
+ * fail the command.
+ */
+void DeviceCommand::fallBackToDiscovery()
+{
+    if (!connectingFromCache) {
+        return; // Already fallen back, or never connected via the cache.
+    }
+    qCInfo(lc).noquote() << tr("Failed to connect to cached device; looking for device \"%1\"...")
+        .arg(deviceToScanFor);
+    connectingFromCache = false;
+    rescanning = true;
+    DeviceCache().remove(deviceToScanFor);
+    Q_ASSERT(device);
+    QObject::disconnect(device->controller(), nullptr, this, nullptr);
+    device->controller()->disconnectFromDevice();
+    discoveryAgent->start();
+}
+
+/*!
+ * Refreshes the details of the already-discovered \a service, then invokes
+ * serviceDetailsDiscovered(), as if the service had only just been discovered.
+ *
+ * Service details can only be discovered once per connection, so when a command attaches to a
+ * shared device that an earlier command has used, the service's cached values may be stale. So
+ * this function re-reads all readable characteristics, as discovery would have, unless \a service
+ * skips value discovery anyway (see AbstractPokitService::skipValueDiscovery). Only reads of those
+ * characteristics count towards completion, and a service error abandons the refresh (see
+ * serviceError()).
+ */
+void DeviceCommand::refreshServiceDetails(AbstractPokitService * const service)
+{
+    QLowEnergyService * const lowEnergyService = service->service();
+    Q_ASSERT(lowEnergyService);
+    QList<QLowEnergyCharacteristic> characteristics;
+    if (!service->skipValueDiscovery()) {
+        const QList<QLowEnergyCharacteristic> all = lowEnergyService->characteristics();
+        std::copy_if(all.cbegin(), all.cend(), std::back_inserter(characteristics),
+            [](const QLowEnergyCharacteristic &characteristic) {
+                return characteristic.properties().testFlag(QLowEnergyCharacteristic::Read);
+            });
+    }
+    if (characteristics.isEmpty()) {
+        QTimer::singleShot(0, this, &DeviceCommand::serviceDetailsDiscovered);
+        return;
+    }
+
+    qCDebug(lc).noquote() << tr("Refreshing %Ln characteristic(s).", nullptr,
+                                characteristics.size());
+    pendingRefreshReads.clear();
+    for (const QLowEnergyCharacteristic &characteristic: characteristics) {
+        pendingRefreshReads.insert(characteristic.uuid());
+    }
+    refreshConnection = connect(lowEnergyService, &QLowEnergyService::characteristicRead, this,
+        [this](const QLowEnergyCharacteristic &characteristic) {
+            if ((pendingRefreshReads.remove(characteristic.uuid())) &&
+                (pendingRefreshReads.isEmpty())) {
+                QObject::disconnect(refreshConnection);
+                serviceDetailsDiscovered();
+            }
+        });
+    for (const QLowEnergyCharacteristic &characteristic: characteristics) {
+        lowEnergyService->readCharacteristic(characteristic);
+    }
+}
+
 /*!
  * Checks if \a info is the device (if any) we're looking for, and if so, create a contoller and
  * service, and begins connecting to the device.
+ *
+ * If #device already exists because a direct connection to a cached device failed, then that
+ * device's controller is re-used (with its signals re-connected), since it refers to the same
+ * hardware address (or UUID).
  */
 void DeviceCommand::deviceDiscovered(const QBluetoothDeviceInfo &info)
 {
+    if ((rescanning) && (deviceMatcher.isMatch(info))) {
+        qCDebug(lc).noquote() << tr("Found cached Pokit device \"%1\" (%2) at (%3).")
+            .arg(info.name(), info.deviceUuid().toString(), info.address().toString());
+        discoveryAgent->stop();
+        rescanning = false;
+        deviceInfo = info;
+        connectControllerSignals();
+        connect(device->controller(), &QLowEnergyController::connected,
+                this, &DeviceCommand::deviceConnected);
+        device->controller()->connectToDevice();
+        return;
+    }
+
     if (device) {
         qCDebug(lc).noquote() << tr("Ignoring additional Pokit device \"%1\" (%2) at (%3).")
             .arg(info.name(), info.deviceUuid().toString(), info.address().toString());
         return;
     }
 
-    if ((deviceToScanFor.isEmpty()) || (deviceToScanFor == info.name()) ||
-        ((!info.address().isNull()) && (info.address() == QBluetoothAddress(deviceToScanFor))) ||
-        ((!info.deviceUuid().isNull()) && (info.deviceUuid() == QBluetoothUuid(deviceToScanFor))))
-    {
+    if (deviceMatcher.isMatch(info)) {
         qCDebug(lc).noquote() << tr("Found Pokit device \"%1\" (%2) at (%3).")
             .arg(info.name(), info.deviceUuid().toString(), info.address().toString());
         discoveryAgent->stop();
-
-        device = new PokitDevice(info, this);
-        connect(device->controller(), &QLowEnergyController::disconnected,
-                this, &DeviceCommand::deviceDisconnected);
-        connect(device->controller(),
-            #if (QT_VERSION < QT_VERSION_CHECK(6, 2, 0))
-            QOverload<QLowEnergyController::Error>::of(&QLowEnergyController::error),
-            #else
-            &QLowEnergyController::errorOccurred,
-            #endif
-            this, &DeviceCommand::controllerError, Qt::QueuedConnection);
-
-        AbstractPokitService * const service = getService();
-
-        Q_ASSERT(service);
-        connect(service, &AbstractPokitService::serviceDetailsDiscovered,
-                this, &DeviceCommand::serviceDetailsDiscovered);
-        connect(service, &AbstractPokitService::serviceErrorOccurred,
-                this, &DeviceCommand::serviceError);
-
-        qCDebug(lc).noquote() << tr("Connecting to Pokit device \"%1\" (%2) at (%3).")
-            .arg(info.name(), info.deviceUuid().toString(), info.address().toString());
-        device->controller()->connectToDevice();
+        connectToDevice(info);
         return;
     }
 
@@ -160,10 +559,11 @@ void DeviceCommand::deviceDiscovered(const QBluetoothDeviceInfo &info)
  */
 void DeviceCommand::deviceDiscoveryFinished()
 {
-    if (!device) {
-        qCWarning(lc).noquote() << ((deviceToScanFor.isNull())
+    if ((!device) || (rescanning)) {
+        qCWarning(lc).noquote() << ((deviceMatcher.isEmpty())
             ? tr("Failed to find any Pokit device.")
-            : tr("Failed to find device \"%1\".").arg(deviceToScanFor));
-        QCoreApplication::exit(EXIT_FAILURE);
+            : tr("Failed to find device \"%1\".")
+                .arg(deviceMatcher.targets().join(QLatin1String("\" or \""))));
+        finish(EXIT_FAILURE);
     }
 }
@@ -5,38 +5,80 @@
 #define QTPOKIT_DEVICECOMMAND_H
 
 #include "abstractcommand.h"
+#include "devicematcher.h"
+
+#include <qtpokit/abstractpokitservice.h>
 
 #include <QLowEnergyController>
+#include <QSet>
+
+#include <functional>
 
-class AbstractPokitService;
 class PokitDevice;
 
 class DeviceCommand : public AbstractCommand
 {
 public:
+    typedef std::function<void (DeviceCommand * const command, const int exitCode)> FinishedHandler;
+
     explicit DeviceCommand(QObject * const parent);
 
+    QStringList supportedOptions(const QCommandLineParser &parser) const override;
+
+    static QString formatStatistics(const AbstractPokitService::Statistics &statistics);
+
+    void setFinishedHandler(const FinishedHandler &handler);
+
 public slots:
+    QStringList processOptions(const QCommandLineParser &parser) override;
     bool start() override;
+    void connectToDevice(const QBluetoothDeviceInfo &info);
+    void attachToDevice(PokitDevice * const pokitDevice);
+    void abort();
 
 protected:
     PokitDevice * device; ///< Pokit Bluetooth device (if any) this command inerracts with.
     int exitCodeOnDisconnect; ///< Exit code to return on device disconnection.
+    FinishedHandler finishedHandler; ///< Handler (if any) to call on finishing, instead of exiting.
+    DeviceMatcher deviceMatcher; ///< Pre-parsed device(s) (if any) to scan for.
+    bool useCache; ///< Whether to connect directly to cached devices, without scanning first.
+    bool connectingFromCache; ///< Whether a direct connection to a cached device is in progress.
+    bool rescanning; ///< Whether scanning for a device whose cached connection failed.
+    QBluetoothDeviceInfo deviceInfo; ///< Details of the device connected to, for caching.
+    QSet<QBluetoothUuid> pendingRefreshReads; ///< Characteristics still to be refreshed.
+    QMetaObject::Connection refreshConnection; ///< Connection for counting refreshed reads.
+    bool printStatistics; ///< Whether to print the service's statistics on finishing.
+    AbstractPokitService * statisticsService; ///< Service (if any) to print statistics for.
+    bool samplesPerNotificationLogged; ///< Whether logSamplesPerNotification() has logged yet.
+
+    static const int cachedConnectTimeout = 5000; ///< Milliseconds to wait for cached connections.
 
     void disconnect(int exitCode=EXIT_SUCCESS);
+    void finish(const int exitCode);
+    int maximumSamplesPerNotification() const;
+    void prepareForSamples();
+    void logSamplesPerNotification(const int samples);
     virtual AbstractPokitService * getService() = 0;
+    virtual AbstractPokitService * prepareService(PokitDevice * const pokitDevice) const;
+    virtual void disableNotifications();
+    void connectControllerSignals();
 
 protected slots:
     virtual void controllerError(const QLowEnergyController::Error error);
     virtual void deviceDisconnected();
     virtual void serviceError(const QLowEnergyService::ServiceError error);
     virtual void serviceDetailsDiscovered();
+    void deviceConnected();
+    void fallBackToDiscovery();
+    void refreshServiceDetails(AbstractPokitService * const service);
 
 private slots:
     // These are protected in the base class, but hidden (private) for our descendents.
     void deviceDiscovered(const QBluetoothDeviceInfo &info) override;
     void deviceDiscoveryFinished() override;
 
+    friend class BatchCommand;
+    friend class MultiDeviceCommand;
     friend class TestDeviceCommand;
 };
 
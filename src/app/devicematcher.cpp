@@ -0,0 +1,172 @@
+// SPDX-FileCopyrightText: 2022 Paul Colby <git@colby.id.au>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "devicematcher.h"
+
+/*!
+ * \class DeviceMatcher
+ *
+ * The DeviceMatcher class matches discovered devices against a set of `--device` targets.
+ *
+ * Each target may be a device name, hardware address, MacOS UUID, or a name pattern: either a glob
+ * (containing `*`, `?` or `[...]`, such as `Pokit*`), or a regular expression between slashes (such
+ * as `/^Pokit (Meter|Pro)$/`). Targets are parsed once, on construction, so that matching each of
+ * the (many) advertisements seen while scanning is just a few integer comparisons, and at most one
+ * string comparison or regular expression match per target.
+ */
+
+/*!
+ * Constructs an empty device matcher, which matches any device.
+ */
+DeviceMatcher::DeviceMatcher() : patterns(false)
+{
+
+}
+
+/*!
+ * Constructs a device matcher for \a targets. Empty targets are ignored, so if all \a targets are
+ * empty, the matcher matches any device.
+ */
+DeviceMatcher::DeviceMatcher(const QStringList &targets) : patterns(false)
+{
+    for (const QString &target: targets) {
+        if (target.isEmpty()) {
+            continue;
+        }
+        Target parsed{ target, QBluetoothAddress(target), QBluetoothUuid(target),
+                       QRegularExpression() };
+        if ((target.size() > 2) && (target.startsWith(QLatin1Char('/'))) &&
+            (target.endsWith(QLatin1Char('/'))))
+        {
+            parsed.name.setPattern(target.mid(1, target.size() - 2));
+        } else if (target.contains(QRegularExpression(QStringLiteral("[*?[]")))) {
+            parsed.name.setPattern(globToRegularExpression(target));
+        }
+        if ((!parsed.name.pattern().isEmpty()) && (!parsed.name.isValid()) && (error.isEmpty())) {
+            error = tr("Invalid device pattern \"%1\": %2").arg(target, parsed.name.errorString());
+        }
+        parsed.name.optimize();
+        patterns |= (!parsed.name.pattern().isEmpty());
+        targetList.append(parsed);
+    }
+}
+
+/// Returns `true` if this matcher has no targets, and so matches any device, `false` otherwise.
+bool DeviceMatcher::isEmpty() const
+{
+    return targetList.isEmpty();
+}
+
+/// Returns the number of targets.
+int DeviceMatcher::size() const
+{
+    return targetList.size();
+}
+
+/// Returns the targets, as given on construction (less any empty ones).
+QStringList DeviceMatcher::targets() const
+{
+    QStringList targets;
+    for (const Target &target: targetList) {
+        targets.append(target.target);
+    }
+    return targets;
+}
+
+/*!
+ * Returns `true` if the target at \a index is a name pattern, and so may match any number of
+ * devices, `false` otherwise.
+ */
+bool DeviceMatcher::isPattern(const int index) const
+{
+    return !targetList.at(index).name.pattern().isEmpty();
+}
+
+/*!
+ * Returns `true` if any targets are name patterns, in which case there is no way to know when all
+ * matching devices have been found.
+ */
+bool DeviceMatcher::hasPatterns() const
+{
+    return patterns;
+}
+
+/// Returns a description of the first invalid target, if any, otherwise a null string.
+QString DeviceMatcher::errorString() const
+{
+    return error;
+}
+
+/*!
+ * Returns the index of the first target, at or after \a from, that matches \a info, or `-1` if
+ * none do. So all targets matching \a info may be iterated like:
+ *
+ * ```
+ * for (int index = matcher.indexOf(info); index >= 0; index = matcher.indexOf(info, index + 1)) {
+ *     // Handle match.
+ * }
+ * ```
+ */
+int DeviceMatcher::indexOf(const QBluetoothDeviceInfo &info, const int from) const
+{
+    for (int index = from; index < targetList.size(); ++index) {
+        if (isMatch(targetList.at(index), info)) {
+            return index;
+        }
+    }
+    return -1;
+}
+
+/*!
+ * Returns `true` if \a info matches any target (or there are no targets), `false` otherwise.
+ */
+bool DeviceMatcher::isMatch(const QBluetoothDeviceInfo &info) const
+{
+    return (targetList.isEmpty()) || (indexOf(info) >= 0);
+}
+
+/*!
+ * Returns the anchored regular expression equivalent of the \a glob pattern, in which `*` matches
+ * any string, `?` matches any one character, and `[...]` (or `[!...]`) matches any one character in
+ * (or not in) the set. All other characters match themselves.
+ */
+QString DeviceMatcher::globToRegularExpression(const QString &glob)
+{
+    QString regex = QStringLiteral("\\A(?:");
+    for (int index = 0; index < glob.size(); ++index) {
+        const QChar c = glob.at(index);
+        if (c == QLatin1Char('*')) {
+            regex.append(QLatin1String(".*"));
+        } else if (c == QLatin1Char('?')) {
+            regex.append(QLatin1Char('.'));
+        } else if ((c == QLatin1Char('[')) && (glob.indexOf(QLatin1Char(']'), index + 2) > index)) {
+            const int end = glob.indexOf(QLatin1Char(']'), index + 2);
+            QString set = glob.mid(index + 1, end - index - 1);
+            if (set.startsWith(QLatin1Char('!'))) {
+                set[0] = QLatin1Char('^');
+            }
+            regex.append(QLatin1Char('[')).append(set.replace(QLatin1Char('\\'),
+                QLatin1String("\\\\"))).append(QLatin1Char(']'));
+            index = end;
+        } else {
+            regex.append(QRegularExpression::escape(QString(c)));
+        }
+    }
+    return regex.append(QLatin1String(")\\z"));
+}
+
+/*!
+ * Returns `true` if \a info matches \a target, `false` otherwise. The cheapest comparisons (of
+ * pre-parsed addresses and UUIDs) are made first.
+ */
+bool DeviceMatcher::isMatch(const Target &target, const QBluetoothDeviceInfo &info) const
+{
+    if ((!target.address.isNull()) && (!info.address().isNull())) {
+        return target.address == info.address();
+    }
+    if ((!target.uuid.isNull()) && (!info.deviceUuid().isNull())) {
+        return target.uuid == info.deviceUuid();
+    }
+    return (target.name.pattern().isEmpty()) ? (target.target == info.name())
+        : target.name.match(info.name()).hasMatch();
+}
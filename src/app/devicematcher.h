@@ -0,0 +1,52 @@
+// SPDX-FileCopyrightText: 2022 Paul Colby <git@colby.id.au>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#ifndef QTPOKIT_DEVICEMATCHER_H
+#define QTPOKIT_DEVICEMATCHER_H
+
+#include <QBluetoothAddress>
+#include <QBluetoothDeviceInfo>
+#include <QBluetoothUuid>
+#include <QCoreApplication>
+#include <QRegularExpression>
+#include <QStringList>
+#include <QVector>
+
+class DeviceMatcher
+{
+    Q_DECLARE_TR_FUNCTIONS(DeviceMatcher)
+
+public:
+    DeviceMatcher();
+    explicit DeviceMatcher(const QStringList &targets);
+
+    bool isEmpty() const;
+    int size() const;
+    QStringList targets() const;
+    bool isPattern(const int index) const;
+    bool hasPatterns() const;
+    QString errorString() const;
+
+    int indexOf(const QBluetoothDeviceInfo &info, const int from = 0) const;
+    bool isMatch(const QBluetoothDeviceInfo &info) const;
+
+    static QString globToRegularExpression(const QString &glob);
+
+private:
+    struct Target {
+        QString target;            ///< Target as given, such as a name, address, UUID or pattern.
+        QBluetoothAddress address; ///< Target parsed as a hardware address, or null if not one.
+        QBluetoothUuid uuid;       ///< Target parsed as a (MacOS) UUID, or null if not one.
+        QRegularExpression name;   ///< Name pattern, if the target is a glob or regex pattern.
+    };
+
+    QVector<Target> targetList; ///< Pre-parsed targets.
+    bool patterns;              ///< Whether any targets are name patterns.
+    QString error;              ///< Description of the first invalid target, if any.
+
+    bool isMatch(const Target &target, const QBluetoothDeviceInfo &info) const;
+
+    friend class TestDeviceMatcher;
+};
+
+#endif // QTPOKIT_DEVICEMATCHER_H
@@ -4,7 +4,9 @@
 #include "dsocommand.h"
 
 #include <qtpokit/pokitdevice.h>
+#include <qtpokit/pokitranges.h>
 
+#include <QDateTime>
 #include <QJsonDocument>
 #include <QJsonObject>
 
@@ -20,7 +22,8 @@
 DsoCommand::DsoCommand(QObject * const parent) : DeviceCommand(parent),
     service(nullptr), settings{
         DsoService::Command::FreeRunning, 0, DsoService::Mode::DcVoltage,
-        { DsoService::VoltageRange::_30V_to_60V }, 1000*1000, 1000}
+        { DsoService::VoltageRange::_30V_to_60V }, 1000*1000, 1000},
+    samplesToGo(0), sampleNumber(0), started(0)
 {
 
 }
@@ -36,6 +39,7 @@ QStringList DsoCommand::requiredOptions(const QCommandLineParser &parser) const
 QStringList DsoCommand::supportedOptions(const QCommandLineParser &parser) const
 {
     return DeviceCommand::supportedOptions(parser) + QStringList{
+        QLatin1String("all-devices"),
         QLatin1String("interval"),
         QLatin1String("samples"),
         QLatin1String("trigger-level"),
@@ -167,12 +171,40 @@ AbstractPokitService * DsoCommand::getService()
     if (!service) {
         service = device->dso();
         Q_ASSERT(service);
+        service->setSkipValueDiscovery(); // We never read cached values.
         connect(service, &DsoService::settingsWritten,
                 this, &DsoCommand::settingsWritten);
     }
     return service;
 }
 
+/*!
+ * \copybrief DeviceCommand::prepareService
+ *
+ * This override returns a pointer to \a pokitDevice's DsoService object, with its
+ * value discovery skipped, since this command never reads cached values.
+ */
+AbstractPokitService * DsoCommand::prepareService(PokitDevice * const pokitDevice) const
+{
+    DsoService * const pokitService = pokitDevice->dso();
+    Q_ASSERT(pokitService);
+    pokitService->setSkipValueDiscovery(); // We never read cached values.
+    return pokitService;
+}
+
+/*!
+ * \copybrief DeviceCommand::disableNotifications
+ *
+ * This override disables the service's `Metadata` and `Reading` characteristics' notifications.
+ */
+void DsoCommand::disableNotifications()
+{
+    if (service) {
+        service->disableMetadataNotifications();
+        service->disableReadingNotifications();
+    }
+}
+
 /*!
  * \copybrief DeviceCommand::serviceDetailsDiscovered
  *
@@ -185,6 +217,8 @@ void DsoCommand::serviceDetailsDiscovered()
     qCInfo(lc).noquote() << tr("Sampling %1, with range %2, %L3 samples over %L4us").arg(
         DsoService::toString(settings.mode), (range.isNull()) ? QString::fromLatin1("N/A") : range)
         .arg(settings.numberOfSamples).arg(settings.samplingWindow);
+    // Negotiate short connection intervals while the DSO acquires, ready to stream the samples.
+    device->setConnectionProfile(PokitDevice::ConnectionProfile::Throughput);
     service->setSettings(settings);
 }
 
@@ -216,56 +250,51 @@ DsoService::Range DsoCommand::lowestRange(
     return range;
 }
 
-#define POKIT_APP_IF_LESS_THAN_RETURN(value, label) \
-if (value <=  DsoService::maxValue(DsoService::label).toUInt()) { \
-    return DsoService::label; \
-}
-
 /*!
- * Returns the lowest current range that can measure at least up to \a desired max, or AutoRange
- * if no such range is available.
+ * Returns the lowest current range that can measure at least up to \a desired max, or the highest
+ * range if no such range is available.
  */
 DsoService::CurrentRange DsoCommand::lowestCurrentRange(const quint32 desiredMax)
 {
-    POKIT_APP_IF_LESS_THAN_RETURN(desiredMax, CurrentRange::_0_to_10mA)
-    POKIT_APP_IF_LESS_THAN_RETURN(desiredMax, CurrentRange::_10mA_to_30mA)
-    POKIT_APP_IF_LESS_THAN_RETURN(desiredMax, CurrentRange::_30mA_to_150mA)
-    POKIT_APP_IF_LESS_THAN_RETURN(desiredMax, CurrentRange::_150mA_to_300mA)
-    POKIT_APP_IF_LESS_THAN_RETURN(desiredMax, CurrentRange::_300mA_to_3A)
-    return DsoService::CurrentRange::_300mA_to_3A; // Out of range, so go with the biggest.
+    const PokitRanges::Descriptor * const range = PokitRanges::lowest(
+        PokitRanges::Quantity::Current, desiredMax/1000.0);
+    return (range) ? static_cast<DsoService::CurrentRange>(range->value)
+        : DsoService::CurrentRange::_300mA_to_3A; // Out of range, so go with the biggest.
 }
 
 /*!
- * Returns the lowest voltage range that can measure at least up to \a desired max, or AutoRange
- * if no such range is available.
+ * Returns the lowest voltage range that can measure at least up to \a desired max, or the highest
+ * range if no such range is available.
  */
 DsoService::VoltageRange DsoCommand::lowestVoltageRange(const quint32 desiredMax)
 {
-    POKIT_APP_IF_LESS_THAN_RETURN(desiredMax, VoltageRange::_0_to_300mV)
-    POKIT_APP_IF_LESS_THAN_RETURN(desiredMax, VoltageRange::_300mV_to_2V)
-    POKIT_APP_IF_LESS_THAN_RETURN(desiredMax, VoltageRange::_2V_to_6V)
-    POKIT_APP_IF_LESS_THAN_RETURN(desiredMax, VoltageRange::_6V_to_12V)
-    POKIT_APP_IF_LESS_THAN_RETURN(desiredMax, VoltageRange::_12V_to_30V)
-    POKIT_APP_IF_LESS_THAN_RETURN(desiredMax, VoltageRange::_30V_to_60V)
-    return DsoService::VoltageRange::_30V_to_60V; // Out of range, so go with the biggest.
+    const PokitRanges::Descriptor * const range = PokitRanges::lowest(
+        PokitRanges::Quantity::Voltage, desiredMax/1000.0);
+    return (range) ? static_cast<DsoService::VoltageRange>(range->value)
+        : DsoService::VoltageRange::_30V_to_60V; // Out of range, so go with the biggest.
 }
 
-#undef POKIT_APP_IF_LESS_THAN_RETURN
-
 /*!
  * Invoked when the DSO settings have been written.
  */
 void DsoCommand::settingsWritten()
 {
     qCDebug(lc).noquote() << tr("Settings written; DSO has started.");
+    started = (quint32)QDateTime::currentSecsSinceEpoch();
     connect(service, &DsoService::metadataRead, this, &DsoCommand::metadataRead);
-    connect(service, &DsoService::samplesRead, this, &DsoCommand::outputSamples);
+    if (format == OutputFormat::Binary) {
+        connect(service, &DsoService::samplesRead, this, &DsoCommand::outputRawSamples);
+    } else {
+        connect(service, &DsoService::scaledSamplesRead, this, &DsoCommand::outputSamples);
+    }
     service->enableMetadataNotifications();
     service->enableReadingNotifications();
 }
 
 /*!
- * Invoked when \a metadata has been received from the DSO.
+ * Invoked when \a metadata has been received from the DSO. The DSO notifies its metadata whenever
+ * its status changes, but samples follow only once the acquisition is DsoService::DsoStatus::Done,
+ * so only then does this arm #samplesToGo, and (for binary output) write the acquisition's header.
  */
 void DsoCommand::metadataRead(const DsoService::Metadata &metadata)
 {
@@ -277,14 +306,27 @@ void DsoCommand::metadataRead(const DsoService::Metadata &metadata)
     qCDebug(lc) << "numberOfSamples:" << metadata.numberOfSamples;
     qCDebug(lc) << "samplingRate:" << metadata.samplingRate << "Hz";
     this->metadata = metadata;
+    if (metadata.status != DsoService::DsoStatus::Done) {
+        return; // No samples to expect yet.
+    }
     this->samplesToGo = metadata.numberOfSamples;
+    prepareForSamples();
+
+    // For binary output, each acquisition is a self-describing header, then the raw samples.
+    if (format == OutputFormat::Binary) {
+        appendBinaryHeader(outputBuffer, {
+            BinarySource::Dso, (quint8)metadata.mode, (quint8)metadata.range.voltageRange,
+            metadata.scale, metadata.samplingWindow, metadata.samplingRate, started,
+            metadata.numberOfSamples });
+    }
 }
 
 /*!
  * Outputs DSO \a samples in the selected ouput format.
  */
-void DsoCommand::outputSamples(const DsoService::Samples &samples)
+void DsoCommand::outputSamples(const DsoService::ScaledSamples &samples)
 {
+    logSamplesPerNotification(samples.size());
     QString unit;
     switch (metadata.mode) {
     case DsoService::Mode::DcVoltage: unit = QLatin1String("Vdc"); break;
@@ -296,32 +338,77 @@ void DsoCommand::outputSamples(const DsoService::Samples &samples)
             .arg(DsoService::toString(metadata.mode));
     }
     const QString range = DsoService::toString(metadata.range, metadata.mode);
+    const QByteArray unitBytes = unit.toLocal8Bit(), rangeBytes = range.toLocal8Bit();
 
-    for (const qint16 &sample: samples) {
-        static int sampleNumber = 0; ++sampleNumber;
-        const float value = sample * metadata.scale;
+    // For JSON Lines, the batch-invariant strings are written once, in a header record.
+    if (format == OutputFormat::JsonLines) {
+        outputBuffer.append("{\"mode\":");
+        appendJsonString(outputBuffer, DsoService::toString(metadata.mode));
+        outputBuffer.append(",\"range\":");
+        appendJsonString(outputBuffer, range);
+        outputBuffer.append(",\"unit\":");
+        appendJsonString(outputBuffer, unit);
+        outputBuffer.append(",\"samples\":");
+        appendInteger(outputBuffer, samples.size());
+        outputBuffer.append("}\n");
+    }
+
+    // Format the whole batch into the (reused) output buffer, then write it all at once.
+    for (const float &value: samples) {
+        ++sampleNumber;
         switch (format) {
         case OutputFormat::Csv:
-            for (static bool firstTime = true; firstTime; firstTime = false) {
-                fputs(qPrintable(tr("sample_number,value,unit,range\n")), stdout);
-            }
-            fputs(qPrintable(QString::fromLatin1("%1,%2,%3,%4\n").arg(sampleNumber).arg(value)
-                .arg(unit, range)), stdout);
+            appendCsvHeader(tr("sample_number,value,unit,range\n"));
+            appendInteger(outputBuffer, sampleNumber);
+            outputBuffer.append(',');
+            appendReal(outputBuffer, value);
+            outputBuffer.append(',').append(unitBytes).append(',').append(rangeBytes).append('\n');
             break;
         case OutputFormat::Json:
-            fputs(QJsonDocument(QJsonObject{
+            outputBuffer.append(QJsonDocument(QJsonObject{
                     { QLatin1String("value"),  value },
                     { QLatin1String("unit"),   unit },
                     { QLatin1String("range"),  range },
                     { QLatin1String("mode"),   DsoService::toString(metadata.mode) },
-                }).toJson(), stdout);
+                }).toJson());
             break;
+        case OutputFormat::JsonLines:
+            outputBuffer.append("{\"sample\":");
+            appendInteger(outputBuffer, sampleNumber);
+            outputBuffer.append(",\"value\":");
+            appendJsonNumber(outputBuffer, value);
+            outputBuffer.append("}\n");
+            break;
+        case OutputFormat::Binary: // Handled by outputRawSamples() instead.
         case OutputFormat::Text:
-            fputs(qPrintable(tr("%1 %2 %3\n").arg(sampleNumber).arg(value).arg(unit)), stdout);
+            appendInteger(outputBuffer, sampleNumber);
+            outputBuffer.append(' ');
+            appendReal(outputBuffer, value);
+            outputBuffer.append(' ').append(unitBytes).append('\n');
             break;
         }
         --samplesToGo;
     }
+    samplesOutput += samples.size();
+    flushOutput();
+    if (samplesToGo <= 0) {
+        qCInfo(lc).noquote() << tr("Finished fetching %L1 samples (with %L3 to remaining).")
+            .arg(metadata.numberOfSamples).arg(samplesToGo);
+        disconnect(); // Will exit the application once disconnected.
+    }
+}
+
+/*!
+ * Outputs raw DSO \a samples, following the binary header already written by metadataRead(), for
+ * the OutputFormat::Binary output format.
+ */
+void DsoCommand::outputRawSamples(const DsoService::Samples &samples)
+{
+    logSamplesPerNotification(samples.size());
+    appendRawSamples(outputBuffer, samples);
+    samplesOutput += samples.size();
+    flushOutput();
+    samplesToGo -= samples.size();
     if (samplesToGo <= 0) {
         qCInfo(lc).noquote() << tr("Finished fetching %L1 samples (with %L3 to remaining).")
             .arg(metadata.numberOfSamples).arg(samplesToGo);
@@ -18,6 +18,8 @@ public slots:
 
 protected:
     AbstractPokitService * getService() override;
+    AbstractPokitService * prepareService(PokitDevice * const pokitDevice) const override;
+    void disableNotifications() override;
 
 protected slots:
     void serviceDetailsDiscovered() override;
@@ -27,6 +29,8 @@ private:
     DsoService::Settings settings; ///< Settings for the Pokit device's DSO mode.
     DsoService::Metadata metadata; ///< Most recent DSO metadata.
     qint32 samplesToGo; ///< Number of samples we're expecting in the current window.
+    int sampleNumber; ///< Number of the most recently output sample.
+    quint32 started; ///< Seconds since the epoch at which the DSO was started, if at all.
 
     static DsoService::Range lowestRange(const DsoService::Mode mode,
                                                 const quint32 desiredMax);
@@ -36,7 +40,10 @@ private:
 private slots:
     void settingsWritten();
     void metadataRead(const DsoService::Metadata &metadata);
-    void outputSamples(const DsoService::Samples &samples);
+    void outputSamples(const DsoService::ScaledSamples &samples);
+    void outputRawSamples(const DsoService::Samples &samples);
 
+    friend class BenchDsoCommand;
+    template<class, class> friend class SampleCommandBench;
     friend class TestDsoCommand;
 };
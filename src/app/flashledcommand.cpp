@@ -58,12 +58,27 @@ AbstractPokitService * FlashLedCommand::getService()
     if (!service) {
         service = device->status();
         Q_ASSERT(service);
+        service->setSkipValueDiscovery(); // We never read cached values.
         connect(service, &StatusService::deviceLedFlashed,
                 this, &FlashLedCommand::deviceLedFlashed);
     }
     return service;
 }
 
+/*!
+ * \copybrief DeviceCommand::prepareService
+ *
+ * This override returns a pointer to \a pokitDevice's StatusService object, with its
+ * value discovery skipped, since this command never reads cached values.
+ */
+AbstractPokitService * FlashLedCommand::prepareService(PokitDevice * const pokitDevice) const
+{
+    StatusService * const pokitService = pokitDevice->status();
+    Q_ASSERT(pokitService);
+    pokitService->setSkipValueDiscovery(); // We never read cached values.
+    return pokitService;
+}
+
 /*!
  * \copybrief DeviceCommand::serviceDetailsDiscovered
  *
@@ -74,7 +89,7 @@ void FlashLedCommand::serviceDetailsDiscovered()
     DeviceCommand::serviceDetailsDiscovered(); // Just logs consistently.
     qCInfo(lc).noquote() << tr("Flashing Pokit device LED...");
     if (!service->flashLed()) {
-        QCoreApplication::exit(EXIT_FAILURE);
+        finish(EXIT_FAILURE);
     }
 }
 
@@ -85,14 +100,17 @@ void FlashLedCommand::deviceLedFlashed()
 {
     switch (format) {
     case OutputFormat::Csv:
-        fputs(qPrintable(tr("flash_led_result\nsuccess\n")), stdout);
+        outputBuffer.append(qPrintable(tr("flash_led_result\nsuccess\n")));
         break;
     case OutputFormat::Json:
-        fputs(qPrintable(QLatin1String("true\n")), stdout);
+    case OutputFormat::JsonLines:
+        outputBuffer.append(qPrintable(QLatin1String("true\n")));
         break;
+    case OutputFormat::Binary: // Only sample data has a binary form, so use text otherwise.
     case OutputFormat::Text:
-        fputs(qPrintable(tr("Done.\n")), stdout);
+        outputBuffer.append(qPrintable(tr("Done.\n")));
         break;
     }
+    flushOutput();
     disconnect(); // Will exit the application once disconnected.
 }
@@ -65,6 +65,16 @@ AbstractPokitService * InfoCommand::getService()
     return service;
 }
 
+/*!
+ * \copybrief DeviceCommand::prepareService
+ *
+ * This override returns a pointer to \a pokitDevice's DeviceInfoService object.
+ */
+AbstractPokitService * InfoCommand::prepareService(PokitDevice * const pokitDevice) const
+{
+    return pokitDevice->deviceInformation();
+}
+
 /*!
  * \copybrief DeviceCommand::serviceDetailsDiscovered
  *
@@ -78,17 +88,19 @@ void InfoCommand::serviceDetailsDiscovered()
     const QBluetoothUuid deviceUuid = device->controller()->remoteDeviceUuid();
     switch (format) {
     case OutputFormat::Csv:
-        fputs(qPrintable(tr("device_name,device_address,device_uuid,manufacturer_name,model_number,"
-                            "hardware_revision,firmware_revision,software_revision\n")), stdout);
-        fputs(qPrintable(QString::fromLatin1("%1,%2,%3,%4,%5,%6,%7,%8\n").arg(
+        outputBuffer.append(qPrintable(tr("device_name,device_address,device_uuid,"
+            "manufacturer_name,model_number,hardware_revision,firmware_revision,"
+            "software_revision\n")));
+        outputBuffer.append(qPrintable(QString::fromLatin1("%1,%2,%3,%4,%5,%6,%7,%8\n").arg(
             escapeCsvField(deviceName),
             (deviceAddress.isNull()) ? QString() : deviceAddress.toString(),
             (deviceUuid.isNull()) ? QString() : deviceUuid.toString(),
             escapeCsvField(service->manufacturer()), escapeCsvField(service->modelNumber()),
             escapeCsvField(service->hardwareRevision()), escapeCsvField(service->firmwareRevision()),
-            escapeCsvField(service->softwareRevision()))), stdout);
+            escapeCsvField(service->softwareRevision()))));
         break;
-    case OutputFormat::Json: {
+    case OutputFormat::Json:
+    case OutputFormat::JsonLines: {
         QJsonObject jsonObject{
             { QLatin1String("manufacturerName"), service->manufacturer() },
             { QLatin1String("modelNumber"),      service->modelNumber() },
@@ -105,24 +117,31 @@ void InfoCommand::serviceDetailsDiscovered()
         if (!deviceUuid.isNull()) {
             jsonObject.insert(QLatin1String("deviceUuid"), deviceUuid.toString());
         }
-        fputs(QJsonDocument(jsonObject).toJson(), stdout);
+        outputBuffer.append(formatJson(QJsonDocument(jsonObject)));
     }   break;
+    case OutputFormat::Binary: // Only sample data has a binary form, so use text otherwise.
     case OutputFormat::Text:
         if (!deviceName.isEmpty()) {
-            fputs(qPrintable(tr("Device name:       %1\n").arg(deviceName)), stdout);
+            outputBuffer.append(qPrintable(tr("Device name:       %1\n").arg(deviceName)));
         }
         if (!deviceAddress.isNull()) {
-            fputs(qPrintable(tr("Device addres:     %1\n").arg(deviceAddress.toString())), stdout);
+            outputBuffer.append(qPrintable(tr("Device addres:     %1\n")
+                .arg(deviceAddress.toString())));
         }
         if (!deviceUuid.isNull()) {
-            fputs(qPrintable(tr("Device UUID:       %1\n").arg(deviceUuid.toString())), stdout);
+            outputBuffer.append(qPrintable(tr("Device UUID:       %1\n")
+                .arg(deviceUuid.toString())));
         }
-        fputs(qPrintable(tr("Manufacturer name: %1\n").arg(service->manufacturer())), stdout);
-        fputs(qPrintable(tr("Model number:      %1\n").arg(service->modelNumber())), stdout);
-        fputs(qPrintable(tr("Hardware revision: %1\n").arg(service->hardwareRevision())), stdout);
-        fputs(qPrintable(tr("Firmware revision: %1\n").arg(service->firmwareRevision())), stdout);
-        fputs(qPrintable(tr("Software revision: %1\n").arg(service->softwareRevision())), stdout);
+        outputBuffer.append(qPrintable(tr("Manufacturer name: %1\n").arg(service->manufacturer())));
+        outputBuffer.append(qPrintable(tr("Model number:      %1\n").arg(service->modelNumber())));
+        outputBuffer.append(qPrintable(tr("Hardware revision: %1\n")
+            .arg(service->hardwareRevision())));
+        outputBuffer.append(qPrintable(tr("Firmware revision: %1\n")
+            .arg(service->firmwareRevision())));
+        outputBuffer.append(qPrintable(tr("Software revision: %1\n")
+            .arg(service->softwareRevision())));
         break;
     }
+    flushOutput();
     disconnect(); // Will exit the application once disconnected.
 }
@@ -19,11 +19,23 @@
  * Construct a new LoggerFetchCommand object with \a parent.
  */
 LoggerFetchCommand::LoggerFetchCommand(QObject * const parent)
-    : DeviceCommand(parent), service(nullptr)
+    : DeviceCommand(parent), service(nullptr), samplesToGo(0), timestamp(0)
 {
 
 }
 
+/*!
+ * \copybrief DeviceCommand::supportedOptions
+ *
+ * This implementation extends DeviceCommand::supportedOptions to add the `all-devices` option.
+ */
+QStringList LoggerFetchCommand::supportedOptions(const QCommandLineParser &parser) const
+{
+    return DeviceCommand::supportedOptions(parser) + QStringList{
+        QLatin1String("all-devices"),
+    };
+}
+
 /*!
  * \copybrief DeviceCommand::getService
  *
@@ -35,28 +47,66 @@ AbstractPokitService * LoggerFetchCommand::getService()
     if (!service) {
         service = device->dataLogger();
         Q_ASSERT(service);
+        service->setSkipValueDiscovery(); // We never read cached values.
         connect(service, &DataLoggerService::metadataRead, this, &LoggerFetchCommand::metadataRead);
-        connect(service, &DataLoggerService::samplesRead, this, &LoggerFetchCommand::outputSamples);
+        if (format == OutputFormat::Binary) {
+            connect(service, &DataLoggerService::samplesRead,
+                    this, &LoggerFetchCommand::outputRawSamples);
+        } else {
+            connect(service, &DataLoggerService::scaledSamplesRead,
+                    this, &LoggerFetchCommand::outputSamples);
+        }
     }
     return service;
 }
 
+/*!
+ * \copybrief DeviceCommand::prepareService
+ *
+ * This override returns a pointer to \a pokitDevice's DataLoggerService object, with its
+ * value discovery skipped, since this command never reads cached values.
+ */
+AbstractPokitService * LoggerFetchCommand::prepareService(PokitDevice * const pokitDevice) const
+{
+    DataLoggerService * const pokitService = pokitDevice->dataLogger();
+    Q_ASSERT(pokitService);
+    pokitService->setSkipValueDiscovery(); // We never read cached values.
+    return pokitService;
+}
+
+/*!
+ * \copybrief DeviceCommand::disableNotifications
+ *
+ * This override disables the service's `Metadata` and `Reading` characteristics' notifications.
+ */
+void LoggerFetchCommand::disableNotifications()
+{
+    if (service) {
+        service->disableMetadataNotifications();
+        service->disableReadingNotifications();
+    }
+}
+
 /*!
  * \copybrief DeviceCommand::serviceDetailsDiscovered
  *
- * This override fetches the current device's status, and outputs it in the selected format.
+ * This override requests the device's throughput-optimised connection profile, then fetches the
+ * logger's samples.
  */
 void LoggerFetchCommand::serviceDetailsDiscovered()
 {
     DeviceCommand::serviceDetailsDiscovered(); // Just logs consistently.
     qCInfo(lc).noquote() << tr("Fetching logger samples...");
+    device->setConnectionProfile(PokitDevice::ConnectionProfile::Throughput);
     service->enableMetadataNotifications();
     service->enableReadingNotifications();
     service->fetchSamples();
 }
 
 /*!
- * Invoked when \a metadata has been received from the data logger.
+ * Invoked when \a metadata has been received from the data logger. The first metadata received
+ * describes the samples being fetched, so any more received before those samples have all arrived
+ * (such as status changes, while the logger is still running) are logged, but otherwise ignored.
  */
 void LoggerFetchCommand::metadataRead(const DataLoggerService::Metadata &metadata)
 {
@@ -69,17 +119,30 @@ void LoggerFetchCommand::metadataRead(const DataLoggerService::Metadata &metadat
     qCDebug(lc) << "numberOfSamples:" << metadata.numberOfSamples;
     qCDebug(lc) << "timestamp:" << metadata.timestamp
                                 << QDateTime::fromSecsSinceEpoch(metadata.timestamp);
+    if (samplesToGo > 0) {
+        return; // Still fetching the samples described by earlier metadata.
+    }
     this->metadata = metadata;
     this->samplesToGo = metadata.numberOfSamples;
+    prepareForSamples();
     this->timestamp = (qint64)metadata.timestamp * (qint64)1000;
+
+    // For binary output, each fetch is a self-describing header, then the raw samples.
+    if (format == OutputFormat::Binary) {
+        appendBinaryHeader(outputBuffer, {
+            BinarySource::DataLogger, (quint8)metadata.mode, (quint8)metadata.range.voltageRange,
+            metadata.scale, metadata.updateInterval, 0, metadata.timestamp,
+            metadata.numberOfSamples });
+    }
     qCInfo(lc).noquote() << tr("Fetching %L1 logger samples...").arg(metadata.numberOfSamples);
 }
 
 /*!
  * Outputs logger \a samples in the selected ouput format.
  */
-void LoggerFetchCommand::outputSamples(const DataLoggerService::Samples &samples)
+void LoggerFetchCommand::outputSamples(const DataLoggerService::ScaledSamples &samples)
 {
+    logSamplesPerNotification(samples.size());
     QString unit;
     switch (metadata.mode) {
     case DataLoggerService::Mode::DcVoltage: unit = QLatin1String("Vdc"); break;
@@ -91,38 +154,108 @@ void LoggerFetchCommand::outputSamples(const DataLoggerService::Samples &samples
             .arg(DataLoggerService::toString(metadata.mode));
     }
     const QString range = DataLoggerService::toString(metadata.range, metadata.mode);
+    const QByteArray unitBytes = unit.toLocal8Bit(), rangeBytes = range.toLocal8Bit();
+
+    // For JSON Lines, the batch-invariant strings are written once, in a header record.
+    if (format == OutputFormat::JsonLines) {
+        outputBuffer.append("{\"mode\":");
+        appendJsonString(outputBuffer, DataLoggerService::toString(metadata.mode));
+        outputBuffer.append(",\"range\":");
+        appendJsonString(outputBuffer, range);
+        outputBuffer.append(",\"unit\":");
+        appendJsonString(outputBuffer, unit);
+        outputBuffer.append(",\"samples\":");
+        appendInteger(outputBuffer, samples.size());
+        outputBuffer.append("}\n");
+    }
 
-    for (const qint16 &sample: samples) {
-        const QString timeString = (metadata.timestamp == 0) ? QString::number(timestamp)
-            : QDateTime::fromMSecsSinceEpoch(timestamp).toString(Qt::ISODateWithMs);
-        const float value = sample * metadata.scale;
+    // Format the whole batch into the (reused) output buffer, then write it all at once.
+    for (const float &value: samples) {
         switch (format) {
         case OutputFormat::Csv:
-            for (static bool firstTime = true; firstTime; firstTime = false) {
-                fputs(qPrintable(tr("timestamp,value,unit,range\n")), stdout);
-            }
-            fputs(qPrintable(QString::fromLatin1("%1,%2,%3,%4\n").arg(timeString).arg(value)
-                .arg(unit, range)), stdout);
+            appendCsvHeader(tr("timestamp,value,unit,range\n"));
+            appendTimestamp();
+            outputBuffer.append(',');
+            appendReal(outputBuffer, value);
+            outputBuffer.append(',').append(unitBytes).append(',').append(rangeBytes).append('\n');
             break;
         case OutputFormat::Json:
-            fputs(QJsonDocument(QJsonObject{
-                    { QLatin1String("timestamp"), timeString },
+            outputBuffer.append(QJsonDocument(QJsonObject{
+                    { QLatin1String("timestamp"), timeString() },
                     { QLatin1String("value"),     value },
                     { QLatin1String("unit"),      unit },
                     { QLatin1String("range"),     range },
                     { QLatin1String("mode"),      DataLoggerService::toString(metadata.mode) },
-                }).toJson(), stdout);
+                }).toJson());
+            break;
+        case OutputFormat::JsonLines:
+            outputBuffer.append("{\"timestamp\":");
+            if (metadata.timestamp == 0) {
+                appendInteger(outputBuffer, timestamp);
+            } else {
+                appendJsonString(outputBuffer, timeString());
+            }
+            outputBuffer.append(",\"value\":");
+            appendJsonNumber(outputBuffer, value);
+            outputBuffer.append("}\n");
             break;
+        case OutputFormat::Binary: // Handled by outputRawSamples() instead.
         case OutputFormat::Text:
-            fputs(qPrintable(tr("%1 %2 %3\n").arg(timeString).arg(value).arg(unit)), stdout);
+            appendTimestamp();
+            outputBuffer.append(' ');
+            appendReal(outputBuffer, value);
+            outputBuffer.append(' ').append(unitBytes).append('\n');
             break;
         }
         timestamp += metadata.updateInterval;
         --samplesToGo;
     }
+    samplesOutput += samples.size();
+    flushOutput();
+    if (samplesToGo <= 0) {
+        qCInfo(lc).noquote() << tr("Finished fetching %L1 samples (with %L2 to remaining).")
+            .arg(metadata.numberOfSamples).arg(samplesToGo);
+        disconnect(); // Will exit the application once disconnected.
+    }
+}
+
+/*!
+ * Outputs raw logger \a samples, following the binary header already written by metadataRead(),
+ * for the OutputFormat::Binary output format.
+ */
+void LoggerFetchCommand::outputRawSamples(const DataLoggerService::Samples &samples)
+{
+    logSamplesPerNotification(samples.size());
+    appendRawSamples(outputBuffer, samples);
+    samplesOutput += samples.size();
+    flushOutput();
+    samplesToGo -= samples.size();
     if (samplesToGo <= 0) {
         qCInfo(lc).noquote() << tr("Finished fetching %L1 samples (with %L2 to remaining).")
             .arg(metadata.numberOfSamples).arg(samplesToGo);
         disconnect(); // Will exit the application once disconnected.
     }
 }
+
+/*!
+ * Returns the current sample's timestamp as a string; either the raw number of milliseconds (if the
+ * logger did not record a start time), or an ISO 8601 date-time string.
+ */
+QString LoggerFetchCommand::timeString() const
+{
+    return (metadata.timestamp == 0) ? QString::number(timestamp)
+        : QDateTime::fromMSecsSinceEpoch(timestamp).toString(Qt::ISODateWithMs);
+}
+
+/*!
+ * Appends the current sample's timestamp (see timeString()) to the output buffer, avoiding any
+ * temporary strings for raw (numeric) timestamps.
+ */
+void LoggerFetchCommand::appendTimestamp()
+{
+    if (metadata.timestamp == 0) {
+        appendInteger(outputBuffer, timestamp);
+    } else {
+        outputBuffer.append(timeString().toLocal8Bit());
+    }
+}
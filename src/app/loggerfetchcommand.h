@@ -10,21 +10,31 @@ class LoggerFetchCommand : public DeviceCommand
 public:
     explicit LoggerFetchCommand(QObject * const parent);
 
+    QStringList supportedOptions(const QCommandLineParser &parser) const override;
+
 protected:
     AbstractPokitService * getService() override;
+    AbstractPokitService * prepareService(PokitDevice * const pokitDevice) const override;
+    void disableNotifications() override;
 
 protected slots:
     void serviceDetailsDiscovered() override;
 
 private:
     DataLoggerService * service; ///< Bluetooth service this command interracts with.
-    DataLoggerService::Metadata metadata; ///< Most recent data logging metadata.
+    DataLoggerService::Metadata metadata; ///< Metadata of the samples being fetched.
     qint32 samplesToGo; ///< Number of samples we're still expecting to receive.
     quint64 timestamp; ///< Current sample's epoch milliseconds timestamp.
 
+    QString timeString() const;
+    void appendTimestamp();
+
 private slots:
     void metadataRead(const DataLoggerService::Metadata &metadata);
-    void outputSamples(const DataLoggerService::Samples &samples);
+    void outputSamples(const DataLoggerService::ScaledSamples &samples);
+    void outputRawSamples(const DataLoggerService::Samples &samples);
 
+    friend class BenchLoggerFetchCommand;
+    template<class, class> friend class SampleCommandBench;
     friend class TestLoggerFetchCommand;
 };
@@ -4,6 +4,7 @@
 #include "loggerstartcommand.h"
 
 #include <qtpokit/pokitdevice.h>
+#include <qtpokit/pokitranges.h>
 
 #include <QDateTime>
 #include <QJsonDocument>
@@ -142,6 +143,16 @@ AbstractPokitService * LoggerStartCommand::getService()
     return service;
 }
 
+/*!
+ * \copybrief DeviceCommand::prepareService
+ *
+ * This override returns a pointer to \a pokitDevice's DataLoggerService object.
+ */
+AbstractPokitService * LoggerStartCommand::prepareService(PokitDevice * const pokitDevice) const
+{
+    return pokitDevice->dataLogger();
+}
+
 /*!
  * \copybrief DeviceCommand::serviceDetailsDiscovered
  *
@@ -185,42 +196,30 @@ DataLoggerService::Range LoggerStartCommand::lowestRange(
     return range;
 }
 
-#define POKIT_APP_IF_LESS_THAN_RETURN(value, label) \
-if (value <=  DataLoggerService::maxValue(DataLoggerService::label).toUInt()) { \
-    return DataLoggerService::label; \
-}
-
 /*!
- * Returns the lowest current range that can measure at least up to \a desired max, or AutoRange
- * if no such range is available.
+ * Returns the lowest current range that can measure at least up to \a desired max, or the highest
+ * range if no such range is available.
  */
 DataLoggerService::CurrentRange LoggerStartCommand::lowestCurrentRange(const quint32 desiredMax)
 {
-    POKIT_APP_IF_LESS_THAN_RETURN(desiredMax, CurrentRange::_0_to_10mA)
-    POKIT_APP_IF_LESS_THAN_RETURN(desiredMax, CurrentRange::_10mA_to_30mA)
-    POKIT_APP_IF_LESS_THAN_RETURN(desiredMax, CurrentRange::_30mA_to_150mA)
-    POKIT_APP_IF_LESS_THAN_RETURN(desiredMax, CurrentRange::_150mA_to_300mA)
-    POKIT_APP_IF_LESS_THAN_RETURN(desiredMax, CurrentRange::_300mA_to_3A)
-    return DataLoggerService::CurrentRange::_300mA_to_3A; // Out of range, so go with the biggest.
+    const PokitRanges::Descriptor * const range = PokitRanges::lowest(
+        PokitRanges::Quantity::Current, desiredMax/1000.0);
+    return (range) ? static_cast<DataLoggerService::CurrentRange>(range->value)
+        : DataLoggerService::CurrentRange::_300mA_to_3A; // Out of range, so go with the biggest.
 }
 
 /*!
- * Returns the lowest voltage range that can measure at least up to \a desired max, or AutoRange
- * if no such range is available.
+ * Returns the lowest voltage range that can measure at least up to \a desired max, or the highest
+ * range if no such range is available.
  */
 DataLoggerService::VoltageRange LoggerStartCommand::lowestVoltageRange(const quint32 desiredMax)
 {
-    POKIT_APP_IF_LESS_THAN_RETURN(desiredMax, VoltageRange::_0_to_300mV)
-    POKIT_APP_IF_LESS_THAN_RETURN(desiredMax, VoltageRange::_300mV_to_2V)
-    POKIT_APP_IF_LESS_THAN_RETURN(desiredMax, VoltageRange::_2V_to_6V)
-    POKIT_APP_IF_LESS_THAN_RETURN(desiredMax, VoltageRange::_6V_to_12V)
-    POKIT_APP_IF_LESS_THAN_RETURN(desiredMax, VoltageRange::_12V_to_30V)
-    POKIT_APP_IF_LESS_THAN_RETURN(desiredMax, VoltageRange::_30V_to_60V)
-    return DataLoggerService::VoltageRange::_30V_to_60V; // Out of range, so go with the biggest.
+    const PokitRanges::Descriptor * const range = PokitRanges::lowest(
+        PokitRanges::Quantity::Voltage, desiredMax/1000.0);
+    return (range) ? static_cast<DataLoggerService::VoltageRange>(range->value)
+        : DataLoggerService::VoltageRange::_30V_to_60V; // Out of range, so go with the biggest.
 }
 
-#undef POKIT_APP_IF_LESS_THAN_RETURN
-
 /*!
  * Invoked when the data logger settings have been written.
  */
@@ -229,14 +228,17 @@ void LoggerStartCommand::settingsWritten()
     qCDebug(lc).noquote() << tr("Settings written; data logger has started.");
     switch (format) {
     case OutputFormat::Csv:
-        fputs(qPrintable(tr("logger_start_result\nsuccess\n")), stdout);
+        outputBuffer.append(qPrintable(tr("logger_start_result\nsuccess\n")));
         break;
     case OutputFormat::Json:
-        fputs(qPrintable(QLatin1String("true\n")), stdout);
+    case OutputFormat::JsonLines:
+        outputBuffer.append(qPrintable(QLatin1String("true\n")));
         break;
+    case OutputFormat::Binary: // Only sample data has a binary form, so use text otherwise.
     case OutputFormat::Text:
-        fputs(qPrintable(tr("Done.\n")), stdout);
+        outputBuffer.append(qPrintable(tr("Done.\n")));
         break;
     }
+    flushOutput();
     disconnect(); // Will exit the application once disconnected.
 }
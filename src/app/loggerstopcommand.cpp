@@ -40,6 +40,16 @@ AbstractPokitService * LoggerStopCommand::getService()
     return service;
 }
 
+/*!
+ * \copybrief DeviceCommand::prepareService
+ *
+ * This override returns a pointer to \a pokitDevice's DataLoggerService object.
+ */
+AbstractPokitService * LoggerStopCommand::prepareService(PokitDevice * const pokitDevice) const
+{
+    return pokitDevice->dataLogger();
+}
+
 /*!
  * \copybrief DeviceCommand::serviceDetailsDiscovered
  *
@@ -60,14 +70,17 @@ void LoggerStopCommand::settingsWritten()
     qCDebug(lc).noquote() << tr("Settings written; data logger has stopped.");
     switch (format) {
     case OutputFormat::Csv:
-        fputs(qPrintable(tr("logger_start_result\nsuccess\n")), stdout);
+        outputBuffer.append(qPrintable(tr("logger_start_result\nsuccess\n")));
         break;
     case OutputFormat::Json:
-        fputs(qPrintable(QLatin1String("true\n")), stdout);
+    case OutputFormat::JsonLines:
+        outputBuffer.append(qPrintable(QLatin1String("true\n")));
         break;
+    case OutputFormat::Binary: // Only sample data has a binary form, so use text otherwise.
     case OutputFormat::Text:
-        fputs(qPrintable(tr("Done.\n")), stdout);
+        outputBuffer.append(qPrintable(tr("Done.\n")));
         break;
     }
+    flushOutput();
     disconnect(); // Will exit the application once disconnected.
 }
@@ -12,6 +12,7 @@ public:
 
 protected:
     AbstractPokitService * getService() override;
+    AbstractPokitService * prepareService(PokitDevice * const pokitDevice) const override;
 
 protected slots:
     void serviceDetailsDiscovered() override;
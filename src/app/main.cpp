@@ -1,7 +1,9 @@
 // SPDX-FileCopyrightText: 2022 Paul Colby <git@colby.id.au>
 // SPDX-License-Identifier: LGPL-3.0-or-later
 
+#include "batchcommand.h"
 #include "calibratecommand.h"
+#include "daemoncommand.h"
 #include "dsocommand.h"
 #include "flashledcommand.h"
 #include "infocommand.h"
@@ -9,6 +11,7 @@
 #include "loggerstartcommand.h"
 #include "loggerstopcommand.h"
 #include "metercommand.h"
+#include "multidevicecommand.h"
 #include "scancommand.h"
 #include "setnamecommand.h"
 #include "statuscommand.h"
@@ -74,7 +77,9 @@ enum class Command {
     Scan,
     SetName,
     FlashLed,
-    Calibrate
+    Calibrate,
+    Daemon,
+    Batch
 };
 
 void showCliError(const QString &errorText) {
@@ -84,15 +89,8 @@ void showCliError(const QString &errorText) {
     fputs(qPrintable(message), stderr);
 }
 
-Command getCliCommand(const QStringList &posArguments) {
-    if (posArguments.isEmpty()) {
-        return Command::None;
-    }
-    if (posArguments.size() > 1) {
-        showCliError(QObject::tr("More than one command: %1").arg(posArguments.join(QStringLiteral(", "))));
-        ::exit(EXIT_FAILURE);
-    }
-
+Command toCommand(const QString &name)
+{
     const QMap<QString, Command> supportedCommands {
         { QStringLiteral("info"),         Command::Info },
         { QStringLiteral("status"),       Command::Status },
@@ -105,8 +103,22 @@ Command getCliCommand(const QStringList &posArguments) {
         { QStringLiteral("set-name"),     Command::SetName },
         { QStringLiteral("flash-led"),    Command::FlashLed },
         { QStringLiteral("calibrate"),    Command::Calibrate },
+        { QStringLiteral("daemon"),       Command::Daemon },
+        { QStringLiteral("batch"),        Command::Batch },
     };
-    const Command command = supportedCommands.value(posArguments.first().toLower(), Command::None);
+    return supportedCommands.value(name.toLower(), Command::None);
+}
+
+Command getCliCommand(const QStringList &posArguments) {
+    if (posArguments.isEmpty()) {
+        return Command::None;
+    }
+    if (posArguments.size() > 1) {
+        showCliError(QObject::tr("More than one command: %1").arg(posArguments.join(QStringLiteral(", "))));
+        ::exit(EXIT_FAILURE);
+    }
+
+    const Command command = toCommand(posArguments.first());
     if (command == Command::None) {
         showCliError(QObject::tr("Unknown command: %1").arg(posArguments.first()));
         ::exit(EXIT_FAILURE);
@@ -114,10 +126,20 @@ Command getCliCommand(const QStringList &posArguments) {
     return command;
 }
 
-Command parseCommandLine(const QStringList &appArguments, QCommandLineParser &parser)
+void addCliOptions(QCommandLineParser &parser)
 {
     // Setupt the command line options.
     parser.addOptions({
+        {{QStringLiteral("aggregate")},
+          QCoreApplication::translate("parseCommandLine", "For the meter command, output one "
+          "summary (min, max, mean, RMS and standard deviation) per window of this duration, "
+          "instead of every reading. Readings are still taken at the update interval. Suffixes "
+          "such as 's' and 'ms' may be used, as for the interval option."),
+          QCoreApplication::translate("parseCommandLine", "window")},
+        {{QStringLiteral("all-devices")},
+          QCoreApplication::translate("parseCommandLine", "Use all discovered Pokit devices (or all "
+          "of those given via --device, which may then be repeated) concurrently, with each output "
+          "line tagged by device. Supported by the dso, logger-fetch and meter commands only.")},
         { QStringLiteral("color"),
           QCoreApplication::translate("parseCommandLine", "Colors the console output. Valid options "
           "are: yes, no and auto. The default is auto."),
@@ -126,12 +148,18 @@ Command parseCommandLine(const QStringList &appArguments, QCommandLineParser &pa
           QCoreApplication::translate("parseCommandLine", "Enable debug output.")},
         {{QStringLiteral("d"), QStringLiteral("device")},
           QCoreApplication::translate("parseCommandLine",
-          "Set the name, hardware address or MacOS UUID of Pokit device to use. If not specified, "
-          "the first discovered Pokit device will be used."),
+          "Set the name, hardware address or MacOS UUID of Pokit device to use. Names may also be "
+          "given as glob patterns, such as 'Pokit*', or as regular expressions between slashes. "
+          "May be repeated to use the first device matching any. If not specified, the first "
+          "discovered Pokit device will be used."),
           QCoreApplication::translate("parseCommandLine", "device")},
     });
     parser.addHelpOption();
     parser.addOptions({
+        {{QStringLiteral("incremental")},
+          QCoreApplication::translate("parseCommandLine","For the scan command, output each "
+          "discovered device once, then only what changes, with its signal strength smoothed, "
+          "instead of outputting every device update in full.")},
         {{QStringLiteral("interval")},
           QCoreApplication::translate("parseCommandLine", "Set the update interval for DOS, meter and "
           "logger modes. Suffixes such as 's' and 'ms' (for seconds and milliseconds) may be used. "
@@ -149,9 +177,14 @@ Command parseCommandLine(const QStringList &appArguments, QCommandLineParser &pa
         {{QStringLiteral("new-name")},
           QCoreApplication::translate("parseCommandLine","Give the desired new name for the set-"
           "name command."), QCoreApplication::translate("parseCommandLine", "name")},
+        {{QStringLiteral("no-cache")},
+          QCoreApplication::translate("parseCommandLine","Always scan for the Pokit device, instead "
+          "of connecting directly to recently-used devices given by hardware address or MacOS "
+          "UUID.")},
         {{QStringLiteral("output")},
           QCoreApplication::translate("parseCommandLine","Set the format for output. Supported "
-          "formats are: CSV, JSON and Text. All are case insenstitve. The default is Text."),
+          "formats are: Binary, CSV, JSON, JSONL (aka NDJSON) and Text. All are case insenstitve. "
+          "Binary applies to dso and logger fetch samples only. The default is Text."),
           QCoreApplication::translate("parseCommandLine", "format"),
           QCoreApplication::translate("parseCommandLine", "text")},
         {{QStringLiteral("range")},
@@ -163,6 +196,19 @@ Command parseCommandLine(const QStringList &appArguments, QCommandLineParser &pa
         {{QStringLiteral("samples")},
           QCoreApplication::translate("parseCommandLine","Set the number of samples to acquire."),
           QCoreApplication::translate("parseCommandLine", "count")},
+        {{QStringLiteral("script")},
+          QCoreApplication::translate("parseCommandLine","Set the script of commands for the batch "
+          "command to run, one per line. The default is '-', meaning stdin."),
+          QCoreApplication::translate("parseCommandLine", "file")},
+        {{QStringLiteral("socket")},
+          QCoreApplication::translate("parseCommandLine","Set the local socket name (or path) for "
+          "the daemon command to listen on. For other commands, forward the command to the daemon "
+          "listening on this socket, instead of connecting to the Pokit device directly. The "
+          "daemon's default is 'pokit'."),
+          QCoreApplication::translate("parseCommandLine", "name")},
+        {{QStringLiteral("stats")},
+          QCoreApplication::translate("parseCommandLine","Print Bluetooth LE statistics (counts, "
+          "bytes and latency percentiles for each characteristic) when the command finishes.")},
         {{QStringLiteral("temperature")},
           QCoreApplication::translate("parseCommandLine","Set the current ambient temperature for "
           "the calibration command."), QCoreApplication::translate("parseCommandLine", "degrees")},
@@ -220,6 +266,17 @@ Command parseCommandLine(const QStringList &appArguments, QCommandLineParser &pa
     parser.addPositionalArgument(QStringLiteral("calibrate"),
         QCoreApplication::translate("parseCommandLine", "Calibrate Pokit device temperature"),
         QStringLiteral(" "));
+    parser.addPositionalArgument(QStringLiteral("batch"),
+        QCoreApplication::translate("parseCommandLine", "Run a script of commands over one Pokit "
+        "device connection"), QStringLiteral(" "));
+    parser.addPositionalArgument(QStringLiteral("daemon"),
+        QCoreApplication::translate("parseCommandLine", "Keep a Pokit device connected, serving "
+        "other commands via a local socket"), QStringLiteral(" "));
+}
+
+Command parseCommandLine(const QStringList &appArguments, QCommandLineParser &parser)
+{
+    addCliOptions(parser);
 
     // Do the initial parse, the see if we have a command specified yet.
     parser.parse(appArguments);
@@ -247,6 +304,9 @@ Command parseCommandLine(const QStringList &appArguments, QCommandLineParser &pa
     return command;
 }
 
+DeviceCommand * getSessionCommandObject(const QStringList &arguments, QCommandLineParser &parser,
+                                       QString &error, QObject * const parent);
+
 AbstractCommand * getCommandObject(const Command command, QObject * const parent)
 {
     switch (command) {
@@ -254,7 +314,9 @@ AbstractCommand * getCommandObject(const Command command, QObject * const parent
         showCliError(QCoreApplication::translate("main",
             "Missing argument: <command>\nSee --help for usage information."));
         return nullptr;
+    case Command::Batch:       return new BatchCommand(getSessionCommandObject, parent);
     case Command::Calibrate:   return new CalibrateCommand(parent);
+    case Command::Daemon:      return new DaemonCommand(getSessionCommandObject, parent);
     case Command::DSO:         return new DsoCommand(parent);
     case Command::FlashLed:    return new FlashLedCommand(parent);
     case Command::Info:        return new InfoCommand(parent);
@@ -270,6 +332,56 @@ AbstractCommand * getCommandObject(const Command command, QObject * const parent
     return nullptr;
 }
 
+DeviceCommand * getSessionCommandObject(const QStringList &arguments, QCommandLineParser &parser,
+                                       QString &error, QObject * const parent)
+{
+    addCliOptions(parser);
+    if (!parser.parse(QStringList{ QCoreApplication::applicationName() } + arguments)) {
+        error = parser.errorText();
+        return nullptr;
+    }
+    const QStringList posArguments = parser.positionalArguments();
+    const Command command = (posArguments.size() == 1) ? toCommand(posArguments.first())
+        : Command::None;
+    switch (command) {
+    case Command::Calibrate:
+    case Command::DSO:
+    case Command::FlashLed:
+    case Command::Info:
+    case Command::LoggerFetch:
+    case Command::LoggerStart:
+    case Command::LoggerStop:
+    case Command::Meter:
+    case Command::SetName:
+    case Command::Status:
+        return static_cast<DeviceCommand *>(getCommandObject(command, parent));
+    case Command::Batch:
+    case Command::Daemon:
+    case Command::None:
+    case Command::Scan:
+        break;
+    }
+    error = QCoreApplication::translate("main", "Unsupported batch or daemon command: %1")
+        .arg(posArguments.join(QStringLiteral(", ")));
+    return nullptr;
+}
+
+QStringList getForwardedArguments(const QStringList &appArguments)
+{
+    QStringList arguments;
+    for (auto iter = appArguments.cbegin() + 1; iter != appArguments.cend(); ++iter) {
+        if (*iter == QStringLiteral("--socket")) {
+            ++iter; // Skip the option's value too.
+            if (iter == appArguments.cend()) {
+                break;
+            }
+        } else if (!iter->startsWith(QStringLiteral("--socket="))) {
+            arguments.append(*iter);
+        }
+    }
+    return arguments;
+}
+
 int main(int argc, char *argv[])
 {
     // Setup the core application.
@@ -286,8 +398,22 @@ int main(int argc, char *argv[])
     QCommandLineParser parser;
     const Command commandType = parseCommandLine(appArguments, parser);
 
-    // Handle the given command.
-    AbstractCommand * const command = getCommandObject(commandType, &app);
+    // Forward the command to a running daemon, if requested.
+    if ((parser.isSet(QStringLiteral("socket"))) && (commandType != Command::Daemon) &&
+        (commandType != Command::None))
+    {
+        return DaemonCommand::forward(parser.value(QStringLiteral("socket")),
+                                      getForwardedArguments(appArguments));
+    }
+
+    // Handle the given command, wrapped in a multi-device session if requested (and supported).
+    AbstractCommand * const command = ((parser.isSet(QStringLiteral("all-devices"))) &&
+        ((commandType == Command::DSO) || (commandType == Command::LoggerFetch) ||
+         (commandType == Command::Meter)))
+        ? new MultiDeviceCommand([commandType](QObject * const parent) {
+              return static_cast<DeviceCommand *>(getCommandObject(commandType, parent));
+          }, &app)
+        : getCommandObject(commandType, &app);
     if (command == nullptr) {
         return EXIT_FAILURE; // getCommandObject will have logged the reason already.
     }
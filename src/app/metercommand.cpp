@@ -4,10 +4,13 @@
 #include "metercommand.h"
 
 #include <qtpokit/pokitdevice.h>
+#include <qtpokit/pokitranges.h>
 
 #include <QJsonDocument>
 #include <QJsonObject>
 
+#include <cmath>
+
 /*!
  * \class MeterCommand
  *
@@ -22,7 +25,8 @@ MeterCommand::MeterCommand(QObject * const parent) : DeviceCommand(parent),
         MultimeterService::Mode::DcVoltage,
         { MultimeterService::VoltageRange::AutoRange },
         1000
-    }, samplesToGo(-1)
+    }, samplesToGo(-1), aggregateWindow(0), readingsPerWindow(1),
+    aggregateMode(MultimeterService::Mode::Idle), aggregate(), outputMetadata()
 {
 
 }
@@ -37,6 +41,8 @@ QStringList MeterCommand::requiredOptions(const QCommandLineParser &parser) cons
 QStringList MeterCommand::supportedOptions(const QCommandLineParser &parser) const
 {
     return DeviceCommand::supportedOptions(parser) + QStringList{
+        QLatin1String("aggregate"),
+        QLatin1String("all-devices"),
         QLatin1String("interval"),
         QLatin1String("range"),
         QLatin1String("samples"),
@@ -90,6 +96,21 @@ QStringList MeterCommand::processOptions(const QCommandLineParser &parser)
         }
     }
 
+    // Parse the aggregate option (after the interval option, which it depends on).
+    if (parser.isSet(QLatin1String("aggregate"))) {
+        const QString value = parser.value(QLatin1String("aggregate"));
+        const quint32 window = parseMilliValue(value, QLatin1String("s"), 500);
+        if (window == 0) {
+            errors.append(tr("Invalid aggregate window: %1").arg(value));
+        } else {
+            aggregateWindow = window;
+            readingsPerWindow = (int)qMax((window + settings.updateInterval/2)
+                                          / settings.updateInterval, (quint32)1);
+            qCDebug(lc).noquote() << tr("Aggregating %Ln reading(s) per window.", nullptr,
+                                        readingsPerWindow);
+        }
+    }
+
     // Parse the range option.
     if (parser.isSet(QLatin1String("range"))) {
         const QString value = parser.value(QLatin1String("range"));
@@ -159,12 +180,39 @@ AbstractPokitService * MeterCommand::getService()
     if (!service) {
         service = device->multimeter();
         Q_ASSERT(service);
+        service->setSkipValueDiscovery(); // We never read cached values.
         connect(service, &MultimeterService::settingsWritten,
                 this, &MeterCommand::settingsWritten);
     }
     return service;
 }
 
+/*!
+ * \copybrief DeviceCommand::prepareService
+ *
+ * This override returns a pointer to \a pokitDevice's MultimeterService object, with its
+ * value discovery skipped, since this command never reads cached values.
+ */
+AbstractPokitService * MeterCommand::prepareService(PokitDevice * const pokitDevice) const
+{
+    MultimeterService * const pokitService = pokitDevice->multimeter();
+    Q_ASSERT(pokitService);
+    pokitService->setSkipValueDiscovery(); // We never read cached values.
+    return pokitService;
+}
+
+/*!
+ * \copybrief DeviceCommand::disableNotifications
+ *
+ * This override disables the service's `Reading` characteristic's notifications.
+ */
+void MeterCommand::disableNotifications()
+{
+    if (service) {
+        service->disableReadingNotifications();
+    }
+}
+
 /*!
  * \copybrief DeviceCommand::serviceDetailsDiscovered
  *
@@ -207,23 +255,16 @@ MultimeterService::Range MeterCommand::lowestRange(
     return range;
 }
 
-#define POKIT_APP_IF_LESS_THAN_RETURN(value, label) \
-if (value <=  MultimeterService::maxValue(MultimeterService::label).toUInt()) { \
-    return MultimeterService::label; \
-}
-
 /*!
  * Returns the lowest current range that can measure at least up to \a desired max, or AutoRange
  * if no such range is available.
  */
 MultimeterService::CurrentRange MeterCommand::lowestCurrentRange(const quint32 desiredMax)
 {
-    POKIT_APP_IF_LESS_THAN_RETURN(desiredMax, CurrentRange::_0_to_10mA)
-    POKIT_APP_IF_LESS_THAN_RETURN(desiredMax, CurrentRange::_10mA_to_30mA)
-    POKIT_APP_IF_LESS_THAN_RETURN(desiredMax, CurrentRange::_30mA_to_150mA)
-    POKIT_APP_IF_LESS_THAN_RETURN(desiredMax, CurrentRange::_150mA_to_300mA)
-    POKIT_APP_IF_LESS_THAN_RETURN(desiredMax, CurrentRange::_300mA_to_3A)
-    return MultimeterService::CurrentRange::AutoRange;
+    const PokitRanges::Descriptor * const range = PokitRanges::lowest(
+        PokitRanges::Quantity::Current, desiredMax/1000.0);
+    return (range) ? static_cast<MultimeterService::CurrentRange>(range->value)
+        : MultimeterService::CurrentRange::AutoRange;
 }
 
 /*!
@@ -232,15 +273,10 @@ MultimeterService::CurrentRange MeterCommand::lowestCurrentRange(const quint32 d
  */
 MultimeterService::ResistanceRange MeterCommand::lowestResistanceRange(const quint32 desiredMax)
 {
-    POKIT_APP_IF_LESS_THAN_RETURN(desiredMax, ResistanceRange::_0_to_160)
-    POKIT_APP_IF_LESS_THAN_RETURN(desiredMax, ResistanceRange::_160_to_330)
-    POKIT_APP_IF_LESS_THAN_RETURN(desiredMax, ResistanceRange::_330_to_890)
-    POKIT_APP_IF_LESS_THAN_RETURN(desiredMax, ResistanceRange::_890_to_1K5)
-    POKIT_APP_IF_LESS_THAN_RETURN(desiredMax, ResistanceRange::_1K5_to_10K)
-    POKIT_APP_IF_LESS_THAN_RETURN(desiredMax, ResistanceRange::_10K_to_100K)
-    POKIT_APP_IF_LESS_THAN_RETURN(desiredMax, ResistanceRange::_100K_to_470K)
-    POKIT_APP_IF_LESS_THAN_RETURN(desiredMax, ResistanceRange::_470K_to_1M)
-    return MultimeterService::ResistanceRange::AutoRange;
+    const PokitRanges::Descriptor * const range = PokitRanges::lowest(
+        PokitRanges::Quantity::Resistance, (double)desiredMax);
+    return (range) ? static_cast<MultimeterService::ResistanceRange>(range->value)
+        : MultimeterService::ResistanceRange::AutoRange;
 }
 
 /*!
@@ -249,16 +285,67 @@ MultimeterService::ResistanceRange MeterCommand::lowestResistanceRange(const qui
  */
 MultimeterService::VoltageRange MeterCommand::lowestVoltageRange(const quint32 desiredMax)
 {
-    POKIT_APP_IF_LESS_THAN_RETURN(desiredMax, VoltageRange::_0_to_300mV)
-    POKIT_APP_IF_LESS_THAN_RETURN(desiredMax, VoltageRange::_300mV_to_2V)
-    POKIT_APP_IF_LESS_THAN_RETURN(desiredMax, VoltageRange::_2V_to_6V)
-    POKIT_APP_IF_LESS_THAN_RETURN(desiredMax, VoltageRange::_6V_to_12V)
-    POKIT_APP_IF_LESS_THAN_RETURN(desiredMax, VoltageRange::_12V_to_30V)
-    POKIT_APP_IF_LESS_THAN_RETURN(desiredMax, VoltageRange::_30V_to_60V)
-    return MultimeterService::VoltageRange::AutoRange;
+    const PokitRanges::Descriptor * const range = PokitRanges::lowest(
+        PokitRanges::Quantity::Voltage, desiredMax/1000.0);
+    return (range) ? static_cast<MultimeterService::VoltageRange>(range->value)
+        : MultimeterService::VoltageRange::AutoRange;
+}
+
+/*!
+ * Returns the units that \a mode's readings are measured in, or a null string if unitless.
+ */
+QString MeterCommand::unitsString(const MultimeterService::Mode mode)
+{
+    switch (mode) {
+    case MultimeterService::Mode::Idle:        break;
+    case MultimeterService::Mode::DcVoltage:   return QLatin1String("Vdc");
+    case MultimeterService::Mode::AcVoltage:   return QLatin1String("Vac");
+    case MultimeterService::Mode::DcCurrent:   return QLatin1String("Adc");
+    case MultimeterService::Mode::AcCurrent:   return QLatin1String("Aac");
+    case MultimeterService::Mode::Resistance:  return QString::fromUtf8("Ω");
+    case MultimeterService::Mode::Diode:       break;
+    case MultimeterService::Mode::Continuity:  break;
+    case MultimeterService::Mode::Temperature: return QString::fromUtf8("°C");
+    }
+    return QString();
+}
+
+/*!
+ * Adds \a reading to \a aggregate's running statistics, in constant time and space.
+ *
+ * Error readings, and non-finite (ie overloaded) values, are counted, but otherwise excluded.
+ */
+void MeterCommand::accumulate(Aggregate &aggregate, const MultimeterService::Reading &reading)
+{
+    ++aggregate.readings;
+    if ((reading.status == MultimeterService::MeterStatus::Error) || (!qIsFinite(reading.value))) {
+        ++aggregate.errors;
+        return;
+    }
+    const double value = reading.value;
+    if (aggregate.count++ == 0) {
+        aggregate.minimum = aggregate.maximum = value;
+    } else {
+        aggregate.minimum = qMin(aggregate.minimum, value);
+        aggregate.maximum = qMax(aggregate.maximum, value);
+    }
+    const double delta = value - aggregate.mean;
+    aggregate.mean += delta / aggregate.count;
+    aggregate.m2 += delta * (value - aggregate.mean);
+    aggregate.sumOfSquares += value * value;
+}
+
+/// Returns the root mean square of \a aggregate's values, or NaN if there are none.
+double MeterCommand::rms(const Aggregate &aggregate)
+{
+    return (aggregate.count == 0) ? qQNaN() : std::sqrt(aggregate.sumOfSquares / aggregate.count);
 }
 
-#undef POKIT_APP_IF_LESS_THAN_RETURN
+/// Returns the (population) standard deviation of \a aggregate's values, or NaN if there are none.
+double MeterCommand::standardDeviation(const Aggregate &aggregate)
+{
+    return (aggregate.count == 0) ? qQNaN() : std::sqrt(aggregate.m2 / aggregate.count);
+}
 
 /*!
  * Invoked when the multimeter settings have been written, to begin reading the meter values.
@@ -266,16 +353,39 @@ MultimeterService::VoltageRange MeterCommand::lowestVoltageRange(const quint32 d
 void MeterCommand::settingsWritten()
 {
     qCDebug(lc).noquote() << tr("Settings written; starting meter readings...");
-    connect(service, &MultimeterService::readingRead,
-            this, &MeterCommand::outputReading);
+    if (aggregateWindow > 0) {
+        connect(service, &MultimeterService::readingRead,
+                this, &MeterCommand::aggregateReading);
+    } else {
+        connect(service, &MultimeterService::readingRead,
+                this, &MeterCommand::outputReading);
+    }
     service->enableReadingNotifications();
 }
 
 /*!
- * Outputs meter \a reading in the selected ouput format.
+ * Returns the output metadata (status, units and range strings, pre-formatted for the selected
+ * output format) for \a reading, resolving it only if \a reading's mode, range or status differs
+ * from the previous reading's.
+ *
+ * Since these only change when the device changes modes or auto-ranges, this keeps the string
+ * lookups, QVariant conversions and translations out of the per-reading output path.
  */
-void MeterCommand::outputReading(const MultimeterService::Reading &reading)
+const MeterCommand::OutputMetadata &MeterCommand::resolveOutputMetadata(
+    const MultimeterService::Reading &reading)
 {
+    if ((outputMetadata.valid) && (outputMetadata.format == format) &&
+        (outputMetadata.mode == reading.mode) &&
+        (outputMetadata.range == (quint8)reading.range.voltageRange) &&
+        (outputMetadata.status == reading.status))
+    {
+        return outputMetadata;
+    }
+    qCDebug(lc).noquote() << tr("Resolving output metadata for mode 0x%1, range 0x%2, status 0x%3.")
+        .arg((quint8)reading.mode,2,16,QLatin1Char('0'))
+        .arg((quint8)reading.range.voltageRange,2,16,QLatin1Char('0'))
+        .arg((quint8)reading.status,2,16,QLatin1Char('0'));
+
     QString status;
     if (reading.status == MultimeterService::MeterStatus::Error) {
         status = QLatin1String("Error");
@@ -300,18 +410,7 @@ void MeterCommand::outputReading(const MultimeterService::Reading &reading)
         break;
     }
 
-    QString units;
-    switch (reading.mode) {
-    case MultimeterService::Mode::Idle:        break;
-    case MultimeterService::Mode::DcVoltage:   units = QLatin1String("Vdc"); break;
-    case MultimeterService::Mode::AcVoltage:   units = QLatin1String("Vac"); break;
-    case MultimeterService::Mode::DcCurrent:   units = QLatin1String("Adc"); break;
-    case MultimeterService::Mode::AcCurrent:   units = QLatin1String("Aac"); break;
-    case MultimeterService::Mode::Resistance:  units = QString::fromUtf8("Ω"); break;
-    case MultimeterService::Mode::Diode:       break;
-    case MultimeterService::Mode::Continuity:  break;
-    case MultimeterService::Mode::Temperature: units = QString::fromUtf8("°C"); break;
-    }
+    const QString units = unitsString(reading.mode);
 
     QString range;
     QVariant rangeMin, rangeMax;
@@ -339,55 +438,208 @@ void MeterCommand::outputReading(const MultimeterService::Reading &reading)
     case MultimeterService::Mode::Temperature: break;
     }
 
+    QJsonObject jsonObject{
+        { QLatin1String("status"), status },
+        { QLatin1String("mode"),   MultimeterService::toString(reading.mode) },
+    };
+    if ((!rangeMin.isNull()) || (!rangeMax.isNull())) {
+        jsonObject.insert(QLatin1String("range"), QJsonObject{
+            { QLatin1String("min"),
+                #if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+                (rangeMin.typeId() == QMetaType::Int)
+                #else
+                (rangeMin.type() == QVariant::Int)
+                #endif
+                ? QJsonValue(rangeMin.toInt()/1000.0) : rangeMin.toJsonValue() },
+            { QLatin1String("max"),
+                #if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+                (rangeMax.typeId() == QMetaType::Int) ?
+                #else
+                (rangeMax.type() == QVariant::Int) ?
+                #endif
+                QJsonValue(rangeMax.toInt()/1000.0) : rangeMax.toJsonValue() },
+        });
+    }
+
+    OutputMetadata metadata{ true, format, reading.mode, (quint8)reading.range.voltageRange,
+                             reading.status, QByteArray(), QByteArray(), QJsonObject() };
     switch (format) {
     case OutputFormat::Csv:
-        for (static bool firstTime = true; firstTime; firstTime = false) {
-            fputs(qPrintable(tr("mode,value,units,status,range_min_milli,range_max_milli\n")), stdout);
-        }
-        fputs(qPrintable(QString::fromLatin1("%1,%2,%3,%4,%5,%6\n")
-            .arg(escapeCsvField(MultimeterService::toString(reading.mode)))
-            .arg(reading.value, 0, 'f').arg(units, status, rangeMin.toString(), rangeMax.toString())
-            ), stdout);
+        metadata.prefix = escapeCsvField(MultimeterService::toString(reading.mode)).toLocal8Bit();
+        metadata.prefix.append(',');
+        metadata.suffix.append(',').append(units.toLocal8Bit()).append(',')
+            .append(status.toLocal8Bit()).append(',').append(rangeMin.toString().toLocal8Bit())
+            .append(',').append(rangeMax.toString().toLocal8Bit()).append('\n');
+        break;
+    case OutputFormat::Json:
+        metadata.json = jsonObject;
+        break;
+    case OutputFormat::JsonLines:
+        // QJsonDocument sorts keys, so "value" is always last; ie the value goes before the '}'.
+        metadata.prefix = QJsonDocument(jsonObject).toJson(QJsonDocument::Compact);
+        metadata.prefix.chop(1);
+        metadata.prefix.append(",\"value\":");
+        metadata.suffix = "}\n";
+        break;
+    case OutputFormat::Binary: // Only sample data has a binary form, so use text otherwise.
+    case OutputFormat::Text: {
+        const QString value = tr("Value:  %1 %2\n").arg(QStringLiteral("%1"), units);
+        const int index = value.indexOf(QLatin1String("%1"));
+        metadata.prefix = tr("Mode:   %1 (0x%2)\n").arg(MultimeterService::toString(reading.mode))
+            .arg((quint8)reading.mode,2,16,QLatin1Char('0')).toLocal8Bit();
+        metadata.prefix.append(value.left(index).toLocal8Bit());
+        metadata.suffix = value.mid(index + 2).toLocal8Bit();
+        metadata.suffix.append(tr("Status: %1 (0x%2)\n").arg(status)
+            .arg((quint8)reading.status,2,16,QLatin1Char('0')).toLocal8Bit());
+        metadata.suffix.append(tr("Range:  %1 (0x%2)\n").arg(range)
+            .arg((quint8)reading.range.voltageRange,2,16,QLatin1Char('0')).toLocal8Bit());
+    }   break;
+    }
+    outputMetadata = metadata;
+    return outputMetadata;
+}
+
+/*!
+ * Outputs meter \a reading in the selected ouput format.
+ *
+ * All of the reading's output, other than its value, is resolved by resolveOutputMetadata().
+ */
+void MeterCommand::outputReading(const MultimeterService::Reading &reading)
+{
+    const OutputMetadata &metadata = resolveOutputMetadata(reading);
+
+    // Format the whole reading into the (reused) output buffer, then write it all at once.
+    switch (format) {
+    case OutputFormat::Csv:
+        appendCsvHeader(tr("mode,value,units,status,range_min_milli,range_max_milli\n"));
+        outputBuffer.append(metadata.prefix);
+        appendReal(outputBuffer, reading.value, 'f');
+        outputBuffer.append(metadata.suffix);
         break;
     case OutputFormat::Json: {
-        QJsonObject jsonObject{
-            { QLatin1String("status"), status },
-            { QLatin1String("value"), qIsInf(reading.value) ?
-                QJsonValue(tr("Infinity")) : QJsonValue(reading.value) },
-            { QLatin1String("mode"),   MultimeterService::toString(reading.mode) },
-        };
-        if ((!rangeMin.isNull()) || (!rangeMax.isNull())) {
-            jsonObject.insert(QLatin1String("range"), QJsonObject{
-                { QLatin1String("min"),
-                    #if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
-                    (rangeMin.typeId() == QMetaType::Int)
-                    #else
-                    (rangeMin.type() == QVariant::Int)
-                    #endif
-                    ? QJsonValue(rangeMin.toInt()/1000.0) : rangeMin.toJsonValue() },
-                { QLatin1String("max"),
-                    #if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
-                    (rangeMax.typeId() == QMetaType::Int) ?
-                    #else
-                    (rangeMax.type() == QVariant::Int) ?
-                    #endif
-                    QJsonValue(rangeMax.toInt()/1000.0) : rangeMax.toJsonValue() },
-            });
-        }
-        fputs(QJsonDocument(jsonObject).toJson(), stdout);
+        QJsonObject jsonObject = metadata.json;
+        jsonObject.insert(QLatin1String("value"), qIsInf(reading.value) ?
+            QJsonValue(tr("Infinity")) : QJsonValue(reading.value));
+        outputBuffer.append(formatJson(QJsonDocument(jsonObject)));
     }   break;
+    case OutputFormat::JsonLines:
+        outputBuffer.append(metadata.prefix);
+        if (qIsInf(reading.value)) {
+            appendJsonString(outputBuffer, tr("Infinity"));
+        } else {
+            appendJsonNumber(outputBuffer, reading.value);
+        }
+        outputBuffer.append(metadata.suffix);
+        break;
+    case OutputFormat::Binary: // Only sample data has a binary form, so use text otherwise.
     case OutputFormat::Text:
-        fputs(qPrintable(tr("Mode:   %1 (0x%2)\n").arg(MultimeterService::toString(reading.mode))
-            .arg((quint8)reading.mode,2,16,QLatin1Char('0'))), stdout);
-        fputs(qPrintable(tr("Value:  %1 %2\n").arg(reading.value,0,'f').arg(units)), stdout);
-        fputs(qPrintable(tr("Status: %1 (0x%2)\n").arg(status)
-            .arg((quint8)reading.status,2,16,QLatin1Char('0'))), stdout);
-        fputs(qPrintable(tr("Range:  %1 (0x%2)\n").arg(range)
-            .arg((quint8)reading.range.voltageRange,2,16,QLatin1Char('0'))), stdout);
+        outputBuffer.append(metadata.prefix);
+        appendReal(outputBuffer, reading.value, 'f');
+        outputBuffer.append(metadata.suffix);
         break;
     }
+    ++samplesOutput;
+    flushOutput();
 
     if ((samplesToGo > 0) && (--samplesToGo == 0)) {
         disconnect(); // Will exit the application once disconnected.
     }
 }
+
+/*!
+ * Adds meter \a reading to the current aggregation window, and outputs the window's statistics
+ * (see outputAggregate()) once it holds #readingsPerWindow readings.
+ *
+ * The device still takes readings at the requested update interval, but only one record is output
+ * per window, regardless of how many readings that window holds.
+ */
+void MeterCommand::aggregateReading(const MultimeterService::Reading &reading)
+{
+    if ((aggregate.readings > 0) && (reading.mode != aggregateMode)) {
+        outputAggregate(); // Never aggregate readings of different modes together.
+    }
+    aggregateMode = reading.mode;
+    accumulate(aggregate, reading);
+    ++samplesOutput;
+
+    const bool finished = ((samplesToGo > 0) && (--samplesToGo == 0));
+    if ((aggregate.readings >= readingsPerWindow) || (finished)) {
+        outputAggregate();
+    }
+    if (finished) {
+        disconnect(); // Will exit the application once disconnected.
+    }
+}
+
+/*!
+ * Outputs the current aggregation window's statistics in the selected output format, then begins
+ * a new window.
+ *
+ * If the window holds no valid readings (ie only errors), then its statistics are output as empty
+ * fields (or `null`s for the JSON formats), the same way errors are reported elsewhere.
+ */
+void MeterCommand::outputAggregate()
+{
+    const bool empty = (aggregate.count == 0);
+    const double minimum = (empty) ? qQNaN() : aggregate.minimum;
+    const double maximum = (empty) ? qQNaN() : aggregate.maximum;
+    const double mean    = (empty) ? qQNaN() : aggregate.mean;
+    const double rms     = MeterCommand::rms(aggregate);
+    const double stddev  = standardDeviation(aggregate);
+    const QString units  = unitsString(aggregateMode);
+
+    switch (format) {
+    case OutputFormat::Csv:
+        appendCsvHeader(tr("mode,readings,errors,min,max,mean,rms,stddev,units\n"));
+        outputBuffer.append(escapeCsvField(MultimeterService::toString(aggregateMode))
+            .toLocal8Bit()).append(',');
+        appendInteger(outputBuffer, aggregate.readings);
+        outputBuffer.append(',');
+        appendInteger(outputBuffer, aggregate.errors);
+        for (const double value: { minimum, maximum, mean, rms, stddev }) {
+            outputBuffer.append(',');
+            if (!empty) {
+                appendReal(outputBuffer, value, 'f');
+            }
+        }
+        outputBuffer.append(',').append(units.toLocal8Bit()).append('\n');
+        break;
+    case OutputFormat::Json:
+    case OutputFormat::JsonLines: {
+        const auto toJson = [](const double value) {
+            return (qIsNaN(value)) ? QJsonValue() : QJsonValue(value);
+        };
+        outputBuffer.append(formatJson(QJsonDocument(QJsonObject{
+            { QLatin1String("mode"),     MultimeterService::toString(aggregateMode) },
+            { QLatin1String("readings"), aggregate.readings },
+            { QLatin1String("errors"),   aggregate.errors },
+            { QLatin1String("min"),      toJson(minimum) },
+            { QLatin1String("max"),      toJson(maximum) },
+            { QLatin1String("mean"),     toJson(mean) },
+            { QLatin1String("rms"),      toJson(rms) },
+            { QLatin1String("stddev"),   toJson(stddev) },
+            { QLatin1String("units"),    units },
+        })));
+    }   break;
+    case OutputFormat::Binary: // Only sample data has a binary form, so use text otherwise.
+    case OutputFormat::Text:
+        outputBuffer.append(tr("Mode:     %1 (0x%2)\n")
+            .arg(MultimeterService::toString(aggregateMode))
+            .arg((quint8)aggregateMode,2,16,QLatin1Char('0')).toLocal8Bit());
+        outputBuffer.append(tr("Readings: %1 (%2 errors)\n").arg(aggregate.readings)
+            .arg(aggregate.errors).toLocal8Bit());
+        if (empty) {
+            outputBuffer.append(tr("Min:      \nMax:      \nMean:     \nRMS:      \nStd Dev:  \n")
+                .toLocal8Bit());
+            break;
+        }
+        outputBuffer.append(tr("Min:      %1 %2\n").arg(minimum,0,'f').arg(units).toLocal8Bit());
+        outputBuffer.append(tr("Max:      %1 %2\n").arg(maximum,0,'f').arg(units).toLocal8Bit());
+        outputBuffer.append(tr("Mean:     %1 %2\n").arg(mean,0,'f').arg(units).toLocal8Bit());
+        outputBuffer.append(tr("RMS:      %1 %2\n").arg(rms,0,'f').arg(units).toLocal8Bit());
+        outputBuffer.append(tr("Std Dev:  %1 %2\n").arg(stddev,0,'f').arg(units).toLocal8Bit());
+        break;
+    }
+    flushOutput();
+    aggregate = Aggregate();
+}
@@ -5,6 +5,8 @@
 
 #include <qtpokit/multimeterservice.h>
 
+#include <QJsonObject>
+
 class MeterCommand : public DeviceCommand
 {
 public:
@@ -18,6 +20,8 @@ public slots:
 
 protected:
     AbstractPokitService * getService() override;
+    AbstractPokitService * prepareService(PokitDevice * const pokitDevice) const override;
+    void disableNotifications() override;
 
 protected slots:
     void serviceDetailsDiscovered() override;
@@ -27,14 +31,51 @@ private:
     MultimeterService::Settings settings; ///< Settings for the Pokit device's multimeter mode.
     int samplesToGo; ///< Number of samples to read, if specified on the CLI.
 
+    struct Aggregate {
+        int readings;        ///< Number of readings in the window, including #errors.
+        int errors;          ///< Number of error (or overload) readings, excluded from statistics.
+        int count;           ///< Number of readings included in the statistics.
+        double minimum;      ///< Minimum value.
+        double maximum;      ///< Maximum value.
+        double mean;         ///< Running mean (via Welford's algorithm).
+        double m2;           ///< Running sum of squared differences from the #mean.
+        double sumOfSquares; ///< Running sum of squared values, for the RMS.
+    };
+
+    quint32 aggregateWindow; ///< Milliseconds per aggregation window, or `0` to not aggregate.
+    int readingsPerWindow; ///< Number of readings per aggregation window, at the update interval.
+    MultimeterService::Mode aggregateMode; ///< Mode of the readings in the current #aggregate.
+    Aggregate aggregate; ///< Statistics for the current aggregation window.
+
+    struct OutputMetadata {
+        bool valid;                            ///< Whether the rest of the fields are valid.
+        OutputFormat format;                   ///< Output format the fields were resolved for.
+        MultimeterService::Mode mode;          ///< Mode the fields were resolved for.
+        quint8 range;                          ///< Range the fields were resolved for.
+        MultimeterService::MeterStatus status; ///< Status the fields were resolved for.
+        QByteArray prefix; ///< Formatted output to precede each reading's value.
+        QByteArray suffix; ///< Formatted output to follow each reading's value.
+        QJsonObject json;  ///< Reading's JSON object, sans value, for OutputFormat::Json.
+    };
+
+    OutputMetadata outputMetadata; ///< Output metadata for the most recent reading's mode, etc.
+
     MultimeterService::Range lowestRange(const MultimeterService::Mode mode, const quint32 desiredMax);
     static MultimeterService::CurrentRange lowestCurrentRange(const quint32 desiredMax);
     static MultimeterService::ResistanceRange lowestResistanceRange(const quint32 desiredMax);
     static MultimeterService::VoltageRange lowestVoltageRange(const quint32 desiredMax);
+    static QString unitsString(const MultimeterService::Mode mode);
+    static void accumulate(Aggregate &aggregate, const MultimeterService::Reading &reading);
+    static double rms(const Aggregate &aggregate);
+    static double standardDeviation(const Aggregate &aggregate);
+    void outputAggregate();
+    const OutputMetadata &resolveOutputMetadata(const MultimeterService::Reading &reading);
 
 private slots:
     void settingsWritten();
     void outputReading(const MultimeterService::Reading &reading);
+    void aggregateReading(const MultimeterService::Reading &reading);
 
+    friend class BenchMeterCommand;
     friend class TestMeterCommand;
 };
@@ -0,0 +1,219 @@
+// SPDX-FileCopyrightText: 2022 Paul Colby <git@colby.id.au>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "multidevicecommand.h"
+#include "devicecommand.h"
+
+#include <qtpokit/pokitdiscoveryagent.h>
+
+/*!
+ * \class MultiDeviceCommand
+ *
+ * The MultiDeviceCommand class runs a device command (such as `meter` or `dso`) against multiple
+ * Pokit devices concurrently.
+ *
+ * A single discovery scan is performed, and a separate command object (created via the factory
+ * given to the constructor) is connected to each matching device as soon as it is discovered. Each
+ * command's output is tagged with its device's address (or UUID on macOS), so the readings from all
+ * devices may be multiplexed into a single output stream. Aggregate throughput is reported
+ * periodically, and once all devices have finished.
+ */
+
+/*!
+ * Construct a new MultiDeviceCommand object with \a parent, using \a factory to create one command
+ * per device.
+ */
+MultiDeviceCommand::MultiDeviceCommand(const Factory &factory, QObject * const parent)
+    : AbstractCommand(parent), factory(factory), prototype(factory(this)), parser(nullptr),
+      discoveryFinished(false), exitCode(EXIT_SUCCESS)
+{
+    Q_ASSERT(prototype);
+    reportTimer.setInterval(10000);
+    connect(&reportTimer, &QTimer::timeout, this, &MultiDeviceCommand::reportThroughput);
+}
+
+/*!
+ * \copybrief AbstractCommand::requiredOptions
+ *
+ * This implementation returns the required options of the per-device commands.
+ */
+QStringList MultiDeviceCommand::requiredOptions(const QCommandLineParser &parser) const
+{
+    return prototype->requiredOptions(parser);
+}
+
+/*!
+ * \copybrief AbstractCommand::supportedOptions
+ *
+ * This implementation returns the supported options of the per-device commands.
+ */
+QStringList MultiDeviceCommand::supportedOptions(const QCommandLineParser &parser) const
+{
+    return prototype->supportedOptions(parser);
+}
+
+/*!
+ * \copybrief AbstractCommand::processOptions
+ *
+ * This implementation extends AbstractCommand::processOptions to validate the options for the
+ * per-device commands too, and to allow the `device` option to be given more than once.
+ */
+QStringList MultiDeviceCommand::processOptions(const QCommandLineParser &parser)
+{
+    QStringList errors = AbstractCommand::processOptions(parser);
+    if (!errors.isEmpty()) {
+        return errors;
+    }
+    if (format == OutputFormat::Binary) {
+        errors.append(tr("Binary output cannot be used with multiple devices."));
+        return errors;
+    }
+    deviceMatcher = DeviceMatcher(parser.values(QLatin1String("device")));
+    if (!deviceMatcher.errorString().isEmpty()) {
+        errors.append(deviceMatcher.errorString());
+        return errors;
+    }
+    this->parser = &parser;
+    return prototype->processOptions(parser);
+}
+
+/*!
+ * Begins scanning for Pokit devices.
+ */
+bool MultiDeviceCommand::start()
+{
+    qCInfo(lc).noquote() << ((deviceMatcher.isEmpty())
+        ? tr("Looking for all available Pokit devices...")
+        : tr("Looking for devices \"%1\"...")
+            .arg(deviceMatcher.targets().join(QLatin1String("\", \""))));
+    discoveryAgent->start();
+    return true;
+}
+
+/*!
+ * Handles the finishing of the device \a command, with \a exitCode. Once all device commands have
+ * finished (and discovery is complete), the aggregate throughput is reported, and the application
+ * exits with the worst of the commands' exit codes.
+ */
+void MultiDeviceCommand::deviceFinished(DeviceCommand * const command, const int exitCode)
+{
+    if (finishedCommands.contains(command)) {
+        return; // Already finished, such as an error, followed by a disconnection.
+    }
+    finishedCommands.append(command);
+    qCDebug(lc).noquote() << tr("Device %1 of %2 finished with exit code %3.")
+        .arg(finishedCommands.size()).arg(commands.size()).arg(exitCode);
+    if (exitCode != EXIT_SUCCESS) {
+        this->exitCode = exitCode;
+    }
+    exitIfFinished();
+}
+
+/*!
+ * Checks if \a info is a device we're looking for, and if so, creates a new command, and begins
+ * connecting it to the device.
+ */
+void MultiDeviceCommand::deviceDiscovered(const QBluetoothDeviceInfo &info)
+{
+    const QString id = deviceId(info);
+    if (commands.contains(id)) {
+        return; // Already connected to this device.
+    }
+
+    if (!deviceMatcher.isMatch(info)) {
+        qCDebug(lc).noquote() << tr("Ignoring non-matching Pokit device \"%1\" (%2) at (%3).")
+            .arg(info.name(), info.deviceUuid().toString(), info.address().toString());
+        return;
+    }
+
+    qCInfo(lc).noquote() << tr("Found Pokit device \"%1\" (%2).").arg(info.name(), id);
+    DeviceCommand * const command = factory(this);
+    Q_ASSERT(command);
+    const QStringList errors = command->processOptions(*parser);
+    if (!errors.isEmpty()) { // Should not happen, since the prototype accepted the same options.
+        qCWarning(lc).noquote() << tr("Skipping device %1: %2")
+            .arg(id, errors.join(QLatin1String("; ")));
+        delete command;
+        return;
+    }
+    command->setFinishedHandler([this](DeviceCommand * const command, const int exitCode) {
+        deviceFinished(command, exitCode);
+    });
+    command->setOutputTag(id, &csvHeaderPending); // Only the first to output writes the header.
+    commands.insert(id, command);
+    if (!elapsed.isValid()) {
+        elapsed.start();
+        reportTimer.start();
+    }
+    command->connectToDevice(info);
+
+    // Stop scanning once we have found all of the (explicitly) requested devices. Name patterns may
+    // match any number of devices, so in that case, scanning continues until the agent times out.
+    for (int index = deviceMatcher.indexOf(info); index >= 0;
+         index = deviceMatcher.indexOf(info, index + 1))
+    {
+        foundTargets.insert(index);
+    }
+    if ((!deviceMatcher.isEmpty()) && (!deviceMatcher.hasPatterns()) &&
+        (foundTargets.size() >= deviceMatcher.size()))
+    {
+        discoveryAgent->stop();
+        deviceDiscoveryFinished();
+    }
+}
+
+/*!
+ * Checks that at least one device was discovered, and if not, reports and error and exits.
+ */
+void MultiDeviceCommand::deviceDiscoveryFinished()
+{
+    if (discoveryFinished) {
+        return;
+    }
+    discoveryFinished = true;
+    if (commands.isEmpty()) {
+        qCWarning(lc).noquote() << tr("Failed to find any matching Pokit devices.");
+        QCoreApplication::exit(EXIT_FAILURE);
+        return;
+    }
+    qCInfo(lc).noquote() << tr("Using %Ln Pokit device(s).", nullptr, commands.size());
+    exitIfFinished();
+}
+
+/*!
+ * Returns a string uniquely identifying the device \a info; that is, its hardware address, or its
+ * UUID on platforms (such as macOS) that do not expose addresses.
+ */
+QString MultiDeviceCommand::deviceId(const QBluetoothDeviceInfo &info)
+{
+    return (info.address().isNull()) ? info.deviceUuid().toString() : info.address().toString();
+}
+
+/*!
+ * Logs the aggregate (and per-device) throughput since the first device was connected.
+ */
+void MultiDeviceCommand::reportThroughput() const
+{
+    const double seconds = elapsed.isValid() ? elapsed.nsecsElapsed() / 1e9 : 0.0;
+    quint64 total = 0;
+    for (auto iter = commands.constBegin(); iter != commands.constEnd(); ++iter) {
+        total += iter.value()->samplesOutput;
+        qCDebug(lc).noquote() << tr("%1: %L2 samples")
+            .arg(iter.key()).arg(iter.value()->samplesOutput);
+    }
+    qCInfo(lc).noquote() << tr("%L1 samples from %L2 device(s) in %L3s (%L4 samples/s).")
+        .arg(total).arg(commands.size()).arg(seconds, 0, 'f', 1)
+        .arg((seconds > 0.0) ? total / seconds : 0.0, 0, 'f', 1);
+}
+
+/*!
+ * Reports the final throughput, and exits, if discovery and all device commands have finished.
+ */
+void MultiDeviceCommand::exitIfFinished()
+{
+    if ((discoveryFinished) && (finishedCommands.size() >= commands.size())) {
+        reportTimer.stop();
+        reportThroughput();
+        QCoreApplication::exit(exitCode);
+    }
+}
@@ -0,0 +1,59 @@
+// SPDX-FileCopyrightText: 2022 Paul Colby <git@colby.id.au>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#ifndef QTPOKIT_MULTIDEVICECOMMAND_H
+#define QTPOKIT_MULTIDEVICECOMMAND_H
+
+#include "abstractcommand.h"
+#include "devicematcher.h"
+
+#include <QElapsedTimer>
+#include <QMap>
+#include <QSet>
+#include <QTimer>
+
+#include <functional>
+
+class DeviceCommand;
+
+class MultiDeviceCommand : public AbstractCommand
+{
+public:
+    typedef std::function<DeviceCommand * (QObject * const parent)> Factory;
+
+    MultiDeviceCommand(const Factory &factory, QObject * const parent);
+
+    QStringList requiredOptions(const QCommandLineParser &parser) const override;
+    QStringList supportedOptions(const QCommandLineParser &parser) const override;
+
+    void deviceFinished(DeviceCommand * const command, const int exitCode);
+
+public slots:
+    QStringList processOptions(const QCommandLineParser &parser) override;
+    bool start() override;
+
+protected slots:
+    void deviceDiscovered(const QBluetoothDeviceInfo &info) override;
+    void deviceDiscoveryFinished() override;
+
+private:
+    Factory factory; ///< Factory for creating one command per device.
+    DeviceCommand * prototype; ///< Command used to validate options, but never connected.
+    const QCommandLineParser * parser; ///< Parser to process each device command's options with.
+    DeviceMatcher deviceMatcher; ///< Devices (if any) that were passed via --device options.
+    QSet<int> foundTargets; ///< Indexes of the #deviceMatcher targets matched so far.
+    QMap<QString, DeviceCommand *> commands; ///< Commands for each device, keyed by deviceId().
+    QList<DeviceCommand *> finishedCommands; ///< Commands that have finished.
+    bool discoveryFinished; ///< Whether device discovery has finished.
+    int exitCode; ///< Exit code to return once all commands have finished.
+    QElapsedTimer elapsed; ///< Time since the first device was connected.
+    QTimer reportTimer; ///< Timer for periodically reporting throughput.
+
+    static QString deviceId(const QBluetoothDeviceInfo &info);
+    void reportThroughput() const;
+    void exitIfFinished();
+
+    friend class TestMultiDeviceCommand;
+};
+
+#endif // QTPOKIT_MULTIDEVICECOMMAND_H
@@ -15,12 +15,19 @@
  *
  * The ScanCommand class implements the `scan` CLI command, by scanning for nearby Pokit Bluetooth
  * devices. When devices are found, they are logged to stdout in the chosen format.
+ *
+ * By default, every device discovery and update is output in full, so in a room with many Pokit
+ * devices, frequent signal strength (RSSI) updates can flood stdout. With the `incremental` option,
+ * the command instead keeps a table of the devices discovered so far, outputs each device in full
+ * just once, and thereafter outputs only what changed, with the signal strength smoothed (see
+ * RssiTracker), and reported only when it first becomes known, or moves by at least
+ * #signalStrengthThreshold dBm.
  */
 
 /*!
  * Construct a new ScanCommand object with \a parent.
  */
-ScanCommand::ScanCommand(QObject * const parent) : AbstractCommand(parent)
+ScanCommand::ScanCommand(QObject * const parent) : AbstractCommand(parent), incremental(false)
 {
     #if (QT_VERSION >= QT_VERSION_CHECK(5, 12, 0)) // Required signal, and Fields, added in Qt 5.12.
     connect(discoveryAgent, &PokitDiscoveryAgent::pokitDeviceUpdated,
@@ -36,6 +43,7 @@ QStringList ScanCommand::requiredOptions(const QCommandLineParser &parser) const
 QStringList ScanCommand::supportedOptions(const QCommandLineParser &parser) const
 {
     return AbstractCommand::supportedOptions(parser) + QStringList{
+        QLatin1String("incremental"),
     };
 }
 
@@ -47,6 +55,7 @@ QStringList ScanCommand::processOptions(const QCommandLineParser &parser)
         return errors;
     }
 
+    incremental = parser.isSet(QLatin1String("incremental"));
     return errors;
 }
 
@@ -66,33 +75,47 @@ bool ScanCommand::start()
  */
 void ScanCommand::deviceDiscovered(const QBluetoothDeviceInfo &info)
 {
+    if (incremental) {
+        updateDevice(info, false);
+        return;
+    }
+
     switch (format) {
     case OutputFormat::Csv:
-        for (static bool firstTime = true; firstTime; firstTime = false) {
-            fputs(qPrintable(tr("uuid,address,name,major_class,minor_class,signal_strength\n")), stdout);
-        }
-        fputs(qPrintable(QString::fromLatin1("%1,%2,%3,%4,%5,%6\n").arg(info.deviceUuid().toString(),
-            info.address().toString(), escapeCsvField(info.name()), toString(info.majorDeviceClass()),
-            toString(info.majorDeviceClass(), info.minorDeviceClass())).arg(info.rssi())), stdout);
+        appendCsvHeader(tr("uuid,address,name,major_class,minor_class,signal_strength\n"));
+        outputBuffer.append(QString::fromLatin1("%1,%2,%3,%4,%5,%6\n").arg(
+            info.deviceUuid().toString(), info.address().toString(), escapeCsvField(info.name()),
+            toString(info.majorDeviceClass()),
+            toString(info.majorDeviceClass(), info.minorDeviceClass())).arg(info.rssi())
+            .toLocal8Bit());
         break;
     case OutputFormat::Json:
-        fputs(QJsonDocument(toJson(info)).toJson(), stdout);
+    case OutputFormat::JsonLines:
+        outputBuffer.append(formatJson(QJsonDocument(toJson(info))));
         break;
+    case OutputFormat::Binary: // Only sample data has a binary form, so use text otherwise.
     case OutputFormat::Text:
-        fputs(qPrintable(tr("%1 %2 %3 %4\n").arg(info.deviceUuid().toString(),
-            info.address().toString(), info.name()).arg(info.rssi())), stdout);
+        outputBuffer.append(tr("%1 %2 %3 %4\n").arg(info.deviceUuid().toString(),
+            info.address().toString(), info.name()).arg(info.rssi()).toLocal8Bit());
         break;
     }
+    flushOutput();
 }
 
 /*!
- * Handles updated Pokit devices, writing \a info to stdout. Currently \a updatedFields us unused.
+ * Handles updated Pokit devices, writing \a info to stdout. In #incremental mode, only the
+ * \a updatedFields are compared against the previously discovered info, and only changes are
+ * written; otherwise \a updatedFields is unused.
  */
 #if (QT_VERSION >= QT_VERSION_CHECK(5, 12, 0)) // Required signal, and Fields, added in Qt 5.12.
 void ScanCommand::deviceUpdated(const QBluetoothDeviceInfo &info,
                                 const QBluetoothDeviceInfo::Fields updatedFields)
 {
-    Q_UNUSED(updatedFields)
+    if (incremental) {
+        updateDevice(info,
+            updatedFields == QBluetoothDeviceInfo::Fields(QBluetoothDeviceInfo::Field::RSSI));
+        return;
+    }
     deviceDiscovered(info);
 }
 #endif
@@ -104,9 +127,113 @@ void ScanCommand::deviceUpdated(const QBluetoothDeviceInfo &info,
 void ScanCommand::deviceDiscoveryFinished()
 {
     qCDebug(lc).noquote() << tr("Finished scanning for Pokit devices.");
+    if (incremental) {
+        qCDebug(lc).noquote() << tr("Discovered %Ln Pokit device(s).", nullptr, devices.size());
+    }
     QCoreApplication::quit();
 }
 
+/*!
+ * Updates the #devices table with \a info, and outputs the device in full if newly discovered,
+ * otherwise outputs just what changed, if anything. If \a rssiOnly is `true`, then only the signal
+ * strength has been updated, so the (relatively expensive) comparison of other fields is skipped.
+ */
+void ScanCommand::updateDevice(const QBluetoothDeviceInfo &info, const bool rssiOnly)
+{
+    const QString key = PokitDiscoveryAgent::deviceKey(info);
+    const auto iter = devices.find(key);
+    if (iter == devices.end()) {
+        DeviceRecord record{ info, RssiTracker() };
+        record.signalStrength.update(info.rssi(), signalStrengthThreshold);
+        outputDevice(*devices.insert(key, record), QStringList());
+        return;
+    }
+
+    // Report signal strength changes beyond the threshold, and when it first becomes known.
+    DeviceRecord &record = iter.value();
+    QStringList changes;
+    const bool wasKnown = record.signalStrength.isValid();
+    if ((record.signalStrength.update(info.rssi(), signalStrengthThreshold)) ||
+        (record.signalStrength.isValid() != wasKnown)) {
+        changes.append(QLatin1String("signalStrength"));
+    }
+    if (!rssiOnly) {
+        if (info.name() != record.info.name()) {
+            changes.append(QLatin1String("name"));
+        }
+        #if (QT_VERSION >= QT_VERSION_CHECK(5, 12, 0)) // Added in Qt 5.12.
+        if (info.manufacturerData() != record.info.manufacturerData()) {
+            changes.append(QLatin1String("manufacturerData"));
+        }
+        #endif
+        if (info.serviceUuids() != record.info.serviceUuids()) {
+            changes.append(QLatin1String("serviceUuids"));
+        }
+        record.info = info;
+    }
+    if (!changes.isEmpty()) {
+        outputDevice(record, changes);
+    }
+}
+
+/*!
+ * Writes the discovered device \a record to stdout, in #incremental form. If \a changes is empty,
+ * the device is output in full, otherwise, for JSON formats, only the identifying fields, and the
+ * fields named by \a changes, are output. CSV and Text formats always output complete lines.
+ */
+void ScanCommand::outputDevice(const DeviceRecord &record, const QStringList &changes)
+{
+    const QBluetoothDeviceInfo &info = record.info;
+    const RssiTracker &strength = record.signalStrength;
+    switch (format) {
+    case OutputFormat::Csv:
+        appendCsvHeader(tr("uuid,address,name,major_class,minor_class,signal_strength,"
+            "signal_strength_average,signal_strength_min,signal_strength_max\n"));
+        outputBuffer.append(QString::fromLatin1("%1,%2,%3,%4,%5,%6,%7,%8,%9\n").arg(
+            info.deviceUuid().toString(), info.address().toString(), escapeCsvField(info.name()),
+            toString(info.majorDeviceClass()),
+            toString(info.majorDeviceClass(), info.minorDeviceClass())).arg(strength.latest())
+            .arg(strength.average(), 0, 'f', 1).arg(strength.minimum()).arg(strength.maximum())
+            .toLocal8Bit());
+        break;
+    case OutputFormat::Json:
+    case OutputFormat::JsonLines: {
+        QJsonObject json;
+        if (changes.isEmpty()) {
+            json = toJson(info);
+        } else {
+            json.insert(QLatin1String("address"), info.address().toString());
+            if (!info.deviceUuid().isNull()) {
+                json.insert(QLatin1String("deviceUuid"), info.deviceUuid().toString());
+            }
+            if (changes.contains(QLatin1String("name"))) {
+                json.insert(QLatin1String("name"), info.name());
+            }
+            #if (QT_VERSION >= QT_VERSION_CHECK(5, 12, 0)) // Added in Qt 5.12.
+            if (changes.contains(QLatin1String("manufacturerData"))) {
+                json.insert(QLatin1String("manufacturerData"), toJson(info.manufacturerData()));
+            }
+            #endif
+            if (changes.contains(QLatin1String("serviceUuids"))) {
+                json.insert(QLatin1String("serviceUuids"), toJson(info.serviceUuids()));
+            }
+        }
+        if ((changes.isEmpty()) || (changes.contains(QLatin1String("signalStrength")))) {
+            json.insert(QLatin1String("signalStrength"), toJson(strength));
+        }
+        outputBuffer.append(formatJson(QJsonDocument(json)));
+    }   break;
+    case OutputFormat::Binary: // Only sample data has a binary form, so use text otherwise.
+    case OutputFormat::Text:
+        outputBuffer.append(tr("%1 %2 %3 %4 (average %5, min %6, max %7)\n").arg(
+            info.deviceUuid().toString(), info.address().toString(), info.name())
+            .arg(strength.latest()).arg(strength.average(), 0, 'f', 1).arg(strength.minimum())
+            .arg(strength.maximum()).toLocal8Bit());
+        break;
+    }
+    flushOutput();
+}
+
 /*!
  * Returns \a info as a JSON object.
  */
@@ -143,6 +270,19 @@ QJsonObject ScanCommand::toJson(const QBluetoothDeviceInfo &info) {
     return json;
 }
 
+/*!
+ * Returns \a strength as a JSON object.
+ */
+QJsonObject ScanCommand::toJson(const RssiTracker &strength)
+{
+    return QJsonObject{
+        { QLatin1String("latest"),  strength.latest() },
+        { QLatin1String("average"), qRound(strength.average() * 10.0) / 10.0 },
+        { QLatin1String("minimum"), strength.minimum() },
+        { QLatin1String("maximum"), strength.maximum() },
+    };
+}
+
 /*!
  * Returns \a configuration as a JSON array of strings.
  */
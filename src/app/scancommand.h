@@ -3,6 +3,10 @@
 
 #include "abstractcommand.h"
 
+#include <qtpokit/rssitracker.h>
+
+#include <QHash>
+
 class ScanCommand : public AbstractCommand
 {
 public:
@@ -24,7 +28,21 @@ protected slots:
     void deviceDiscoveryFinished() override;
 
 private:
+    struct DeviceRecord {
+        QBluetoothDeviceInfo info;     ///< Most recent device info.
+        RssiTracker signalStrength;    ///< Smoothed signal strength.
+    };
+
+    static const int signalStrengthThreshold = 3; ///< Smoothed dBm change worth reporting.
+
+    bool incremental; ///< Whether to output only the changes to discovered devices.
+    QHash<QString, DeviceRecord> devices; ///< Devices discovered so far, in #incremental mode.
+
+    void updateDevice(const QBluetoothDeviceInfo &info, const bool rssiOnly);
+    void outputDevice(const DeviceRecord &record, const QStringList &changes);
+
     static QJsonObject toJson(const QBluetoothDeviceInfo &info);
+    static QJsonObject toJson(const RssiTracker &strength);
     static QJsonArray  toJson(const QBluetoothDeviceInfo::CoreConfigurations &configurations);
     static QJsonValue  toJson(const QBluetoothDeviceInfo::MajorDeviceClass &majorClass);
     static QJsonValue  toJson(const QBluetoothDeviceInfo::MajorDeviceClass &majorClass, const quint8 minorClass);
@@ -65,12 +65,27 @@ AbstractPokitService * SetNameCommand::getService()
     if (!service) {
         service = device->status();
         Q_ASSERT(service);
+        service->setSkipValueDiscovery(); // We never read cached values.
         connect(service, &StatusService::deivceNameWritten,
                 this, &SetNameCommand::deivceNameWritten);
     }
     return service;
 }
 
+/*!
+ * \copybrief DeviceCommand::prepareService
+ *
+ * This override returns a pointer to \a pokitDevice's StatusService object, with its
+ * value discovery skipped, since this command never reads cached values.
+ */
+AbstractPokitService * SetNameCommand::prepareService(PokitDevice * const pokitDevice) const
+{
+    StatusService * const pokitService = pokitDevice->status();
+    Q_ASSERT(pokitService);
+    pokitService->setSkipValueDiscovery(); // We never read cached values.
+    return pokitService;
+}
+
 /*!
  * \copybrief DeviceCommand::serviceDetailsDiscovered
  *
@@ -80,7 +95,7 @@ void SetNameCommand::serviceDetailsDiscovered()
 {
     qCInfo(lc).noquote() << tr("Setting device name to: %1").arg(newName);
     if (!service->setDeviceName(newName)) {
-        QCoreApplication::exit(EXIT_FAILURE);
+        finish(EXIT_FAILURE);
     }
 }
 
@@ -91,14 +106,17 @@ void SetNameCommand::deivceNameWritten()
 {
     switch (format) {
     case OutputFormat::Csv:
-        fputs(qPrintable(tr("set_name_result\nsuccess\n")), stdout);
+        outputBuffer.append(qPrintable(tr("set_name_result\nsuccess\n")));
         break;
     case OutputFormat::Json:
-        fputs(qPrintable(QLatin1String("true\n")), stdout);
+    case OutputFormat::JsonLines:
+        outputBuffer.append(qPrintable(QLatin1String("true\n")));
         break;
+    case OutputFormat::Binary: // Only sample data has a binary form, so use text otherwise.
     case OutputFormat::Text:
-        fputs(qPrintable(tr("Done.\n")), stdout);
+        outputBuffer.append(qPrintable(tr("Done.\n")));
         break;
     }
+    flushOutput();
     disconnect(); // Will exit the application once disconnected.
 }
@@ -65,6 +65,16 @@ AbstractPokitService * StatusCommand::getService()
     return service;
 }
 
+/*!
+ * \copybrief DeviceCommand::prepareService
+ *
+ * This override returns a pointer to \a pokitDevice's StatusService object.
+ */
+AbstractPokitService * StatusCommand::prepareService(PokitDevice * const pokitDevice) const
+{
+    return pokitDevice->status();
+}
+
 /*!
  * \copybrief DeviceCommand::serviceDetailsDiscovered
  *
@@ -80,31 +90,33 @@ void StatusCommand::serviceDetailsDiscovered()
     const StatusService::DeviceCharacteristics chrs = service->deviceCharacteristics();
     if (chrs.firmwareVersion.isNull()) {
         qCWarning(lc).noquote() << tr("Failed to parse device information");
-        QCoreApplication::exit(EXIT_FAILURE);
+        finish(EXIT_FAILURE);
         return;
     }
 
     switch (format) {
     case OutputFormat::Csv:
-        fputs(qPrintable(tr("device_name,device_status,firmware_version,maximum_voltage,"
-                            "maximum_current,maximum_resistance,maximum_sampling_rate,"
-                            "sampling_buffer_size,capability_mask,mac_address,battery_voltage,"
-                            "battery_status\n")), stdout);
-        fputs(qPrintable(QString::fromLatin1("%1,%2,%3,%4,%5,%6,%7,%8,%9,%10,%11,%12\n")
+        outputBuffer.append(qPrintable(tr("device_name,device_status,firmware_version,"
+                            "maximum_voltage,maximum_current,maximum_resistance,"
+                            "maximum_sampling_rate,sampling_buffer_size,capability_mask,"
+                            "mac_address,battery_voltage,battery_status\n")));
+        outputBuffer.append(qPrintable(
+            QString::fromLatin1("%1,%2,%3,%4,%5,%6,%7,%8,%9,%10,%11,%12\n")
             .arg(escapeCsvField(deviceName),statusLabel.toLower(),chrs.firmwareVersion.toString())
             .arg(chrs.maximumVoltage).arg(chrs.maximumCurrent).arg(chrs.maximumResistance)
             .arg(chrs.maximumSamplingRate).arg(chrs.samplingBufferSize).arg(chrs.capabilityMask)
             .arg(chrs.macAddress.toString()).arg(status.batteryVoltage)
-            .arg(batteryLabel.toLower())), stdout);
+            .arg(batteryLabel.toLower())));
         break;
-    case OutputFormat::Json: {
+    case OutputFormat::Json:
+    case OutputFormat::JsonLines: {
         QJsonObject battery{
             { QLatin1String("level"),  status.batteryVoltage },
         };
         if (!batteryLabel.isNull()) {
             battery.insert(QLatin1String("status"), batteryLabel);
         }
-        fputs(QJsonDocument(QJsonObject{
+        outputBuffer.append(formatJson(QJsonDocument(QJsonObject{
                 { QLatin1String("deviceName"),   deviceName },
                 { QLatin1String("firmwareVersion"), QJsonObject{
                       { QLatin1String("major"), chrs.firmwareVersion.majorVersion() },
@@ -122,25 +134,33 @@ void StatusCommand::serviceDetailsDiscovered()
                       { QLatin1String("label"), statusLabel },
                 }},
                 { QLatin1String("battery"), battery },
-            }).toJson(), stdout);
+            })));
     }   break;
+    case OutputFormat::Binary: // Only sample data has a binary form, so use text otherwise.
     case OutputFormat::Text:
-        fputs(qPrintable(tr("Device name:           %1\n").arg(deviceName)), stdout);
-        fputs(qPrintable(tr("Firmware version:      %1\n").arg(chrs.firmwareVersion.toString())), stdout);
-        fputs(qPrintable(tr("Maximum voltage:       %1\n").arg(chrs.maximumVoltage)), stdout);
-        fputs(qPrintable(tr("Maximum current:       %1\n").arg(chrs.maximumCurrent)), stdout);
-        fputs(qPrintable(tr("Maximum resistance:    %1\n").arg(chrs.maximumResistance)), stdout);
-        fputs(qPrintable(tr("Maximum sampling rate: %1\n").arg(chrs.maximumSamplingRate)), stdout);
-        fputs(qPrintable(tr("Sampling buffer size:  %1\n").arg(chrs.samplingBufferSize)), stdout);
-        fputs(qPrintable(tr("Capability mask:       %1\n").arg(chrs.capabilityMask)), stdout);
-        fputs(qPrintable(tr("MAC address:           %1\n").arg(chrs.macAddress.toString())), stdout);
-        fputs(qPrintable(tr("Device status:         %1 (%2)\n").arg(statusLabel)
-            .arg((quint8)status.deviceStatus)), stdout);
-        fputs(qPrintable(tr("Battery voltage:       %1\n").arg(status.batteryVoltage)), stdout);
-        fputs(qPrintable(tr("Battery status:        %1 (%2)\n")
+        outputBuffer.append(qPrintable(tr("Device name:           %1\n").arg(deviceName)));
+        outputBuffer.append(qPrintable(tr("Firmware version:      %1\n")
+            .arg(chrs.firmwareVersion.toString())));
+        outputBuffer.append(qPrintable(tr("Maximum voltage:       %1\n").arg(chrs.maximumVoltage)));
+        outputBuffer.append(qPrintable(tr("Maximum current:       %1\n").arg(chrs.maximumCurrent)));
+        outputBuffer.append(qPrintable(tr("Maximum resistance:    %1\n")
+            .arg(chrs.maximumResistance)));
+        outputBuffer.append(qPrintable(tr("Maximum sampling rate: %1\n")
+            .arg(chrs.maximumSamplingRate)));
+        outputBuffer.append(qPrintable(tr("Sampling buffer size:  %1\n")
+            .arg(chrs.samplingBufferSize)));
+        outputBuffer.append(qPrintable(tr("Capability mask:       %1\n").arg(chrs.capabilityMask)));
+        outputBuffer.append(qPrintable(tr("MAC address:           %1\n")
+            .arg(chrs.macAddress.toString())));
+        outputBuffer.append(qPrintable(tr("Device status:         %1 (%2)\n").arg(statusLabel)
+            .arg((quint8)status.deviceStatus)));
+        outputBuffer.append(qPrintable(tr("Battery voltage:       %1\n")
+            .arg(status.batteryVoltage)));
+        outputBuffer.append(qPrintable(tr("Battery status:        %1 (%2)\n")
             .arg(batteryLabel.isNull() ? QString::fromLatin1("N/A") : batteryLabel)
-            .arg((quint8)status.batteryStatus)), stdout);
+            .arg((quint8)status.batteryStatus)));
         break;
     }
+    flushOutput();
     disconnect(); // Will exit the application once disconnected.
 }
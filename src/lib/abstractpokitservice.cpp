@@ -12,6 +12,8 @@
 #include <qtpokit/pokitdevice.h>
 
 #include <QLowEnergyController>
+#include <QTimer>
+#include <QtMath>
 
 /*!
  * \class AbstractPokitService
@@ -77,6 +79,99 @@ void AbstractPokitService::setAutoDiscover(const bool discover)
     d->autoDiscover = discover;
 }
 
+/*!
+ * Returns `true` if autodiscovery of service details will skip reading characteristic and descriptor
+ * values, `false` otherwise.
+ *
+ * \see setSkipValueDiscovery
+ */
+bool AbstractPokitService::skipValueDiscovery() const
+{
+    Q_D(const AbstractPokitService);
+    return d->skipValueDiscovery;
+}
+
+/*!
+ * If \a skip is \c true, autodiscovery of service details will discover the service's
+ * characteristics and descriptors (ie their handles) only, without also reading all of their values.
+ *
+ * Reading every value is the bulk of the service details discovery round-trips, so skipping it
+ * significantly shortens the time from connection to serviceDetailsDiscovered(), which suits
+ * clients that only write characteristics, or enable notifications. However, characteristic values
+ * will then be empty until explicitly read, so accessors that return cached values (such as
+ * DeviceInfoService::manufacturer) should not be relied upon until their characteristics have been
+ * read, or re-read via readCharacteristics().
+ *
+ * This must be set before service details discovery begins. Automatic discovery begins no sooner
+ * than the next pass of the event loop after the internal service object is created, so this may
+ * still be set immediately after constructing this service, even for already-connected devices
+ * (such as via PokitDevice's service accessors). It has no effect with Qt versions prior to 6.2,
+ * which always read all values.
+ *
+ * \see skipValueDiscovery
+ * \see setAutoDiscover
+ */
+void AbstractPokitService::setSkipValueDiscovery(const bool skip)
+{
+    Q_D(AbstractPokitService);
+    d->skipValueDiscovery = skip;
+}
+
+/*!
+ * Returns `true` if per-characteristic statistics are being recorded, `false` otherwise.
+ *
+ * \see setStatisticsEnabled
+ */
+bool AbstractPokitService::statisticsEnabled() const
+{
+    Q_D(const AbstractPokitService);
+    return d->statisticsEnabled;
+}
+
+/*!
+ * If \a enabled is \c true, per-characteristic statistics will be recorded, otherwise not.
+ *
+ * The statistics include read, write and notification counts and byte totals, along with
+ * LatencyHistogram distributions of the time from each read or write request to its completion,
+ * and of the time between consecutive notifications. Recording is off by default; while off, the
+ * cost is a single flag test per operation.
+ *
+ * \see statistics
+ * \see resetStatistics
+ */
+void AbstractPokitService::setStatisticsEnabled(const bool enabled)
+{
+    Q_D(AbstractPokitService);
+    d->statisticsEnabled = enabled;
+    if ((enabled) && (!d->statisticsTimer.isValid())) {
+        d->statisticsTimer.start();
+    }
+}
+
+/*!
+ * Returns the statistics recorded since statistics were enabled, or last reset, keyed by
+ * characteristic UUID.
+ *
+ * \see setStatisticsEnabled
+ */
+AbstractPokitService::Statistics AbstractPokitService::statistics() const
+{
+    Q_D(const AbstractPokitService);
+    return d->statistics;
+}
+
+/*!
+ * Clears all recorded statistics, including any outstanding read and write requests.
+ */
+void AbstractPokitService::resetStatistics()
+{
+    Q_D(AbstractPokitService);
+    d->statistics.clear();
+    d->pendingReads.clear();
+    d->pendingWrites.clear();
+    d->lastNotified.clear();
+}
+
 /*!
  * Returns a non-const pointer to the internal service object, if any.
  */
@@ -101,8 +196,9 @@ const QLowEnergyService * AbstractPokitService::service() const
  * This signal is emitted when the Pokit service details have been discovered.
  *
  * Once this signal has been emitted, cached characteristics values should be immediately available
- * via derived classes' accessor functions, and refreshes can be queued via readCharacteristics()
- * and any related read functions provided by derived classes.
+ * via derived classes' accessor functions (unless skipValueDiscovery() is enabled), and refreshes
+ * can be queued via readCharacteristics() and any related read functions provided by derived
+ * classes.
  */
 
 /*!
@@ -111,6 +207,111 @@ const QLowEnergyService * AbstractPokitService::service() const
  *  This signal is emitted whenever an error occurs on the underlying QLowEnergyService.
  */
 
+/*!
+ * \struct AbstractPokitService::LatencyHistogram
+ *
+ * The LatencyHistogram struct records a distribution of durations (in microseconds) in the manner
+ * of an HDR histogram. That is, values below `2 << subBucketBits` are counted exactly, and larger
+ * values are counted in buckets that split each power of two into `1 << subBucketBits` linear
+ * sub-buckets, bounding the relative error of any percentile to about 6%, at a cost of only 16
+ * buckets per power of two.
+ */
+
+/*!
+ * Constructs an empty LatencyHistogram.
+ */
+AbstractPokitService::LatencyHistogram::LatencyHistogram() : count(0), min(0), max(0), total(0)
+{
+
+}
+
+/*!
+ * Records one occurrence of \a microseconds. Negative values are recorded as `0`.
+ */
+void AbstractPokitService::LatencyHistogram::record(const qint64 microseconds)
+{
+    const qint64 value = qMax<qint64>(microseconds, 0);
+    const int index = bucketIndex(value);
+    if (index >= buckets.size()) {
+        buckets.resize(index + 1);
+    }
+    ++buckets[index];
+    min = (count == 0) ? value : qMin(min, value);
+    max = qMax(max, value);
+    total += value;
+    ++count;
+}
+
+/*!
+ * Returns the mean of all recorded values, or `0` if none have been recorded.
+ */
+qint64 AbstractPokitService::LatencyHistogram::mean() const
+{
+    return (count == 0) ? 0 : (total / (qint64)count);
+}
+
+/*!
+ * Returns the value below which \a percent (`0` to `100`) of recorded values fall, to within the
+ * histogram's resolution, or `0` if no values have been recorded.
+ */
+qint64 AbstractPokitService::LatencyHistogram::percentile(const double percent) const
+{
+    if (count == 0) {
+        return 0;
+    }
+    const quint64 rank = qMax<quint64>(1,
+        (quint64)qCeil(qBound(0.0, percent, 100.0) * count / 100.0));
+    quint64 cumulative = 0;
+    for (int index = 0; index < buckets.size(); ++index) {
+        cumulative += buckets.at(index);
+        if (cumulative >= rank) {
+            return qBound(min, bucketUpperBound(index), max);
+        }
+    }
+    return max;
+}
+
+/*!
+ * Returns the index of the bucket that counts \a microseconds, which must not be negative.
+ */
+int AbstractPokitService::LatencyHistogram::bucketIndex(const qint64 microseconds)
+{
+    Q_ASSERT(microseconds >= 0);
+    const int subBuckets = 1 << subBucketBits;
+    if (microseconds < 2 * subBuckets) {
+        return (int)microseconds;
+    }
+    int msb = 0; // Index of the most significant set bit.
+    for (quint64 value = (quint64)microseconds >> 1; value != 0; value >>= 1) {
+        ++msb;
+    }
+    const int shift = msb - subBucketBits;
+    return 2 * subBuckets + (shift - 1) * subBuckets
+        + (int)((quint64)microseconds >> shift) - subBuckets;
+}
+
+/*!
+ * Returns the largest value counted by the bucket at \a index.
+ */
+qint64 AbstractPokitService::LatencyHistogram::bucketUpperBound(const int index)
+{
+    const int subBuckets = 1 << subBucketBits;
+    if (index < 2 * subBuckets) {
+        return index;
+    }
+    const int shift = (index - 2 * subBuckets) / subBuckets + 1;
+    const qint64 lowerBound = (qint64)(subBuckets + (index - 2 * subBuckets) % subBuckets) << shift;
+    return lowerBound + ((qint64)1 << shift) - 1;
+}
+
+/*!
+ * \struct AbstractPokitService::CharacteristicStatistics
+ *
+ * The CharacteristicStatistics struct holds the statistics recorded for a single characteristic.
+ *
+ * \see AbstractPokitService::setStatisticsEnabled
+ */
+
 /*!
  * \cond internal
  * \class AbstractPokitServicePrivate
@@ -131,8 +332,8 @@ const QLowEnergyService * AbstractPokitService::service() const
  */
 AbstractPokitServicePrivate::AbstractPokitServicePrivate(const QBluetoothUuid &serviceUuid,
     QLowEnergyController * controller, AbstractPokitService * const q)
-    : autoDiscover(true), controller(controller), service(nullptr), serviceUuid(serviceUuid),
-      q_ptr(q)
+    : autoDiscover(true), skipValueDiscovery(false), controller(controller), service(nullptr),
+      serviceUuid(serviceUuid), statisticsEnabled(false), q_ptr(q)
 {
     if (controller) {
         connect(controller, &QLowEnergyController::connected,
@@ -210,7 +411,9 @@ bool AbstractPokitServicePrivate::createServiceObject()
         this, &AbstractPokitServicePrivate::errorOccurred);
 
     if (autoDiscover) {
-        service->discoverDetails();
+        // Deferred, so that settings applied immediately after creation (such as skipValueDiscovery
+        // for services created lazily, on already-connected devices) still take effect.
+        QTimer::singleShot(0, this, &AbstractPokitServicePrivate::discoverServiceDetails);
     }
     return true;
 }
@@ -282,9 +485,56 @@ bool AbstractPokitServicePrivate::readCharacteristic(const QBluetoothUuid &uuid)
     qCDebug(lc).noquote() << tr("Reading characteristic %1 \"%2\".")
         .arg(uuid.toString(), PokitDevice::charcteristicToString(uuid));
     service->readCharacteristic(characteristic);
+    if (statisticsEnabled) {
+        pendingReads.insert(uuid, statisticsTimer.nsecsElapsed() / 1000);
+    }
     return true;
 }
 
+/*!
+ * Writes \a newValue to \a characteristic, which must be valid.
+ *
+ * Derived classes should use this function, rather than writing to #service directly, so that
+ * write latencies can be recorded (see AbstractPokitService::setStatisticsEnabled).
+ */
+void AbstractPokitServicePrivate::writeCharacteristic(
+    const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue)
+{
+    Q_ASSERT(service);
+    Q_ASSERT(characteristic.isValid());
+    if (statisticsEnabled) {
+        pendingWrites.insert(characteristic.uuid(), statisticsTimer.nsecsElapsed() / 1000);
+    }
+    service->writeCharacteristic(characteristic, newValue);
+}
+
+/*!
+ * Records statistics (if enabled) for the notification of the characteristic identified by \a uuid
+ * changing to \a newValue, then passes both to characteristicNotified().
+ *
+ * This is separate from characteristicChanged() since QLowEnergyCharacteristic objects can only be
+ * constructed by Qt's Bluetooth backends, whereas this function may also be invoked directly, such
+ * as by PokitSimulator.
+ */
+void AbstractPokitServicePrivate::dispatchNotification(const QBluetoothUuid &uuid,
+                                                       const QByteArray &newValue)
+{
+    if (statisticsEnabled) {
+        const qint64 now = statisticsTimer.nsecsElapsed() / 1000;
+        AbstractPokitService::CharacteristicStatistics &stats = statistics[uuid];
+        ++stats.notifications;
+        stats.bytesNotified += newValue.size();
+        const QHash<QBluetoothUuid, qint64>::iterator last = lastNotified.find(uuid);
+        if (last == lastNotified.end()) {
+            lastNotified.insert(uuid, now);
+        } else {
+            stats.notificationInterval.record(now - last.value());
+            last.value() = now;
+        }
+    }
+    characteristicNotified(uuid, newValue);
+}
+
 /*!
  * Enables client (Pokit device) side notification for characteristic \a uuid.
  *
@@ -419,6 +669,37 @@ void AbstractPokitServicePrivate::connected()
     }
 }
 
+/*!
+ * Begins discovery of the internal service object's details, if `autoDiscover` is (still) enabled,
+ * and the details have not been discovered, nor begun being discovered, already. Characteristic
+ * and descriptor values will be read too, unless `skipValueDiscovery` is enabled (Qt 6.2+ only).
+ *
+ * Returns \c true if discovery was begun, \c false otherwise.
+ *
+ * \see AbstractPokitService::autoDiscover()
+ * \see AbstractPokitService::skipValueDiscovery()
+ */
+bool AbstractPokitServicePrivate::discoverServiceDetails()
+{
+    if ((!service) || (!autoDiscover) || (service->state() != QLowEnergyService::
+        #if (QT_VERSION < QT_VERSION_CHECK(6, 0, 0))
+        DiscoveryRequired
+        #else
+        RemoteService
+        #endif
+    )) {
+        return false;
+    }
+
+    #if (QT_VERSION >= QT_VERSION_CHECK(6, 2, 0)) // DiscoveryMode added in Qt 6.2.
+    service->discoverDetails((skipValueDiscovery) ? QLowEnergyService::SkipValueDiscovery
+        : QLowEnergyService::FullDiscovery);
+    #else
+    service->discoverDetails();
+    #endif
+    return true;
+}
+
 /*!
  * Handles `QLowEnergyController::discoveryFinished` events.
  *
@@ -497,7 +778,7 @@ void AbstractPokitServicePrivate::stateChanged(QLowEnergyService::ServiceState n
 
 /*!
  * Handles `QLowEnergyService::characteristicRead` events. This base implementation simply debug
- * logs the event.
+ * logs the event, and records statistics (if enabled).
  *
  * Derived classes should implement this function to handle the successful reads of
  * \a characteristic, typically by parsing \a value, then emitting a speciailised signal.
@@ -508,11 +789,22 @@ void AbstractPokitServicePrivate::characteristicRead(
     qCDebug(lc).noquote() << tr("Characteristic %1 \"%2\" read %3 bytes: %4").arg(
         characteristic.uuid().toString(), PokitDevice::charcteristicToString(characteristic.uuid()))
         .arg(value.size()).arg(toHexString(value));
+    if (statisticsEnabled) {
+        AbstractPokitService::CharacteristicStatistics &stats = statistics[characteristic.uuid()];
+        ++stats.reads;
+        stats.bytesRead += value.size();
+        const QHash<QBluetoothUuid, qint64>::iterator pending =
+            pendingReads.find(characteristic.uuid());
+        if (pending != pendingReads.end()) {
+            stats.readLatency.record(statisticsTimer.nsecsElapsed() / 1000 - pending.value());
+            pendingReads.erase(pending);
+        }
+    }
 }
 
 /*!
  * Handles `QLowEnergyService::characteristicWritten` events. This base implementation simply debug
- * logs the event.
+ * logs the event, and records statistics (if enabled).
  *
  * Derived classes should implement this function to handle the successful writes of
  * \a characteristic, typically by parsing \a newValue, then emitting a speciailised signal.
@@ -523,15 +815,23 @@ void AbstractPokitServicePrivate::characteristicWritten(
     qCDebug(lc).noquote() << tr("Characteristic %1 \"%2\" written with %L3 bytes: %4").arg(
         characteristic.uuid().toString(), PokitDevice::charcteristicToString(characteristic.uuid()))
         .arg(newValue.size()).arg(toHexString(newValue));
+    if (statisticsEnabled) {
+        AbstractPokitService::CharacteristicStatistics &stats = statistics[characteristic.uuid()];
+        ++stats.writes;
+        stats.bytesWritten += newValue.size();
+        const QHash<QBluetoothUuid, qint64>::iterator pending =
+            pendingWrites.find(characteristic.uuid());
+        if (pending != pendingWrites.end()) {
+            stats.writeLatency.record(statisticsTimer.nsecsElapsed() / 1000 - pending.value());
+            pendingWrites.erase(pending);
+        }
+    }
 }
 
 /*!
  * Handles `QLowEnergyService::characteristicChanged` events. This base implementation simply debug
- * logs the event.
- *
- * If derived classes support characteristics with client-side notification (ie Notify, as opposed
- * to Read or Write operations), they should implement this function to handle the successful reads of
- * \a characteristic, typically by parsing \a value, then emitting a speciailised signal.
+ * logs the event, then passes \a characteristic's UUID, and \a newValue, to
+ * dispatchNotification().
  */
 void AbstractPokitServicePrivate::characteristicChanged(
     const QLowEnergyCharacteristic &characteristic, const QByteArray &newValue)
@@ -539,6 +839,24 @@ void AbstractPokitServicePrivate::characteristicChanged(
     qCDebug(lc).noquote() << tr("Characteristic %1 \"%2\" changed to %L3 bytes: %4").arg(
         characteristic.uuid().toString(), PokitDevice::charcteristicToString(characteristic.uuid()))
         .arg(newValue.size()).arg(toHexString(newValue));
+    dispatchNotification(characteristic.uuid(), newValue);
+}
+
+/*!
+ * Handles the notification of the characteristic identified by \a uuid changing to \a newValue.
+ * This base implementation does nothing.
+ *
+ * If derived classes support characteristics with client-side notification (ie Notify, as opposed
+ * to Read or Write operations), they should implement this function to handle the notifications,
+ * typically by parsing \a newValue, then emitting a speciailised signal.
+ *
+ * \see dispatchNotification
+ */
+void AbstractPokitServicePrivate::characteristicNotified(const QBluetoothUuid &uuid,
+                                                         const QByteArray &newValue)
+{
+    Q_UNUSED(uuid)
+    Q_UNUSED(newValue)
 }
 
 /// \endcond
@@ -9,8 +9,9 @@
 #ifndef QTPOKIT_ABSTRACTPOKITSERVICE_P_H
 #define QTPOKIT_ABSTRACTPOKITSERVICE_P_H
 
-#include <qtpokit/qtpokit_global.h>
+#include <qtpokit/abstractpokitservice.h>
 
+#include <QElapsedTimer>
 #include <QLoggingCategory>
 #include <QLowEnergyService>
 #include <QObject>
@@ -19,8 +20,6 @@ class QLowEnergyController;
 
 QTPOKIT_BEGIN_NAMESPACE
 
-class AbstractPokitService;
-
 class QTPOKIT_EXPORT AbstractPokitServicePrivate : public QObject
 {
     Q_OBJECT
@@ -29,16 +28,27 @@ public:
     static Q_LOGGING_CATEGORY(lc, "pokit.ble.service", QtInfoMsg); ///< Logging category.
 
     bool autoDiscover;                 ///< Whether autodiscovery is enabled or not.
+    bool skipValueDiscovery;           ///< Whether to skip reading values during autodiscovery.
     QLowEnergyController * controller; ///< BLE controller to fetch the service from.
     QLowEnergyService * service;       ///< BLE service to read/write characteristics.
     QBluetoothUuid serviceUuid;        ///< UUIDs for #service.
 
+    bool statisticsEnabled;                         ///< Whether to record #statistics.
+    QElapsedTimer statisticsTimer;                  ///< Monotonic clock for #statistics.
+    AbstractPokitService::Statistics statistics;    ///< Per-characteristic statistics.
+    QHash<QBluetoothUuid, qint64> pendingReads;     ///< Read request times, by characteristic.
+    QHash<QBluetoothUuid, qint64> pendingWrites;    ///< Write request times, by characteristic.
+    QHash<QBluetoothUuid, qint64> lastNotified;     ///< Last notification times, by characteristic.
+
     AbstractPokitServicePrivate(const QBluetoothUuid &serviceUuid,
         QLowEnergyController * controller, AbstractPokitService * const q);
 
     bool createServiceObject();
     QLowEnergyCharacteristic getCharacteristic(const QBluetoothUuid &uuid) const;
     bool readCharacteristic(const QBluetoothUuid &uuid);
+    void writeCharacteristic(const QLowEnergyCharacteristic &characteristic,
+                             const QByteArray &newValue);
+    void dispatchNotification(const QBluetoothUuid &uuid, const QByteArray &newValue);
 
     bool enableCharacteristicNotificatons(const QBluetoothUuid &uuid);
     bool disableCharacteristicNotificatons(const QBluetoothUuid &uuid);
@@ -52,6 +62,7 @@ protected:
 
 protected slots:
     void connected();
+    bool discoverServiceDetails();
     void discoveryFinished();
     void errorOccurred(const QLowEnergyService::ServiceError newError);
     virtual void serviceDiscovered(const QBluetoothUuid &newService);
@@ -64,9 +75,13 @@ protected slots:
     virtual void characteristicChanged(const QLowEnergyCharacteristic &characteristic,
                                        const QByteArray &newValue);
 
+protected:
+    virtual void characteristicNotified(const QBluetoothUuid &uuid, const QByteArray &newValue);
+
 private:
     Q_DECLARE_PUBLIC(AbstractPokitService)
     Q_DISABLE_COPY(AbstractPokitServicePrivate)
+    friend class PokitSimulatorPrivate;
     friend class TestAbstractPokitService;
 };
 
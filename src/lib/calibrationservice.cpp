@@ -80,7 +80,7 @@ bool CalibrationService::readCharacteristics()
 bool CalibrationService::calibrateTemperature(const float ambientTemperature)
 {
     static_assert(sizeof(float) == 4, "Pokit devices expect 32-bit floats");
-    Q_D(const CalibrationService);
+    Q_D(CalibrationService);
     const QLowEnergyCharacteristic characteristic =
         d->getCharacteristic(CharacteristicUuids::temperature);
     if (!characteristic.isValid()) {
@@ -90,7 +90,7 @@ bool CalibrationService::calibrateTemperature(const float ambientTemperature)
     const QByteArray newValue = d->encodeTemperature(ambientTemperature);
     qCDebug(d->lc).noquote() << tr("Writing new temperature %1 (0x%2).")
         .arg(ambientTemperature).arg(QLatin1String(newValue.toHex()));
-    d->service->writeCharacteristic(characteristic, newValue);
+    d->writeCharacteristic(characteristic, newValue);
     return (d->service->error() != QLowEnergyService::ServiceError::CharacteristicWriteError);
 }
 
@@ -0,0 +1,505 @@
+// SPDX-FileCopyrightText: 2022 Paul Colby <git@colby.id.au>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+/*!
+ * \file
+ * Defines the CaptureArchive and CaptureArchivePrivate classes.
+ */
+
+#include <qtpokit/capturearchive.h>
+#include "capturearchive_p.h"
+
+#include <QtEndian>
+
+#include <algorithm>
+#include <cstring>
+
+/*!
+ * \class CaptureArchive
+ *
+ * The CaptureArchive class provides an append-only, memory-mappable, on-disk store of DSO and data
+ * logger captures.
+ *
+ * An archive consists of two files:
+ *
+ * * a segment file (fileName()) holding, for each capture, a fixed-layout Record followed by the
+ *   capture's raw signed 16-bit samples, padded to an 8-byte boundary; and
+ * * an index file (indexFileName()) holding one fixed-layout IndexEntry (offset, timestamp, and
+ *   sample count) per capture.
+ *
+ * Both files begin with an 8-byte header: a 4-byte magic (`QTPS` and `QTPI` respectively) followed
+ * by a 32-bit format version. All values are stored in little-endian byte order, exactly as laid
+ * out by the Record and IndexEntry structs, so once open() has memory-mapped the files, record()
+ * and samples() return pointers directly into the mapped data, without any parsing or copying.
+ *
+ * The segment file is always written (and flushed) before the index file, so an interrupted append
+ * never leaves an index entry referring to an incomplete record.
+ *
+ * \note Since the on-disk layout matches the in-memory layout of little-endian hosts only, archives
+ * cannot be opened on big-endian hosts.
+ */
+
+/// \enum CaptureArchive::Source
+/// \brief Services that archived captures may come from.
+
+/// \struct CaptureArchive::Record
+/// \brief Fixed-layout header preceding each capture's samples in the segment file.
+
+/// \struct CaptureArchive::IndexEntry
+/// \brief Fixed-layout entry locating one capture within the segment file.
+
+/*!
+ * Constructs a new capture archive backed by the segment file \a fileName (and a `.idx` index
+ * file alongside it), with \a parent. The archive must be open()'ed before use.
+ */
+CaptureArchive::CaptureArchive(const QString &fileName, QObject * const parent)
+    : QObject(parent), d_ptr(new CaptureArchivePrivate(fileName, this))
+{
+
+}
+
+/*!
+ * \cond internal
+ * Constructs a new capture archive with \a parent, and private implementation \a d.
+ */
+CaptureArchive::CaptureArchive(CaptureArchivePrivate * const d, QObject * const parent)
+    : QObject(parent), d_ptr(d)
+{
+
+}
+/// \endcond
+
+/*!
+ * Destroys this CaptureArchive object, closing the archive first if need be.
+ */
+CaptureArchive::~CaptureArchive()
+{
+    close();
+    delete d_ptr;
+}
+
+/*!
+ * Returns the name of the archive's segment file.
+ */
+QString CaptureArchive::fileName() const
+{
+    Q_D(const CaptureArchive);
+    return d->segment.fileName();
+}
+
+/*!
+ * Returns the name of the archive's index file.
+ */
+QString CaptureArchive::indexFileName() const
+{
+    Q_D(const CaptureArchive);
+    return d->indexFile.fileName();
+}
+
+/*!
+ * Opens the archive according to \a mode, returning `true` on success, `false` otherwise.
+ *
+ * If \a mode includes QIODevice::WriteOnly, then the archive files are created if they do not
+ * already exist, and new captures may be append()'ed. Otherwise the archive is opened read-only,
+ * and reflects the captures present at the time it was opened.
+ */
+bool CaptureArchive::open(const QIODevice::OpenMode mode)
+{
+    Q_D(CaptureArchive);
+    if (isOpen()) {
+        qCWarning(d->lc).noquote() << tr("Capture archive is already open:") << fileName();
+        return false;
+    }
+
+    #if (Q_BYTE_ORDER != Q_LITTLE_ENDIAN)
+    qCWarning(d->lc).noquote() << tr("Capture archives are not supported on big-endian hosts.");
+    return false;
+    #endif
+
+    const QIODevice::OpenMode fileMode = (mode & QIODevice::WriteOnly)
+        ? (QIODevice::ReadWrite|QIODevice::Append) : QIODevice::ReadOnly;
+    if ((!d->openFile(d->segment, "QTPS", fileMode)) ||
+        (!d->openFile(d->indexFile, "QTPI", fileMode)) ||
+        ((d->segment.isWritable()) && (!d->trimSegment())) || (!d->map())) {
+        close();
+        return false;
+    }
+    qCDebug(d->lc).noquote() << tr("Opened capture archive %1 with %L2 capture(s).")
+        .arg(fileName()).arg(count());
+    return true;
+}
+
+/*!
+ * Closes the archive, unmapping any mapped memory. Any pointers previously returned by index(),
+ * record() or samples() are no longer valid once the archive is closed.
+ */
+void CaptureArchive::close()
+{
+    Q_D(CaptureArchive);
+    d->unmap();
+    d->segment.close();
+    d->indexFile.close();
+}
+
+/*!
+ * Returns `true` if the archive is open, `false` otherwise.
+ */
+bool CaptureArchive::isOpen() const
+{
+    Q_D(const CaptureArchive);
+    return d->segment.isOpen();
+}
+
+/*!
+ * Returns `true` if the archive is open for appending captures, `false` otherwise.
+ */
+bool CaptureArchive::isWritable() const
+{
+    Q_D(const CaptureArchive);
+    return d->segment.isWritable();
+}
+
+/*!
+ * Appends a DSO capture, described by \a metadata, with raw \a samples to the archive. If
+ * \a timestamp is not valid, then the current time is used, since DSO metadata does not include
+ * a timestamp.
+ *
+ * Returns `true` if the capture was successfully written, `false` otherwise.
+ */
+bool CaptureArchive::append(const DsoService::Metadata &metadata,
+                            const DsoService::Samples &samples, const QDateTime &timestamp)
+{
+    Q_D(CaptureArchive);
+    return d->append({ { }, Source::Dso, (quint8)metadata.status, (quint8)metadata.mode,
+        (quint8)metadata.range.voltageRange, metadata.scale, metadata.samplingWindow,
+        metadata.samplingRate, 0, (timestamp.isValid() ? timestamp
+            : QDateTime::currentDateTimeUtc()).toMSecsSinceEpoch() }, samples);
+}
+
+/*!
+ * Appends a data logger capture, described by \a metadata, with raw \a samples to the archive. If
+ * \a timestamp is not valid, then the metadata's own timestamp is used, or the current time if the
+ * logger did not record one.
+ *
+ * Returns `true` if the capture was successfully written, `false` otherwise.
+ */
+bool CaptureArchive::append(const DataLoggerService::Metadata &metadata,
+                            const DataLoggerService::Samples &samples, const QDateTime &timestamp)
+{
+    Q_D(CaptureArchive);
+    const qint64 msecs = timestamp.isValid() ? timestamp.toMSecsSinceEpoch()
+        : (metadata.timestamp != 0) ? (qint64)metadata.timestamp * (qint64)1000
+        : QDateTime::currentMSecsSinceEpoch();
+    return d->append({ { }, Source::DataLogger, (quint8)metadata.status, (quint8)metadata.mode,
+        (quint8)metadata.range.voltageRange, metadata.scale, metadata.updateInterval, 0, 0, msecs },
+        samples);
+}
+
+/*!
+ * Returns the number of captures in the archive.
+ */
+int CaptureArchive::count() const
+{
+    Q_D(const CaptureArchive);
+    return d->count();
+}
+
+/*!
+ * Returns a pointer to the archive's memory-mapped index of count() entries, or `nullptr` if the
+ * archive is not open.
+ *
+ * The returned pointer remains valid until the archive is closed, or next appended to.
+ */
+const CaptureArchive::IndexEntry * CaptureArchive::index() const
+{
+    Q_D(const CaptureArchive);
+    return d->entries();
+}
+
+/*!
+ * Returns a pointer to the memory-mapped Record of the capture at \a index, or `nullptr` if
+ * \a index is out of range, or the archive is corrupt.
+ *
+ * The returned pointer remains valid until the archive is closed, or next appended to.
+ */
+const CaptureArchive::Record * CaptureArchive::record(const int index) const
+{
+    Q_D(const CaptureArchive);
+    if ((index < 0) || (index >= d->count())) {
+        return nullptr;
+    }
+    const IndexEntry &entry = d->entries()[index];
+    if ((entry.offset < d->fileHeaderSize) || (entry.offset % 8 != 0) ||
+        (entry.offset + d->paddedSize(entry.numberOfSamples) > d->segmentSize))
+    {
+        qCWarning(d->lc).noquote() << tr("Capture %1 is outside of segment file.").arg(index);
+        return nullptr;
+    }
+    const Record * const record = reinterpret_cast<const Record *>(d->segmentData + entry.offset);
+    if ((std::memcmp(record->magic, "QTPR", sizeof(record->magic)) != 0) ||
+        (record->numberOfSamples != entry.numberOfSamples))
+    {
+        qCWarning(d->lc).noquote() << tr("Capture %1 does not match its index entry.").arg(index);
+        return nullptr;
+    }
+    return record;
+}
+
+/*!
+ * Returns a pointer to the memory-mapped raw samples of the capture at \a index, or `nullptr` if
+ * \a index is out of range, or the archive is corrupt. The capture's record() gives the number of
+ * samples, and the scale to apply to them.
+ *
+ * The returned pointer remains valid until the archive is closed, or next appended to.
+ */
+const qint16 * CaptureArchive::samples(const int index) const
+{
+    const Record * const record = this->record(index);
+    return (record == nullptr) ? nullptr : reinterpret_cast<const qint16 *>(record + 1);
+}
+
+/*!
+ * Returns the index of the first capture at or after \a timestamp, or `-1` if there is no such
+ * capture. This is a binary search of the index, so assumes captures were appended in chronological
+ * order.
+ */
+int CaptureArchive::find(const QDateTime &timestamp) const
+{
+    Q_D(const CaptureArchive);
+    const IndexEntry * const begin = d->entries();
+    if (begin == nullptr) {
+        return -1;
+    }
+    const IndexEntry * const end = begin + d->count();
+    const IndexEntry * const iter = std::lower_bound(begin, end, timestamp.toMSecsSinceEpoch(),
+        [](const IndexEntry &entry, const qint64 msecs) { return entry.timestamp < msecs; });
+    return (iter == end) ? -1 : (int)(iter - begin);
+}
+
+/*!
+ * \cond internal
+ * \class CaptureArchivePrivate
+ *
+ * The CaptureArchivePrivate class provides private implementation for CaptureArchive.
+ */
+
+/*!
+ * Constructs a new CaptureArchivePrivate object for the segment file \a fileName, with public
+ * implementation \a q.
+ */
+CaptureArchivePrivate::CaptureArchivePrivate(const QString &fileName, CaptureArchive * const q)
+    : segment(fileName), indexFile(fileName + QLatin1String(".idx")), segmentData(nullptr),
+      segmentSize(0), indexData(nullptr), indexSize(0), stale(false), q_ptr(q)
+{
+    static_assert(sizeof(CaptureArchive::Record)     == 32, "Expected to be 32 bytes.");
+    static_assert(sizeof(CaptureArchive::IndexEntry) == 24, "Expected to be 24 bytes.");
+}
+
+/*!
+ * Opens \a file with \a mode, then writes (if the file is new) or verifies the file's header,
+ * consisting of \a magic and #formatVersion.
+ *
+ * Returns `true` on success, `false` otherwise.
+ */
+bool CaptureArchivePrivate::openFile(QFile &file, const char * const magic,
+                                     const QIODevice::OpenMode mode)
+{
+    if (!file.open(mode)) {
+        qCWarning(lc).noquote() << tr("Failed to open %1: %2")
+            .arg(file.fileName(), file.errorString());
+        return false;
+    }
+
+    char header[fileHeaderSize];
+    if ((file.size() == 0) && (file.isWritable())) {
+        std::memcpy(header, magic, 4);
+        qToLittleEndian<quint32>(formatVersion, header + 4);
+        if ((file.write(header, sizeof(header)) != sizeof(header)) || (!file.flush())) {
+            qCWarning(lc).noquote() << tr("Failed to write %1: %2")
+                .arg(file.fileName(), file.errorString());
+            return false;
+        }
+        return true;
+    }
+
+    if ((!file.seek(0)) || (file.read(header, sizeof(header)) != sizeof(header)) ||
+        (std::memcmp(header, magic, 4) != 0))
+    {
+        qCWarning(lc).noquote() << tr("Not a capture archive file:") << file.fileName();
+        return false;
+    }
+    const quint32 version = qFromLittleEndian<quint32>(header + 4);
+    if (version != formatVersion) {
+        qCWarning(lc).noquote() << tr("Unsupported capture archive version %1 in %2")
+            .arg(version).arg(file.fileName());
+        return false;
+    }
+
+    // Drop any trailing partial index entry, such as may be left by an interrupted append.
+    if ((file.isWritable()) && (&file == &indexFile)) {
+        const qint64 excess = (file.size() - fileHeaderSize) % sizeof(CaptureArchive::IndexEntry);
+        if (excess != 0) {
+            qCWarning(lc).noquote() << tr("Discarding %1 trailing byte(s) from %2")
+                .arg(excess).arg(file.fileName());
+            file.resize(file.size() - excess);
+        }
+    }
+    return (!file.isWritable()) || file.seek(file.size());
+}
+
+/*!
+ * Truncates the (writable) segment file to the padded end of the last indexed record, or to just
+ * its header if the index is empty. This discards any orphaned record bytes, such as may be left
+ * by an append that was interrupted before its index entry was written, which would otherwise
+ * leave the next appended record at an unaligned offset.
+ *
+ * Returns `true` on success, `false` otherwise.
+ */
+bool CaptureArchivePrivate::trimSegment()
+{
+    qint64 end = fileHeaderSize;
+    if (indexFile.size() > fileHeaderSize) {
+        CaptureArchive::IndexEntry entry;
+        char * const entryData = reinterpret_cast<char *>(&entry);
+        if ((!indexFile.seek(indexFile.size() - (qint64)sizeof(entry))) ||
+            (indexFile.read(entryData, sizeof(entry)) != sizeof(entry)) ||
+            (!indexFile.seek(indexFile.size())))
+        {
+            qCWarning(lc).noquote() << tr("Failed to read %1: %2")
+                .arg(indexFile.fileName(), indexFile.errorString());
+            return false;
+        }
+        end = entry.offset + paddedSize(entry.numberOfSamples);
+    }
+
+    const qint64 excess = segment.size() - end;
+    if (excess > 0) {
+        qCWarning(lc).noquote() << tr("Discarding %1 trailing byte(s) from %2")
+            .arg(excess).arg(segment.fileName());
+        if ((!segment.resize(end)) || (!segment.seek(end))) {
+            qCWarning(lc).noquote() << tr("Failed to truncate %1: %2")
+                .arg(segment.fileName(), segment.errorString());
+            return false;
+        }
+    }
+    return true;
+}
+
+/*!
+ * Memory-maps the segment and index files, if not already mapped, or if #stale.
+ *
+ * Returns `true` on success, `false` otherwise.
+ */
+bool CaptureArchivePrivate::map() const
+{
+    if ((!stale) && (segmentData != nullptr) && (indexData != nullptr)) {
+        return true;
+    }
+    if (!segment.isOpen()) {
+        return false;
+    }
+    unmap();
+    const auto mapFile = [](QFile &file, uchar * &data, qint64 &size) {
+        size = file.size();
+        data = file.map(0, size);
+        if (data == nullptr) {
+            size = 0;
+            qCWarning(lc).noquote() << tr("Failed to map %1: %2")
+                .arg(file.fileName(), file.errorString());
+        }
+        return (data != nullptr);
+    };
+    auto * const self = const_cast<CaptureArchivePrivate *>(this);
+    stale = false;
+    return mapFile(self->segment, segmentData, segmentSize)
+        && mapFile(self->indexFile, indexData, indexSize);
+}
+
+/*!
+ * Unmaps the segment and index files, if mapped.
+ */
+void CaptureArchivePrivate::unmap() const
+{
+    auto * const self = const_cast<CaptureArchivePrivate *>(this);
+    if (segmentData != nullptr) {
+        self->segment.unmap(segmentData);
+        segmentData = nullptr;
+        segmentSize = 0;
+    }
+    if (indexData != nullptr) {
+        self->indexFile.unmap(indexData);
+        indexData = nullptr;
+        indexSize = 0;
+    }
+}
+
+/*!
+ * Appends \a record, followed by \a samples, to the segment file, then a corresponding entry to the
+ * index file. The \a record's magic and number of samples are set here.
+ *
+ * Returns `true` on success, `false` otherwise (in which case both files are restored to their
+ * previous sizes).
+ */
+bool CaptureArchivePrivate::append(CaptureArchive::Record record, const QVector<qint16> &samples)
+{
+    if (!segment.isWritable()) {
+        qCWarning(lc).noquote() << tr("Capture archive is not open for writing.");
+        return false;
+    }
+
+    std::memcpy(record.magic, "QTPR", sizeof(record.magic));
+    record.numberOfSamples = static_cast<quint32>(samples.size());
+    const qint64 samplesSize = samples.size() * (qint64)sizeof(qint16);
+    const qint64 paddingSize = paddedSize(record.numberOfSamples) - sizeof(record) - samplesSize;
+    static const char padding[8] = { };
+
+    const qint64 segmentOffset = segment.size(), indexOffset = indexFile.size();
+    const CaptureArchive::IndexEntry entry{ segmentOffset, record.timestamp,
+        record.numberOfSamples, record.source, { } };
+    const char * const recordData = reinterpret_cast<const char *>(&record);
+    const char * const samplesData = reinterpret_cast<const char *>(samples.constData());
+    if ((segment.write(recordData, sizeof(record)) != sizeof(record)) ||
+        (segment.write(samplesData, samplesSize) != samplesSize) ||
+        (segment.write(padding, paddingSize) != paddingSize) || (!segment.flush()) ||
+        (indexFile.write(reinterpret_cast<const char *>(&entry), sizeof(entry)) != sizeof(entry)) ||
+        (!indexFile.flush()))
+    {
+        qCWarning(lc).noquote() << tr("Failed to append capture: %1").arg((segment.error()
+            != QFileDevice::NoError) ? segment.errorString() : indexFile.errorString());
+        unmap();
+        indexFile.resize(indexOffset);
+        segment.resize(segmentOffset);
+        return false;
+    }
+    stale = true; // So map() will re-map the larger files when next needed.
+    return true;
+}
+
+/*!
+ * Returns a pointer to the first mapped index entry, or `nullptr` if the archive is not open.
+ */
+const CaptureArchive::IndexEntry * CaptureArchivePrivate::entries() const
+{
+    return map() ? reinterpret_cast<const CaptureArchive::IndexEntry *>(indexData + fileHeaderSize)
+        : nullptr;
+}
+
+/*!
+ * Returns the number of complete entries in the mapped index file.
+ */
+int CaptureArchivePrivate::count() const
+{
+    return map() ? (int)((indexSize - fileHeaderSize) / sizeof(CaptureArchive::IndexEntry)) : 0;
+}
+
+/*!
+ * Returns the number of segment file bytes occupied by a record of \a numberOfSamples samples,
+ * including padding to the next 8-byte boundary.
+ */
+qint64 CaptureArchivePrivate::paddedSize(const quint32 numberOfSamples)
+{
+    return ((qint64)sizeof(CaptureArchive::Record) + numberOfSamples * (qint64)sizeof(qint16) + 7)
+        & ~(qint64)7;
+}
+
+/// \endcond
@@ -0,0 +1,63 @@
+// SPDX-FileCopyrightText: 2022 Paul Colby <git@colby.id.au>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+/*!
+ * \file
+ * Declares the CaptureArchivePrivate class.
+ */
+
+#ifndef QTPOKIT_CAPTUREARCHIVE_P_H
+#define QTPOKIT_CAPTUREARCHIVE_P_H
+
+#include <qtpokit/capturearchive.h>
+
+#include <QFile>
+#include <QLoggingCategory>
+#include <QObject>
+#include <QVector>
+
+QTPOKIT_BEGIN_NAMESPACE
+
+class QTPOKIT_EXPORT CaptureArchivePrivate : public QObject
+{
+    Q_OBJECT
+
+public:
+    static Q_LOGGING_CATEGORY(lc, "pokit.capture.archive", QtInfoMsg); ///< Logging category.
+
+    static const int fileHeaderSize = 8; ///< Size of the segment and index file headers.
+    static const quint32 formatVersion = 1; ///< Version written to, and expected in, file headers.
+
+    QFile segment;                  ///< Segment file holding the capture records and samples.
+    QFile indexFile;                ///< Index file holding one IndexEntry per capture.
+    mutable uchar * segmentData;    ///< Memory-mapped segment file, or `nullptr` if not mapped.
+    mutable qint64 segmentSize;     ///< Number of bytes of #segment currently mapped.
+    mutable uchar * indexData;      ///< Memory-mapped index file, or `nullptr` if not mapped.
+    mutable qint64 indexSize;       ///< Number of bytes of #indexFile currently mapped.
+    mutable bool stale;             ///< Whether the files have grown since they were last mapped.
+
+    CaptureArchivePrivate(const QString &fileName, CaptureArchive * const q);
+
+    bool openFile(QFile &file, const char * const magic, const QIODevice::OpenMode mode);
+    bool trimSegment();
+    bool map() const;
+    void unmap() const;
+
+    bool append(CaptureArchive::Record record, const QVector<qint16> &samples);
+    const CaptureArchive::IndexEntry * entries() const;
+    int count() const;
+
+    static qint64 paddedSize(const quint32 numberOfSamples);
+
+protected:
+    CaptureArchive * q_ptr; ///< Internal q-pointer.
+
+private:
+    Q_DECLARE_PUBLIC(CaptureArchive)
+    Q_DISABLE_COPY(CaptureArchivePrivate)
+    friend class TestCaptureArchive;
+};
+
+QTPOKIT_END_NAMESPACE
+
+#endif // QTPOKIT_CAPTUREARCHIVE_P_H
@@ -7,13 +7,16 @@
  */
 
 #include <qtpokit/dataloggerservice.h>
+#include <qtpokit/pokitranges.h>
 #include "dataloggerservice_p.h"
+#include "sampledecoder_p.h"
 
 #include <qtpokit/statusservice.h>
 
 #include <QDataStream>
 #include <QIODevice>
 #include <QLowEnergyController>
+#include <QMetaMethod>
 #include <QtEndian>
 
 /*!
@@ -67,15 +70,7 @@ QString DataLoggerService::toString(const Mode &mode)
 /// Returns \a range as a user-friendly string.
 QString DataLoggerService::toString(const VoltageRange &range)
 {
-    switch (range) {
-    case VoltageRange::_0_to_300mV:  return tr("0 to 300mV");
-    case VoltageRange::_300mV_to_2V: return tr("300mV to 2V");
-    case VoltageRange::_2V_to_6V:    return tr("2V to 6V");
-    case VoltageRange::_6V_to_12V:   return tr("6V to 12V");
-    case VoltageRange::_12V_to_30V:  return tr("12V to 30V");
-    case VoltageRange::_30V_to_60V:  return tr("30V to 60V");
-    default:                         return QString();
-    }
+    return PokitRanges::label(PokitRanges::Quantity::Voltage, (quint8)range);
 }
 
 /*!
@@ -89,15 +84,7 @@ QString DataLoggerService::toString(const VoltageRange &range)
  */
 QVariant DataLoggerService::minValue(const VoltageRange &range)
 {
-    switch (range) {
-    case VoltageRange::_0_to_300mV:  return     0;
-    case VoltageRange::_300mV_to_2V: return   300;
-    case VoltageRange::_2V_to_6V:    return  2000;
-    case VoltageRange::_6V_to_12V:   return  6000;
-    case VoltageRange::_12V_to_30V:  return 12000;
-    case VoltageRange::_30V_to_60V:  return 30000;
-    default:                         return QVariant();
-    }
+    return PokitRanges::minValue(PokitRanges::Quantity::Voltage, (quint8)range);
 }
 
 /*!
@@ -106,15 +93,7 @@ QVariant DataLoggerService::minValue(const VoltageRange &range)
  */
 QVariant DataLoggerService::maxValue(const VoltageRange &range)
 {
-    switch (range) {
-    case VoltageRange::_0_to_300mV:  return   300;
-    case VoltageRange::_300mV_to_2V: return  2000;
-    case VoltageRange::_2V_to_6V:    return  6000;
-    case VoltageRange::_6V_to_12V:   return 12000;
-    case VoltageRange::_12V_to_30V:  return 30000;
-    case VoltageRange::_30V_to_60V:  return 60000;
-    default:                         return QVariant();
-    }
+    return PokitRanges::maxValue(PokitRanges::Quantity::Voltage, (quint8)range);
 }
 
 /// \enum DataLoggerService::CurrentRange
@@ -124,14 +103,7 @@ QVariant DataLoggerService::maxValue(const VoltageRange &range)
 /// Returns \a range as a user-friendly string.
 QString DataLoggerService::toString(const CurrentRange &range)
 {
-    switch (range) {
-    case CurrentRange::_0_to_10mA:      return tr("0 to 10mA");
-    case CurrentRange::_10mA_to_30mA:   return tr("10mA to 30mA");
-    case CurrentRange::_30mA_to_150mA:  return tr("30mA to 150mA");
-    case CurrentRange::_150mA_to_300mA: return tr("150mA to 300mA");
-    case CurrentRange::_300mA_to_3A:    return tr("300mA to 3A");
-    default:                            return QString();
-    }
+    return PokitRanges::label(PokitRanges::Quantity::Current, (quint8)range);
 }
 
 /*!
@@ -145,14 +117,7 @@ QString DataLoggerService::toString(const CurrentRange &range)
  */
 QVariant DataLoggerService::minValue(const CurrentRange &range)
 {
-    switch (range) {
-    case CurrentRange::_0_to_10mA:      return   0;
-    case CurrentRange::_10mA_to_30mA:   return  10;
-    case CurrentRange::_30mA_to_150mA:  return  30;
-    case CurrentRange::_150mA_to_300mA: return 150;
-    case CurrentRange::_300mA_to_3A:    return 300;
-    default:                            return QVariant();
-    }
+    return PokitRanges::minValue(PokitRanges::Quantity::Current, (quint8)range);
 }
 
 /*!
@@ -161,14 +126,7 @@ QVariant DataLoggerService::minValue(const CurrentRange &range)
  */
 QVariant DataLoggerService::maxValue(const CurrentRange &range)
 {
-    switch (range) {
-    case CurrentRange::_0_to_10mA:      return   10;
-    case CurrentRange::_10mA_to_30mA:   return   30;
-    case CurrentRange::_30mA_to_150mA:  return  150;
-    case CurrentRange::_150mA_to_300mA: return  300;
-    case CurrentRange::_300mA_to_3A:    return 3000;
-    default:                            return QVariant();
-    }
+    return PokitRanges::maxValue(PokitRanges::Quantity::Current, (quint8)range);
 }
 
 /// \union DataLoggerService::Range
@@ -198,6 +156,9 @@ QString DataLoggerService::toString(const Range &range, const Mode &mode)
 /// \struct DataLoggerService::Metadata
 /// \brief Attributes included in the `Metadata` characterstic.
 
+/// \struct DataLoggerService::CoalescingSettings
+/// \brief Settings for coalescing `Reading` notifications into fewer samplesRead() signals.
+
 /*!
  * \typedef DataLoggerService::Samples
  *
@@ -269,7 +230,7 @@ bool DataLoggerService::readMetadataCharacteristic()
  */
 bool DataLoggerService::setSettings(const Settings &settings)
 {
-    Q_D(const DataLoggerService);
+    Q_D(DataLoggerService);
     const QLowEnergyCharacteristic characteristic =
         d->getCharacteristic(CharacteristicUuids::settings);
     if (!characteristic.isValid()) {
@@ -283,7 +244,7 @@ bool DataLoggerService::setSettings(const Settings &settings)
         return false;
     }
 
-    d->service->writeCharacteristic(characteristic, value);
+    d->writeCharacteristic(characteristic, value);
     return (d->service->error() != QLowEnergyService::ServiceError::CharacteristicWriteError);
 }
 
@@ -420,6 +381,37 @@ bool DataLoggerService::disableReadingNotifications()
     return d->disableCharacteristicNotificatons(CharacteristicUuids::reading);
 }
 
+/*!
+ * Returns the current sample coalescing settings.
+ *
+ * \see setCoalescingSettings
+ */
+DataLoggerService::CoalescingSettings DataLoggerService::coalescingSettings() const
+{
+    Q_D(const DataLoggerService);
+    return { d->coalescer.isEnabled(), d->coalescer.chunkSize(), d->coalescer.maxLatency() };
+}
+
+/*!
+ * Sets the sample coalescing \a settings.
+ *
+ * By default, samplesRead() and scaledSamplesRead() are emitted once per `Reading` notification,
+ * which (with the default MTU) carries just 10 samples. When coalescing is enabled, decoded samples
+ * are instead accumulated into one buffer, preallocated from the `Metadata::numberOfSamples` of the
+ * most recently read metadata, and emitted once per capture, once per
+ * CoalescingSettings::chunkSize samples, or once CoalescingSettings::maxLatency milliseconds have
+ * passed since the first sample was held, whichever comes first.
+ *
+ * Disabling coalescing emits any samples held at the time.
+ */
+void DataLoggerService::setCoalescingSettings(const CoalescingSettings &settings)
+{
+    Q_D(DataLoggerService);
+    d->coalescer.setChunkSize(settings.chunkSize);
+    d->coalescer.setMaxLatency(settings.maxLatency);
+    d->coalescer.setEnabled(settings.enabled);
+}
+
 /*!
  * \fn DataLoggerService::settingsWritten
  *
@@ -445,6 +437,20 @@ bool DataLoggerService::disableReadingNotifications()
  * \see stopSampling
  */
 
+/*!
+ * \fn DataLoggerService::scaledSamplesRead
+ *
+ * This signal is emitted when the `Reading` characteristic has been notified, with each sample
+ * already multiplied by the `Metadata::scale` of the most recently read metadata.
+ *
+ * The scaling is performed in bulk within the library, using the host CPU's SIMD instructions where
+ * available, so this is generally a cheaper alternative to scaling samplesRead() values one by one.
+ * Samples are only decoded for the signals that have at least one connected receiver, so there is no
+ * cost in not using one of samplesRead() or scaledSamplesRead().
+ *
+ * If no metadata has been read yet, then the scale is unknown, and so all values will be NaN.
+ */
+
 
 /*!
  * \cond internal
@@ -459,9 +465,11 @@ bool DataLoggerService::disableReadingNotifications()
  */
 DataLoggerServicePrivate::DataLoggerServicePrivate(
     QLowEnergyController * controller, DataLoggerService * const q)
-    : AbstractPokitServicePrivate(DataLoggerService::serviceUuid, controller, q)
+    : AbstractPokitServicePrivate(DataLoggerService::serviceUuid, controller, q),
+      scale(std::numeric_limits<float>::quiet_NaN()), coalescer(this)
 {
-
+    connect(&coalescer, &SampleCoalescer::samplesReady,
+            this, &DataLoggerServicePrivate::samplesCoalesced);
 }
 
 /*!
@@ -560,14 +568,117 @@ DataLoggerService::Samples DataLoggerServicePrivate::parseSamples(const QByteArr
             .arg(value.size()).arg(toHexString(value));
         return samples;
     }
-    for (; (samples.size()*2) < value.size();) {
-        samples.append(qFromLittleEndian<qint16>(value.mid(samples.size()*2,2)));
-    }
+    samples.resize(value.size()/2);
+    parseSamples(value, samples.data(), samples.size());
     qCDebug(lc).noquote() << tr("Read %1 samples from %2-bytes.")
         .arg(samples.size()).arg(value.size());
     return samples;
 }
 
+/*!
+ * Parses the `Reading` \a value directly into the caller-owned \a samples buffer, which must have
+ * room for at least \a maxSamples samples.
+ *
+ * This overload performs no heap allocations, so is suitable for callers that accumulate samples
+ * into a buffer of their own.
+ *
+ * Returns the number of samples written to \a samples, which will be less than the number of samples
+ * in \a value if \a maxSamples is too small. Returns `-1` if \a value has an odd size (and so does
+ * not contain a whole number of samples), in which case \a samples is left untouched.
+ */
+int DataLoggerServicePrivate::parseSamples(const QByteArray &value, qint16 * const samples,
+                                           const int maxSamples)
+{
+    if ((value.size()%2) != 0) {
+        qCWarning(lc).noquote() << tr("Samples value has odd size %1 (should be even): %2")
+            .arg(value.size()).arg(toHexString(value));
+        return -1;
+    }
+    const int count = qMin(value.size()/2, maxSamples);
+    if (count < value.size()/2) {
+        qCWarning(lc).noquote() << tr("Samples buffer too small; discarding %1 of %2 samples.")
+            .arg(value.size()/2-count).arg(value.size()/2);
+    }
+    return SampleDecoder::decode(value, samples, count);
+}
+
+/*!
+ * Parses the `Reading` \a value into a DataLoggerService::ScaledSamples vector, multiplying each
+ * sample by \a scale.
+ */
+DataLoggerService::ScaledSamples DataLoggerServicePrivate::parseScaledSamples(const QByteArray &value,
+                                                                              const float scale)
+{
+    DataLoggerService::ScaledSamples samples;
+    if ((value.size()%2) != 0) {
+        qCWarning(lc).noquote() << tr("Samples value has odd size %1 (should be even): %2")
+            .arg(value.size()).arg(toHexString(value));
+        return samples;
+    }
+    samples.resize(value.size()/2);
+    SampleDecoder::decode(value, scale, samples.data(), samples.size());
+    qCDebug(lc).noquote() << tr("Read %1 scaled samples from %2-bytes.")
+        .arg(samples.size()).arg(value.size());
+    return samples;
+}
+
+/*!
+ * Parses the `Metadata` \a value, records its scale for subsequent samples, begins a new coalesced
+ * capture (if coalescing is enabled), and emits it via the DataLoggerService::metadataRead signal.
+ */
+void DataLoggerServicePrivate::processMetadata(const QByteArray &value)
+{
+    Q_Q(DataLoggerService);
+    const DataLoggerService::Metadata metadata = parseMetadata(value);
+    if (coalescer.isEnabled()) {
+        coalescer.beginCapture(metadata.numberOfSamples); // Flushes any held samples first.
+    }
+    scale = metadata.scale;
+    emit q->metadataRead(metadata);
+}
+
+/*!
+ * Parses the `Reading` \a value, and emits the results via the DataLoggerService::samplesRead and/or
+ * DataLoggerService::scaledSamplesRead signals. Parsing is skipped for either signal that has no
+ * receivers connected. If coalescing is enabled, the samples are instead held by #coalescer, until
+ * samplesCoalesced() emits them.
+ */
+void DataLoggerServicePrivate::processSamples(const QByteArray &value)
+{
+    Q_Q(DataLoggerService);
+    if (coalescer.isEnabled()) {
+        if (!coalescer.append(value)) {
+            qCWarning(lc).noquote() << tr("Samples value has odd size %1 (should be even): %2")
+                .arg(value.size()).arg(toHexString(value));
+        }
+        return;
+    }
+    if (q->isSignalConnected(QMetaMethod::fromSignal(&DataLoggerService::samplesRead))) {
+        emit q->samplesRead(parseSamples(value));
+    }
+    if (q->isSignalConnected(QMetaMethod::fromSignal(&DataLoggerService::scaledSamplesRead))) {
+        emit q->scaledSamplesRead(parseScaledSamples(value, scale));
+    }
+}
+
+/*!
+ * Emits coalesced \a samples via the DataLoggerService::samplesRead and/or
+ * DataLoggerService::scaledSamplesRead signals, the latter multiplied by the most recent scale.
+ */
+void DataLoggerServicePrivate::samplesCoalesced(const QVector<qint16> &samples)
+{
+    Q_Q(DataLoggerService);
+    qCDebug(lc).noquote() << tr("Emitting %1 coalesced samples.").arg(samples.size());
+    if (q->isSignalConnected(QMetaMethod::fromSignal(&DataLoggerService::samplesRead))) {
+        emit q->samplesRead(samples);
+    }
+    if (q->isSignalConnected(QMetaMethod::fromSignal(&DataLoggerService::scaledSamplesRead))) {
+        DataLoggerService::ScaledSamples values(samples.size());
+        SampleDecoder::scale(samples.constData(), samples.size(), scale, values.data());
+        emit q->scaledSamplesRead(values);
+    }
+}
+
 /*!
  * Implements AbstractPokitServicePrivate::characteristicRead to parse \a value, then emit a
  * specialised signal, for each supported \a characteristic.
@@ -583,9 +694,8 @@ void DataLoggerServicePrivate::characteristicRead(const QLowEnergyCharacteristic
         return;
     }
 
-    Q_Q(DataLoggerService);
     if (characteristic.uuid() == DataLoggerService::CharacteristicUuids::metadata) {
-        emit q->metadataRead(parseMetadata(value));
+        processMetadata(value);
         return;
     }
 
@@ -631,33 +741,30 @@ void DataLoggerServicePrivate::characteristicWritten(const QLowEnergyCharacteris
 }
 
 /*!
- * Implements AbstractPokitServicePrivate::characteristicChanged to parse \a newValue, then emit a
- * specialised signal, for each supported \a characteristic.
+ * Implements AbstractPokitServicePrivate::characteristicNotified to parse \a newValue, then emit a
+ * specialised signal, for each supported characteristic \a uuid.
  */
-void DataLoggerServicePrivate::characteristicChanged(const QLowEnergyCharacteristic &characteristic,
-                                                     const QByteArray &newValue)
+void DataLoggerServicePrivate::characteristicNotified(const QBluetoothUuid &uuid,
+                                                      const QByteArray &newValue)
 {
-    AbstractPokitServicePrivate::characteristicChanged(characteristic, newValue);
-
-    Q_Q(DataLoggerService);
-    if (characteristic.uuid() == DataLoggerService::CharacteristicUuids::settings) {
+    if (uuid == DataLoggerService::CharacteristicUuids::settings) {
         qCWarning(lc).noquote() << tr("Settings characteristic is write-only, but somehow updated")
-            << serviceUuid << characteristic.name() << characteristic.uuid();
+            << serviceUuid << uuid;
         return;
     }
 
-    if (characteristic.uuid() == DataLoggerService::CharacteristicUuids::metadata) {
-        emit q->metadataRead(parseMetadata(newValue));
+    if (uuid == DataLoggerService::CharacteristicUuids::metadata) {
+        processMetadata(newValue);
         return;
     }
 
-    if (characteristic.uuid() == DataLoggerService::CharacteristicUuids::reading) {
-        emit q->samplesRead(parseSamples(newValue));
+    if (uuid == DataLoggerService::CharacteristicUuids::reading) {
+        processSamples(newValue);
         return;
     }
 
     qCWarning(lc).noquote() << tr("Unknown characteristic notified for Data Logger service")
-        << serviceUuid << characteristic.name() << characteristic.uuid();
+        << serviceUuid << uuid;
 }
 
 /// \endcond
@@ -12,6 +12,7 @@
 #include <qtpokit/dataloggerservice.h>
 
 #include "abstractpokitservice_p.h"
+#include "samplecoalescer_p.h"
 
 QTPOKIT_BEGIN_NAMESPACE
 
@@ -20,6 +21,9 @@ class QTPOKIT_EXPORT DataLoggerServicePrivate : public AbstractPokitServicePriva
     Q_OBJECT
 
 public:
+    float scale; ///< Scale from the most recently read metadata, or NaN if none read yet.
+    SampleCoalescer coalescer; ///< Coalesces `Reading` notifications, if enabled.
+
     explicit DataLoggerServicePrivate(QLowEnergyController * controller, DataLoggerService * const q);
 
     static QByteArray encodeSettings(const DataLoggerService::Settings &settings,
@@ -27,14 +31,22 @@ public:
 
     static DataLoggerService::Metadata parseMetadata(const QByteArray &value);
     static DataLoggerService::Samples parseSamples(const QByteArray &value);
+    static int parseSamples(const QByteArray &value, qint16 * const samples, const int maxSamples);
+    static DataLoggerService::ScaledSamples parseScaledSamples(const QByteArray &value,
+                                                               const float scale);
 
 protected:
+    void processMetadata(const QByteArray &value);
+    void processSamples(const QByteArray &value);
+
     void characteristicRead(const QLowEnergyCharacteristic &characteristic,
                             const QByteArray &value) override;
     void characteristicWritten(const QLowEnergyCharacteristic &characteristic,
                                const QByteArray &newValue) override;
-    void characteristicChanged(const QLowEnergyCharacteristic &characteristic,
-                               const QByteArray &newValue) override;
+    void characteristicNotified(const QBluetoothUuid &uuid, const QByteArray &newValue) override;
+
+protected slots:
+    void samplesCoalesced(const QVector<qint16> &samples);
 
 private:
     Q_DECLARE_PUBLIC(DataLoggerService)
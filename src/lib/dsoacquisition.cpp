@@ -0,0 +1,479 @@
+// SPDX-FileCopyrightText: 2022 Paul Colby <git@colby.id.au>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+/*!
+ * \file
+ * Defines the DsoAcquisition and DsoAcquisitionPrivate classes.
+ */
+
+#include <qtpokit/dsoacquisition.h>
+#include "dsoacquisition_p.h"
+
+#include <cstring>
+#include <limits>
+
+/*!
+ * \class DsoAcquisition
+ *
+ * The DsoAcquisition class provides continuous (back-to-back) DSO acquisition.
+ *
+ * A single DsoService::startDso() call captures one block of samples, after which the Pokit device
+ * goes idle. This class instead re-arms the DSO (with the same settings) as soon as each capture's
+ * `Done` status and samples have been received, so as to keep dead time between captures to a
+ * minimum. Samples are scaled (via DsoService::scaledSamplesRead) and appended to a preallocated,
+ * lock-free, single-producer single-consumer ring buffer.
+ *
+ * The ring buffer is written to from this object's thread (typically the thread running the Qt
+ * event loop that services BLE notifications), and may be read via available() and read() from any
+ * one other thread at a time, without blocking the producer. The samplesAvailable() signal may be
+ * connected (with a queued connection, if need be) to be notified when new samples arrive.
+ *
+ * If the consumer falls behind, and the ring buffer fills up, then new samples are discarded (never
+ * overwriting unread samples), and counted in the acquisition metrics(), along with the dead time
+ * between captures.
+ *
+ * Likewise, if a capture's samples stop arriving (such as when a BLE `Reading` notification is
+ * lost) for longer than shortfallTimeout(), then the capture is abandoned, its missing samples are
+ * counted as lost in the metrics(), and the DSO is re-armed as normal.
+ *
+ * Note, all functions other than available() and read() must be invoked from this object's thread.
+ */
+
+/// \struct DsoAcquisition::Metrics
+/// \brief Attributes describing the performance of a continuous acquisition.
+
+/*!
+ * Constructs a new continuous acquisition for \a service, with a ring buffer able to hold at least
+ * \a capacity samples, and \a parent.
+ *
+ * The ring buffer capacity is rounded up to the next power of two, and allocated up front.
+ */
+DsoAcquisition::DsoAcquisition(DsoService * const service, const int capacity,
+                               QObject * const parent)
+    : QObject(parent), d_ptr(new DsoAcquisitionPrivate(service, capacity, this))
+{
+
+}
+
+/*!
+ * \cond internal
+ * Constructs a new continuous acquisition with \a parent, and private implementation \a d.
+ */
+DsoAcquisition::DsoAcquisition(DsoAcquisitionPrivate * const d, QObject * const parent)
+    : QObject(parent), d_ptr(d)
+{
+
+}
+/// \endcond
+
+/*!
+ * Destroys this DsoAcquisition object.
+ */
+DsoAcquisition::~DsoAcquisition()
+{
+    delete d_ptr;
+}
+
+/*!
+ * Returns a non-const pointer to the DSO service samples are acquired from.
+ */
+DsoService * DsoAcquisition::service()
+{
+    Q_D(DsoAcquisition);
+    return d->service;
+}
+
+/*!
+ * Returns a const pointer to the DSO service samples are acquired from.
+ */
+const DsoService * DsoAcquisition::service() const
+{
+    Q_D(const DsoAcquisition);
+    return d->service;
+}
+
+/*!
+ * Returns the number of samples the ring buffer can hold.
+ */
+int DsoAcquisition::capacity() const
+{
+    Q_D(const DsoAcquisition);
+    return d->buffer.size();
+}
+
+/*!
+ * Returns `true` if continuous acquisition is running, i.e. the DSO will be re-armed after the
+ * current capture completes.
+ */
+bool DsoAcquisition::isRunning() const
+{
+    Q_D(const DsoAcquisition);
+    return d->running;
+}
+
+/*!
+ * Returns the number of samples available to read().
+ *
+ * This function may be called from the consumer thread.
+ */
+int DsoAcquisition::available() const
+{
+    Q_D(const DsoAcquisition);
+    return d->available();
+}
+
+/*!
+ * Reads up to \a maxValues samples from the ring buffer into \a values, returning the number of
+ * samples read. This never blocks; if no samples are available, `0` is returned.
+ *
+ * This function may be called from the consumer thread, but only from one thread at a time.
+ */
+int DsoAcquisition::read(float * const values, const int maxValues)
+{
+    Q_D(DsoAcquisition);
+    return d->read(values, maxValues);
+}
+
+/*!
+ * Returns the acquisition metrics collected since construction, or the last resetMetrics() call.
+ */
+DsoAcquisition::Metrics DsoAcquisition::metrics() const
+{
+    Q_D(const DsoAcquisition);
+    return d->metrics;
+}
+
+/*!
+ * Resets all acquisition metrics to zero.
+ */
+void DsoAcquisition::resetMetrics()
+{
+    Q_D(DsoAcquisition);
+    d->metrics = Metrics{ 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+}
+
+/*!
+ * Returns the number of milliseconds to wait for a capture's outstanding samples, before abandoning
+ * the capture. The default is 2,000 milliseconds.
+ */
+int DsoAcquisition::shortfallTimeout() const
+{
+    Q_D(const DsoAcquisition);
+    return d->shortfallTimer.interval();
+}
+
+/*!
+ * Sets the number of milliseconds to wait for a capture's outstanding samples to \a timeout. The
+ * timeout restarts each time samples arrive, so only needs to cover the longest expected gap
+ * between `Reading` notifications.
+ */
+void DsoAcquisition::setShortfallTimeout(const int timeout)
+{
+    Q_D(DsoAcquisition);
+    d->shortfallTimer.setInterval(qMax(timeout, 0));
+}
+
+/*!
+ * Starts continuous acquisition using \a settings.
+ *
+ * Returns `true` if the initial DSO request was successfully submitted to the device queue, `false`
+ * otherwise (including if acquisition is already running).
+ */
+bool DsoAcquisition::start(const DsoService::Settings &settings)
+{
+    Q_D(DsoAcquisition);
+    if (d->running) {
+        qCWarning(d->lc).noquote() << tr("Continuous acquisition is already running.");
+        return false;
+    }
+    d->settings = settings;
+    d->running = true;
+    if (!d->arm()) {
+        d->running = false;
+        return false;
+    }
+    emit started();
+    return true;
+}
+
+/*!
+ * Stops continuous acquisition.
+ *
+ * Any capture already in progress will still complete (and its samples added to the ring buffer),
+ * but the DSO will not be re-armed. The stopped() signal is emitted once that capture has
+ * completed.
+ */
+void DsoAcquisition::stop()
+{
+    Q_D(DsoAcquisition);
+    if (!d->running) {
+        return;
+    }
+    d->running = false;
+    if ((!d->sampling) && (d->samplesToGo <= 0)) {
+        emit stopped();
+    }
+}
+
+/*!
+ * \fn DsoAcquisition::started
+ *
+ * This signal is emitted when continuous acquisition has started.
+ */
+
+/*!
+ * \fn DsoAcquisition::stopped
+ *
+ * This signal is emitted when continuous acquisition has stopped, either because stop() was
+ * called, or because the DSO could not be re-armed.
+ */
+
+/*!
+ * \fn DsoAcquisition::captureFinished
+ *
+ * This signal is emitted when all samples for a capture, described by \a metadata, have been
+ * received.
+ */
+
+/*!
+ * \fn DsoAcquisition::samplesAvailable
+ *
+ * This signal is emitted when \a count new samples have been added to the ring buffer.
+ */
+
+/*!
+ * \cond internal
+ * \class DsoAcquisitionPrivate
+ *
+ * The DsoAcquisitionPrivate class provides private implementation for DsoAcquisition.
+ */
+
+/*!
+ * Constructs a new DsoAcquisitionPrivate object for \a service, with a ring buffer of at least
+ * \a capacity samples, and public implementation \a q.
+ */
+DsoAcquisitionPrivate::DsoAcquisitionPrivate(DsoService * const service, const int capacity,
+                                             DsoAcquisition * const q)
+    : service(service), settings{ DsoService::Command::FreeRunning, 0.0f, DsoService::Mode::Idle,
+        { DsoService::VoltageRange::_0_to_300mV }, 0, 0 },
+      metadata{ DsoService::DsoStatus::Error, std::numeric_limits<float>::quiet_NaN(),
+        DsoService::Mode::Idle, { DsoService::VoltageRange::_0_to_300mV }, 0, 0, 0 },
+      running(false), notificationsEnabled(false), sampling(false), samplesToGo(0),
+      metrics{ 0, 0, 0, 0, 0, 0, 0, 0, 0 }, buffer(roundUpCapacity(capacity)),
+      mask(static_cast<quint32>(buffer.size() - 1)), head(0), tail(0), q_ptr(q)
+{
+    shortfallTimer.setInterval(2000);
+    shortfallTimer.setSingleShot(true);
+    connect(&shortfallTimer, &QTimer::timeout, this, &DsoAcquisitionPrivate::shortfall);
+    if (service) {
+        connect(service, &DsoService::settingsWritten,
+                this, &DsoAcquisitionPrivate::settingsWritten);
+        connect(service, &DsoService::metadataRead,
+                this, &DsoAcquisitionPrivate::metadataRead);
+        connect(service, &DsoService::scaledSamplesRead,
+                this, &DsoAcquisitionPrivate::samplesRead);
+    }
+}
+
+/*!
+ * Returns \a capacity rounded up to the next power of two, within the range 2 to 2^30 inclusive.
+ */
+int DsoAcquisitionPrivate::roundUpCapacity(const int capacity)
+{
+    int rounded = 2;
+    while ((rounded < capacity) && (rounded < (1 << 30))) {
+        rounded <<= 1;
+    }
+    return rounded;
+}
+
+/*!
+ * Writes up to \a count \a values to the ring buffer, returning the number of values written, which
+ * will be less than \a count if the ring buffer does not have enough free space.
+ *
+ * This function must only be called from the producer (ie this object's) thread.
+ */
+int DsoAcquisitionPrivate::write(const float * const values, const int count)
+{
+    const quint32 writePos = head.loadAcquire();
+    const quint32 readPos = tail.loadAcquire();
+    const int free = buffer.size() - static_cast<int>(writePos - readPos);
+    const int total = qMax(qMin(count, free), 0);
+    const int index = static_cast<int>(writePos & mask);
+    const int first = qMin(total, buffer.size() - index);
+    float * const data = buffer.data();
+    std::memcpy(data + index, values, first * sizeof(float));
+    std::memcpy(data, values + first, (total - first) * sizeof(float));
+    head.storeRelease(writePos + static_cast<quint32>(total));
+    return total;
+}
+
+/*!
+ * Reads up to \a maxValues values from the ring buffer into \a values, returning the number of
+ * values read.
+ *
+ * This function must only be called from one consumer thread at a time.
+ */
+int DsoAcquisitionPrivate::read(float * const values, const int maxValues)
+{
+    const quint32 readPos = tail.loadAcquire();
+    const quint32 writePos = head.loadAcquire();
+    const int total = qMax(qMin(maxValues, static_cast<int>(writePos - readPos)), 0);
+    const int index = static_cast<int>(readPos & mask);
+    const int first = qMin(total, buffer.size() - index);
+    const float * const data = buffer.constData();
+    std::memcpy(values, data + index, first * sizeof(float));
+    std::memcpy(values + first, data, (total - first) * sizeof(float));
+    tail.storeRelease(readPos + static_cast<quint32>(total));
+    return total;
+}
+
+/*!
+ * Returns the number of values currently available to read from the ring buffer.
+ */
+int DsoAcquisitionPrivate::available() const
+{
+    return static_cast<int>(head.loadAcquire() - tail.loadAcquire());
+}
+
+/*!
+ * Requests the DSO to begin a new capture with the current settings.
+ *
+ * Returns `true` if the request was successfully submitted to the device queue, `false` otherwise.
+ */
+bool DsoAcquisitionPrivate::arm()
+{
+    if (!service) {
+        qCWarning(lc).noquote() << tr("Cannot arm the DSO without a DSO service.");
+        return false;
+    }
+    if (!service->startDso(settings)) {
+        qCWarning(lc).noquote() << tr("Failed to arm the DSO.");
+        return false;
+    }
+    return true;
+}
+
+/*!
+ * Handles DsoService::settingsWritten signals, marking the start of a new capture.
+ */
+void DsoAcquisitionPrivate::settingsWritten()
+{
+    if (!running) {
+        return;
+    }
+    if (deadTimer.isValid()) {
+        metrics.lastDeadTime = deadTimer.nsecsElapsed() / 1000;
+        metrics.maxDeadTime = qMax(metrics.maxDeadTime, metrics.lastDeadTime);
+        metrics.totalDeadTime += metrics.lastDeadTime;
+        deadTimer.invalidate();
+        qCDebug(lc).noquote() << tr("DSO re-armed after %L1us.").arg(metrics.lastDeadTime);
+    }
+    sampling = true;
+    samplesToGo = 0;
+    if (!notificationsEnabled) {
+        notificationsEnabled = service->enableMetadataNotifications()
+            && service->enableReadingNotifications();
+    }
+}
+
+/*!
+ * Handles DsoService::metadataRead signals, noting the end of each capture.
+ */
+void DsoAcquisitionPrivate::metadataRead(const DsoService::Metadata &metadata)
+{
+    if (!sampling) {
+        return;
+    }
+    this->metadata = metadata;
+    switch (metadata.status) {
+    case DsoService::DsoStatus::Sampling:
+        return;
+    case DsoService::DsoStatus::Done:
+        deadTimer.start();
+        sampling = false;
+        samplesToGo = metadata.numberOfSamples;
+        qCDebug(lc).noquote() << tr("Capture done; expecting %L1 samples.").arg(samplesToGo);
+        if (samplesToGo <= 0) {
+            captureFinished();
+        } else {
+            shortfallTimer.start();
+        }
+        return;
+    default:
+        qCWarning(lc).noquote() << tr("DSO reported error status %1; stopping acquisition.")
+            .arg((quint8)metadata.status);
+        sampling = false;
+        samplesToGo = 0;
+        running = false;
+        Q_Q(DsoAcquisition);
+        emit q->stopped();
+    }
+}
+
+/*!
+ * Handles DsoService::scaledSamplesRead signals, adding \a samples to the ring buffer.
+ */
+void DsoAcquisitionPrivate::samplesRead(const DsoService::ScaledSamples &samples)
+{
+    if (samplesToGo <= 0) {
+        qCDebug(lc).noquote() << tr("Ignoring %L1 unexpected samples.").arg(samples.size());
+        return;
+    }
+    const int written = write(samples.constData(), samples.size());
+    metrics.samples += written;
+    if (written < samples.size()) {
+        metrics.droppedSamples += samples.size() - written;
+        ++metrics.droppedNotifications;
+        qCDebug(lc).noquote() << tr("Ring buffer full; dropped %L1 of %L2 samples.")
+            .arg(samples.size() - written).arg(samples.size());
+    }
+    samplesToGo -= samples.size();
+    Q_Q(DsoAcquisition);
+    if (written > 0) {
+        emit q->samplesAvailable(written);
+    }
+    if (samplesToGo <= 0) {
+        captureFinished();
+    } else {
+        shortfallTimer.start();
+    }
+}
+
+/*!
+ * Handles #shortfallTimer timeouts, abandoning the current capture because some of its samples
+ * (typically, whole `Reading` notifications) have been lost, then re-arming the DSO as usual.
+ */
+void DsoAcquisitionPrivate::shortfall()
+{
+    if (samplesToGo <= 0) {
+        return;
+    }
+    qCWarning(lc).noquote() << tr("Timed out waiting for %Ln sample(s); abandoning capture.",
+        nullptr, samplesToGo);
+    metrics.lostSamples += samplesToGo;
+    ++metrics.lostCaptures;
+    captureFinished();
+}
+
+/*!
+ * Completes the current capture, and re-arms the DSO if still running.
+ */
+void DsoAcquisitionPrivate::captureFinished()
+{
+    Q_Q(DsoAcquisition);
+    shortfallTimer.stop();
+    samplesToGo = 0;
+    ++metrics.captures;
+    emit q->captureFinished(metadata);
+    if (!running) {
+        emit q->stopped();
+        return;
+    }
+    if (!arm()) {
+        running = false;
+        emit q->stopped();
+    }
+}
+
+/// \endcond
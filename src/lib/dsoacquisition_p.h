@@ -0,0 +1,75 @@
+// SPDX-FileCopyrightText: 2022 Paul Colby <git@colby.id.au>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+/*!
+ * \file
+ * Declares the DsoAcquisitionPrivate class.
+ */
+
+#ifndef QTPOKIT_DSOACQUISITION_P_H
+#define QTPOKIT_DSOACQUISITION_P_H
+
+#include <qtpokit/dsoacquisition.h>
+
+#include <QAtomicInteger>
+#include <QElapsedTimer>
+#include <QLoggingCategory>
+#include <QObject>
+#include <QTimer>
+#include <QVector>
+
+QTPOKIT_BEGIN_NAMESPACE
+
+class QTPOKIT_EXPORT DsoAcquisitionPrivate : public QObject
+{
+    Q_OBJECT
+
+public:
+    static Q_LOGGING_CATEGORY(lc, "pokit.dso.acquisition", QtInfoMsg); ///< Logging category.
+
+    DsoService * service;              ///< DSO service to acquire samples from.
+    DsoService::Settings settings;     ///< Settings to (re-)arm the DSO with.
+    DsoService::Metadata metadata;     ///< Metadata for the current capture.
+    bool running;                      ///< Whether to re-arm the DSO after each capture.
+    bool notificationsEnabled;         ///< Whether DSO notifications have been enabled yet.
+    bool sampling;                     ///< Whether a capture is currently in progress.
+    int samplesToGo;                   ///< Samples still expected for the current capture.
+    QTimer shortfallTimer;             ///< Timer for abandoning captures with lost samples.
+    QElapsedTimer deadTimer;           ///< Measures time from one capture's end to the next's.
+    DsoAcquisition::Metrics metrics;   ///< Acquisition metrics.
+
+    QVector<float> buffer;             ///< Preallocated ring buffer storage.
+    quint32 mask;                      ///< Mask for mapping ring positions to #buffer indexes.
+    QAtomicInteger<quint32> head;      ///< Total samples ever written (producer owned).
+    QAtomicInteger<quint32> tail;      ///< Total samples ever read (consumer owned).
+
+    DsoAcquisitionPrivate(DsoService * const service, const int capacity, DsoAcquisition * const q);
+
+    static int roundUpCapacity(const int capacity);
+
+    int write(const float * const values, const int count);
+    int read(float * const values, const int maxValues);
+    int available() const;
+
+    bool arm();
+
+protected:
+    DsoAcquisition * q_ptr; ///< Internal q-pointer.
+
+protected slots:
+    void settingsWritten();
+    void metadataRead(const DsoService::Metadata &metadata);
+    void samplesRead(const DsoService::ScaledSamples &samples);
+    void shortfall();
+
+private:
+    void captureFinished();
+
+    Q_DECLARE_PUBLIC(DsoAcquisition)
+    Q_DISABLE_COPY(DsoAcquisitionPrivate)
+    friend class TestDsoAcquisition;
+};
+
+QTPOKIT_END_NAMESPACE
+
+#endif // QTPOKIT_DSOACQUISITION_P_H
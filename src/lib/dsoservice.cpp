@@ -7,10 +7,13 @@
  */
 
 #include <qtpokit/dsoservice.h>
+#include <qtpokit/pokitranges.h>
 #include "dsoservice_p.h"
+#include "sampledecoder_p.h"
 
 #include <QDataStream>
 #include <QIODevice>
+#include <QMetaMethod>
 #include <QtEndian>
 
 /*!
@@ -64,15 +67,7 @@ QString DsoService::toString(const Mode &mode)
 /// Returns \a range as a user-friendly string.
 QString DsoService::toString(const VoltageRange &range)
 {
-    switch (range) {
-    case VoltageRange::_0_to_300mV:  return tr("0 to 300mV");
-    case VoltageRange::_300mV_to_2V: return tr("300mV to 2V");
-    case VoltageRange::_2V_to_6V:    return tr("2V to 6V");
-    case VoltageRange::_6V_to_12V:   return tr("6V to 12V");
-    case VoltageRange::_12V_to_30V:  return tr("12V to 30V");
-    case VoltageRange::_30V_to_60V:  return tr("30V to 60V");
-    default:                         return QString();
-    }
+    return PokitRanges::label(PokitRanges::Quantity::Voltage, (quint8)range);
 }
 
 /*!
@@ -86,15 +81,7 @@ QString DsoService::toString(const VoltageRange &range)
  */
 QVariant DsoService::minValue(const VoltageRange &range)
 {
-    switch (range) {
-    case VoltageRange::_0_to_300mV:  return     0;
-    case VoltageRange::_300mV_to_2V: return   300;
-    case VoltageRange::_2V_to_6V:    return  2000;
-    case VoltageRange::_6V_to_12V:   return  6000;
-    case VoltageRange::_12V_to_30V:  return 12000;
-    case VoltageRange::_30V_to_60V:  return 30000;
-    default:                         return QVariant();
-    }
+    return PokitRanges::minValue(PokitRanges::Quantity::Voltage, (quint8)range);
 }
 
 /*!
@@ -103,15 +90,7 @@ QVariant DsoService::minValue(const VoltageRange &range)
  */
 QVariant DsoService::maxValue(const VoltageRange &range)
 {
-    switch (range) {
-    case VoltageRange::_0_to_300mV:  return   300;
-    case VoltageRange::_300mV_to_2V: return  2000;
-    case VoltageRange::_2V_to_6V:    return  6000;
-    case VoltageRange::_6V_to_12V:   return 12000;
-    case VoltageRange::_12V_to_30V:  return 30000;
-    case VoltageRange::_30V_to_60V:  return 60000;
-    default:                         return QVariant();
-    }
+    return PokitRanges::maxValue(PokitRanges::Quantity::Voltage, (quint8)range);
 }
 
 /// \enum DsoService::CurrentRange
@@ -121,14 +100,7 @@ QVariant DsoService::maxValue(const VoltageRange &range)
 /// Returns \a range as a user-friendly string.
 QString DsoService::toString(const CurrentRange &range)
 {
-    switch (range) {
-    case CurrentRange::_0_to_10mA:      return tr("0 to 10mA");
-    case CurrentRange::_10mA_to_30mA:   return tr("10mA to 30mA");
-    case CurrentRange::_30mA_to_150mA:  return tr("30mA to 150mA");
-    case CurrentRange::_150mA_to_300mA: return tr("150mA to 300mA");
-    case CurrentRange::_300mA_to_3A:    return tr("300mA to 3A");
-    default:                            return QString();
-    }
+    return PokitRanges::label(PokitRanges::Quantity::Current, (quint8)range);
 }
 
 /*!
@@ -142,14 +114,7 @@ QString DsoService::toString(const CurrentRange &range)
  */
 QVariant DsoService::minValue(const CurrentRange &range)
 {
-    switch (range) {
-    case CurrentRange::_0_to_10mA:      return   0;
-    case CurrentRange::_10mA_to_30mA:   return  10;
-    case CurrentRange::_30mA_to_150mA:  return  30;
-    case CurrentRange::_150mA_to_300mA: return 150;
-    case CurrentRange::_300mA_to_3A:    return 300;
-    default:                            return QVariant();
-    }
+    return PokitRanges::minValue(PokitRanges::Quantity::Current, (quint8)range);
 }
 
 /*!
@@ -158,14 +123,7 @@ QVariant DsoService::minValue(const CurrentRange &range)
  */
 QVariant DsoService::maxValue(const CurrentRange &range)
 {
-    switch (range) {
-    case CurrentRange::_0_to_10mA:      return   10;
-    case CurrentRange::_10mA_to_30mA:   return   30;
-    case CurrentRange::_30mA_to_150mA:  return  150;
-    case CurrentRange::_150mA_to_300mA: return  300;
-    case CurrentRange::_300mA_to_3A:    return 3000;
-    default:                            return QVariant();
-    }
+    return PokitRanges::maxValue(PokitRanges::Quantity::Current, (quint8)range);
 }
 
 /// \union DsoService::Range
@@ -195,6 +153,9 @@ QString DsoService::toString(const Range &range, const Mode &mode)
 /// \struct DsoService::Metadata
 /// \brief Attributes included in the `Metadata` characterstic.
 
+/// \struct DsoService::CoalescingSettings
+/// \brief Settings for coalescing `Reading` notifications into fewer samplesRead() signals.
+
 /*!
  * \typedef DsoService::Samples
  *
@@ -265,7 +226,7 @@ bool DsoService::readMetadataCharacteristic()
  */
 bool DsoService::setSettings(const Settings &settings)
 {
-    Q_D(const DsoService);
+    Q_D(DsoService);
     const QLowEnergyCharacteristic characteristic =
         d->getCharacteristic(CharacteristicUuids::settings);
     if (!characteristic.isValid()) {
@@ -277,7 +238,7 @@ bool DsoService::setSettings(const Settings &settings)
         return false;
     }
 
-    d->service->writeCharacteristic(characteristic, value);
+    d->writeCharacteristic(characteristic, value);
     return (d->service->error() != QLowEnergyService::ServiceError::CharacteristicWriteError);
 }
 
@@ -396,6 +357,37 @@ bool DsoService::disableReadingNotifications()
     return d->disableCharacteristicNotificatons(CharacteristicUuids::reading);
 }
 
+/*!
+ * Returns the current sample coalescing settings.
+ *
+ * \see setCoalescingSettings
+ */
+DsoService::CoalescingSettings DsoService::coalescingSettings() const
+{
+    Q_D(const DsoService);
+    return { d->coalescer.isEnabled(), d->coalescer.chunkSize(), d->coalescer.maxLatency() };
+}
+
+/*!
+ * Sets the sample coalescing \a settings.
+ *
+ * By default, samplesRead() and scaledSamplesRead() are emitted once per `Reading` notification,
+ * which (with the default MTU) carries just 10 samples. When coalescing is enabled, decoded samples
+ * are instead accumulated into one buffer, preallocated from the `Metadata::numberOfSamples` of the
+ * most recently read metadata, and emitted once per capture, once per
+ * CoalescingSettings::chunkSize samples, or once CoalescingSettings::maxLatency milliseconds have
+ * passed since the first sample was held, whichever comes first.
+ *
+ * Disabling coalescing emits any samples held at the time.
+ */
+void DsoService::setCoalescingSettings(const CoalescingSettings &settings)
+{
+    Q_D(DsoService);
+    d->coalescer.setChunkSize(settings.chunkSize);
+    d->coalescer.setMaxLatency(settings.maxLatency);
+    d->coalescer.setEnabled(settings.enabled);
+}
+
 /*!
  * \fn DsoService::settingsWritten
  *
@@ -421,6 +413,20 @@ bool DsoService::disableReadingNotifications()
  * \see stopSampling
  */
 
+/*!
+ * \fn DsoService::scaledSamplesRead
+ *
+ * This signal is emitted when the `Reading` characteristic has been notified, with each sample
+ * already multiplied by the `Metadata::scale` of the most recently read metadata.
+ *
+ * The scaling is performed in bulk within the library, using the host CPU's SIMD instructions where
+ * available, so this is generally a cheaper alternative to scaling samplesRead() values one by one.
+ * Samples are only decoded for the signals that have at least one connected receiver, so there is no
+ * cost in not using one of samplesRead() or scaledSamplesRead().
+ *
+ * If no metadata has been read yet, then the scale is unknown, and so all values will be NaN.
+ */
+
 
 /*!
  * \cond internal
@@ -435,9 +441,11 @@ bool DsoService::disableReadingNotifications()
  */
 DsoServicePrivate::DsoServicePrivate(
     QLowEnergyController * controller, DsoService * const q)
-    : AbstractPokitServicePrivate(DsoService::serviceUuid, controller, q)
+    : AbstractPokitServicePrivate(DsoService::serviceUuid, controller, q),
+      scale(std::numeric_limits<float>::quiet_NaN()), coalescer(this)
 {
-
+    connect(&coalescer, &SampleCoalescer::samplesReady,
+            this, &DsoServicePrivate::samplesCoalesced);
 }
 
 /*!
@@ -491,6 +499,8 @@ DsoService::Metadata DsoServicePrivate::parseMetadata(const QByteArray &value)
 
 /*!
  * Parses the `Reading` \a value into a DsoService::Samples vector.
+ *
+ * The returned vector is allocated once, at its final size, and then decoded in bulk.
  */
 DsoService::Samples DsoServicePrivate::parseSamples(const QByteArray &value)
 {
@@ -500,14 +510,117 @@ DsoService::Samples DsoServicePrivate::parseSamples(const QByteArray &value)
             .arg(value.size()).arg(toHexString(value));
         return samples;
     }
-    for (; (samples.size()*2) < value.size();) {
-        samples.append(qFromLittleEndian<qint16>(value.mid(samples.size()*2,2)));
-    }
+    samples.resize(value.size()/2);
+    parseSamples(value, samples.data(), samples.size());
     qCDebug(lc).noquote() << tr("Read %1 samples from %2-bytes.")
         .arg(samples.size()).arg(value.size());
     return samples;
 }
 
+/*!
+ * Parses the `Reading` \a value directly into the caller-owned \a samples buffer, which must have
+ * room for at least \a maxSamples samples.
+ *
+ * This overload performs no heap allocations, so is suitable for callers that accumulate samples
+ * into a buffer of their own, such as a pre-allocated capture buffer.
+ *
+ * Returns the number of samples written to \a samples, which will be less than the number of samples
+ * in \a value if \a maxSamples is too small. Returns `-1` if \a value has an odd size (and so does
+ * not contain a whole number of samples), in which case \a samples is left untouched.
+ */
+int DsoServicePrivate::parseSamples(const QByteArray &value, qint16 * const samples,
+                                    const int maxSamples)
+{
+    if ((value.size()%2) != 0) {
+        qCWarning(lc).noquote() << tr("Samples value has odd size %1 (should be even): %2")
+            .arg(value.size()).arg(toHexString(value));
+        return -1;
+    }
+    const int count = qMin(value.size()/2, maxSamples);
+    if (count < value.size()/2) {
+        qCWarning(lc).noquote() << tr("Samples buffer too small; discarding %1 of %2 samples.")
+            .arg(value.size()/2-count).arg(value.size()/2);
+    }
+    return SampleDecoder::decode(value, samples, count);
+}
+
+/*!
+ * Parses the `Reading` \a value into a DsoService::ScaledSamples vector, multiplying each
+ * sample by \a scale.
+ */
+DsoService::ScaledSamples DsoServicePrivate::parseScaledSamples(const QByteArray &value,
+                                                                const float scale)
+{
+    DsoService::ScaledSamples samples;
+    if ((value.size()%2) != 0) {
+        qCWarning(lc).noquote() << tr("Samples value has odd size %1 (should be even): %2")
+            .arg(value.size()).arg(toHexString(value));
+        return samples;
+    }
+    samples.resize(value.size()/2);
+    SampleDecoder::decode(value, scale, samples.data(), samples.size());
+    qCDebug(lc).noquote() << tr("Read %1 scaled samples from %2-bytes.")
+        .arg(samples.size()).arg(value.size());
+    return samples;
+}
+
+/*!
+ * Parses the `Metadata` \a value, records its scale for subsequent samples, begins a new coalesced
+ * capture (if coalescing is enabled), and emits it via the DsoService::metadataRead signal.
+ */
+void DsoServicePrivate::processMetadata(const QByteArray &value)
+{
+    Q_Q(DsoService);
+    const DsoService::Metadata metadata = parseMetadata(value);
+    if (coalescer.isEnabled()) {
+        coalescer.beginCapture(metadata.numberOfSamples); // Flushes any held samples first.
+    }
+    scale = metadata.scale;
+    emit q->metadataRead(metadata);
+}
+
+/*!
+ * Parses the `Reading` \a value, and emits the results via the DsoService::samplesRead and/or
+ * DsoService::scaledSamplesRead signals. Parsing is skipped for either signal that has no
+ * receivers connected. If coalescing is enabled, the samples are instead held by #coalescer, until
+ * samplesCoalesced() emits them.
+ */
+void DsoServicePrivate::processSamples(const QByteArray &value)
+{
+    Q_Q(DsoService);
+    if (coalescer.isEnabled()) {
+        if (!coalescer.append(value)) {
+            qCWarning(lc).noquote() << tr("Samples value has odd size %1 (should be even): %2")
+                .arg(value.size()).arg(toHexString(value));
+        }
+        return;
+    }
+    if (q->isSignalConnected(QMetaMethod::fromSignal(&DsoService::samplesRead))) {
+        emit q->samplesRead(parseSamples(value));
+    }
+    if (q->isSignalConnected(QMetaMethod::fromSignal(&DsoService::scaledSamplesRead))) {
+        emit q->scaledSamplesRead(parseScaledSamples(value, scale));
+    }
+}
+
+/*!
+ * Emits coalesced \a samples via the DsoService::samplesRead and/or
+ * DsoService::scaledSamplesRead signals, the latter multiplied by the most recently read scale.
+ */
+void DsoServicePrivate::samplesCoalesced(const QVector<qint16> &samples)
+{
+    Q_Q(DsoService);
+    qCDebug(lc).noquote() << tr("Emitting %1 coalesced samples.").arg(samples.size());
+    if (q->isSignalConnected(QMetaMethod::fromSignal(&DsoService::samplesRead))) {
+        emit q->samplesRead(samples);
+    }
+    if (q->isSignalConnected(QMetaMethod::fromSignal(&DsoService::scaledSamplesRead))) {
+        DsoService::ScaledSamples values(samples.size());
+        SampleDecoder::scale(samples.constData(), samples.size(), scale, values.data());
+        emit q->scaledSamplesRead(values);
+    }
+}
+
 /*!
  * Implements AbstractPokitServicePrivate::characteristicRead to parse \a value, then emit a
  * specialised signal, for each supported \a characteristic.
@@ -523,9 +636,8 @@ void DsoServicePrivate::characteristicRead(const QLowEnergyCharacteristic &chara
         return;
     }
 
-    Q_Q(DsoService);
     if (characteristic.uuid() == DsoService::CharacteristicUuids::metadata) {
-        emit q->metadataRead(parseMetadata(value));
+        processMetadata(value);
         return;
     }
 
@@ -571,33 +683,30 @@ void DsoServicePrivate::characteristicWritten(const QLowEnergyCharacteristic &ch
 }
 
 /*!
- * Implements AbstractPokitServicePrivate::characteristicChanged to parse \a newValue, then emit a
- * specialised signal, for each supported \a characteristic.
+ * Implements AbstractPokitServicePrivate::characteristicNotified to parse \a newValue, then emit a
+ * specialised signal, for each supported characteristic \a uuid.
  */
-void DsoServicePrivate::characteristicChanged(const QLowEnergyCharacteristic &characteristic,
-                                                     const QByteArray &newValue)
+void DsoServicePrivate::characteristicNotified(const QBluetoothUuid &uuid,
+                                               const QByteArray &newValue)
 {
-    AbstractPokitServicePrivate::characteristicChanged(characteristic, newValue);
-
-    Q_Q(DsoService);
-    if (characteristic.uuid() == DsoService::CharacteristicUuids::settings) {
+    if (uuid == DsoService::CharacteristicUuids::settings) {
         qCWarning(lc).noquote() << tr("Settings characteristic is write-only, but somehow updated")
-            << serviceUuid << characteristic.name() << characteristic.uuid();
+            << serviceUuid << uuid;
         return;
     }
 
-    if (characteristic.uuid() == DsoService::CharacteristicUuids::metadata) {
-        emit q->metadataRead(parseMetadata(newValue));
+    if (uuid == DsoService::CharacteristicUuids::metadata) {
+        processMetadata(newValue);
         return;
     }
 
-    if (characteristic.uuid() == DsoService::CharacteristicUuids::reading) {
-        emit q->samplesRead(parseSamples(newValue));
+    if (uuid == DsoService::CharacteristicUuids::reading) {
+        processSamples(newValue);
         return;
     }
 
     qCWarning(lc).noquote() << tr("Unknown characteristic notified for DSO service")
-        << serviceUuid << characteristic.name() << characteristic.uuid();
+        << serviceUuid << uuid;
 }
 
 /// \endcond
@@ -12,6 +12,7 @@
 #include <qtpokit/dsoservice.h>
 
 #include "abstractpokitservice_p.h"
+#include "samplecoalescer_p.h"
 
 QTPOKIT_BEGIN_NAMESPACE
 
@@ -20,20 +21,31 @@ class QTPOKIT_EXPORT DsoServicePrivate : public AbstractPokitServicePrivate
     Q_OBJECT
 
 public:
+    float scale; ///< Scale from the most recently read metadata, or NaN if none read yet.
+    SampleCoalescer coalescer; ///< Coalesces `Reading` notifications, if enabled.
+
     explicit DsoServicePrivate(QLowEnergyController * controller, DsoService * const q);
 
     static QByteArray encodeSettings(const DsoService::Settings &settings);
 
     static DsoService::Metadata parseMetadata(const QByteArray &value);
     static DsoService::Samples parseSamples(const QByteArray &value);
+    static int parseSamples(const QByteArray &value, qint16 * const samples, const int maxSamples);
+    static DsoService::ScaledSamples parseScaledSamples(const QByteArray &value,
+                                                        const float scale);
 
 protected:
+    void processMetadata(const QByteArray &value);
+    void processSamples(const QByteArray &value);
+
     void characteristicRead(const QLowEnergyCharacteristic &characteristic,
                             const QByteArray &value) override;
     void characteristicWritten(const QLowEnergyCharacteristic &characteristic,
                                const QByteArray &newValue) override;
-    void characteristicChanged(const QLowEnergyCharacteristic &characteristic,
-                               const QByteArray &newValue) override;
+    void characteristicNotified(const QBluetoothUuid &uuid, const QByteArray &newValue) override;
+
+protected slots:
+    void samplesCoalesced(const QVector<qint16> &samples);
 
 private:
     Q_DECLARE_PUBLIC(DsoService)
@@ -148,7 +148,7 @@ QString GenericAccessService::deviceName() const
  */
 bool GenericAccessService::setDeviceName(const QString &name)
 {
-    Q_D(const GenericAccessService);
+    Q_D(GenericAccessService);
     const QLowEnergyCharacteristic characteristic =
         d->getCharacteristic(CharacteristicUuids::deviceName);
     if (!characteristic.isValid()) {
@@ -162,7 +162,7 @@ bool GenericAccessService::setDeviceName(const QString &name)
         return false;
     }
 
-    d->service->writeCharacteristic(characteristic, value);
+    d->writeCharacteristic(characteristic, value);
     return (d->service->error() != QLowEnergyService::ServiceError::CharacteristicWriteError);
 }
 
@@ -7,6 +7,7 @@
  */
 
 #include <qtpokit/multimeterservice.h>
+#include <qtpokit/pokitranges.h>
 #include "multimeterservice_p.h"
 
 #include <QDataStream>
@@ -61,16 +62,10 @@ QString MultimeterService::toString(const Mode &mode)
 /// Returns \a range as a user-friendly string.
 QString MultimeterService::toString(const VoltageRange &range)
 {
-    switch (range) {
-    case VoltageRange::_0_to_300mV:  return tr("0 to 300mV");
-    case VoltageRange::_300mV_to_2V: return tr("300mV to 2V");
-    case VoltageRange::_2V_to_6V:    return tr("2V to 6V");
-    case VoltageRange::_6V_to_12V:   return tr("6V to 12V");
-    case VoltageRange::_12V_to_30V:  return tr("12V to 30V");
-    case VoltageRange::_30V_to_60V:  return tr("30V to 60V");
-    case VoltageRange::AutoRange:    return tr("Auto-range");
-    default:                         return QString();
+    if (range == VoltageRange::AutoRange) {
+        return tr("Auto-range");
     }
+    return PokitRanges::label(PokitRanges::Quantity::Voltage, (quint8)range);
 }
 
 /*!
@@ -84,16 +79,10 @@ QString MultimeterService::toString(const VoltageRange &range)
  */
 QVariant MultimeterService::minValue(const VoltageRange &range)
 {
-    switch (range) {
-    case VoltageRange::_0_to_300mV:  return     0;
-    case VoltageRange::_300mV_to_2V: return   300;
-    case VoltageRange::_2V_to_6V:    return  2000;
-    case VoltageRange::_6V_to_12V:   return  6000;
-    case VoltageRange::_12V_to_30V:  return 12000;
-    case VoltageRange::_30V_to_60V:  return 30000;
-    case VoltageRange::AutoRange:    return tr("Auto");
-    default:                         return QVariant();
+    if (range == VoltageRange::AutoRange) {
+        return tr("Auto");
     }
+    return PokitRanges::minValue(PokitRanges::Quantity::Voltage, (quint8)range);
 }
 
 /*!
@@ -102,16 +91,10 @@ QVariant MultimeterService::minValue(const VoltageRange &range)
  */
 QVariant MultimeterService::maxValue(const VoltageRange &range)
 {
-    switch (range) {
-    case VoltageRange::_0_to_300mV:  return   300;
-    case VoltageRange::_300mV_to_2V: return  2000;
-    case VoltageRange::_2V_to_6V:    return  6000;
-    case VoltageRange::_6V_to_12V:   return 12000;
-    case VoltageRange::_12V_to_30V:  return 30000;
-    case VoltageRange::_30V_to_60V:  return 60000;
-    case VoltageRange::AutoRange:    return tr("Auto");
-    default:                         return QVariant();
+    if (range == VoltageRange::AutoRange) {
+        return tr("Auto");
     }
+    return PokitRanges::maxValue(PokitRanges::Quantity::Voltage, (quint8)range);
 }
 
 /// \enum MultimeterService::CurrentRange
@@ -121,15 +104,10 @@ QVariant MultimeterService::maxValue(const VoltageRange &range)
 /// Returns \a range as a user-friendly string.
 QString MultimeterService::toString(const CurrentRange &range)
 {
-    switch (range) {
-    case CurrentRange::_0_to_10mA:      return tr("0 to 10mA");
-    case CurrentRange::_10mA_to_30mA:   return tr("10mA to 30mA");
-    case CurrentRange::_30mA_to_150mA:  return tr("30mA to 150mA");
-    case CurrentRange::_150mA_to_300mA: return tr("150mA to 300mA");
-    case CurrentRange::_300mA_to_3A:    return tr("300mA to 3A");
-    case CurrentRange::AutoRange:       return tr("Auto-range");
-    default:                            return QString();
+    if (range == CurrentRange::AutoRange) {
+        return tr("Auto-range");
     }
+    return PokitRanges::label(PokitRanges::Quantity::Current, (quint8)range);
 }
 
 /*!
@@ -143,15 +121,10 @@ QString MultimeterService::toString(const CurrentRange &range)
  */
 QVariant MultimeterService::minValue(const CurrentRange &range)
 {
-    switch (range) {
-    case CurrentRange::_0_to_10mA:      return   0;
-    case CurrentRange::_10mA_to_30mA:   return  10;
-    case CurrentRange::_30mA_to_150mA:  return  30;
-    case CurrentRange::_150mA_to_300mA: return 150;
-    case CurrentRange::_300mA_to_3A:    return 300;
-    case CurrentRange::AutoRange:       return tr("Auto");
-    default:                            return QVariant();
+    if (range == CurrentRange::AutoRange) {
+        return tr("Auto");
     }
+    return PokitRanges::minValue(PokitRanges::Quantity::Current, (quint8)range);
 }
 
 /*!
@@ -160,15 +133,10 @@ QVariant MultimeterService::minValue(const CurrentRange &range)
  */
 QVariant MultimeterService::maxValue(const CurrentRange &range)
 {
-    switch (range) {
-    case CurrentRange::_0_to_10mA:      return   10;
-    case CurrentRange::_10mA_to_30mA:   return   30;
-    case CurrentRange::_30mA_to_150mA:  return  150;
-    case CurrentRange::_150mA_to_300mA: return  300;
-    case CurrentRange::_300mA_to_3A:    return 3000;
-    case CurrentRange::AutoRange:       return tr("Auto");
-    default:                            return QVariant();
+    if (range == CurrentRange::AutoRange) {
+        return tr("Auto");
     }
+    return PokitRanges::maxValue(PokitRanges::Quantity::Current, (quint8)range);
 }
 
 /// \enum MultimeterService::ResistanceRange
@@ -178,18 +146,10 @@ QVariant MultimeterService::maxValue(const CurrentRange &range)
 /// Returns \a range as a user-friendly string.
 QString MultimeterService::toString(const ResistanceRange &range)
 {
-    switch (range) {
-    case ResistanceRange::_0_to_160:     return tr("0 to 160 ohms");
-    case ResistanceRange::_160_to_330:   return tr("160 to 330 ohms");
-    case ResistanceRange::_330_to_890:   return tr("330 to 890 ohms");
-    case ResistanceRange::_890_to_1K5:   return tr("890 to 1.5K ohms");
-    case ResistanceRange::_1K5_to_10K:   return tr("1.5K to 10K ohms");
-    case ResistanceRange::_10K_to_100K:  return tr("10K to 100K ohms");
-    case ResistanceRange::_100K_to_470K: return tr("100K to 470K ohms");
-    case ResistanceRange::_470K_to_1M:   return tr("470K to 1M ohms");
-    case ResistanceRange::AutoRange:     return tr("Auto-range");
-    default:                             return QString();
+    if (range == ResistanceRange::AutoRange) {
+        return tr("Auto-range");
     }
+    return PokitRanges::label(PokitRanges::Quantity::Resistance, (quint8)range);
 }
 
 /*!
@@ -198,18 +158,10 @@ QString MultimeterService::toString(const ResistanceRange &range)
  */
 QVariant MultimeterService::minValue(const ResistanceRange &range)
 {
-    switch (range) {
-    case ResistanceRange::_0_to_160:     return      0;
-    case ResistanceRange::_160_to_330:   return    160;
-    case ResistanceRange::_330_to_890:   return    330;
-    case ResistanceRange::_890_to_1K5:   return    890;
-    case ResistanceRange::_1K5_to_10K:   return   1500;
-    case ResistanceRange::_10K_to_100K:  return  10000;
-    case ResistanceRange::_100K_to_470K: return 100000;
-    case ResistanceRange::_470K_to_1M:   return 470000;
-    case ResistanceRange::AutoRange:     return tr("Auto");
-    default:                             return QVariant();
+    if (range == ResistanceRange::AutoRange) {
+        return tr("Auto");
     }
+    return PokitRanges::minValue(PokitRanges::Quantity::Resistance, (quint8)range);
 }
 
 /*!
@@ -218,18 +170,10 @@ QVariant MultimeterService::minValue(const ResistanceRange &range)
  */
 QVariant MultimeterService::maxValue(const ResistanceRange &range)
 {
-    switch (range) {
-    case ResistanceRange::_0_to_160:     return     160;
-    case ResistanceRange::_160_to_330:   return     330;
-    case ResistanceRange::_330_to_890:   return     890;
-    case ResistanceRange::_890_to_1K5:   return    1500;
-    case ResistanceRange::_1K5_to_10K:   return   10000;
-    case ResistanceRange::_10K_to_100K:  return  100000;
-    case ResistanceRange::_100K_to_470K: return  470000;
-    case ResistanceRange::_470K_to_1M:   return 1000000;
-    case ResistanceRange::AutoRange:     return tr("Auto");
-    default:                             return QVariant();
+    if (range == ResistanceRange::AutoRange) {
+        return tr("Auto");
     }
+    return PokitRanges::maxValue(PokitRanges::Quantity::Resistance, (quint8)range);
 }
 
 /// \union MultimeterService::Range
@@ -317,7 +261,7 @@ bool MultimeterService::readReadingCharacteristic()
  */
 bool MultimeterService::setSettings(const Settings &settings)
 {
-    Q_D(const MultimeterService);
+    Q_D(MultimeterService);
     const QLowEnergyCharacteristic characteristic =
         d->getCharacteristic(CharacteristicUuids::settings);
     if (!characteristic.isValid()) {
@@ -329,7 +273,7 @@ bool MultimeterService::setSettings(const Settings &settings)
         return false;
     }
 
-    d->service->writeCharacteristic(characteristic, value);
+    d->writeCharacteristic(characteristic, value);
     return (d->service->error() != QLowEnergyService::ServiceError::CharacteristicWriteError);
 }
 
@@ -512,28 +456,26 @@ void MultimeterServicePrivate::characteristicWritten(const QLowEnergyCharacteris
 }
 
 /*!
- * Implements AbstractPokitServicePrivate::characteristicChanged to parse \a newValue, then emit a
- * specialised signal, for each supported \a characteristic.
+ * Implements AbstractPokitServicePrivate::characteristicNotified to parse \a newValue, then emit a
+ * specialised signal, for each supported characteristic \a uuid.
  */
-void MultimeterServicePrivate::characteristicChanged(const QLowEnergyCharacteristic &characteristic,
-                                                     const QByteArray &newValue)
+void MultimeterServicePrivate::characteristicNotified(const QBluetoothUuid &uuid,
+                                                      const QByteArray &newValue)
 {
-    AbstractPokitServicePrivate::characteristicChanged(characteristic, newValue);
-
     Q_Q(MultimeterService);
-    if (characteristic.uuid() == MultimeterService::CharacteristicUuids::settings) {
+    if (uuid == MultimeterService::CharacteristicUuids::settings) {
         qCWarning(lc).noquote() << tr("Settings characteristic is write-only, but somehow updated")
-            << serviceUuid << characteristic.name() << characteristic.uuid();
+            << serviceUuid << uuid;
         return;
     }
 
-    if (characteristic.uuid() == MultimeterService::CharacteristicUuids::reading) {
+    if (uuid == MultimeterService::CharacteristicUuids::reading) {
         emit q->readingRead(parseReading(newValue));
         return;
     }
 
     qCWarning(lc).noquote() << tr("Unknown characteristic notified for Multimeter service")
-        << serviceUuid << characteristic.name() << characteristic.uuid();
+        << serviceUuid << uuid;
 }
 
 /// \endcond
@@ -31,8 +31,7 @@ protected:
                             const QByteArray &value) override;
     void characteristicWritten(const QLowEnergyCharacteristic &characteristic,
                                const QByteArray &newValue) override;
-    void characteristicChanged(const QLowEnergyCharacteristic &characteristic,
-                               const QByteArray &newValue) override;
+    void characteristicNotified(const QBluetoothUuid &uuid, const QByteArray &newValue) override;
 
 private:
     Q_DECLARE_PUBLIC(MultimeterService)
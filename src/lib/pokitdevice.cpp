@@ -27,13 +27,85 @@
  *
  * It does this by wrapping QLowEnergyController to provide:
  * * convenient Pokit service factory methods (dataLogger(), deviceInformation(), dso(),
- *   genericAccess(), multimeter() and status()); and
+ *   genericAccess(), multimeter() and status());
+ * * connection parameter profiles (see setConnectionProfile()); and
  * * consistent debug logging of QLowEnergyController events.
  *
  * But this class is entirely optional, in that all features of all other QtPokit classes can be
  * used wihtout this class.  It's just a (meaningful) convenience.
  */
 
+/*!
+ * \enum PokitDevice::ConnectionProfile
+ *
+ * Each profile is a set of BLE connection parameters, chosen to trade notification throughput
+ * against power consumption, in the same manner as Android's connection priorities. For example,
+ * a Pokit device can only send a limited number of notifications per connection interval, so the
+ * Throughput profile's shorter intervals significantly increase the rate at which DSO and Data
+ * Logger samples can be fetched.
+ *
+ * \see profileParameters
+ */
+
+/*!
+ * Returns \a profile as a user-friendly string.
+ */
+QString PokitDevice::toString(const ConnectionProfile &profile)
+{
+    switch (profile) {
+    case ConnectionProfile::Balanced:   return tr("Balanced");
+    case ConnectionProfile::Throughput: return tr("Throughput");
+    case ConnectionProfile::LowPower:   return tr("Low power");
+    }
+    return QString();
+}
+
+/*!
+ * Returns the connection parameters requested for \a profile.
+ *
+ * | Profile    | Interval (ms) | Latency | Supervision timeout (ms) |
+ * |------------|---------------|---------|--------------------------|
+ * | Balanced   | 30 to 50      | 0       | 5000                     |
+ * | Throughput | 7.5 to 15     | 0       | 4000                     |
+ * | LowPower   | 100 to 125    | 2       | 6000                     |
+ */
+QLowEnergyConnectionParameters PokitDevice::profileParameters(const ConnectionProfile &profile)
+{
+    QLowEnergyConnectionParameters parameters;
+    switch (profile) {
+    case ConnectionProfile::Balanced:
+        parameters.setIntervalRange(30.0, 50.0);
+        parameters.setLatency(0);
+        parameters.setSupervisionTimeout(5000);
+        break;
+    case ConnectionProfile::Throughput:
+        parameters.setIntervalRange(7.5, 15.0); // 7.5ms is the smallest interval BLE allows.
+        parameters.setLatency(0);
+        parameters.setSupervisionTimeout(4000);
+        break;
+    case ConnectionProfile::LowPower:
+        parameters.setIntervalRange(100.0, 125.0);
+        parameters.setLatency(2);
+        parameters.setSupervisionTimeout(6000);
+        break;
+    }
+    return parameters;
+}
+
+/*!
+ * Returns the maximum number of value bytes a single notification can carry with an ATT \a mtu.
+ * That is, \a mtu less the 3-byte ATT notification header. If \a mtu is not known (ie is less than
+ * #defaultMtu), then #defaultMtu is assumed. The result is capped at 512 bytes, the maximum length
+ * of an attribute value.
+ *
+ * For example, the default MTU allows just 20 bytes (10 DSO or Data Logger samples) per
+ * notification, whereas an MTU of 247 (common with LE Data Length Extension) allows 244 bytes.
+ */
+int PokitDevice::maximumNotificationPayload(const int mtu)
+{
+    return qMin(qMax(mtu, int(defaultMtu)) - 3, 512);
+}
+
 /*!
  * Constructs a new Pokit device controller wrapper for \a deviceInfo, with \a parent.
  *
@@ -194,6 +266,65 @@ StatusService * PokitDevice::status()
 }
 #undef POKIT_INTERNAL_GET_SERVICE
 
+/*!
+ * Returns the connection profile most recently set via setConnectionProfile(), which is
+ * ConnectionProfile::Balanced by default.
+ */
+PokitDevice::ConnectionProfile PokitDevice::connectionProfile() const
+{
+    Q_D(const PokitDevice);
+    return d->connectionProfile;
+}
+
+/*!
+ * Sets the connection \a profile to request of the Pokit device. If the device is connected, the
+ * profile's parameters (see profileParameters()) are requested immediately, otherwise they will be
+ * requested once connected.
+ *
+ * Typically, clients would set ConnectionProfile::Throughput before bulk transfers (such as
+ * fetching DSO or Data Logger samples), then restore ConnectionProfile::Balanced afterwards.
+ *
+ * Note, the device (and local Bluetooth stack) may choose other parameters, so clients should use
+ * connectionParameters() (or the connectionParametersUpdated() signal) to see what was actually
+ * negotiated. Also, Qt only supports connection parameter requests on some platforms (currently
+ * Linux and Android); elsewhere this function has no effect.
+ */
+void PokitDevice::setConnectionProfile(const ConnectionProfile profile)
+{
+    Q_D(PokitDevice);
+    if (profile == d->connectionProfile) {
+        return;
+    }
+    d->connectionProfile = profile;
+    d->requestConnectionProfile();
+}
+
+/*!
+ * Returns the connection parameters most recently negotiated with the Pokit device, or invalid
+ * (default constructed) parameters if none have been reported yet.
+ *
+ * \see connectionParametersUpdated
+ */
+QLowEnergyConnectionParameters PokitDevice::connectionParameters() const
+{
+    Q_D(const PokitDevice);
+    return d->connectionParameters;
+}
+
+/*!
+ * Returns the ATT MTU (Maximum Transmission Unit) negotiated with the Pokit device, in bytes, or
+ * `-1` if not known, such as before connecting, or with Qt versions prior to 6.2, which do not
+ * report the MTU.
+ *
+ * \see maximumNotificationPayload
+ * \see mtuChanged
+ */
+int PokitDevice::mtu() const
+{
+    Q_D(const PokitDevice);
+    return d->mtu;
+}
+
 /*!
  * Returns a human-readable name for the \a uuid service, or a null QString if unknonw.
  *
@@ -263,6 +394,21 @@ QString PokitDevice::charcteristicToString(const QBluetoothUuid &uuid)
     return hash.value(uuid);
 }
 
+/*!
+ * \fn PokitDevice::connectionParametersUpdated
+ *
+ * This signal is emitted when the connection \a parameters have been (re)negotiated with the
+ * Pokit device, such as after setConnectionProfile().
+ */
+
+/*!
+ * \fn PokitDevice::mtuChanged
+ *
+ * This signal is emitted when the ATT \a mtu has been (re)negotiated with the Pokit device.
+ *
+ * \see mtu
+ */
+
 /*!
  * \cond internal
  * \class PokitDevicePrivate
@@ -275,7 +421,8 @@ QString PokitDevice::charcteristicToString(const QBluetoothUuid &uuid)
  */
 PokitDevicePrivate::PokitDevicePrivate(PokitDevice * const q)
     : controller(nullptr), calibration(nullptr), dataLogger(nullptr), deviceInfo(nullptr),
-      dso(nullptr), genericAccess(nullptr), multimeter(nullptr), status(nullptr), q_ptr(q)
+      dso(nullptr), genericAccess(nullptr), multimeter(nullptr), status(nullptr),
+      connectionProfile(PokitDevice::ConnectionProfile::Balanced), mtu(-1), q_ptr(q)
 {
 
 }
@@ -341,12 +488,45 @@ void PokitDevicePrivate::setController(QLowEnergyController * newController)
     connect(controller, &QLowEnergyController::serviceDiscovered,
             this, &PokitDevicePrivate::serviceDiscovered);
 
+    #if (QT_VERSION >= QT_VERSION_CHECK(6, 2, 0)) // MTU reporting added in Qt 6.2.
+    connect(controller, &QLowEnergyController::mtuChanged,
+            this, &PokitDevicePrivate::mtuChanged);
+    #endif
+
     connect(controller, &QLowEnergyController::stateChanged,
             this, &PokitDevicePrivate::stateChanged);
 }
 
+/*!
+ * Requests the #connectionProfile parameters, if the controller is connected.
+ *
+ * Returns \c true if the request was made, \c false otherwise.
+ */
+bool PokitDevicePrivate::requestConnectionProfile()
+{
+    if ((!controller) || (controller->state() == QLowEnergyController::UnconnectedState) ||
+        (controller->state() == QLowEnergyController::ConnectingState) ||
+        (controller->state() == QLowEnergyController::ClosingState))
+    {
+        qCDebug(lc).noquote() << tr("Deferring %1 connection profile until connected.")
+            .arg(PokitDevice::toString(connectionProfile));
+        return false;
+    }
+    const QLowEnergyConnectionParameters parameters =
+        PokitDevice::profileParameters(connectionProfile);
+    qCDebug(lc).noquote() << tr("Requesting %1 connection profile: interval %2 to %3ms, latency "
+        "%4, supervision timeout %5ms.").arg(PokitDevice::toString(connectionProfile))
+        .arg(parameters.minimumInterval()).arg(parameters.maximumInterval())
+        .arg(parameters.latency()).arg(parameters.supervisionTimeout());
+    controller->requestConnectionUpdate(parameters);
+    return true;
+}
+
 /*!
  * Handle connected signals.
+ *
+ * If a connection profile other than the default (ConnectionProfile::Balanced) has been set, then
+ * that profile's parameters are requested now.
  */
 void PokitDevicePrivate::connected()
 {
@@ -357,16 +537,26 @@ void PokitDevicePrivate::connected()
     qCDebug(lc).noquote() << tr("Connected to \"%1\" (%2) at (%3).").arg(
         controller->remoteName(), controller->remoteDeviceUuid().toString(),
         controller->remoteAddress().toString());
+    #if (QT_VERSION >= QT_VERSION_CHECK(6, 2, 0)) // MTU reporting added in Qt 6.2.
+    mtuChanged(controller->mtu());
+    #endif
+    if (connectionProfile != PokitDevice::ConnectionProfile::Balanced) {
+        requestConnectionProfile();
+    }
 }
 
 /*!
- * Handle connectionUpdated signals.
+ * Handle connectionUpdated signals, by recording \a newParameters, and re-emitting them via
+ * PokitDevice::connectionParametersUpdated.
  */
 void PokitDevicePrivate::connectionUpdated(const QLowEnergyConnectionParameters &newParameters)
 {
+    Q_Q(PokitDevice);
     qCDebug(lc).noquote() << tr("Connection updated:") << newParameters.latency()
         << newParameters.minimumInterval() << newParameters.maximumInterval()
         << newParameters.supervisionTimeout();
+    connectionParameters = newParameters;
+    emit q->connectionParametersUpdated(newParameters);
 }
 
 /*!
@@ -393,6 +583,23 @@ void PokitDevicePrivate::errorOccurred(QLowEnergyController::Error newError)
     qCDebug(lc).noquote() << tr("Controller error:") << newError;
 }
 
+/*!
+ * Handle mtuChanged signals, by recording \a newMtu, and re-emitting it via
+ * PokitDevice::mtuChanged (if changed).
+ */
+void PokitDevicePrivate::mtuChanged(const int newMtu)
+{
+    if (newMtu == mtu) {
+        return;
+    }
+    const int payload = PokitDevice::maximumNotificationPayload(newMtu);
+    qCDebug(lc).noquote() << tr("MTU changed to %1 bytes; up to %2 bytes (%3 samples) per "
+        "notification.").arg(newMtu).arg(payload).arg(payload / 2);
+    Q_Q(PokitDevice);
+    mtu = newMtu;
+    emit q->mtuChanged(newMtu);
+}
+
 /*!
  * Handle serviceDiscovered signals.
  */
@@ -9,7 +9,7 @@
 #ifndef QTPOKIT_POKITDEVICE_P_H
 #define QTPOKIT_POKITDEVICE_P_H
 
-#include <qtpokit/qtpokit_global.h>
+#include <qtpokit/pokitdevice.h>
 
 #include <QLoggingCategory>
 #include <QLowEnergyController>
@@ -27,8 +27,6 @@ class GenericAccessService;
 class MultimeterService;
 class StatusService;
 
-class PokitDevice;
-
 class QTPOKIT_EXPORT PokitDevicePrivate : public QObject
 {
     Q_OBJECT
@@ -54,9 +52,14 @@ public:
     QMutex multimeterMutex;    ///< Mutex for protecting access to #multimeter.
     QMutex statusMutex;        ///< Mutex for protecting access to #status.
 
+    PokitDevice::ConnectionProfile connectionProfile; ///< Connection profile to request.
+    QLowEnergyConnectionParameters connectionParameters; ///< Most recently negotiated parameters.
+    int mtu; ///< Most recently negotiated ATT MTU, or `-1` if not known.
+
     explicit PokitDevicePrivate(PokitDevice * const q);
 
     void setController(QLowEnergyController * newController);
+    bool requestConnectionProfile();
 
 public slots:
     void connected();
@@ -64,6 +67,7 @@ public slots:
     void disconnected();
     void discoveryFinished();
     void errorOccurred(QLowEnergyController::Error newError);
+    void mtuChanged(const int newMtu);
     void serviceDiscovered(const QBluetoothUuid &newService);
     void stateChanged(QLowEnergyController::ControllerState state);
 
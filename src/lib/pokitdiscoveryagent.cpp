@@ -20,8 +20,25 @@
  *
  * After constructing a PokitDiscoveryAgent object, and subscribing to the relevant signals,
  * invoke start() to begin discovery.
+ *
+ * Alternatively, invoke startMonitoring() to continuously track the presence of nearby Pokit
+ * devices. Rather than scanning continuously (or repeatedly restarting full scans), monitoring runs
+ * a duty-cycled schedule of short scans (see PresenceSettings), keeps a table of when each Pokit
+ * device was last seen, and its smoothed RSSI, and emits:
+ *  - pokitDeviceAppeared() when a device is first seen;
+ *  - pokitDeviceMoved() when a device's smoothed RSSI (see RssiTracker) has changed by at least
+ *    PresenceSettings::rssiThreshold dBm since it was first known (or last moved); and
+ *  - pokitDeviceLost() when a device has not been seen for PresenceSettings::lostTimeout
+ *    milliseconds, which should span a few scan cycles, so that one missed advertisement does not
+ *    make a device flap between lost and appeared.
  */
 
+/// \struct PokitDiscoveryAgent::PresenceSettings
+/// \brief Settings for the presence monitoring scan schedule, and its event hysteresis.
+
+/// \struct PokitDiscoveryAgent::Presence
+/// \brief Presence details of a monitored Pokit device.
+
 /*!
  * Constructs a new Pokit device discovery agent with \a parent, using \a deviceAdapter for the
  * search device.
@@ -109,6 +126,15 @@ bool PokitDiscoveryAgent::isPokitPro(const QBluetoothDeviceInfo &info)
     return info.serviceUuids().contains(StatusService::ServiceUuids::pokitPro);
 }
 
+/*!
+ * Returns the key that uniquely identifies the device described by \a info, being its Bluetooth
+ * address, or on platforms that do not expose addresses (such as macOS), its device UUID.
+ */
+QString PokitDiscoveryAgent::deviceKey(const QBluetoothDeviceInfo &info)
+{
+    return (info.address().isNull()) ? info.deviceUuid().toString() : info.address().toString();
+}
+
 /*!
  * Starts Pokit device discovery.
  *
@@ -133,6 +159,103 @@ void PokitDiscoveryAgent::start()
     QBluetoothDeviceDiscoveryAgent::start(QBluetoothDeviceDiscoveryAgent::LowEnergyMethod);
 }
 
+/*!
+ * Returns the default presence monitoring settings: 4 second scans, every 20 seconds (a 20% duty
+ * cycle), with devices lost after 60 seconds (3 scan cycles) unseen, and moved after a 6 dBm change
+ * in smoothed RSSI.
+ */
+PokitDiscoveryAgent::PresenceSettings PokitDiscoveryAgent::defaultPresenceSettings()
+{
+    return { 4000, 20000, 60000, 6 };
+}
+
+/*!
+ * Returns the current presence monitoring settings.
+ */
+PokitDiscoveryAgent::PresenceSettings PokitDiscoveryAgent::presenceSettings() const
+{
+    Q_D(const PokitDiscoveryAgent);
+    return d->settings;
+}
+
+/*!
+ * Sets the presence monitoring \a settings. Any PresenceSettings::scanDuration longer than the
+ * PresenceSettings::scanInterval is reduced to match it (ie continuous scanning). If monitoring is
+ * already running, the new schedule applies from the next scan cycle.
+ */
+void PokitDiscoveryAgent::setPresenceSettings(const PresenceSettings &settings)
+{
+    Q_D(PokitDiscoveryAgent);
+    d->settings = settings;
+    d->settings.scanInterval = qMax(settings.scanInterval, 1);
+    d->settings.scanDuration = qBound(1, settings.scanDuration, d->settings.scanInterval);
+    if (d->monitoring) {
+        d->scanTimer.setInterval(d->settings.scanInterval);
+        setLowEnergyDiscoveryTimeout(d->settings.scanDuration);
+    }
+}
+
+/*!
+ * Returns `true` if presence monitoring is running, `false` otherwise.
+ */
+bool PokitDiscoveryAgent::isMonitoring() const
+{
+    Q_D(const PokitDiscoveryAgent);
+    return d->monitoring;
+}
+
+/*!
+ * Returns the presence details of each monitored Pokit device that is currently present (ie has
+ * appeared, and not been lost since).
+ */
+QList<PokitDiscoveryAgent::Presence> PokitDiscoveryAgent::presentDevices() const
+{
+    Q_D(const PokitDiscoveryAgent);
+    return d->presence.values();
+}
+
+/*!
+ * Starts continuous presence monitoring of nearby Pokit devices, according to presenceSettings().
+ *
+ * Any previous presence table is cleared, so all nearby devices will (re-)appear.
+ */
+void PokitDiscoveryAgent::startMonitoring()
+{
+    Q_D(PokitDiscoveryAgent);
+    if (!d->monitoring) {
+        d->savedTimeout = lowEnergyDiscoveryTimeout();
+    }
+    d->monitoring = true;
+    d->presence.clear();
+    qCDebug(d->lc).noquote() << tr("Monitoring Pokit device presence; %1ms scans every %2ms.")
+        .arg(d->settings.scanDuration).arg(d->settings.scanInterval);
+    if (isActive()) {
+        stop(); // So the next scan begins with the monitoring timeout.
+    }
+    setLowEnergyDiscoveryTimeout(d->settings.scanDuration);
+    d->scanTimer.start(d->settings.scanInterval);
+    d->startScanCycle();
+}
+
+/*!
+ * Stops presence monitoring, including any scan in progress. The presence table is retained, and
+ * so remains available via presentDevices().
+ */
+void PokitDiscoveryAgent::stopMonitoring()
+{
+    Q_D(PokitDiscoveryAgent);
+    if (!d->monitoring) {
+        return;
+    }
+    d->monitoring = false;
+    d->scanTimer.stop();
+    if (isActive()) {
+        stop();
+    }
+    setLowEnergyDiscoveryTimeout(d->savedTimeout);
+    qCDebug(d->lc).noquote() << tr("Stopped monitoring Pokit device presence.");
+}
+
 /*!
  * \fn void PokitDiscoveryAgent::pokitDeviceDiscovered(const QBluetoothDeviceInfo &info)
  *
@@ -146,6 +269,26 @@ void PokitDiscoveryAgent::start()
  * \a updatedFields flags tell which information has been updated.
  */
 
+/*!
+ * \fn void PokitDiscoveryAgent::pokitDeviceAppeared(const QBluetoothDeviceInfo &info)
+ *
+ * This signal is emitted, while monitoring, when the Pokit device described by \a info appears.
+ */
+
+/*!
+ * \fn void PokitDiscoveryAgent::pokitDeviceMoved(const QBluetoothDeviceInfo &info, const qint16 rssi)
+ *
+ * This signal is emitted, while monitoring, when the smoothed RSSI of the Pokit device described by
+ * \a info has changed to \a rssi, by at least PresenceSettings::rssiThreshold dBm.
+ */
+
+/*!
+ * \fn void PokitDiscoveryAgent::pokitDeviceLost(const QBluetoothDeviceInfo &info)
+ *
+ * This signal is emitted, while monitoring, when the Pokit device described by \a info has not
+ * been seen for PresenceSettings::lostTimeout milliseconds.
+ */
+
 /*!
  * \cond internal
  * \class PokitDiscoveryAgentPrivate
@@ -159,8 +302,11 @@ void PokitDiscoveryAgent::start()
  * Constructs a new PokitDiscoveryAgentPrivate object with public implementation \a q.
  */
 PokitDiscoveryAgentPrivate::PokitDiscoveryAgentPrivate(PokitDiscoveryAgent * const q)
-    : q_ptr(q)
+    : monitoring(false), settings(PokitDiscoveryAgent::defaultPresenceSettings()), savedTimeout(0),
+      q_ptr(q)
 {
+    connect(&scanTimer, &QTimer::timeout, this, &PokitDiscoveryAgentPrivate::startScanCycle);
+
     connect(q, &QBluetoothDeviceDiscoveryAgent::deviceDiscovered,
             this, &PokitDiscoveryAgentPrivate::deviceDiscovered);
 
@@ -190,6 +336,9 @@ void PokitDiscoveryAgentPrivate::deviceDiscovered(const QBluetoothDeviceInfo &in
     qCDebug(lc).noquote() << tr("Discovered Pokit device \"%1\" at %2.")
         .arg(info.name(), info.address().toString());
     emit q->pokitDeviceDiscovered(info);
+    if (monitoring) {
+        updatePresence(info, QDateTime::currentDateTimeUtc());
+    }
 }
 
 #if (QT_VERSION >= QT_VERSION_CHECK(5, 12, 0)) // Required signal, and Fields, added in Qt 5.12.
@@ -208,6 +357,9 @@ void PokitDiscoveryAgentPrivate::deviceUpdated(
     qCDebug(lc).noquote() << tr("Pokit device \"%1\" at %2 updated with RSSI %3.")
         .arg(info.name(), info.address().toString()).arg(info.rssi());
     emit q->pokitDeviceUpdated(info, updatedFields);
+    if (monitoring) {
+        updatePresence(info, QDateTime::currentDateTimeUtc());
+    }
 }
 #endif
 
@@ -227,4 +379,76 @@ void PokitDiscoveryAgentPrivate::finished()
     qCDebug(lc).noquote() << tr("Pokit device scan finished.");
 }
 
+/*!
+ * Records that the Pokit device described by \a info was seen at \a now, emitting
+ * PokitDiscoveryAgent::pokitDeviceAppeared if it is new, or PokitDiscoveryAgent::pokitDeviceMoved
+ * if its smoothed RSSI has moved by at least PokitDiscoveryAgent::PresenceSettings::rssiThreshold.
+ */
+void PokitDiscoveryAgentPrivate::updatePresence(const QBluetoothDeviceInfo &info,
+                                                const QDateTime &now)
+{
+    Q_Q(PokitDiscoveryAgent);
+    const QString key = PokitDiscoveryAgent::deviceKey(info);
+    const auto iter = presence.find(key);
+    if (iter == presence.end()) {
+        PokitDiscoveryAgent::Presence device{ info, now, now, RssiTracker() };
+        device.signalStrength.update(info.rssi(), settings.rssiThreshold);
+        presence.insert(key, device);
+        qCDebug(lc).noquote() << tr("Pokit device \"%1\" at %2 appeared with RSSI %3.")
+            .arg(info.name(), key).arg(info.rssi());
+        emit q->pokitDeviceAppeared(info);
+        return;
+    }
+
+    PokitDiscoveryAgent::Presence &device = iter.value();
+    device.info = info;
+    device.lastSeen = now;
+    const qint16 previous = device.signalStrength.reported();
+    if (device.signalStrength.update(info.rssi(), settings.rssiThreshold)) {
+        qCDebug(lc).noquote() << tr("Pokit device \"%1\" at %2 moved from RSSI %3 to %4.")
+            .arg(info.name(), key).arg(previous).arg(device.signalStrength.reported());
+        emit q->pokitDeviceMoved(info, device.signalStrength.reported());
+    }
+}
+
+/*!
+ * Removes, from the #presence table, all devices that have not been seen for at least
+ * PokitDiscoveryAgent::PresenceSettings::lostTimeout milliseconds before \a now, emitting
+ * PokitDiscoveryAgent::pokitDeviceLost for each.
+ */
+void PokitDiscoveryAgentPrivate::checkForLostDevices(const QDateTime &now)
+{
+    Q_Q(PokitDiscoveryAgent);
+    for (auto iter = presence.begin(); iter != presence.end();) {
+        if (iter->lastSeen.msecsTo(now) < settings.lostTimeout) {
+            ++iter;
+            continue;
+        }
+        const QBluetoothDeviceInfo info = iter->info;
+        qCDebug(lc).noquote() << tr("Pokit device \"%1\" at %2 lost; last seen %3.")
+            .arg(info.name(), iter.key(), iter->lastSeen.toString(Qt::ISODateWithMs));
+        iter = presence.erase(iter);
+        emit q->pokitDeviceLost(info);
+    }
+}
+
+/*!
+ * Begins the next presence monitoring scan cycle, by first checking for lost devices, then starting
+ * a (PokitDiscoveryAgent::PresenceSettings::scanDuration long) scan, unless the previous scan is
+ * somehow still active.
+ */
+void PokitDiscoveryAgentPrivate::startScanCycle()
+{
+    Q_Q(PokitDiscoveryAgent);
+    if (!monitoring) {
+        return;
+    }
+    checkForLostDevices(QDateTime::currentDateTimeUtc());
+    if (q->isActive()) {
+        qCDebug(lc).noquote() << tr("Previous presence scan still active; skipping scan cycle.");
+        return;
+    }
+    q->start();
+}
+
 /// \endcond
@@ -9,16 +9,16 @@
 #ifndef QTPOKIT_POKITDISCOVERYAGENT_P_H
 #define QTPOKIT_POKITDISCOVERYAGENT_P_H
 
-#include <qtpokit/qtpokit_global.h>
+#include <qtpokit/pokitdiscoveryagent.h>
 
 #include <QBluetoothDeviceDiscoveryAgent>
 #include <QBluetoothDeviceInfo>
+#include <QHash>
 #include <QLoggingCategory>
+#include <QTimer>
 
 QTPOKIT_BEGIN_NAMESPACE
 
-class PokitDiscoveryAgent;
-
 class QTPOKIT_EXPORT PokitDiscoveryAgentPrivate : public QObject
 {
     Q_OBJECT
@@ -26,8 +26,17 @@ class QTPOKIT_EXPORT PokitDiscoveryAgentPrivate : public QObject
 public:
     static Q_LOGGING_CATEGORY(lc, "pokit.ble.discovery", QtInfoMsg); ///< Logging category.
 
+    bool monitoring;                                   ///< Whether presence monitoring is running.
+    PokitDiscoveryAgent::PresenceSettings settings;    ///< Presence monitoring settings.
+    QHash<QString, PokitDiscoveryAgent::Presence> presence; ///< Present devices, by device key.
+    QTimer scanTimer;                                  ///< Timer for starting each scan cycle.
+    int savedTimeout; ///< Low energy discovery timeout to restore when monitoring stops.
+
     explicit PokitDiscoveryAgentPrivate(PokitDiscoveryAgent * const q);
 
+    void updatePresence(const QBluetoothDeviceInfo &info, const QDateTime &now);
+    void checkForLostDevices(const QDateTime &now);
+
 public slots:
     void canceled();
     void deviceDiscovered(const QBluetoothDeviceInfo &info);
@@ -36,6 +45,7 @@ public slots:
     #endif
     void error(const QBluetoothDeviceDiscoveryAgent::Error error);
     void finished();
+    void startScanCycle();
 
 protected:
     PokitDiscoveryAgent * q_ptr; ///< Internal q-pointer.
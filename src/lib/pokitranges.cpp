@@ -0,0 +1,176 @@
+// SPDX-FileCopyrightText: 2022 Paul Colby <git@colby.id.au>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+/*!
+ * \file
+ * Defines the PokitRanges class.
+ */
+
+#include <qtpokit/pokitranges.h>
+#include <qtpokit/dataloggerservice.h>
+#include <qtpokit/dsoservice.h>
+#include <qtpokit/multimeterservice.h>
+
+/*!
+ * \class PokitRanges
+ *
+ * The PokitRanges class describes the measurement ranges supported by Pokit Meter devices.
+ *
+ * The ranges are defined in compile-time tables of Descriptor structs, one table per measured
+ * quantity, shared by the MultimeterService, DsoService and DataLoggerService classes. Each table
+ * is indexed by range value, so lookups (such as find() and lowest()) never allocate.
+ */
+
+/// \enum PokitRanges::Quantity
+/// \brief Quantities measured via ranges.
+
+/// \struct PokitRanges::Descriptor
+/// \brief Attributes of a single measurement range.
+
+/// \struct PokitRanges::Table
+/// \brief Contiguous, ordered, array of measurement range descriptors.
+
+/// \cond internal
+
+/// Pokit Meter voltage ranges, as used by MultimeterService, DsoService and DataLoggerService.
+static constexpr PokitRanges::Descriptor meterVoltageRanges[] {
+    { 0,  0.0,   0.3, QT_TRANSLATE_NOOP("PokitRanges", "0 to 300mV")  },
+    { 1,  0.3,   2.0, QT_TRANSLATE_NOOP("PokitRanges", "300mV to 2V") },
+    { 2,  2.0,   6.0, QT_TRANSLATE_NOOP("PokitRanges", "2V to 6V")    },
+    { 3,  6.0,  12.0, QT_TRANSLATE_NOOP("PokitRanges", "6V to 12V")   },
+    { 4, 12.0,  30.0, QT_TRANSLATE_NOOP("PokitRanges", "12V to 30V")  },
+    { 5, 30.0,  60.0, QT_TRANSLATE_NOOP("PokitRanges", "30V to 60V")  },
+};
+
+/// Pokit Meter current ranges, as used by MultimeterService, DsoService and DataLoggerService.
+static constexpr PokitRanges::Descriptor meterCurrentRanges[] {
+    { 0, 0.000, 0.010, QT_TRANSLATE_NOOP("PokitRanges", "0 to 10mA")      },
+    { 1, 0.010, 0.030, QT_TRANSLATE_NOOP("PokitRanges", "10mA to 30mA")   },
+    { 2, 0.030, 0.150, QT_TRANSLATE_NOOP("PokitRanges", "30mA to 150mA")  },
+    { 3, 0.150, 0.300, QT_TRANSLATE_NOOP("PokitRanges", "150mA to 300mA") },
+    { 4, 0.300, 3.000, QT_TRANSLATE_NOOP("PokitRanges", "300mA to 3A")    },
+};
+
+/// Pokit Meter resistance ranges, as used by MultimeterService.
+static constexpr PokitRanges::Descriptor meterResistanceRanges[] {
+    { 0,      0.0,     160.0, QT_TRANSLATE_NOOP("PokitRanges", "0 to 160 ohms")     },
+    { 1,    160.0,     330.0, QT_TRANSLATE_NOOP("PokitRanges", "160 to 330 ohms")   },
+    { 2,    330.0,     890.0, QT_TRANSLATE_NOOP("PokitRanges", "330 to 890 ohms")   },
+    { 3,    890.0,    1500.0, QT_TRANSLATE_NOOP("PokitRanges", "890 to 1.5K ohms")  },
+    { 4,   1500.0,   10000.0, QT_TRANSLATE_NOOP("PokitRanges", "1.5K to 10K ohms")  },
+    { 5,  10000.0,  100000.0, QT_TRANSLATE_NOOP("PokitRanges", "10K to 100K ohms")  },
+    { 6, 100000.0,  470000.0, QT_TRANSLATE_NOOP("PokitRanges", "100K to 470K ohms") },
+    { 7, 470000.0, 1000000.0, QT_TRANSLATE_NOOP("PokitRanges", "470K to 1M ohms")   },
+};
+
+/*!
+ * Returns `true` if \a ranges, from \a index onwards, are indexed by value, and are contiguous and
+ * ascending; which find() and lowest() rely on.
+ */
+template<int N>
+static constexpr bool isValidTable(const PokitRanges::Descriptor (&ranges)[N], const int index = 0)
+{
+    return (index >= N) || ((ranges[index].value == index) &&
+        (ranges[index].minimum < ranges[index].maximum) &&
+        ((index == 0) || (ranges[index-1].maximum == ranges[index].minimum)) &&
+        (isValidTable(ranges, index + 1)));
+}
+
+/// Returns the number of descriptors in \a ranges.
+template<int N>
+static constexpr int tableSize(const PokitRanges::Descriptor (&)[N])
+{
+    return N;
+}
+
+static_assert(isValidTable(meterVoltageRanges), "Invalid Pokit Meter voltage ranges");
+static_assert(isValidTable(meterCurrentRanges), "Invalid Pokit Meter current ranges");
+static_assert(isValidTable(meterResistanceRanges), "Invalid Pokit Meter resistance ranges");
+
+// Each service's range enums must cover exactly the same values as the shared tables.
+#define QTPOKIT_ASSERT_LAST_RANGE(ranges, last) \
+    static_assert((int)last + 1 == tableSize(ranges), #last " does not match " #ranges);
+QTPOKIT_ASSERT_LAST_RANGE(meterVoltageRanges, MultimeterService::VoltageRange::_30V_to_60V)
+QTPOKIT_ASSERT_LAST_RANGE(meterVoltageRanges, DsoService::VoltageRange::_30V_to_60V)
+QTPOKIT_ASSERT_LAST_RANGE(meterVoltageRanges, DataLoggerService::VoltageRange::_30V_to_60V)
+QTPOKIT_ASSERT_LAST_RANGE(meterCurrentRanges, MultimeterService::CurrentRange::_300mA_to_3A)
+QTPOKIT_ASSERT_LAST_RANGE(meterCurrentRanges, DsoService::CurrentRange::_300mA_to_3A)
+QTPOKIT_ASSERT_LAST_RANGE(meterCurrentRanges, DataLoggerService::CurrentRange::_300mA_to_3A)
+QTPOKIT_ASSERT_LAST_RANGE(meterResistanceRanges, MultimeterService::ResistanceRange::_470K_to_1M)
+#undef QTPOKIT_ASSERT_LAST_RANGE
+
+/// \endcond
+
+/*!
+ * Returns the table of ranges for \a quantity.
+ */
+PokitRanges::Table PokitRanges::table(const Quantity quantity)
+{
+    switch (quantity) {
+    case Quantity::Voltage:
+        return Table{ meterVoltageRanges, tableSize(meterVoltageRanges) };
+    case Quantity::Current:
+        return Table{ meterCurrentRanges, tableSize(meterCurrentRanges) };
+    case Quantity::Resistance:
+        return Table{ meterResistanceRanges, tableSize(meterResistanceRanges) };
+    }
+    return Table{ nullptr, 0 };
+}
+
+/*!
+ * Returns the descriptor of the \a quantity range with \a value, or `nullptr` if there is no such
+ * range (such as the various services' `AutoRange` values).
+ */
+const PokitRanges::Descriptor * PokitRanges::find(const Quantity quantity, const quint8 value)
+{
+    const Table ranges = table(quantity);
+    return (value < ranges.size) ? (ranges.descriptors + value) : nullptr;
+}
+
+/*!
+ * Returns the descriptor of the lowest \a quantity range that can measure at least up to
+ * \a maximum (in SI units), or `nullptr` if no range can.
+ */
+const PokitRanges::Descriptor * PokitRanges::lowest(const Quantity quantity, const double maximum)
+{
+    for (const Descriptor &range: table(quantity)) {
+        if (maximum <= range.maximum) {
+            return &range;
+        }
+    }
+    return nullptr;
+}
+
+/*!
+ * Returns the user-friendly (translated) label of the \a quantity range with \a value, or a null
+ * QString if there is no such range.
+ */
+QString PokitRanges::label(const Quantity quantity, const quint8 value)
+{
+    const Descriptor * const range = find(quantity, value);
+    return (range) ? tr(range->label) : QString();
+}
+
+/*!
+ * Returns the minimum value of the \a quantity range with \a value, as an integer number of
+ * millivolts, milliamps, or ohms (according to \a quantity), or a null QVariant if there is no such
+ * range. This is the form returned by the services' `minValue()` functions.
+ */
+QVariant PokitRanges::minValue(const Quantity quantity, const quint8 value)
+{
+    const Descriptor * const range = find(quantity, value);
+    return (range) ? QVariant(qRound(range->minimum *
+        ((quantity == Quantity::Resistance) ? 1.0 : 1000.0))) : QVariant();
+}
+
+/*!
+ * Returns the maximum value of the \a quantity range with \a value, as an integer number of
+ * millivolts, milliamps, or ohms (according to \a quantity), or a null QVariant if there is no such
+ * range. This is the form returned by the services' `maxValue()` functions.
+ */
+QVariant PokitRanges::maxValue(const Quantity quantity, const quint8 value)
+{
+    const Descriptor * const range = find(quantity, value);
+    return (range) ? QVariant(qRound(range->maximum *
+        ((quantity == Quantity::Resistance) ? 1.0 : 1000.0))) : QVariant();
+}
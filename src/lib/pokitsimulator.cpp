@@ -0,0 +1,363 @@
+// SPDX-FileCopyrightText: 2022 Paul Colby <git@colby.id.au>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+/*!
+ * \file
+ * Defines the PokitSimulator and PokitSimulatorPrivate classes.
+ */
+
+#include <qtpokit/pokitsimulator.h>
+#include "pokitsimulator_p.h"
+#include "abstractpokitservice_p.h"
+
+#include <QDataStream>
+#include <QtEndian>
+#include <QtMath>
+
+/*!
+ * \class PokitSimulator
+ *
+ * The PokitSimulator class simulates the notification streams of a Pokit device's Multimeter, DSO
+ * and Data Logger services, at configurable rates and payload sizes, without any Bluetooth
+ * hardware. This allows the services' parsing, and everything downstream of their signals (such as
+ * output formatting), to be exercised and benchmarked on machines without Bluetooth radios.
+ *
+ * Qt's QLowEnergyController and QLowEnergyService classes cannot be substituted, since their
+ * behaviour is provided by private, platform-specific backends. So instead, PokitSimulator
+ * delivers each simulated value directly to the service's notification handling, exactly as a
+ * real `characteristicChanged` notification would be after Qt has dispatched it. The services may
+ * therefore be constructed without a controller, for example:
+ *
+ * ```
+ * MultimeterService service(nullptr);
+ * connect(&service, &MultimeterService::readingRead, ...);
+ * PokitSimulator simulator;
+ * simulator.addStream(&service, { 10, 0, 100 }); // 10 readings per second, 100 readings in total.
+ * simulator.start();
+ * ```
+ *
+ * DSO and Data Logger streams begin with a `Metadata` notification, followed by `Reading`
+ * notifications, each containing PokitSimulator::StreamSettings::payloadSize bytes of samples.
+ */
+
+/*!
+ * Constructs a new PokitSimulator object, with \a parent.
+ */
+PokitSimulator::PokitSimulator(QObject * const parent)
+    : QObject(parent), d_ptr(new PokitSimulatorPrivate(this))
+{
+
+}
+
+/*!
+ * \cond internal
+ * Constructs a new PokitSimulator object with \a parent, and private implementation \a d.
+ */
+PokitSimulator::PokitSimulator(PokitSimulatorPrivate * const d, QObject * const parent)
+    : QObject(parent), d_ptr(d)
+{
+
+}
+/// \endcond
+
+/*!
+ * Destroys this PokitSimulator object.
+ */
+PokitSimulator::~PokitSimulator()
+{
+    delete d_ptr;
+}
+
+/*!
+ * Adds a stream of `Reading` notifications to Multimeter \a service, according to \a settings.
+ * Multimeter readings have a fixed size, so StreamSettings::payloadSize is ignored.
+ */
+void PokitSimulator::addStream(MultimeterService * const service, const StreamSettings &settings)
+{
+    Q_D(PokitSimulator);
+    QVector<QByteArray> readings;
+    for (int index = 0; index < 64; ++index) {
+        readings.append(encodeReading({
+            MultimeterService::MeterStatus::AutoRangeOff,
+            static_cast<float>(qSin(index * 2.0 * M_PI / 64.0) * 5.0),
+            MultimeterService::Mode::DcVoltage,
+            { MultimeterService::VoltageRange::_6V_to_12V }
+        }));
+    }
+    d->addStream(service, QBluetoothUuid(), QByteArray(),
+                 MultimeterService::CharacteristicUuids::reading, readings, settings);
+}
+
+/*!
+ * Adds a `Metadata` notification, then a stream of `Reading` notifications, to DSO \a service,
+ * according to \a settings.
+ */
+void PokitSimulator::addStream(DsoService * const service, const StreamSettings &settings)
+{
+    Q_D(PokitSimulator);
+    const int samplesPerReading = qMax(settings.payloadSize/2, 1);
+    const qint64 totalSamples = (settings.notificationCount > 0)
+        ? qint64(settings.notificationCount) * samplesPerReading : 8192;
+    QVector<QByteArray> readings;
+    for (int index = 0; index < 8; ++index) {
+        readings.append(encodeSamples(samplesPerReading, index * samplesPerReading));
+    }
+    d->addStream(service, DsoService::CharacteristicUuids::metadata, encodeMetadata({
+        DsoService::DsoStatus::Done, 12.0f/32767.0f, DsoService::Mode::DcVoltage,
+        { DsoService::VoltageRange::_6V_to_12V }, 1000000,
+        static_cast<quint16>(qMin<qint64>(totalSamples, 8192)), 8192
+    }), DsoService::CharacteristicUuids::reading, readings, settings);
+}
+
+/*!
+ * Adds a `Metadata` notification, then a stream of `Reading` notifications, to Data Logger
+ * \a service, according to \a settings.
+ */
+void PokitSimulator::addStream(DataLoggerService * const service, const StreamSettings &settings)
+{
+    Q_D(PokitSimulator);
+    const int samplesPerReading = qMax(settings.payloadSize/2, 1);
+    const qint64 totalSamples = (settings.notificationCount > 0)
+        ? qint64(settings.notificationCount) * samplesPerReading : 6192;
+    QVector<QByteArray> readings;
+    for (int index = 0; index < 8; ++index) {
+        readings.append(encodeSamples(samplesPerReading, index * samplesPerReading));
+    }
+    d->addStream(service, DataLoggerService::CharacteristicUuids::metadata, encodeMetadata({
+        DataLoggerService::LoggerStatus::Done, 12.0f/32767.0f,
+        DataLoggerService::Mode::DcVoltage, { DataLoggerService::VoltageRange::_6V_to_12V },
+        1000, static_cast<quint16>(qMin<qint64>(totalSamples, 6192)), 0
+    }), DataLoggerService::CharacteristicUuids::reading, readings, settings);
+}
+
+/*!
+ * Stops the simulation (if active), and removes all streams.
+ */
+void PokitSimulator::clearStreams()
+{
+    Q_D(PokitSimulator);
+    stop();
+    d->streams.clear();
+}
+
+/*!
+ * Returns `true` if the simulation is active, that is, start() has been called, and at least one
+ * stream has notifications remaining, and stop() has not been called since.
+ */
+bool PokitSimulator::isActive() const
+{
+    Q_D(const PokitSimulator);
+    return d->timer.isActive();
+}
+
+/*!
+ * Returns the total number of notifications (`Metadata` and `Reading`) delivered since start().
+ */
+qint64 PokitSimulator::notificationCount() const
+{
+    Q_D(const PokitSimulator);
+    return d->notificationCount;
+}
+
+/*!
+ * Returns the total number of notified bytes delivered since start().
+ */
+qint64 PokitSimulator::bytesNotified() const
+{
+    Q_D(const PokitSimulator);
+    return d->bytesNotified;
+}
+
+/*!
+ * Returns \a reading encoded as a Multimeter service `Reading` characteristic value.
+ */
+QByteArray PokitSimulator::encodeReading(const MultimeterService::Reading &reading)
+{
+    QByteArray value;
+    QDataStream stream(&value, QIODevice::WriteOnly);
+    stream.setByteOrder(QDataStream::LittleEndian);
+    stream.setFloatingPointPrecision(QDataStream::SinglePrecision);
+    stream << (quint8)reading.status << reading.value << (quint8)reading.mode
+           << (quint8)reading.range.voltageRange;
+    Q_ASSERT(value.size() == 7);
+    return value;
+}
+
+/*!
+ * Returns \a metadata encoded as a DSO service `Metadata` characteristic value.
+ */
+QByteArray PokitSimulator::encodeMetadata(const DsoService::Metadata &metadata)
+{
+    QByteArray value;
+    QDataStream stream(&value, QIODevice::WriteOnly);
+    stream.setByteOrder(QDataStream::LittleEndian);
+    stream.setFloatingPointPrecision(QDataStream::SinglePrecision);
+    stream << (quint8)metadata.status << metadata.scale << (quint8)metadata.mode
+           << (quint8)metadata.range.voltageRange << metadata.samplingWindow
+           << metadata.numberOfSamples << metadata.samplingRate;
+    Q_ASSERT(value.size() == 17);
+    return value;
+}
+
+/*!
+ * Returns \a metadata encoded as a (Pokit Meter) Data Logger service `Metadata` characteristic
+ * value.
+ */
+QByteArray PokitSimulator::encodeMetadata(const DataLoggerService::Metadata &metadata)
+{
+    QByteArray value;
+    QDataStream stream(&value, QIODevice::WriteOnly);
+    stream.setByteOrder(QDataStream::LittleEndian);
+    stream.setFloatingPointPrecision(QDataStream::SinglePrecision);
+    stream << (quint8)metadata.status << metadata.scale << (quint8)metadata.mode
+           << (quint8)metadata.range.voltageRange << (quint16)(metadata.updateInterval/1000)
+           << metadata.numberOfSamples << metadata.timestamp;
+    Q_ASSERT(value.size() == 15);
+    return value;
+}
+
+/*!
+ * Returns \a numberOfSamples signed 16-bit little-endian samples of a sine wave, with a period of
+ * 64 samples, beginning \a phase samples into the wave.
+ */
+QByteArray PokitSimulator::encodeSamples(const int numberOfSamples, const int phase)
+{
+    QByteArray value(numberOfSamples * 2, Qt::Uninitialized);
+    for (int index = 0; index < numberOfSamples; ++index) {
+        const qint16 sample = static_cast<qint16>(
+            qSin((phase + index) * 2.0 * M_PI / 64.0) * 10000.0);
+        qToLittleEndian<qint16>(sample, value.data() + index * 2);
+    }
+    return value;
+}
+
+/*!
+ * Starts (or restarts) the simulation, delivering each stream's `Metadata` notification (if any)
+ * immediately, and its `Reading` notifications at the stream's configured rate thereafter.
+ */
+void PokitSimulator::start()
+{
+    Q_D(PokitSimulator);
+    d->notificationCount = 0;
+    d->bytesNotified = 0;
+    bool unlimitedRate = false;
+    // Index-based, with copies, since receivers may add (or clear) streams during delivery.
+    for (int index = 0; index < d->streams.size(); ++index) {
+        d->streams[index].notified = 0;
+        const PokitSimulatorPrivate::Stream stream = d->streams.at(index);
+        unlimitedRate |= (stream.settings.notificationsPerSecond <= 0);
+        if ((stream.service) && (!stream.metadata.isEmpty())) {
+            d->notify(stream.service, stream.metadataUuid, stream.metadata);
+        }
+    }
+    qCDebug(d->lc).noquote() << tr("Starting simulation of %Ln stream(s).", nullptr,
+        d->streams.size());
+    d->elapsed.start();
+    d->timer.start(unlimitedRate ? 0 : 1);
+}
+
+/*!
+ * Stops the simulation.
+ */
+void PokitSimulator::stop()
+{
+    Q_D(PokitSimulator);
+    d->timer.stop();
+}
+
+/*!
+ * \fn PokitSimulator::finished
+ *
+ * This signal is emitted when all streams have delivered their configured number of
+ * notifications. It is never emitted if any stream is unlimited.
+ */
+
+/*!
+ * \cond internal
+ * \class PokitSimulatorPrivate
+ *
+ * The PokitSimulatorPrivate provides the private implementation for PokitSimulator.
+ */
+
+/*!
+ * \internal
+ * Constructs a new PokitSimulatorPrivate object with public implementation \a q.
+ */
+PokitSimulatorPrivate::PokitSimulatorPrivate(PokitSimulator * const q)
+    : notificationCount(0), bytesNotified(0), q_ptr(q)
+{
+    timer.setTimerType(Qt::PreciseTimer);
+    connect(&timer, &QTimer::timeout, this, &PokitSimulatorPrivate::tick);
+}
+
+/*!
+ * Adds a stream of \a readings (delivered cyclically) to \a service's \a readingUuid
+ * characteristic, preceded by \a metadata (if not empty) to its \a metadataUuid characteristic,
+ * according to \a settings.
+ */
+void PokitSimulatorPrivate::addStream(AbstractPokitService * const service,
+    const QBluetoothUuid &metadataUuid, const QByteArray &metadata,
+    const QBluetoothUuid &readingUuid, const QVector<QByteArray> &readings,
+    const PokitSimulator::StreamSettings &settings)
+{
+    Q_ASSERT(service);
+    Q_ASSERT(!readings.isEmpty());
+    streams.append(Stream{ service, metadataUuid, metadata, readingUuid, readings, settings, 0 });
+}
+
+/*!
+ * Delivers \a value, as a notification of \a uuid, to \a service.
+ *
+ * Since this invokes the notification's receivers, which may modify #streams, callers must not
+ * hold references into #streams across this call.
+ */
+void PokitSimulatorPrivate::notify(AbstractPokitService * const service, const QBluetoothUuid &uuid,
+                                   const QByteArray &value)
+{
+    Q_ASSERT(service);
+    service->d_ptr->dispatchNotification(uuid, value);
+    ++notificationCount;
+    bytesNotified += value.size();
+}
+
+/*!
+ * Delivers all notifications that have fallen due since the last tick. Streams with unlimited
+ * rates deliver up to #burstSize notifications per tick, so that the event loop remains responsive.
+ */
+void PokitSimulatorPrivate::tick()
+{
+    Q_Q(PokitSimulator);
+    const qint64 now = elapsed.elapsed();
+    bool remaining = false;
+    // Index-based, since receivers may add (or clear) streams during delivery.
+    for (int index = 0; (index < streams.size()) && (timer.isActive()); ++index) {
+        const PokitSimulator::StreamSettings settings = streams.at(index).settings;
+        qint64 due = (settings.notificationsPerSecond <= 0)
+            ? streams.at(index).notified + burstSize
+            : (now * settings.notificationsPerSecond) / 1000 + 1;
+        if (settings.notificationCount > 0) {
+            due = qMin<qint64>(due, settings.notificationCount);
+        }
+        while ((index < streams.size()) && (streams.at(index).service) &&
+               (streams.at(index).notified < due))
+        {
+            const Stream &stream = streams.at(index);
+            const QPointer<AbstractPokitService> service = stream.service;
+            const QBluetoothUuid uuid = stream.readingUuid;
+            const QByteArray value = stream.readings.at(stream.notified % stream.readings.size());
+            ++streams[index].notified; // Before notify(), which may invalidate the stream.
+            notify(service, uuid, value);
+        }
+        remaining |= ((index < streams.size()) && (streams.at(index).service) &&
+            ((settings.notificationCount <= 0) ||
+             (streams.at(index).notified < settings.notificationCount)));
+    }
+    if ((timer.isActive()) && (!remaining)) {
+        qCDebug(lc).noquote() << tr("Simulation finished after %L1 notification(s).")
+            .arg(notificationCount);
+        timer.stop();
+        emit q->finished();
+    }
+}
+
+/// \endcond
@@ -0,0 +1,71 @@
+// SPDX-FileCopyrightText: 2022 Paul Colby <git@colby.id.au>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+/*!
+ * \file
+ * Declares the PokitSimulatorPrivate class.
+ */
+
+#ifndef QTPOKIT_POKITSIMULATOR_P_H
+#define QTPOKIT_POKITSIMULATOR_P_H
+
+#include <qtpokit/pokitsimulator.h>
+
+#include <QElapsedTimer>
+#include <QLoggingCategory>
+#include <QObject>
+#include <QPointer>
+#include <QTimer>
+#include <QVector>
+
+QTPOKIT_BEGIN_NAMESPACE
+
+class QTPOKIT_EXPORT PokitSimulatorPrivate : public QObject
+{
+    Q_OBJECT
+
+public:
+    static Q_LOGGING_CATEGORY(lc, "pokit.ble.simulator", QtInfoMsg); ///< Logging category.
+
+    static const int burstSize = 64; ///< Notifications per stream per tick, at unlimited rates.
+
+    struct Stream {
+        QPointer<AbstractPokitService> service;  ///< Service to deliver notifications to.
+        QBluetoothUuid metadataUuid;             ///< UUID of the `Metadata` characteristic, if any.
+        QByteArray metadata;                     ///< `Metadata` value to notify first, if any.
+        QBluetoothUuid readingUuid;              ///< UUID of the `Reading` characteristic.
+        QVector<QByteArray> readings;            ///< `Reading` values to notify, cyclically.
+        PokitSimulator::StreamSettings settings; ///< Rate, payload size and count settings.
+        int notified;                            ///< Number of `Reading` notifications so far.
+    };
+
+    QVector<Stream> streams;       ///< Streams to simulate.
+    QTimer timer;                  ///< Timer for generating notifications.
+    QElapsedTimer elapsed;         ///< Time since start(), for pacing rate-limited streams.
+    qint64 notificationCount;      ///< Total notifications delivered since start().
+    qint64 bytesNotified;          ///< Total bytes delivered since start().
+
+    explicit PokitSimulatorPrivate(PokitSimulator * const q);
+
+    void addStream(AbstractPokitService * const service, const QBluetoothUuid &metadataUuid,
+                   const QByteArray &metadata, const QBluetoothUuid &readingUuid,
+                   const QVector<QByteArray> &readings,
+                   const PokitSimulator::StreamSettings &settings);
+    void notify(AbstractPokitService * const service, const QBluetoothUuid &uuid,
+                const QByteArray &value);
+
+protected:
+    PokitSimulator * q_ptr; ///< Internal q-pointer.
+
+protected slots:
+    void tick();
+
+private:
+    Q_DECLARE_PUBLIC(PokitSimulator)
+    Q_DISABLE_COPY(PokitSimulatorPrivate)
+    friend class TestPokitSimulator;
+};
+
+QTPOKIT_END_NAMESPACE
+
+#endif // QTPOKIT_POKITSIMULATOR_P_H
@@ -0,0 +1,100 @@
+// SPDX-FileCopyrightText: 2022 Paul Colby <git@colby.id.au>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+/*!
+ * \file
+ * Defines the RssiTracker class.
+ */
+
+#include <qtpokit/rssitracker.h>
+
+#include <QtGlobal>
+
+/*!
+ * \class RssiTracker
+ *
+ * The RssiTracker class smooths a device's signal strength (aka RSSI) readings, via an
+ * exponentially-weighted moving average, and tracks when that average has changed enough to be
+ * worth reporting, so that the noise inherent in RSSI readings does not flood consumers.
+ *
+ * An RSSI of `0` means the signal strength is unknown, so such readings are ignored. In particular,
+ * the tracker remains invalid (see isValid()) until the first known reading, which then seeds the
+ * average, rather than the average drifting away from an unknown `0`.
+ */
+
+/*!
+ * Constructs a new, invalid, RssiTracker object.
+ */
+RssiTracker::RssiTracker()
+    : averageRssi(0.0), latestRssi(0), minimumRssi(0), maximumRssi(0), reportedRssi(0),
+      valid(false)
+{
+
+}
+
+/// Returns `true` if at least one known (non-zero) RSSI has been seen, `false` otherwise.
+bool RssiTracker::isValid() const
+{
+    return valid;
+}
+
+/// Returns the smoothed RSSI, in dBm, or `0` if not valid.
+double RssiTracker::average() const
+{
+    return averageRssi;
+}
+
+/// Returns the most recent known RSSI, in dBm, or `0` if not valid.
+qint16 RssiTracker::latest() const
+{
+    return latestRssi;
+}
+
+/// Returns the minimum known RSSI seen, in dBm, or `0` if not valid.
+qint16 RssiTracker::minimum() const
+{
+    return minimumRssi;
+}
+
+/// Returns the maximum known RSSI seen, in dBm, or `0` if not valid.
+qint16 RssiTracker::maximum() const
+{
+    return maximumRssi;
+}
+
+/// Returns the rounded average, as at the first known RSSI, or the last reported change.
+qint16 RssiTracker::reported() const
+{
+    return reportedRssi;
+}
+
+/*!
+ * Folds \a rssi into the smoothed average, and returns `true` if the (rounded) average has moved by
+ * at least \a threshold dBm since last reported, in which case it is also marked as reported.
+ *
+ * An \a rssi of `0` is ignored. The first known \a rssi seeds the tracker (see isValid()), and
+ * returns `false`, since there is no previous value for it to have moved from.
+ */
+bool RssiTracker::update(const qint16 rssi, const int threshold)
+{
+    if (rssi == 0) {
+        return false;
+    }
+    if (!valid) {
+        averageRssi = rssi;
+        latestRssi = minimumRssi = maximumRssi = reportedRssi = rssi;
+        valid = true;
+        return false;
+    }
+    const double weight = 0.25; // Weight of the newest value; about a 4-update time constant.
+    averageRssi += weight * (rssi - averageRssi);
+    latestRssi = rssi;
+    minimumRssi = qMin(minimumRssi, rssi);
+    maximumRssi = qMax(maximumRssi, rssi);
+    const qint16 rounded = static_cast<qint16>(qRound(averageRssi));
+    if (qAbs(rounded - reportedRssi) < threshold) {
+        return false;
+    }
+    reportedRssi = rounded;
+    return true;
+}
@@ -0,0 +1,177 @@
+// SPDX-FileCopyrightText: 2022 Paul Colby <git@colby.id.au>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+/*!
+ * \file
+ * Defines the SampleCoalescer class.
+ */
+
+#include "samplecoalescer_p.h"
+#include "sampledecoder_p.h"
+
+/*!
+ * \cond internal
+ * \class SampleCoalescer
+ *
+ * The SampleCoalescer class accumulates the samples of many DSO or Data Logger `Reading`
+ * notifications into one preallocated buffer, so that the services can emit one samplesRead signal
+ * per capture (or per chunk of samples), instead of one per notification.
+ *
+ * With default-sized MTUs, each notification carries just 10 samples, so an 8,192 sample DSO
+ * capture would otherwise cost 820 signal emissions, vector allocations, and slot invocations.
+ *
+ * Accumulated samples are emitted via samplesReady() when any of the following occur:
+ *  - the buffer holds at least chunkSize() samples (if not `0`);
+ *  - the current capture (see beginCapture()) has received all of its samples;
+ *  - maxLatency() milliseconds (if not `0`) have passed since the first sample was held; or
+ *  - flush() is invoked, such as by setEnabled(false), or the beginning of the next capture.
+ *
+ * If none of these can ever occur (ie no chunk size, no deadline, and no known capture size), then
+ * samples are emitted as they arrive, just as if coalescing were disabled.
+ */
+
+/*!
+ * Constructs a new SampleCoalescer object with \a parent. Coalescing is disabled by default.
+ */
+SampleCoalescer::SampleCoalescer(QObject * const parent)
+    : QObject(parent), enabled(false), chunk(0), latency(0), toGo(0)
+{
+    deadline.setSingleShot(true);
+    connect(&deadline, &QTimer::timeout, this, &SampleCoalescer::flush);
+}
+
+/// Returns `true` if samples are being coalesced, `false` otherwise.
+bool SampleCoalescer::isEnabled() const
+{
+    return enabled;
+}
+
+/// Returns the number of samples to accumulate per emission, or `0` to emit once per capture.
+int SampleCoalescer::chunkSize() const
+{
+    return chunk;
+}
+
+/// Returns the maximum milliseconds to hold samples before emitting them, or `0` for no deadline.
+int SampleCoalescer::maxLatency() const
+{
+    return latency;
+}
+
+/*!
+ * Sets whether samples are being coalesced to \a enabled. Disabling flushes any held samples.
+ */
+void SampleCoalescer::setEnabled(const bool enabled)
+{
+    this->enabled = enabled;
+    if (!enabled) {
+        flush();
+    }
+}
+
+/*!
+ * Sets the number of samples to accumulate per emission to \a chunkSize, or `0` to emit once per
+ * capture. Note, emissions may exceed \a chunkSize by up to one notification's worth of samples.
+ */
+void SampleCoalescer::setChunkSize(const int chunkSize)
+{
+    chunk = qMax(chunkSize, 0);
+}
+
+/*!
+ * Sets the maximum milliseconds to hold samples before emitting them to \a maxLatency, or `0` for
+ * no deadline. Takes effect from the next held sample.
+ */
+void SampleCoalescer::setMaxLatency(const int maxLatency)
+{
+    latency = qMax(maxLatency, 0);
+}
+
+/// Returns the number of samples currently held, awaiting emission.
+int SampleCoalescer::pending() const
+{
+    return buffer.size();
+}
+
+/// Returns the number of samples that can be held before the buffer needs to grow.
+int SampleCoalescer::capacity() const
+{
+    return buffer.capacity();
+}
+
+/// Returns the number of samples still expected for the current capture, or `0` if unknown.
+int SampleCoalescer::samplesToGo() const
+{
+    return toGo;
+}
+
+/*!
+ * Begins a new capture of \a numberOfSamples samples, typically as reported by the relevant
+ * service's `Metadata` characteristic. Any samples still held from a previous capture are flushed
+ * first, then the buffer is preallocated for the first emission.
+ */
+void SampleCoalescer::beginCapture(const int numberOfSamples)
+{
+    flush();
+    toGo = qMax(numberOfSamples, 0);
+    buffer.reserve(target());
+}
+
+/*!
+ * Decodes the samples in the `Reading` notification \a value into the buffer, then emits them via
+ * samplesReady() if any of the conditions described above have been met.
+ *
+ * Returns `false` if \a value has an odd size (and so does not contain a whole number of samples),
+ * in which case it is ignored, otherwise returns `true`.
+ */
+bool SampleCoalescer::append(const QByteArray &value)
+{
+    if ((value.size()%2) != 0) {
+        return false;
+    }
+    const int count = value.size()/2;
+    const int offset = buffer.size();
+    buffer.resize(offset + count);
+    SampleDecoder::decode(value, buffer.data() + offset, count);
+
+    const bool capturing = (toGo > 0);
+    toGo = qMax(toGo - count, 0);
+    if (((chunk > 0) && (buffer.size() >= chunk)) || ((capturing) && (toGo == 0)) ||
+        ((chunk == 0) && (!capturing) && (latency == 0))) {
+        flush();
+    } else if ((latency > 0) && (!deadline.isActive())) {
+        deadline.start(latency);
+    }
+    return true;
+}
+
+/*!
+ * Emits any held samples via samplesReady(), then empties the buffer, retaining its capacity (unless
+ * a receiver kept a copy of the emitted samples) for the next emission.
+ */
+void SampleCoalescer::flush()
+{
+    deadline.stop();
+    if (buffer.isEmpty()) {
+        return;
+    }
+    emit samplesReady(buffer);
+    buffer.clear();
+    buffer.reserve(target());
+}
+
+/*!
+ * Returns the number of samples the next emission is expected to hold, for preallocation purposes.
+ */
+int SampleCoalescer::target() const
+{
+    return ((chunk > 0) && ((toGo == 0) || (chunk < toGo))) ? chunk : toGo;
+}
+
+/*!
+ * \fn SampleCoalescer::samplesReady
+ *
+ * This signal is emitted with each batch of coalesced \a samples.
+ */
+
+/// \endcond
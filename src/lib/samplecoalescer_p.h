@@ -0,0 +1,64 @@
+// SPDX-FileCopyrightText: 2022 Paul Colby <git@colby.id.au>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+/*!
+ * \file
+ * Declares the SampleCoalescer class.
+ */
+
+#ifndef QTPOKIT_SAMPLECOALESCER_P_H
+#define QTPOKIT_SAMPLECOALESCER_P_H
+
+#include <qtpokit/qtpokit_global.h>
+
+#include <QByteArray>
+#include <QObject>
+#include <QTimer>
+#include <QVector>
+
+QTPOKIT_BEGIN_NAMESPACE
+
+class QTPOKIT_EXPORT SampleCoalescer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit SampleCoalescer(QObject * const parent = nullptr);
+
+    bool isEnabled() const;
+    int chunkSize() const;
+    int maxLatency() const;
+    void setEnabled(const bool enabled);
+    void setChunkSize(const int chunkSize);
+    void setMaxLatency(const int maxLatency);
+
+    int pending() const;
+    int capacity() const;
+    int samplesToGo() const;
+
+    void beginCapture(const int numberOfSamples);
+    bool append(const QByteArray &value);
+
+public slots:
+    void flush();
+
+signals:
+    void samplesReady(const QVector<qint16> &samples);
+
+private:
+    bool enabled;            ///< Whether samples are being coalesced.
+    int chunk;               ///< Samples per emission, or `0` to emit once per capture.
+    int latency;             ///< Milliseconds to hold samples for, or `0` for no deadline.
+    int toGo;                ///< Samples still expected for the current capture, or `0` if unknown.
+    QVector<qint16> buffer;  ///< Preallocated buffer of decoded samples not yet emitted.
+    QTimer deadline;         ///< Timer for flushing samples held for #latency milliseconds.
+
+    int target() const;
+
+    Q_DISABLE_COPY(SampleCoalescer)
+    friend class TestSampleCoalescer;
+};
+
+QTPOKIT_END_NAMESPACE
+
+#endif // QTPOKIT_SAMPLECOALESCER_P_H
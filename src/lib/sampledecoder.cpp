@@ -0,0 +1,391 @@
+// SPDX-FileCopyrightText: 2022 Paul Colby <git@colby.id.au>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+/*!
+ * \file
+ * Defines the SampleDecoder class.
+ */
+
+#include "sampledecoder_p.h"
+
+#include <QtEndian>
+
+#include <cstring>
+
+// SSE2 is part of the x86-64 baseline, so needs no runtime check.
+#if defined(Q_PROCESSOR_X86) && (defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && (_M_IX86_FP >= 2)))
+#define QTPOKIT_SAMPLEDECODER_SSE2
+#include <emmintrin.h>
+#endif
+
+// AVX2 is not part of any baseline we build for, so is compiled via per-function target attributes,
+// and only used when the CPU reports support at runtime.
+#if defined(QTPOKIT_SAMPLEDECODER_SSE2) && defined(__GNUC__)
+#define QTPOKIT_SAMPLEDECODER_AVX2
+#include <immintrin.h>
+#endif
+
+// NEON is part of the AArch64 baseline (and most ARMv7 builds that enable it).
+#if defined(Q_PROCESSOR_ARM) && (defined(__ARM_NEON) || defined(__ARM_NEON__)) && \
+    (Q_BYTE_ORDER == Q_LITTLE_ENDIAN)
+#define QTPOKIT_SAMPLEDECODER_NEON
+#include <arm_neon.h>
+#endif
+
+/*!
+ * \cond internal
+ * \class SampleDecoder
+ *
+ * The SampleDecoder class provides the bulk sample decoding kernel shared by the DSO and Data Logger
+ * services.
+ *
+ * Both services' `Reading` characteristics notify blocks of little-endian `int16` samples, which
+ * need to be decoded to host-order qint16 values, and (usually) multiplied by the relevant
+ * `Metadata::scale` value. This class does both, in bulk, using SIMD instructions where available.
+ * The best implementation for the host CPU is selected once, at runtime.
+ *
+ * Note, this class does not validate its input; callers (such as DsoServicePrivate::parseSamples)
+ * are expected to have already rejected malformed values (such as odd-sized ones).
+ */
+
+/// \enum SampleDecoder::Implementation
+/// \brief Sample decoding implementations, in increasing order of preference.
+
+/// Returns \a implementation as a user-friendly string.
+QString SampleDecoder::toString(const Implementation &implementation)
+{
+    switch (implementation) {
+    case Implementation::Generic: return QStringLiteral("Generic");
+    case Implementation::Sse2:    return QStringLiteral("SSE2");
+    case Implementation::Avx2:    return QStringLiteral("AVX2");
+    case Implementation::Neon:    return QStringLiteral("NEON");
+    default:                      return QString();
+    }
+}
+
+namespace {
+
+/*!
+ * Scales \a count (host-order, but possibly unaligned) \a samples by \a scale, writing the results to
+ * \a values.
+ */
+template<typename T>
+void scaleGeneric(const char * const samples, const int count, const T scale, T * const values)
+{
+    for (int index = 0; index < count; ++index) {
+        qint16 sample;
+        std::memcpy(&sample, samples + (index * 2), sizeof(sample));
+        values[index] = sample * scale;
+    }
+}
+
+#ifdef QTPOKIT_SAMPLEDECODER_SSE2
+/// SSE2 equivalent of scaleGeneric() for `float` results.
+void scaleSse2(const char * const samples, const int count, const float scale, float * const values)
+{
+    const __m128 factor = _mm_set1_ps(scale);
+    int index = 0;
+    for (; (index + 8) <= count; index += 8) {
+        const __m128i raw = _mm_loadu_si128(reinterpret_cast<const __m128i *>(samples + (index * 2)));
+        // Sign-extend the eight 16-bit samples to two vectors of four 32-bit integers.
+        const __m128i low  = _mm_srai_epi32(_mm_unpacklo_epi16(raw, raw), 16);
+        const __m128i high = _mm_srai_epi32(_mm_unpackhi_epi16(raw, raw), 16);
+        _mm_storeu_ps(values + index,     _mm_mul_ps(_mm_cvtepi32_ps(low),  factor));
+        _mm_storeu_ps(values + index + 4, _mm_mul_ps(_mm_cvtepi32_ps(high), factor));
+    }
+    scaleGeneric(samples + (index * 2), count - index, scale, values + index);
+}
+
+/// SSE2 equivalent of scaleGeneric() for `double` results.
+void scaleSse2(const char * const samples, const int count, const double scale, double * const values)
+{
+    const __m128d factor = _mm_set1_pd(scale);
+    int index = 0;
+    for (; (index + 8) <= count; index += 8) {
+        const __m128i raw = _mm_loadu_si128(reinterpret_cast<const __m128i *>(samples + (index * 2)));
+        const __m128i low  = _mm_srai_epi32(_mm_unpacklo_epi16(raw, raw), 16);
+        const __m128i high = _mm_srai_epi32(_mm_unpackhi_epi16(raw, raw), 16);
+        _mm_storeu_pd(values + index,     _mm_mul_pd(_mm_cvtepi32_pd(low), factor));
+        _mm_storeu_pd(values + index + 2, _mm_mul_pd(_mm_cvtepi32_pd(_mm_unpackhi_epi64(low, low)), factor));
+        _mm_storeu_pd(values + index + 4, _mm_mul_pd(_mm_cvtepi32_pd(high), factor));
+        _mm_storeu_pd(values + index + 6, _mm_mul_pd(_mm_cvtepi32_pd(_mm_unpackhi_epi64(high, high)), factor));
+    }
+    scaleGeneric(samples + (index * 2), count - index, scale, values + index);
+}
+#endif // QTPOKIT_SAMPLEDECODER_SSE2
+
+#ifdef QTPOKIT_SAMPLEDECODER_AVX2
+/// Returns \c true if the host CPU supports AVX2 instructions.
+bool cpuHasAvx2()
+{
+    static const bool hasAvx2 = __builtin_cpu_supports("avx2");
+    return hasAvx2;
+}
+
+/// AVX2 equivalent of scaleGeneric() for `float` results.
+__attribute__((target("avx2")))
+void scaleAvx2(const char * const samples, const int count, const float scale, float * const values)
+{
+    const __m256 factor = _mm256_set1_ps(scale);
+    int index = 0;
+    for (; (index + 16) <= count; index += 16) {
+        const char * const block = samples + (index * 2);
+        const __m256i low  = _mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(block)));
+        const __m256i high = _mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(block + 16)));
+        _mm256_storeu_ps(values + index,     _mm256_mul_ps(_mm256_cvtepi32_ps(low),  factor));
+        _mm256_storeu_ps(values + index + 8, _mm256_mul_ps(_mm256_cvtepi32_ps(high), factor));
+    }
+    scaleGeneric(samples + (index * 2), count - index, scale, values + index);
+}
+
+/// AVX2 equivalent of scaleGeneric() for `double` results.
+__attribute__((target("avx2")))
+void scaleAvx2(const char * const samples, const int count, const double scale, double * const values)
+{
+    const __m256d factor = _mm256_set1_pd(scale);
+    int index = 0;
+    for (; (index + 8) <= count; index += 8) {
+        const char * const block = samples + (index * 2);
+        const __m128i low  = _mm_cvtepi16_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(block)));
+        const __m128i high = _mm_cvtepi16_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(block + 8)));
+        _mm256_storeu_pd(values + index,     _mm256_mul_pd(_mm256_cvtepi32_pd(low),  factor));
+        _mm256_storeu_pd(values + index + 4, _mm256_mul_pd(_mm256_cvtepi32_pd(high), factor));
+    }
+    scaleGeneric(samples + (index * 2), count - index, scale, values + index);
+}
+#endif // QTPOKIT_SAMPLEDECODER_AVX2
+
+#ifdef QTPOKIT_SAMPLEDECODER_NEON
+/// NEON equivalent of scaleGeneric() for `float` results.
+void scaleNeon(const char * const samples, const int count, const float scale, float * const values)
+{
+    int index = 0;
+    for (; (index + 8) <= count; index += 8) {
+        const int16x8_t raw = vreinterpretq_s16_u8(
+            vld1q_u8(reinterpret_cast<const uint8_t *>(samples + (index * 2))));
+        vst1q_f32(values + index,     vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(raw))),  scale));
+        vst1q_f32(values + index + 4, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(raw))), scale));
+    }
+    scaleGeneric(samples + (index * 2), count - index, scale, values + index);
+}
+#endif // QTPOKIT_SAMPLEDECODER_NEON
+
+/*!
+ * Scales \a count host-order \a samples by \a scale into \a values, using \a implementation.
+ *
+ * If \a implementation is not supported by the host CPU, then the generic implementation is used.
+ */
+template<typename T>
+void scaleWith(const SampleDecoder::Implementation implementation, const char * const samples,
+               const int count, const T scale, T * const values)
+{
+    switch (implementation) {
+    #ifdef QTPOKIT_SAMPLEDECODER_AVX2
+    case SampleDecoder::Implementation::Avx2:
+        if (cpuHasAvx2()) {
+            scaleAvx2(samples, count, scale, values);
+            return;
+        }
+        break;
+    #endif
+    #ifdef QTPOKIT_SAMPLEDECODER_SSE2
+    case SampleDecoder::Implementation::Sse2:
+        scaleSse2(samples, count, scale, values);
+        return;
+    #endif
+    default:
+        break;
+    }
+    scaleGeneric(samples, count, scale, values);
+}
+
+#ifdef QTPOKIT_SAMPLEDECODER_NEON
+/// Overload of scaleWith() for `float` results, as we have a NEON implementation for floats only.
+template<>
+void scaleWith<float>(const SampleDecoder::Implementation implementation, const char * const samples,
+                      const int count, const float scale, float * const values)
+{
+    if (implementation == SampleDecoder::Implementation::Neon) {
+        scaleNeon(samples, count, scale, values);
+    } else {
+        scaleGeneric(samples, count, scale, values);
+    }
+}
+#endif // QTPOKIT_SAMPLEDECODER_NEON
+
+/// Returns the preferred (fastest) implementation supported by the host CPU.
+SampleDecoder::Implementation detectImplementation()
+{
+    #if defined(QTPOKIT_SAMPLEDECODER_AVX2)
+    if (cpuHasAvx2()) {
+        return SampleDecoder::Implementation::Avx2;
+    }
+    #endif
+    #if defined(QTPOKIT_SAMPLEDECODER_SSE2)
+    return SampleDecoder::Implementation::Sse2;
+    #elif defined(QTPOKIT_SAMPLEDECODER_NEON)
+    return SampleDecoder::Implementation::Neon;
+    #else
+    return SampleDecoder::Implementation::Generic;
+    #endif
+}
+
+/*!
+ * Decodes \a count little-endian samples from \a data, and scales them by \a scale into \a values.
+ */
+template<typename T>
+void decodeScaled(const char * const data, const int count, const T scale, T * const values)
+{
+    #if (Q_BYTE_ORDER == Q_LITTLE_ENDIAN)
+    // Little-endian samples are already in host order, so we can scale them in place.
+    scaleWith(SampleDecoder::implementation(), data, count, scale, values);
+    #else
+    for (int index = 0; index < count; ++index) {
+        values[index] = qFromLittleEndian<qint16>(data + (index * 2)) * scale;
+    }
+    #endif
+}
+
+} // namespace
+
+/*!
+ * Returns the implementation that will be used by the decode() and scale() functions that do not
+ * specify an implementation explicitly. This is the fastest implementation supported by the host
+ * CPU, and is detected once only, on first use.
+ */
+SampleDecoder::Implementation SampleDecoder::implementation()
+{
+    static const Implementation preferred = detectImplementation();
+    return preferred;
+}
+
+/*!
+ * Returns the list of implementations supported by the host CPU (including the generic
+ * implementation, which is always supported).
+ */
+QList<SampleDecoder::Implementation> SampleDecoder::supportedImplementations()
+{
+    QList<Implementation> implementations{ Implementation::Generic };
+    for (const Implementation implementation: { Implementation::Sse2, Implementation::Avx2,
+                                                Implementation::Neon }) {
+        if (isSupported(implementation)) {
+            implementations.append(implementation);
+        }
+    }
+    return implementations;
+}
+
+/*!
+ * Returns \c true if \a implementation was both compiled in, and is supported by the host CPU.
+ */
+bool SampleDecoder::isSupported(const Implementation &implementation)
+{
+    switch (implementation) {
+    case Implementation::Generic:
+        return true;
+    #ifdef QTPOKIT_SAMPLEDECODER_SSE2
+    case Implementation::Sse2:
+        return true;
+    #endif
+    #ifdef QTPOKIT_SAMPLEDECODER_AVX2
+    case Implementation::Avx2:
+        return cpuHasAvx2();
+    #endif
+    #ifdef QTPOKIT_SAMPLEDECODER_NEON
+    case Implementation::Neon:
+        return true;
+    #endif
+    default:
+        return false;
+    }
+}
+
+/*!
+ * Decodes the little-endian samples in \a value into the caller-owned \a samples buffer, which must
+ * have room for at least \a maxSamples samples.
+ *
+ * Returns the number of samples decoded, which is the lesser of \a maxSamples, and the number of
+ * whole samples in \a value.
+ */
+int SampleDecoder::decode(const QByteArray &value, qint16 * const samples, const int maxSamples)
+{
+    const int count = qMax(qMin(value.size()/2, maxSamples), 0);
+    #if (QT_VERSION >= QT_VERSION_CHECK(5, 12, 0))
+    // A plain memcpy on little-endian hosts, and QtCore's (SIMD) bulk byte-swap on big-endian hosts.
+    qFromLittleEndian<qint16>(value.constData(), count, samples);
+    #else
+    for (int index = 0; index < count; ++index) {
+        samples[index] = qFromLittleEndian<qint16>(value.constData() + (index * 2));
+    }
+    #endif
+    return count;
+}
+
+/*!
+ * Decodes the little-endian samples in \a value, multiplying each by \a scale, into the caller-owned
+ * \a values buffer, which must have room for at least \a maxValues values.
+ *
+ * Returns the number of values written, which is the lesser of \a maxValues, and the number of
+ * whole samples in \a value.
+ */
+int SampleDecoder::decode(const QByteArray &value, const float scale, float * const values,
+                          const int maxValues)
+{
+    const int count = qMax(qMin(value.size()/2, maxValues), 0);
+    decodeScaled(value.constData(), count, scale, values);
+    return count;
+}
+
+/*!
+ * \overload
+ */
+int SampleDecoder::decode(const QByteArray &value, const double scale, double * const values,
+                          const int maxValues)
+{
+    const int count = qMax(qMin(value.size()/2, maxValues), 0);
+    decodeScaled(value.constData(), count, scale, values);
+    return count;
+}
+
+/*!
+ * Multiplies \a count (already decoded) \a samples by \a scale, writing the results to \a values.
+ */
+void SampleDecoder::scale(const qint16 * const samples, const int count, const float scale,
+                          float * const values)
+{
+    scaleWith(implementation(), reinterpret_cast<const char *>(samples), count, scale, values);
+}
+
+/*!
+ * \overload
+ */
+void SampleDecoder::scale(const qint16 * const samples, const int count, const double scale,
+                          double * const values)
+{
+    scaleWith(implementation(), reinterpret_cast<const char *>(samples), count, scale, values);
+}
+
+/*!
+ * Multiplies \a count (already decoded) \a samples by \a scale, writing the results to \a values,
+ * using a specific \a implementation. This is primarily intended for testing and benchmarking; most
+ * callers should use the overload that selects the best implementation automatically.
+ *
+ * If \a implementation is not supported (see isSupported()), the generic implementation is used.
+ */
+void SampleDecoder::scale(const qint16 * const samples, const int count, const float scale,
+                          float * const values, const Implementation &implementation)
+{
+    scaleWith(implementation, reinterpret_cast<const char *>(samples), count, scale, values);
+}
+
+/*!
+ * \overload
+ */
+void SampleDecoder::scale(const qint16 * const samples, const int count, const double scale,
+                          double * const values, const Implementation &implementation)
+{
+    scaleWith(implementation, reinterpret_cast<const char *>(samples), count, scale, values);
+}
+
+/// \endcond
@@ -0,0 +1,55 @@
+// SPDX-FileCopyrightText: 2022 Paul Colby <git@colby.id.au>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+/*!
+ * \file
+ * Declares the SampleDecoder class.
+ */
+
+#ifndef QTPOKIT_SAMPLEDECODER_P_H
+#define QTPOKIT_SAMPLEDECODER_P_H
+
+#include <qtpokit/qtpokit_global.h>
+
+#include <QByteArray>
+#include <QList>
+#include <QString>
+
+QTPOKIT_BEGIN_NAMESPACE
+
+class QTPOKIT_EXPORT SampleDecoder
+{
+public:
+    enum class Implementation : quint8 {
+        Generic = 0, ///< Portable C++ implementation.
+        Sse2    = 1, ///< x86 SSE2 implementation.
+        Avx2    = 2, ///< x86 AVX2 implementation.
+        Neon    = 3, ///< ARM NEON implementation.
+    };
+    static QString toString(const Implementation &implementation);
+
+    SampleDecoder() = delete;
+
+    static Implementation implementation();
+    static QList<Implementation> supportedImplementations();
+    static bool isSupported(const Implementation &implementation);
+
+    static int decode(const QByteArray &value, qint16 * const samples, const int maxSamples);
+    static int decode(const QByteArray &value, const float scale, float * const values,
+                      const int maxValues);
+    static int decode(const QByteArray &value, const double scale, double * const values,
+                      const int maxValues);
+
+    static void scale(const qint16 * const samples, const int count, const float scale,
+                      float * const values);
+    static void scale(const qint16 * const samples, const int count, const double scale,
+                      double * const values);
+    static void scale(const qint16 * const samples, const int count, const float scale,
+                      float * const values, const Implementation &implementation);
+    static void scale(const qint16 * const samples, const int count, const double scale,
+                      double * const values, const Implementation &implementation);
+};
+
+QTPOKIT_END_NAMESPACE
+
+#endif // QTPOKIT_SAMPLEDECODER_P_H
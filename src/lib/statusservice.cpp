@@ -263,7 +263,7 @@ QString StatusService::deviceName() const
  */
 bool StatusService::setDeviceName(const QString &name)
 {
-    Q_D(const StatusService);
+    Q_D(StatusService);
     const QLowEnergyCharacteristic characteristic =
         d->getCharacteristic(CharacteristicUuids::name);
     if (!characteristic.isValid()) {
@@ -277,7 +277,7 @@ bool StatusService::setDeviceName(const QString &name)
         return false;
     }
 
-    d->service->writeCharacteristic(characteristic, value);
+    d->writeCharacteristic(characteristic, value);
     return (d->service->error() != QLowEnergyService::ServiceError::CharacteristicWriteError);
 }
 
@@ -298,7 +298,7 @@ bool StatusService::setDeviceName(const QString &name)
  */
 bool StatusService::flashLed()
 {
-    Q_D(const StatusService);
+    Q_D(StatusService);
     const QLowEnergyCharacteristic characteristic =
         d->getCharacteristic(CharacteristicUuids::flashLed);
     if (!characteristic.isValid()) {
@@ -310,7 +310,7 @@ bool StatusService::flashLed()
     // say that "any value other than 1 will be ignored", which makes sense given that all current
     // Pokit devices have only one LED.
     const QByteArray value(1, '\x01');
-    d->service->writeCharacteristic(characteristic, value);
+    d->writeCharacteristic(characteristic, value);
     return (d->service->error() != QLowEnergyService::ServiceError::CharacteristicWriteError);
 }
 
@@ -0,0 +1,86 @@
+// SPDX-FileCopyrightText: 2022 Paul Colby <git@colby.id.au>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "allocationcounter.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+/*!
+ * \namespace AllocationCounter
+ *
+ * Counts heap allocations made by benchmark executables that link allocationcounter.cpp.
+ *
+ * With glibc, `malloc`, `calloc` and `realloc` are counted, so Qt's container allocations (which do
+ * not use `operator new`) are included. Elsewhere, only `operator new` allocations are counted.
+ */
+
+namespace {
+
+std::atomic<quint64> allocationCount(0);
+
+}
+
+/*!
+ * Returns the number of heap allocations (including reallocations) made since the program started.
+ */
+quint64 AllocationCounter::allocations()
+{
+    return allocationCount.load(std::memory_order_relaxed);
+}
+
+#if defined(__GLIBC__)
+// Interpose the C allocation functions, forwarding to glibc's own implementations. The default
+// operator new calls malloc, so is counted too.
+extern "C" {
+
+void * __libc_malloc(size_t size);
+void * __libc_calloc(size_t count, size_t size);
+void * __libc_realloc(void * ptr, size_t size);
+
+void * malloc(size_t size)
+{
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    return __libc_malloc(size);
+}
+
+void * calloc(size_t count, size_t size)
+{
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    return __libc_calloc(count, size);
+}
+
+void * realloc(void * ptr, size_t size)
+{
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    return __libc_realloc(ptr, size);
+}
+
+}
+#else
+// Replace the global (non-placement) operator new and delete; the rest forward to these.
+void * operator new(std::size_t size)
+{
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void * const ptr = std::malloc((size == 0) ? 1 : size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void * operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void * ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void * ptr) noexcept
+{
+    std::free(ptr);
+}
+#endif
@@ -0,0 +1,15 @@
+// SPDX-FileCopyrightText: 2022 Paul Colby <git@colby.id.au>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#ifndef QTPOKIT_BENCH_ALLOCATIONCOUNTER_H
+#define QTPOKIT_BENCH_ALLOCATIONCOUNTER_H
+
+#include <QtGlobal>
+
+namespace AllocationCounter {
+
+quint64 allocations();
+
+}
+
+#endif // QTPOKIT_BENCH_ALLOCATIONCOUNTER_H
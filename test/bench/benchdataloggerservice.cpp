@@ -0,0 +1,71 @@
+// SPDX-FileCopyrightText: 2022 Paul Colby <git@colby.id.au>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "benchdataloggerservice.h"
+
+#include "servicebench.h"
+
+#include <qtpokit/pokitsimulator.h>
+#include <qtpokit/dataloggerservice.h>
+#include "dataloggerservice_p.h"
+
+void BenchDataLoggerService::parseSamples_data()
+{
+    ServiceBench::addPayloadSizes();
+}
+
+void BenchDataLoggerService::parseSamples()
+{
+    QFETCH(QByteArray, value);
+    DataLoggerService::Samples samples;
+    QBENCHMARK {
+        samples = DataLoggerServicePrivate::parseSamples(value);
+    }
+    QCOMPARE(samples.size(), value.size()/2);
+}
+
+void BenchDataLoggerService::parseSamples_buffer_data()
+{
+    ServiceBench::addPayloadSizes();
+}
+
+void BenchDataLoggerService::parseSamples_buffer()
+{
+    QFETCH(QByteArray, value);
+    DataLoggerService::Samples samples(value.size()/2);
+    int count = 0;
+    QBENCHMARK {
+        count = DataLoggerServicePrivate::parseSamples(value, samples.data(), samples.size());
+    }
+    QCOMPARE(count, samples.size());
+}
+
+void BenchDataLoggerService::parseScaledSamples_data()
+{
+    ServiceBench::addPayloadSizes();
+}
+
+void BenchDataLoggerService::parseScaledSamples()
+{
+    QFETCH(QByteArray, value);
+    DataLoggerService::ScaledSamples samples;
+    QBENCHMARK {
+        samples = DataLoggerServicePrivate::parseScaledSamples(value, 0.001f);
+    }
+    QCOMPARE(samples.size(), value.size()/2);
+}
+
+void BenchDataLoggerService::parseMetadata()
+{
+    const QByteArray value = PokitSimulator::encodeMetadata(DataLoggerService::Metadata{
+        DataLoggerService::LoggerStatus::Done, 0.001f, DataLoggerService::Mode::DcVoltage,
+        { DataLoggerService::VoltageRange::_6V_to_12V }, 60000, 1000, 1650000000
+    });
+    DataLoggerService::Metadata metadata{};
+    QBENCHMARK {
+        metadata = DataLoggerServicePrivate::parseMetadata(value);
+    }
+    QCOMPARE(metadata.numberOfSamples, (quint16)1000);
+}
+
+QTEST_MAIN(BenchDataLoggerService)
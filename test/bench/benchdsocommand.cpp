@@ -0,0 +1,49 @@
+// SPDX-FileCopyrightText: 2022 Paul Colby <git@colby.id.au>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "benchdsocommand.h"
+
+#include "dsocommand.h"
+#include "samplecommandbench.h"
+
+typedef SampleCommandBench<DsoCommand, DsoService> Bench;
+
+void BenchDsoCommand::outputSamples_data()
+{
+    Bench::addFormatsAndSizes(true);
+}
+
+void BenchDsoCommand::outputSamples()
+{
+    Bench::outputSamples(DsoService::Metadata{
+        DsoService::DsoStatus::Done, 0.001f, DsoService::Mode::DcVoltage,
+        { DsoService::VoltageRange::_6V_to_12V }, 1000000, 1000, 1000
+    });
+}
+
+void BenchDsoCommand::outputRawSamples_data()
+{
+    Bench::addFormatsAndSizes(false);
+}
+
+void BenchDsoCommand::outputRawSamples()
+{
+    Bench::outputRawSamples();
+}
+
+void BenchDsoCommand::pipeline_data()
+{
+    Bench::addFormats();
+}
+
+void BenchDsoCommand::pipeline()
+{
+    // A full 8192-sample DSO acquisition: one `Metadata` notification, then 64 `Reading`
+    // notifications of 128 samples each.
+    Bench::pipeline({ 0, 256, 64 }, 8192, [](DsoCommand &command) {
+        command.getService();
+        command.settingsWritten(); // Connects the service's signals, as once the DSO has started.
+    });
+}
+
+QTEST_MAIN(BenchDsoCommand)
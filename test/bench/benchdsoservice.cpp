@@ -0,0 +1,107 @@
+// SPDX-FileCopyrightText: 2022 Paul Colby <git@colby.id.au>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "benchdsoservice.h"
+
+#include "servicebench.h"
+
+#include <qtpokit/pokitsimulator.h>
+#include <qtpokit/dsoservice.h>
+#include "dsoservice_p.h"
+
+#include <QSignalSpy>
+
+void BenchDsoService::parseSamples_data()
+{
+    ServiceBench::addPayloadSizes();
+}
+
+void BenchDsoService::parseSamples()
+{
+    QFETCH(QByteArray, value);
+    DsoService::Samples samples;
+    QBENCHMARK {
+        samples = DsoServicePrivate::parseSamples(value);
+    }
+    QCOMPARE(samples.size(), value.size()/2);
+}
+
+void BenchDsoService::parseSamples_buffer_data()
+{
+    ServiceBench::addPayloadSizes();
+}
+
+void BenchDsoService::parseSamples_buffer()
+{
+    QFETCH(QByteArray, value);
+    DsoService::Samples samples(value.size()/2);
+    int count = 0;
+    QBENCHMARK {
+        count = DsoServicePrivate::parseSamples(value, samples.data(), samples.size());
+    }
+    QCOMPARE(count, samples.size());
+}
+
+void BenchDsoService::parseScaledSamples_data()
+{
+    ServiceBench::addPayloadSizes();
+}
+
+void BenchDsoService::parseScaledSamples()
+{
+    QFETCH(QByteArray, value);
+    DsoService::ScaledSamples samples;
+    QBENCHMARK {
+        samples = DsoServicePrivate::parseScaledSamples(value, 0.001f);
+    }
+    QCOMPARE(samples.size(), value.size()/2);
+}
+
+void BenchDsoService::parseMetadata()
+{
+    const QByteArray value = PokitSimulator::encodeMetadata(DsoService::Metadata{
+        DsoService::DsoStatus::Done, 0.001f, DsoService::Mode::DcVoltage,
+        { DsoService::VoltageRange::_6V_to_12V }, 1000000, 1000, 1000
+    });
+    DsoService::Metadata metadata{};
+    QBENCHMARK {
+        metadata = DsoServicePrivate::parseMetadata(value);
+    }
+    QCOMPARE(metadata.numberOfSamples, (quint16)1000);
+}
+
+void BenchDsoService::capture_data()
+{
+    QTest::addColumn<bool>("coalesced");
+    QTest::addRow("per-notification") << false;
+    QTest::addRow("coalesced") << true;
+}
+
+void BenchDsoService::capture()
+{
+    QFETCH(bool, coalesced);
+    DsoService service(nullptr);
+    service.setCoalescingSettings({ coalesced, 0, 0 });
+    int emissions = 0;
+    qint64 samples = 0;
+    QObject::connect(&service, &DsoService::samplesRead,
+        [&emissions, &samples](const DsoService::Samples &batch) {
+            ++emissions;
+            samples += batch.size();
+        });
+
+    // An 8,190-sample DSO capture, delivered 10 samples (ie the default MTU's 20 bytes) at a time.
+    PokitSimulator simulator;
+    simulator.addStream(&service, { 0, 20, 819 });
+    QSignalSpy finished(&simulator, &PokitSimulator::finished);
+    int runs = 0;
+    QBENCHMARK {
+        simulator.start();
+        QVERIFY(finished.wait());
+        ++runs;
+    }
+    QCOMPARE(samples, qint64(runs) * 8190);
+    QCOMPARE(emissions, runs * ((coalesced) ? 1 : 819));
+}
+
+QTEST_MAIN(BenchDsoService)
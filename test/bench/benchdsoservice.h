@@ -0,0 +1,24 @@
+// SPDX-FileCopyrightText: 2022 Paul Colby <git@colby.id.au>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include <QTest>
+
+class BenchDsoService : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void parseSamples_data();
+    void parseSamples();
+
+    void parseSamples_buffer_data();
+    void parseSamples_buffer();
+
+    void parseScaledSamples_data();
+    void parseScaledSamples();
+
+    void parseMetadata();
+
+    void capture_data();
+    void capture();
+};
@@ -0,0 +1,48 @@
+// SPDX-FileCopyrightText: 2022 Paul Colby <git@colby.id.au>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "benchloggerfetchcommand.h"
+
+#include "loggerfetchcommand.h"
+#include "samplecommandbench.h"
+
+typedef SampleCommandBench<LoggerFetchCommand, DataLoggerService> Bench;
+
+void BenchLoggerFetchCommand::outputSamples_data()
+{
+    Bench::addFormatsAndSizes(true);
+}
+
+void BenchLoggerFetchCommand::outputSamples()
+{
+    Bench::outputSamples(DataLoggerService::Metadata{
+        DataLoggerService::LoggerStatus::Done, 0.001f, DataLoggerService::Mode::DcVoltage,
+        { DataLoggerService::VoltageRange::_6V_to_12V }, 60000, 1000, 1650000000
+    });
+}
+
+void BenchLoggerFetchCommand::outputRawSamples_data()
+{
+    Bench::addFormatsAndSizes(false);
+}
+
+void BenchLoggerFetchCommand::outputRawSamples()
+{
+    Bench::outputRawSamples();
+}
+
+void BenchLoggerFetchCommand::pipeline_data()
+{
+    Bench::addFormats();
+}
+
+void BenchLoggerFetchCommand::pipeline()
+{
+    // A full 6192-sample logger fetch: one `Metadata` notification, then 48 `Reading`
+    // notifications of 129 samples each.
+    Bench::pipeline({ 0, 258, 48 }, 6192, [](LoggerFetchCommand &command) {
+        command.getService(); // Connects the service's signals.
+    });
+}
+
+QTEST_MAIN(BenchLoggerFetchCommand)
@@ -0,0 +1,19 @@
+// SPDX-FileCopyrightText: 2022 Paul Colby <git@colby.id.au>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include <QTest>
+
+class BenchLoggerFetchCommand : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void outputSamples_data();
+    void outputSamples();
+
+    void outputRawSamples_data();
+    void outputRawSamples();
+
+    void pipeline_data();
+    void pipeline();
+};
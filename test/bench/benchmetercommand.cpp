@@ -0,0 +1,76 @@
+// SPDX-FileCopyrightText: 2022 Paul Colby <git@colby.id.au>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "benchmetercommand.h"
+
+#include "metercommand.h"
+
+Q_DECLARE_METATYPE(AbstractCommand::OutputFormat)
+Q_DECLARE_METATYPE(MultimeterService::Mode)
+
+void BenchMeterCommand::outputReading_data()
+{
+    QTest::addColumn<AbstractCommand::OutputFormat>("format");
+    QTest::addColumn<MultimeterService::Mode>("mode");
+    const QList<QPair<const char *, AbstractCommand::OutputFormat>> formats{
+        { "csv",   AbstractCommand::OutputFormat::Csv },
+        { "json",  AbstractCommand::OutputFormat::Json },
+        { "jsonl", AbstractCommand::OutputFormat::JsonLines },
+        { "text",  AbstractCommand::OutputFormat::Text },
+    };
+    for (const auto &format: formats) {
+        QTest::addRow("%s-dc-voltage", format.first)
+            << format.second << MultimeterService::Mode::DcVoltage;
+        QTest::addRow("%s-resistance", format.first)
+            << format.second << MultimeterService::Mode::Resistance;
+        QTest::addRow("%s-temperature", format.first)
+            << format.second << MultimeterService::Mode::Temperature;
+    }
+}
+
+void BenchMeterCommand::outputReading()
+{
+    QFETCH(AbstractCommand::OutputFormat, format);
+    QFETCH(MultimeterService::Mode, mode);
+    const MultimeterService::Reading reading{
+        MultimeterService::MeterStatus::AutoRangeOn, 1.234f, mode,
+        { MultimeterService::VoltageRange::_2V_to_6V }
+    };
+
+    MeterCommand command(nullptr);
+    command.format = format;
+    qint64 bytes = 0;
+    command.setOutputHandler([&bytes](const QByteArray &output) { bytes += output.size(); });
+    QBENCHMARK {
+        command.outputReading(reading);
+    }
+    QVERIFY(bytes > 0);
+}
+
+void BenchMeterCommand::aggregateReading_data()
+{
+    outputReading_data();
+}
+
+void BenchMeterCommand::aggregateReading()
+{
+    QFETCH(AbstractCommand::OutputFormat, format);
+    QFETCH(MultimeterService::Mode, mode);
+    const MultimeterService::Reading reading{
+        MultimeterService::MeterStatus::AutoRangeOn, 1.234f, mode,
+        { MultimeterService::VoltageRange::_2V_to_6V }
+    };
+
+    MeterCommand command(nullptr);
+    command.format = format;
+    command.aggregateWindow = 60000;
+    command.readingsPerWindow = 60; // ie one minute of readings, at one second intervals.
+    qint64 bytes = 0;
+    command.setOutputHandler([&bytes](const QByteArray &output) { bytes += output.size(); });
+    QBENCHMARK {
+        command.aggregateReading(reading);
+    }
+    QVERIFY(command.samplesOutput > 0);
+}
+
+QTEST_MAIN(BenchMeterCommand)
@@ -0,0 +1,15 @@
+// SPDX-FileCopyrightText: 2022 Paul Colby <git@colby.id.au>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include <QTest>
+
+class BenchMeterCommand : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void outputReading_data();
+    void outputReading();
+    void aggregateReading_data();
+    void aggregateReading();
+};
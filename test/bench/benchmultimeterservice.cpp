@@ -0,0 +1,23 @@
+// SPDX-FileCopyrightText: 2022 Paul Colby <git@colby.id.au>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "benchmultimeterservice.h"
+
+#include <qtpokit/multimeterservice.h>
+#include <qtpokit/pokitsimulator.h>
+#include "multimeterservice_p.h"
+
+void BenchMultimeterService::parseReading()
+{
+    const QByteArray value = PokitSimulator::encodeReading(MultimeterService::Reading{
+        MultimeterService::MeterStatus::AutoRangeOn, 1.5f, MultimeterService::Mode::DcVoltage,
+        { MultimeterService::VoltageRange::_2V_to_6V }
+    });
+    MultimeterService::Reading reading{};
+    QBENCHMARK {
+        reading = MultimeterServicePrivate::parseReading(value);
+    }
+    QCOMPARE(reading.value, 1.5f);
+}
+
+QTEST_MAIN(BenchMultimeterService)
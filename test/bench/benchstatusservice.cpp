@@ -0,0 +1,21 @@
+// SPDX-FileCopyrightText: 2022 Paul Colby <git@colby.id.au>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "benchstatusservice.h"
+
+#include <qtpokit/statusservice.h>
+#include "statusservice_p.h"
+
+void BenchStatusService::parseDeviceCharacteristics()
+{
+    // Sample from a real Pokit Meter device.
+    const QByteArray value("\x01\x04\x3c\x00\x02\x00\xe8\x03\xe8\x03"
+                           "\x00\x20\x00\x00\x84\x2e\x14\x2c\x03\xa8", 20);
+    StatusService::DeviceCharacteristics characteristics{};
+    QBENCHMARK {
+        characteristics = StatusServicePrivate::parseDeviceCharacteristics(value);
+    }
+    QCOMPARE(characteristics.firmwareVersion, QVersionNumber(1,4));
+}
+
+QTEST_MAIN(BenchStatusService)
@@ -0,0 +1,12 @@
+// SPDX-FileCopyrightText: 2022 Paul Colby <git@colby.id.au>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include <QTest>
+
+class BenchStatusService : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void parseDeviceCharacteristics();
+};
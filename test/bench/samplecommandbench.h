@@ -0,0 +1,144 @@
+// SPDX-FileCopyrightText: 2022 Paul Colby <git@colby.id.au>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#ifndef QTPOKIT_BENCH_SAMPLECOMMANDBENCH_H
+#define QTPOKIT_BENCH_SAMPLECOMMANDBENCH_H
+
+#include "allocationcounter.h"
+#include "devicecommand.h"
+
+#include <qtpokit/pokitdevice.h>
+#include <qtpokit/pokitsimulator.h>
+
+#include <QElapsedTimer>
+#include <QLoggingCategory>
+#include <QSignalSpy>
+#include <QTest>
+
+#include <functional>
+#include <limits>
+
+Q_DECLARE_METATYPE(AbstractCommand::OutputFormat)
+
+/*!
+ * Benchmarks shared by the sample-streaming commands (DsoCommand and LoggerFetchCommand), which
+ * differ only in their \a Command and \a Service types, metadata, and simulated stream sizes.
+ */
+template<class Command, class Service>
+class SampleCommandBench
+{
+public:
+    /// Adds `format` and `numberOfSamples` columns, for realistic per-notification sample counts
+    /// (20, 244 and 512 byte payloads), with either the \a scaled or the raw (binary) formats.
+    static void addFormatsAndSizes(const bool scaled)
+    {
+        QTest::addColumn<AbstractCommand::OutputFormat>("format");
+        QTest::addColumn<int>("numberOfSamples");
+        const QList<QPair<const char *, AbstractCommand::OutputFormat>> formats = (scaled)
+            ? QList<QPair<const char *, AbstractCommand::OutputFormat>>{
+                { "csv",   AbstractCommand::OutputFormat::Csv },
+                { "json",  AbstractCommand::OutputFormat::Json },
+                { "jsonl", AbstractCommand::OutputFormat::JsonLines },
+                { "text",  AbstractCommand::OutputFormat::Text } }
+            : QList<QPair<const char *, AbstractCommand::OutputFormat>>{
+                { "binary", AbstractCommand::OutputFormat::Binary } };
+        for (const auto &format: formats) {
+            for (const int numberOfSamples: { 10, 122, 256 }) {
+                QTest::addRow("%s-%d", format.first, numberOfSamples)
+                    << format.second << numberOfSamples;
+            }
+        }
+    }
+
+    /// Adds a `format` column, with a row for each output format.
+    static void addFormats()
+    {
+        QTest::addColumn<AbstractCommand::OutputFormat>("format");
+        QTest::addRow("binary") << AbstractCommand::OutputFormat::Binary;
+        QTest::addRow("csv")    << AbstractCommand::OutputFormat::Csv;
+        QTest::addRow("json")   << AbstractCommand::OutputFormat::Json;
+        QTest::addRow("jsonl")  << AbstractCommand::OutputFormat::JsonLines;
+        QTest::addRow("text")   << AbstractCommand::OutputFormat::Text;
+    }
+
+    /// Benchmarks Command::outputSamples, with \a metadata as the most recently received.
+    static void outputSamples(const typename Service::Metadata &metadata)
+    {
+        QFETCH(AbstractCommand::OutputFormat, format);
+        QFETCH(int, numberOfSamples);
+        const typename Service::ScaledSamples samples(numberOfSamples, 1.234f);
+
+        Command command(nullptr);
+        command.format = format;
+        command.metadata = metadata;
+        qint64 bytes = 0;
+        command.setOutputHandler([&bytes](const QByteArray &output) { bytes += output.size(); });
+        QBENCHMARK {
+            command.samplesToGo = std::numeric_limits<qint32>::max(); // Never finish.
+            command.outputSamples(samples);
+        }
+        QVERIFY(bytes > 0);
+    }
+
+    /// Benchmarks Command::outputRawSamples.
+    static void outputRawSamples()
+    {
+        QFETCH(AbstractCommand::OutputFormat, format);
+        QFETCH(int, numberOfSamples);
+        const typename Service::Samples samples(numberOfSamples, 1234);
+
+        Command command(nullptr);
+        command.format = format;
+        qint64 bytes = 0;
+        command.setOutputHandler([&bytes](const QByteArray &output) { bytes += output.size(); });
+        QBENCHMARK {
+            command.samplesToGo = std::numeric_limits<qint32>::max(); // Never finish.
+            command.outputRawSamples(samples);
+        }
+        QVERIFY(bytes > 0);
+    }
+
+    /// Benchmarks complete (simulated) acquisitions of \a settings, each of \a samplesPerRun
+    /// samples, streamed through the command once \a start has connected the service's signals.
+    static void pipeline(const PokitSimulator::StreamSettings &settings, const qint64 samplesPerRun,
+                         const std::function<void(Command &)> &start)
+    {
+        QFETCH(AbstractCommand::OutputFormat, format);
+        QLoggingCategory::setFilterRules(QStringLiteral("pokit.*.info=false"));
+
+        PokitDevice device(nullptr); // No controller; all notifications come from the simulator.
+        Command command(nullptr);
+        command.format = format;
+        command.device = &device; // Not owned, so finishing calls the handler, not disconnecting.
+        int finishes = 0;
+        command.setFinishedHandler([&finishes](DeviceCommand * const, const int) { ++finishes; });
+        qint64 bytes = 0;
+        command.setOutputHandler([&bytes](const QByteArray &output) { bytes += output.size(); });
+        start(command);
+
+        PokitSimulator simulator;
+        simulator.addStream(command.service, settings);
+        QSignalSpy finished(&simulator, &PokitSimulator::finished);
+
+        int runs = 0;
+        QElapsedTimer timer;
+        const quint64 allocationsBefore = AllocationCounter::allocations();
+        timer.start();
+        QBENCHMARK {
+            simulator.start();
+            QVERIFY(finished.wait());
+            ++runs;
+        }
+        const qint64 nsecs = timer.nsecsElapsed();
+        const quint64 allocations = AllocationCounter::allocations() - allocationsBefore;
+        QCOMPARE(finishes, runs);
+        QVERIFY(bytes > 0);
+
+        const qint64 samples = runs * samplesPerRun;
+        qInfo("%.0f samples/s, %.3f allocations/sample, %.2f bytes/sample",
+              samples * 1e9 / qMax<qint64>(nsecs, 1), double(allocations) / samples,
+              double(bytes) / samples);
+    }
+};
+
+#endif // QTPOKIT_BENCH_SAMPLECOMMANDBENCH_H
@@ -0,0 +1,25 @@
+// SPDX-FileCopyrightText: 2022 Paul Colby <git@colby.id.au>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#ifndef QTPOKIT_BENCH_SERVICEBENCH_H
+#define QTPOKIT_BENCH_SERVICEBENCH_H
+
+#include <qtpokit/pokitsimulator.h>
+
+#include <QTest>
+
+namespace ServiceBench {
+
+// Realistic `Reading` payload sizes: the default ATT MTU's 20 bytes, the LE Data Length Extension's
+// 244 bytes, and the 512 byte maximum attribute value size.
+inline void addPayloadSizes()
+{
+    QTest::addColumn<QByteArray>("value");
+    for (const int size: { 20, 244, 512 }) {
+        QTest::addRow("%d-bytes", size) << PokitSimulator::encodeSamples(size/2);
+    }
+}
+
+}
+
+#endif // QTPOKIT_BENCH_SERVICEBENCH_H
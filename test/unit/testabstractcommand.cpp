@@ -7,6 +7,12 @@
 
 #include <qtpokit/pokitdiscoveryagent.h>
 
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include <limits>
+
 Q_DECLARE_METATYPE(AbstractCommand::OutputFormat)
 
 class MockCommand : public AbstractCommand
@@ -70,6 +76,234 @@ void TestAbstractCommand::escapeCsvField()
     QCOMPARE(AbstractCommand::escapeCsvField(field), expected);
 }
 
+void TestAbstractCommand::appendInteger_data()
+{
+    QTest::addColumn<qint64>("value");
+    QTest::addRow("0")    << (qint64)0;
+    QTest::addRow("1")    << (qint64)1;
+    QTest::addRow("-123") << (qint64)-123;
+    QTest::addRow("max")  << std::numeric_limits<qint64>::max();
+    QTest::addRow("min")  << std::numeric_limits<qint64>::min();
+}
+
+void TestAbstractCommand::appendInteger()
+{
+    QFETCH(qint64, value);
+    QByteArray output("prefix:");
+    AbstractCommand::appendInteger(output, value);
+    QCOMPARE(output, QByteArray("prefix:") + QByteArray::number(value));
+}
+
+void TestAbstractCommand::appendReal_data()
+{
+    QTest::addColumn<double>("value");
+    QTest::addColumn<char>("format");
+    QTest::addColumn<int>("precision");
+
+    for (const char format: { 'e', 'f', 'g' }) {
+        #define QTPOKIT_ADD_TEST_ROW(name, value) \
+            QTest::addRow("%s:%c", name, format) << (double)(value) << format << 6
+        QTPOKIT_ADD_TEST_ROW("zero", 0.0);
+        QTPOKIT_ADD_TEST_ROW("1.5", 1.5);
+        QTPOKIT_ADD_TEST_ROW("-1.2345e-05", -1.2345e-05);
+        QTPOKIT_ADD_TEST_ROW("1234567", 1234567.0);
+        QTPOKIT_ADD_TEST_ROW("0.1f", 0.1f);
+        QTPOKIT_ADD_TEST_ROW("inf", std::numeric_limits<double>::infinity());
+        QTPOKIT_ADD_TEST_ROW("-inf", -std::numeric_limits<double>::infinity());
+        QTPOKIT_ADD_TEST_ROW("nan", std::numeric_limits<double>::quiet_NaN());
+        #undef QTPOKIT_ADD_TEST_ROW
+    }
+    QTest::addRow("precision:2") << 3.14159 << 'g' << 2;
+    QTest::addRow("precision:10") << 3.14159 << 'f' << 10;
+}
+
+void TestAbstractCommand::appendReal()
+{
+    QFETCH(double, value);
+    QFETCH(char, format);
+    QFETCH(int, precision);
+    QByteArray output("prefix:");
+    AbstractCommand::appendReal(output, value, format, precision);
+    QCOMPARE(output, QByteArray("prefix:") + QString::number(value, format, precision).toLatin1());
+}
+
+void TestAbstractCommand::appendJsonString_data()
+{
+    QTest::addColumn<QString>("string");
+    QTest::addColumn<QByteArray>("expected");
+    QTest::addRow("<null>")  << QString()                     << QByteArray("\"\"");
+    QTest::addRow("abc")     << QStringLiteral("abc")         << QByteArray("\"abc\"");
+    QTest::addRow("quotes")  << QStringLiteral("a\"b\\c")     << QByteArray("\"a\\\"b\\\\c\"");
+    QTest::addRow("control") << QStringLiteral("a\nb\tc\x01") << QByteArray("\"a\\nb\\tc\\u0001\"");
+    QTest::addRow("utf8")    << QString::fromUtf8("10\xce\xa9") << QByteArray("\"10\xce\xa9\"");
+}
+
+void TestAbstractCommand::appendJsonString()
+{
+    QFETCH(QString, string);
+    QFETCH(QByteArray, expected);
+    QByteArray output;
+    AbstractCommand::appendJsonString(output, string);
+    QCOMPARE(output, expected);
+
+    // Check the result is also what Qt's own JSON implementation would produce.
+    QCOMPARE(QJsonDocument(QJsonArray{ string }).toJson(QJsonDocument::Compact),
+             QByteArray("[") + expected + QByteArray("]"));
+}
+
+void TestAbstractCommand::appendJsonNumber_data()
+{
+    QTest::addColumn<double>("value");
+    QTest::addColumn<QByteArray>("expected");
+    QTest::addRow("0")     << 0.0 << QByteArray("0");
+    QTest::addRow("-1.5")  << -1.5 << QByteArray("-1.5");
+    QTest::addRow("0.1f")  << (double)0.1f << QByteArray("0.100000001");
+    QTest::addRow("1e-05") << 1e-05 << QByteArray("1e-05");
+    QTest::addRow("inf")   << std::numeric_limits<double>::infinity() << QByteArray("null");
+    QTest::addRow("nan")   << std::numeric_limits<double>::quiet_NaN() << QByteArray("null");
+}
+
+void TestAbstractCommand::appendJsonNumber()
+{
+    QFETCH(double, value);
+    QFETCH(QByteArray, expected);
+    QByteArray output;
+    AbstractCommand::appendJsonNumber(output, value);
+    QCOMPARE(output, expected);
+}
+
+void TestAbstractCommand::appendBinaryHeader()
+{
+    QByteArray output("prefix:");
+    AbstractCommand::appendBinaryHeader(output, {
+        AbstractCommand::BinarySource::DataLogger, 3, 4, 1.0f, 0x12345678, 0, 0xAABBCCDD, 6192 });
+    QCOMPARE(output, QByteArray("prefix:") + QByteArray::fromHex(
+        "5154504b" "2000" "01" "02" "03" "04" "0200" "0000803f"
+        "78563412" "00000000" "ddccbbaa" "30180000"));
+}
+
+void TestAbstractCommand::appendRawSamples_data()
+{
+    QTest::addColumn<QVector<qint16>>("samples");
+    QTest::addColumn<QByteArray>("expected");
+    QTest::addRow("<empty>") << QVector<qint16>{} << QByteArray();
+    QTest::addRow("1")       << QVector<qint16>{ 1 } << QByteArray::fromHex("0100");
+    QTest::addRow("1,-2")    << QVector<qint16>{ 1, -2 } << QByteArray::fromHex("0100feff");
+    QTest::addRow("min,max") << QVector<qint16>{ std::numeric_limits<qint16>::min(),
+        std::numeric_limits<qint16>::max() } << QByteArray::fromHex("0080ff7f");
+}
+
+void TestAbstractCommand::appendRawSamples()
+{
+    QFETCH(QVector<qint16>, samples);
+    QFETCH(QByteArray, expected);
+    QByteArray output("prefix:");
+    AbstractCommand::appendRawSamples(output, samples);
+    QCOMPARE(output, QByteArray("prefix:") + expected);
+}
+
+void TestAbstractCommand::appendTagged_data()
+{
+    QTest::addColumn<AbstractCommand::OutputFormat>("format");
+    QTest::addColumn<QByteArray>("lines");
+    QTest::addColumn<QByteArray>("expected");
+
+    QTest::addRow("csv") << AbstractCommand::OutputFormat::Csv
+        << QByteArray("1,2\n3,4\n") << QByteArray("dev,1,2\ndev,3,4\n");
+    QTest::addRow("text") << AbstractCommand::OutputFormat::Text
+        << QByteArray("a b\nc d") << QByteArray("deva b\ndevc d");
+    QTest::addRow("jsonl") << AbstractCommand::OutputFormat::JsonLines
+        << QByteArray("{\"a\":1}\n{}\ntrue\n") << QByteArray("{dev\"a\":1}\n{}\ntrue\n");
+    QTest::addRow("json") << AbstractCommand::OutputFormat::Json
+        << QByteArray("{\n    \"a\": {\n    }\n}\n{\n}\n")
+        << QByteArray("{dev\n    \"a\": {\n    }\n}\n{dev\n}\n");
+    QTest::addRow("binary") << AbstractCommand::OutputFormat::Binary
+        << QByteArray("\x01\n\x02") << QByteArray("\x01\n\x02");
+}
+
+void TestAbstractCommand::appendTagged()
+{
+    QFETCH(AbstractCommand::OutputFormat, format);
+    QFETCH(QByteArray, lines);
+    QFETCH(QByteArray, expected);
+    QByteArray output;
+    AbstractCommand::appendTagged(output, lines, format, QByteArray("dev"));
+    QCOMPARE(output, expected);
+}
+
+void TestAbstractCommand::setOutputTag_data()
+{
+    QTest::addColumn<AbstractCommand::OutputFormat>("format");
+    QTest::addColumn<QByteArray>("expected");
+    QTest::addRow("binary") << AbstractCommand::OutputFormat::Binary << QByteArray();
+    QTest::addRow("csv")    << AbstractCommand::OutputFormat::Csv << QByteArray("\"a,b\",");
+    QTest::addRow("json")   << AbstractCommand::OutputFormat::Json
+                            << QByteArray("\n    \"device\": \"a,b\",");
+    QTest::addRow("jsonl")  << AbstractCommand::OutputFormat::JsonLines
+                            << QByteArray("\"device\":\"a,b\",");
+    QTest::addRow("text")   << AbstractCommand::OutputFormat::Text << QByteArray("a,b: ");
+}
+
+void TestAbstractCommand::setOutputTag()
+{
+    QFETCH(AbstractCommand::OutputFormat, format);
+    QFETCH(QByteArray, expected);
+    MockCommand command;
+    command.format = format;
+    command.setOutputTag(QStringLiteral("a,b"));
+    QCOMPARE(command.outputTag, expected);
+}
+
+void TestAbstractCommand::appendCsvHeader()
+{
+    MockCommand command;
+    command.format = AbstractCommand::OutputFormat::Csv;
+    QByteArray output;
+    command.setOutputHandler([&output](const QByteArray &data) { output.append(data); });
+    for (const QByteArray &line: { QByteArray("1,2\n"), QByteArray("3,4\n") }) {
+        command.appendCsvHeader(QStringLiteral("a,b\n"));
+        command.outputBuffer.append(line);
+        command.flushOutput();
+    }
+    QCOMPARE(output, QByteArray("a,b\n1,2\n3,4\n"));
+
+    // Each command outputs its own header.
+    MockCommand another;
+    another.format = AbstractCommand::OutputFormat::Csv;
+    another.appendCsvHeader(QStringLiteral("a,b\n"));
+    QCOMPARE(another.outputBuffer, QByteArray("a,b\n"));
+}
+
+void TestAbstractCommand::appendCsvHeader_tagged()
+{
+    // Multiplexed commands share the one (tagged) header.
+    bool csvHeaderPending = true;
+    QByteArray output;
+    MockCommand commands[2];
+    for (MockCommand &command: commands) {
+        command.format = AbstractCommand::OutputFormat::Csv;
+        command.setOutputTag(QString::number(&command - commands), &csvHeaderPending);
+        command.setOutputHandler([&output](const QByteArray &data) { output.append(data); });
+    }
+    for (MockCommand &command: commands) {
+        command.appendCsvHeader(QStringLiteral("a,b\n"));
+        command.outputBuffer.append("1,2\n");
+        command.flushOutput();
+    }
+    QCOMPARE(output, QByteArray("device,a,b\n0,1,2\n1,1,2\n"));
+    QVERIFY(!csvHeaderPending);
+}
+
+void TestAbstractCommand::formatJson()
+{
+    MockCommand command;
+    const QJsonDocument document(QJsonObject{ { QStringLiteral("a"), 1 } });
+    command.format = AbstractCommand::OutputFormat::Json;
+    QCOMPARE(command.formatJson(document), document.toJson(QJsonDocument::Indented));
+    command.format = AbstractCommand::OutputFormat::JsonLines;
+    QCOMPARE(command.formatJson(document), QByteArray("{\"a\":1}\n"));
+}
+
 void TestAbstractCommand::parseMicroValue_data()
 {
     QTest::addColumn<QString>("value");
@@ -255,6 +489,8 @@ void TestAbstractCommand::processOptions_output_data()
     QTest::addColumn<bool>("expectErrors");
 
     // Valid values.
+    QTest::addRow("bin")    << QStringLiteral("bin")    << AbstractCommand::OutputFormat::Binary << false;
+    QTest::addRow("BINARY") << QStringLiteral("BINARY") << AbstractCommand::OutputFormat::Binary << false;
     QTest::addRow("csv" ) << QStringLiteral("csv" ) << AbstractCommand::OutputFormat::Csv  << false;
     QTest::addRow("cSv" ) << QStringLiteral("cSv" ) << AbstractCommand::OutputFormat::Csv  << false;
     QTest::addRow("CSV" ) << QStringLiteral("CSV" ) << AbstractCommand::OutputFormat::Csv  << false;
@@ -264,6 +500,10 @@ void TestAbstractCommand::processOptions_output_data()
     QTest::addRow("text") << QStringLiteral("text") << AbstractCommand::OutputFormat::Text << false;
     QTest::addRow("tExT") << QStringLiteral("tExT") << AbstractCommand::OutputFormat::Text << false;
     QTest::addRow("TEXT") << QStringLiteral("TEXT") << AbstractCommand::OutputFormat::Text << false;
+    QTest::addRow("jsonl")  << QStringLiteral("jsonl")  << AbstractCommand::OutputFormat::JsonLines << false;
+    QTest::addRow("JSONL")  << QStringLiteral("JSONL")  << AbstractCommand::OutputFormat::JsonLines << false;
+    QTest::addRow("ndjson") << QStringLiteral("ndjson") << AbstractCommand::OutputFormat::JsonLines << false;
+    QTest::addRow("NDJSON") << QStringLiteral("NDJSON") << AbstractCommand::OutputFormat::JsonLines << false;
 
     // Invalid values should all remain as the default Text.
     QTest::addRow("<empty>") << QString()             << AbstractCommand::OutputFormat::Text << true;
@@ -15,6 +15,34 @@ private slots:
     void escapeCsvField_data();
     void escapeCsvField();
 
+    void appendInteger_data();
+    void appendInteger();
+
+    void appendReal_data();
+    void appendReal();
+
+    void appendJsonString_data();
+    void appendJsonString();
+
+    void appendJsonNumber_data();
+    void appendJsonNumber();
+
+    void appendBinaryHeader();
+
+    void appendRawSamples_data();
+    void appendRawSamples();
+
+    void appendTagged_data();
+    void appendTagged();
+
+    void setOutputTag_data();
+    void setOutputTag();
+
+    void appendCsvHeader();
+    void appendCsvHeader_tagged();
+
+    void formatJson();
+
     void parseMicroValue_data();
     void parseMicroValue();
 
@@ -33,6 +33,16 @@ void TestAbstractPokitService::autoDiscover()
     QVERIFY(service.autoDiscover());
 }
 
+void TestAbstractPokitService::skipValueDiscovery()
+{
+    MockPokitService service(nullptr);
+    QVERIFY(!service.skipValueDiscovery()); // Off, by default.
+    service.setSkipValueDiscovery();
+    QVERIFY(service.skipValueDiscovery());
+    service.setSkipValueDiscovery(false);
+    QVERIFY(!service.skipValueDiscovery());
+}
+
 void TestAbstractPokitService::service()
 {
     MockPokitService service(nullptr);
@@ -41,6 +51,100 @@ void TestAbstractPokitService::service()
     QCOMPARE(constService.service(), nullptr);
 }
 
+void TestAbstractPokitService::statistics()
+{
+    MockPokitService service(nullptr);
+    QVERIFY(!service.statisticsEnabled()); // Off, by default.
+    const QBluetoothUuid uuid = QBluetoothUuid::createUuid();
+    service.d_ptr->dispatchNotification(uuid, QByteArray(10, '\x01'));
+    QVERIFY(service.statistics().isEmpty()); // Not recorded while disabled.
+
+    service.setStatisticsEnabled();
+    QVERIFY(service.statisticsEnabled());
+    for (int count = 0; count < 3; ++count) {
+        service.d_ptr->dispatchNotification(uuid, QByteArray(10, '\x01'));
+    }
+    service.d_ptr->characteristicRead(QLowEnergyCharacteristic(), QByteArray(4, '\x02'));
+    service.d_ptr->characteristicWritten(QLowEnergyCharacteristic(), QByteArray(2, '\x03'));
+
+    const AbstractPokitService::Statistics statistics = service.statistics();
+    QCOMPARE(statistics.size(), 2);
+    QCOMPARE(statistics.value(uuid).notifications, (quint64)3);
+    QCOMPARE(statistics.value(uuid).bytesNotified, (quint64)30);
+    QCOMPARE(statistics.value(uuid).notificationInterval.count, (quint64)2); // Between the 3.
+    QCOMPARE(statistics.value(uuid).reads, (quint64)0);
+    QCOMPARE(statistics.value(QBluetoothUuid()).reads, (quint64)1);
+    QCOMPARE(statistics.value(QBluetoothUuid()).bytesRead, (quint64)4);
+    QCOMPARE(statistics.value(QBluetoothUuid()).readLatency.count, (quint64)0); // Never requested.
+    QCOMPARE(statistics.value(QBluetoothUuid()).writes, (quint64)1);
+    QCOMPARE(statistics.value(QBluetoothUuid()).bytesWritten, (quint64)2);
+
+    service.resetStatistics();
+    QVERIFY(service.statistics().isEmpty());
+    service.setStatisticsEnabled(false);
+    QVERIFY(!service.statisticsEnabled());
+}
+
+void TestAbstractPokitService::latencyHistogram_data()
+{
+    QTest::addColumn<QList<qint64>>("values");
+    QTest::addColumn<qint64>("mean");
+    QTest::addColumn<qint64>("p50");
+    QTest::addColumn<qint64>("p99");
+
+    QTest::addRow("empty") << QList<qint64>{ } << (qint64)0 << (qint64)0 << (qint64)0;
+    QTest::addRow("single") << QList<qint64>{ 7 } << (qint64)7 << (qint64)7 << (qint64)7;
+    QTest::addRow("exact") << QList<qint64>{ 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 }
+        << (qint64)5 << (qint64)5 << (qint64)10;
+    QTest::addRow("negative") << QList<qint64>{ -5 } << (qint64)0 << (qint64)0 << (qint64)0;
+
+    // 1,000 values of 1ms, and 10 of 100ms; larger values are bucketed to within 1/16th.
+    QList<qint64> values;
+    for (int index = 0; index < 1000; ++index) {
+        values.append(1000);
+    }
+    for (int index = 0; index < 10; ++index) {
+        values.append(100000);
+    }
+    QTest::addRow("bimodal") << values << (qint64)1980 << (qint64)1023 << (qint64)1023;
+}
+
+void TestAbstractPokitService::latencyHistogram()
+{
+    QFETCH(QList<qint64>, values);
+    QFETCH(qint64, mean);
+    QFETCH(qint64, p50);
+    QFETCH(qint64, p99);
+    AbstractPokitService::LatencyHistogram histogram;
+    for (const qint64 value: values) {
+        histogram.record(value);
+    }
+    QCOMPARE(histogram.count, (quint64)values.size());
+    QCOMPARE(histogram.mean(), mean);
+    QCOMPARE(histogram.percentile(50), p50);
+    QCOMPARE(histogram.percentile(99), p99);
+    QCOMPARE(histogram.percentile(100), histogram.max);
+    QVERIFY(histogram.percentile(0) >= histogram.min);
+}
+
+void TestAbstractPokitService::bucketIndex()
+{
+    // Every value must fall within its bucket's bounds, and bucket indexes must never decrease.
+    int previousIndex = 0;
+    for (qint64 value = 0; value < (qint64)1 << 40; value += qMax<qint64>(1, value / 5)) {
+        const int index = AbstractPokitService::LatencyHistogram::bucketIndex(value);
+        QVERIFY(index >= previousIndex);
+        QVERIFY(value <= AbstractPokitService::LatencyHistogram::bucketUpperBound(index));
+        QVERIFY((index == 0) ||
+                (value > AbstractPokitService::LatencyHistogram::bucketUpperBound(index - 1)));
+        previousIndex = index;
+    }
+    QCOMPARE(AbstractPokitService::LatencyHistogram::bucketIndex(31), 31);
+    QCOMPARE(AbstractPokitService::LatencyHistogram::bucketIndex(32), 32);
+    QCOMPARE(AbstractPokitService::LatencyHistogram::bucketUpperBound(32), (qint64)33);
+    QCOMPARE(AbstractPokitService::LatencyHistogram::bucketIndex(64), 48);
+}
+
 void TestAbstractPokitService::createServiceObject()
 {
     // Verify that creation will fail without a Bluetooth device controller
@@ -66,6 +170,13 @@ void TestAbstractPokitService::createServiceObject()
     service.d_ptr->service = nullptr; // Just in case we ever add more code here, and forget to.
 }
 
+void TestAbstractPokitService::discoverServiceDetails()
+{
+    // Verify that (deferred) discovery is skipped safely, when no service object has been created.
+    MockPokitService service(nullptr);
+    QVERIFY(!service.d_ptr->discoverServiceDetails());
+}
+
 void TestAbstractPokitService::getCharacteristic()
 {
     {   // Verify an invalid characteristic is returned safely, when no controller is set.
@@ -261,4 +372,11 @@ void TestAbstractPokitService::characteristicChanged()
     service.d_ptr->characteristicChanged(characteristic, QByteArray());
 }
 
+void TestAbstractPokitService::dispatchNotification()
+{
+    // Verify safe handling, since the base class ignores all notifications.
+    MockPokitService service(nullptr);
+    service.d_ptr->dispatchNotification(QBluetoothUuid::createUuid(), QByteArray("\x01\x02"));
+}
+
 QTEST_MAIN(TestAbstractPokitService)
@@ -10,11 +10,18 @@ class TestAbstractPokitService : public QObject
 private slots:
     // AbstractPokitService tests.
     void autoDiscover();
+    void skipValueDiscovery();
     void service();
+    void statistics();
+
+    void latencyHistogram_data();
+    void latencyHistogram();
+    void bucketIndex();
 
     // AbstractPokitServicePrivate tests.
     // Most of these only test safe error handling, since more would require mocking Qt's BLE classes.
     void createServiceObject();
+    void discoverServiceDetails();
     void getCharacteristic();
     void readCharacteristic();
     void enableCharacteristicNotificatons();
@@ -35,4 +42,5 @@ private slots:
     void characteristicRead();
     void characteristicWritten();
     void characteristicChanged();
+    void dispatchNotification();
 };
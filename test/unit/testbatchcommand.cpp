@@ -0,0 +1,134 @@
+// SPDX-FileCopyrightText: 2022 Paul Colby <git@colby.id.au>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "testbatchcommand.h"
+
+#include "batchcommand.h"
+#include "loggerstartcommand.h"
+#include "loggerstopcommand.h"
+#include "statuscommand.h"
+
+#include <qtpokit/dataloggerservice.h>
+#include <qtpokit/pokitdevice.h>
+
+#include <QTemporaryFile>
+
+namespace {
+
+DeviceCommand * testFactory(const QStringList &arguments, QCommandLineParser &parser,
+                            QString &error, QObject * const parent)
+{
+    parser.addOptions({
+        {{QStringLiteral("output")}, QStringLiteral("description"), QStringLiteral("format")},
+    });
+    if (!parser.parse(QStringList{ QStringLiteral("pokit") } + arguments)) {
+        error = parser.errorText();
+        return nullptr;
+    }
+    if (parser.positionalArguments() != QStringList{ QStringLiteral("status") }) {
+        error = QStringLiteral("Unsupported command");
+        return nullptr;
+    }
+    return new StatusCommand(parent);
+}
+
+QStringList processScript(BatchCommand &command, const QByteArray &script)
+{
+    QTemporaryFile file;
+    if ((!file.open()) || (file.write(script) != script.size())) {
+        return QStringList{ QStringLiteral("Failed to write script") };
+    }
+    file.close();
+
+    QCommandLineParser parser;
+    parser.addOptions({
+        {{QStringLiteral("script")}, QStringLiteral("description"), QStringLiteral("file")},
+    });
+    parser.process(QStringList{ QStringLiteral("pokit"), QStringLiteral("batch"),
+                                QStringLiteral("--script"), file.fileName() });
+    return command.processOptions(parser);
+}
+
+}
+
+void TestBatchCommand::parseLine_data()
+{
+    QTest::addColumn<QString>("line");
+    QTest::addColumn<QStringList>("expected");
+    QTest::addColumn<bool>("expectError");
+
+    QTest::addRow("empty") << QString() << QStringList() << false;
+    QTest::addRow("blank") << QStringLiteral(" \t \n") << QStringList() << false;
+    QTest::addRow("comment") << QStringLiteral("  # status") << QStringList() << false;
+    QTest::addRow("status") << QStringLiteral("status\n")
+        << QStringList{ QStringLiteral("status") } << false;
+    QTest::addRow("options") << QStringLiteral("  dso  --samples 10 # Trailing comment.")
+        << QStringList{ QStringLiteral("dso"), QStringLiteral("--samples"), QStringLiteral("10") }
+        << false;
+    QTest::addRow("single-quoted") << QStringLiteral("meter --mode 'DC Voltage'")
+        << QStringList{ QStringLiteral("meter"), QStringLiteral("--mode"),
+                        QStringLiteral("DC Voltage") } << false;
+    QTest::addRow("double-quoted") << QStringLiteral("set-name --new-name \"My \\\"Pokit\\\"\"")
+        << QStringList{ QStringLiteral("set-name"), QStringLiteral("--new-name"),
+                        QStringLiteral("My \"Pokit\"") } << false;
+    QTest::addRow("escaped") << QStringLiteral("meter --mode DC\\ Voltage")
+        << QStringList{ QStringLiteral("meter"), QStringLiteral("--mode"),
+                        QStringLiteral("DC Voltage") } << false;
+    QTest::addRow("adjacent") << QStringLiteral("--mode=\"DC Voltage\"#1")
+        << QStringList{ QStringLiteral("--mode=DC Voltage#1") } << false;
+    QTest::addRow("empty-quoted") << QStringLiteral("set-name --new-name ''")
+        << QStringList{ QStringLiteral("set-name"), QStringLiteral("--new-name"), QString() }
+        << false;
+    QTest::addRow("unterminated") << QStringLiteral("meter --mode 'DC Voltage")
+        << QStringList() << true;
+}
+
+void TestBatchCommand::parseLine()
+{
+    QFETCH(QString, line);
+    QFETCH(QStringList, expected);
+    QFETCH(bool, expectError);
+    QString error;
+    QCOMPARE(BatchCommand::parseLine(line, error), expected);
+    QCOMPARE(!error.isEmpty(), expectError);
+}
+
+void TestBatchCommand::processOptions()
+{
+    BatchCommand command(testFactory, nullptr);
+    QCOMPARE(processScript(command, "# Comment\nstatus\n\nstatus --output json\n"), QStringList());
+    QCOMPARE(command.commands.size(), 2);
+    QCOMPARE(command.current, nullptr);
+}
+
+void TestBatchCommand::processOptions_errors()
+{
+    BatchCommand empty(testFactory, nullptr);
+    QCOMPARE(processScript(empty, "# Comment only.\n").size(), 1);
+
+    BatchCommand command(testFactory, nullptr);
+    const QStringList errors = processScript(command, "status\nmeter\nstatus 'unterminated\n");
+    QCOMPARE(errors.size(), 2);
+    QVERIFY(errors.at(0).startsWith(QStringLiteral("Line 2: ")));
+    QVERIFY(errors.at(1).startsWith(QStringLiteral("Line 3: ")));
+}
+
+void TestBatchCommand::getService_sharedService()
+{
+    PokitDevice device(nullptr); // No controller, so services are created, but never discovered.
+    BatchCommand command(testFactory, nullptr);
+    QByteArray output;
+    for (DeviceCommand * const queued: QList<DeviceCommand *>{
+         new LoggerStartCommand(&command), new LoggerStopCommand(&command) }) {
+        queued->setOutputHandler([&output](const QByteArray &data) { output.append(data); });
+        command.commands.enqueue(queued);
+    }
+    command.device = &device;
+    QCOMPARE(command.getService(), device.dataLogger());
+
+    // Neither command has been attached to the device yet, so neither reacts to the shared service.
+    emit device.dataLogger()->settingsWritten();
+    QCOMPARE(output, QByteArray());
+}
+
+QTEST_MAIN(TestBatchCommand)
@@ -0,0 +1,18 @@
+// SPDX-FileCopyrightText: 2022 Paul Colby <git@colby.id.au>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include <QTest>
+
+class TestBatchCommand : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void parseLine_data();
+    void parseLine();
+
+    void processOptions();
+    void processOptions_errors();
+
+    void getService_sharedService();
+};
@@ -0,0 +1,277 @@
+// SPDX-FileCopyrightText: 2022 Paul Colby <git@colby.id.au>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "testcapturearchive.h"
+
+#include <qtpokit/capturearchive.h>
+#include "capturearchive_p.h"
+
+#include <QFileInfo>
+#include <QRegularExpression>
+#include <QTemporaryDir>
+
+namespace {
+
+const DsoService::Metadata dsoMetadata{
+    DsoService::DsoStatus::Done, 0.25f, DsoService::Mode::AcVoltage,
+    { DsoService::VoltageRange::_2V_to_6V }, 1000000, 3, 1000 };
+
+const DataLoggerService::Metadata loggerMetadata{
+    DataLoggerService::LoggerStatus::Done, 0.5f, DataLoggerService::Mode::DcCurrent,
+    { DataLoggerService::VoltageRange::_6V_to_12V }, 60000, 2, 1660000000 };
+
+}
+
+void TestCaptureArchive::paddedSize_data()
+{
+    QTest::addColumn<quint32>("numberOfSamples");
+    QTest::addColumn<qint64>("expected");
+    QTest::addRow("0") << (quint32)0 << (qint64)32;
+    QTest::addRow("1") << (quint32)1 << (qint64)40;
+    QTest::addRow("4") << (quint32)4 << (qint64)40;
+    QTest::addRow("5") << (quint32)5 << (qint64)48;
+    QTest::addRow("8192") << (quint32)8192 << (qint64)(32 + 16384);
+}
+
+void TestCaptureArchive::paddedSize()
+{
+    QFETCH(quint32, numberOfSamples);
+    QFETCH(qint64, expected);
+    QCOMPARE(CaptureArchivePrivate::paddedSize(numberOfSamples), expected);
+}
+
+void TestCaptureArchive::open()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    CaptureArchive archive(dir.filePath(QStringLiteral("captures")));
+    QCOMPARE(archive.indexFileName(), dir.filePath(QStringLiteral("captures.idx")));
+    QVERIFY(!archive.isOpen());
+    QCOMPARE(archive.count(), 0);
+    QVERIFY(archive.index() == nullptr);
+    QVERIFY(archive.record(0) == nullptr);
+
+    // Reading a non-existent archive should fail.
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression(QStringLiteral("^Failed to open ")));
+    QVERIFY(!archive.open(QIODevice::ReadOnly));
+    QVERIFY(!archive.isOpen());
+
+    // Writing should create it.
+    QVERIFY(archive.open(QIODevice::WriteOnly));
+    QVERIFY(archive.isOpen());
+    QVERIFY(archive.isWritable());
+    QCOMPARE(archive.count(), 0);
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression(QStringLiteral("already open")));
+    QVERIFY(!archive.open(QIODevice::ReadOnly));
+    archive.close();
+    QVERIFY(!archive.isOpen());
+
+    QFile segment(archive.fileName());
+    QVERIFY(segment.open(QIODevice::ReadOnly));
+    QCOMPARE(segment.readAll(), QByteArray::fromHex("51545053" "01000000"));
+    QFile index(archive.indexFileName());
+    QVERIFY(index.open(QIODevice::ReadOnly));
+    QCOMPARE(index.readAll(), QByteArray::fromHex("51545049" "01000000"));
+}
+
+void TestCaptureArchive::open_invalid()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString fileName = dir.filePath(QStringLiteral("captures"));
+    QFile file(fileName);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    QCOMPARE(file.write("not an archive"), 14);
+    file.close();
+
+    CaptureArchive archive(fileName);
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression(QStringLiteral("^Not a capture archive")));
+    QVERIFY(!archive.open(QIODevice::ReadOnly));
+    QVERIFY(!archive.isOpen());
+
+    // Unsupported versions should be rejected too.
+    QVERIFY(file.open(QIODevice::WriteOnly|QIODevice::Truncate));
+    QCOMPARE(file.write(QByteArray::fromHex("51545053" "02000000")), 8);
+    file.close();
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression(QStringLiteral("^Unsupported capture")));
+    QVERIFY(!archive.open(QIODevice::WriteOnly));
+    QVERIFY(!archive.isOpen());
+}
+
+void TestCaptureArchive::append_dso()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    CaptureArchive archive(dir.filePath(QStringLiteral("captures")));
+    QVERIFY(archive.open(QIODevice::WriteOnly));
+
+    const QDateTime timestamp = QDateTime::fromMSecsSinceEpoch(1660000000123, Qt::UTC);
+    QVERIFY(archive.append(dsoMetadata, DsoService::Samples{ 1, -2, 32767 }, timestamp));
+    QCOMPARE(archive.count(), 1);
+
+    const CaptureArchive::IndexEntry * const index = archive.index();
+    QVERIFY(index != nullptr);
+    QCOMPARE(index[0].offset, (qint64)8);
+    QCOMPARE(index[0].timestamp, timestamp.toMSecsSinceEpoch());
+    QCOMPARE(index[0].numberOfSamples, (quint32)3);
+    QCOMPARE(index[0].source, CaptureArchive::Source::Dso);
+
+    const CaptureArchive::Record * const record = archive.record(0);
+    QVERIFY(record != nullptr);
+    QCOMPARE(record->source, CaptureArchive::Source::Dso);
+    QCOMPARE(record->status, (quint8)DsoService::DsoStatus::Done);
+    QCOMPARE(record->mode, (quint8)DsoService::Mode::AcVoltage);
+    QCOMPARE(record->range, (quint8)DsoService::VoltageRange::_2V_to_6V);
+    QCOMPARE(record->scale, 0.25f);
+    QCOMPARE(record->interval, (quint32)1000000);
+    QCOMPARE(record->samplingRate, (quint32)1000);
+    QCOMPARE(record->numberOfSamples, (quint32)3);
+    QCOMPARE(record->timestamp, timestamp.toMSecsSinceEpoch());
+
+    const qint16 * const samples = archive.samples(0);
+    QVERIFY(samples != nullptr);
+    QCOMPARE(samples[0], (qint16)1);
+    QCOMPARE(samples[1], (qint16)-2);
+    QCOMPARE(samples[2], (qint16)32767);
+
+    QVERIFY(archive.record(1) == nullptr);
+    QVERIFY(archive.samples(-1) == nullptr);
+}
+
+void TestCaptureArchive::append_logger()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    CaptureArchive archive(dir.filePath(QStringLiteral("captures")));
+    QVERIFY(archive.open(QIODevice::WriteOnly));
+
+    // Without an explicit timestamp, the metadata's own timestamp should be used.
+    QVERIFY(archive.append(loggerMetadata, DataLoggerService::Samples{ 100, 200 }));
+    QVERIFY(archive.append(loggerMetadata, DataLoggerService::Samples{ }));
+    QCOMPARE(archive.count(), 2);
+
+    const CaptureArchive::Record * record = archive.record(0);
+    QVERIFY(record != nullptr);
+    QCOMPARE(record->source, CaptureArchive::Source::DataLogger);
+    QCOMPARE(record->mode, (quint8)DataLoggerService::Mode::DcCurrent);
+    QCOMPARE(record->scale, 0.5f);
+    QCOMPARE(record->interval, (quint32)60000);
+    QCOMPARE(record->samplingRate, (quint32)0);
+    QCOMPARE(record->timestamp, (qint64)1660000000 * 1000);
+    QCOMPARE(archive.samples(0)[1], (qint16)200);
+
+    // Second (empty) capture should follow the first, 8-byte aligned.
+    QCOMPARE(archive.index()[1].offset, (qint64)(8 + 40));
+    record = archive.record(1);
+    QVERIFY(record != nullptr);
+    QCOMPARE(record->numberOfSamples, (quint32)0);
+}
+
+void TestCaptureArchive::append_readOnly()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    CaptureArchive archive(dir.filePath(QStringLiteral("captures")));
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression(QStringLiteral("not open for writing")));
+    QVERIFY(!archive.append(dsoMetadata, DsoService::Samples{ 1 }));
+
+    QVERIFY(archive.open(QIODevice::WriteOnly));
+    archive.close();
+    QVERIFY(archive.open(QIODevice::ReadOnly));
+    QVERIFY(!archive.isWritable());
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression(QStringLiteral("not open for writing")));
+    QVERIFY(!archive.append(dsoMetadata, DsoService::Samples{ 1 }));
+    QCOMPARE(archive.count(), 0);
+}
+
+void TestCaptureArchive::reopen()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString fileName = dir.filePath(QStringLiteral("captures"));
+    {
+        CaptureArchive archive(fileName);
+        QVERIFY(archive.open(QIODevice::WriteOnly));
+        QVERIFY(archive.append(dsoMetadata, DsoService::Samples{ 1, 2, 3 }));
+    }
+    {
+        CaptureArchive archive(fileName);
+        QVERIFY(archive.open(QIODevice::WriteOnly|QIODevice::Append));
+        QCOMPARE(archive.count(), 1);
+        QVERIFY(archive.append(loggerMetadata, DataLoggerService::Samples{ 4, 5 }));
+        QCOMPARE(archive.count(), 2);
+    }
+
+    // Simulate an interrupted index write; the partial entry should be ignored, then discarded.
+    QFile index(fileName + QLatin1String(".idx"));
+    QVERIFY(index.open(QIODevice::Append));
+    QCOMPARE(index.write("partial"), 7);
+    index.close();
+
+    CaptureArchive archive(fileName);
+    QVERIFY(archive.open(QIODevice::ReadOnly));
+    QCOMPARE(archive.count(), 2);
+    QCOMPARE(archive.record(0)->source, CaptureArchive::Source::Dso);
+    QCOMPARE(archive.samples(0)[2], (qint16)3);
+    QCOMPARE(archive.record(1)->source, CaptureArchive::Source::DataLogger);
+    QCOMPARE(archive.samples(1)[1], (qint16)5);
+    archive.close();
+
+    QTest::ignoreMessage(QtWarningMsg,
+                         QRegularExpression(QStringLiteral("^Discarding 7 trailing")));
+    QVERIFY(archive.open(QIODevice::WriteOnly));
+    QCOMPARE(archive.count(), 2);
+    QCOMPARE(QFileInfo(archive.indexFileName()).size(), (qint64)(8 + 2 * 24));
+}
+
+void TestCaptureArchive::reopen_orphanedRecord()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString fileName = dir.filePath(QStringLiteral("captures"));
+    {
+        CaptureArchive archive(fileName);
+        QVERIFY(archive.open(QIODevice::WriteOnly));
+        QVERIFY(archive.append(dsoMetadata, DsoService::Samples{ 1, 2, 3 }));
+    }
+
+    // Simulate an append interrupted after writing some of its record, but none of its index entry.
+    QFile segment(fileName);
+    QVERIFY(segment.open(QIODevice::Append));
+    QCOMPARE(segment.write("QTPR\x01"), 5);
+    segment.close();
+
+    // Reopening for writing should discard the orphaned bytes, so the next record is aligned.
+    CaptureArchive archive(fileName);
+    QTest::ignoreMessage(QtWarningMsg,
+                         QRegularExpression(QStringLiteral("^Discarding 5 trailing")));
+    QVERIFY(archive.open(QIODevice::WriteOnly));
+    QCOMPARE(archive.count(), 1);
+    QCOMPARE(QFileInfo(archive.fileName()).size(), (qint64)(8 + 40));
+    QVERIFY(archive.append(loggerMetadata, DataLoggerService::Samples{ 4, 5 }));
+    QCOMPARE(archive.count(), 2);
+    QCOMPARE(archive.index()[1].offset, (qint64)(8 + 40));
+    QVERIFY(archive.record(1) != nullptr);
+    QCOMPARE(archive.samples(1)[1], (qint16)5);
+}
+
+void TestCaptureArchive::find()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    CaptureArchive archive(dir.filePath(QStringLiteral("captures")));
+    QCOMPARE(archive.find(QDateTime::fromMSecsSinceEpoch(0)), -1);
+    QVERIFY(archive.open(QIODevice::WriteOnly));
+    QCOMPARE(archive.find(QDateTime::fromMSecsSinceEpoch(0)), -1);
+    for (qint64 msecs = 1000; msecs <= 5000; msecs += 1000) {
+        QVERIFY(archive.append(dsoMetadata, DsoService::Samples{ 1 },
+                               QDateTime::fromMSecsSinceEpoch(msecs)));
+    }
+    QCOMPARE(archive.find(QDateTime::fromMSecsSinceEpoch(0)), 0);
+    QCOMPARE(archive.find(QDateTime::fromMSecsSinceEpoch(1000)), 0);
+    QCOMPARE(archive.find(QDateTime::fromMSecsSinceEpoch(1001)), 1);
+    QCOMPARE(archive.find(QDateTime::fromMSecsSinceEpoch(5000)), 4);
+    QCOMPARE(archive.find(QDateTime::fromMSecsSinceEpoch(5001)), -1);
+}
+
+QTEST_MAIN(TestCaptureArchive)
@@ -0,0 +1,24 @@
+// SPDX-FileCopyrightText: 2022 Paul Colby <git@colby.id.au>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include <QTest>
+
+class TestCaptureArchive : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void paddedSize_data();
+    void paddedSize();
+
+    void open();
+    void open_invalid();
+
+    void append_dso();
+    void append_logger();
+    void append_readOnly();
+
+    void reopen();
+    void reopen_orphanedRecord();
+    void find();
+};
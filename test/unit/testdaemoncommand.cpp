@@ -0,0 +1,140 @@
+// SPDX-FileCopyrightText: 2022 Paul Colby <git@colby.id.au>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "testdaemoncommand.h"
+
+#include "daemoncommand.h"
+
+#include <QCoreApplication>
+#include <QLocalServer>
+#include <QLocalSocket>
+
+Q_DECLARE_METATYPE(DaemonCommand::FrameType)
+
+// Minimal device command, for standing in for the requests a daemon runs.
+class MockDeviceCommand : public DeviceCommand
+{
+public:
+    explicit MockDeviceCommand(QObject * const parent) : DeviceCommand(parent) { }
+
+protected:
+    AbstractPokitService * getService() override { return nullptr; }
+};
+
+void TestDaemonCommand::encodeFrame_data()
+{
+    QTest::addColumn<DaemonCommand::FrameType>("type");
+    QTest::addColumn<QByteArray>("payload");
+    QTest::addColumn<QByteArray>("expected");
+
+    QTest::addRow("empty") << DaemonCommand::FrameType::Output << QByteArray()
+        << QByteArray("\x01\x00\x00\x00\x00", 5);
+    QTest::addRow("output") << DaemonCommand::FrameType::Output << QByteArray("abc")
+        << QByteArray("\x01\x03\x00\x00\x00" "abc", 8);
+    QTest::addRow("error") << DaemonCommand::FrameType::Error << QByteArray("oops\n")
+        << QByteArray("\x02\x05\x00\x00\x00" "oops\n", 10);
+    QTest::addRow("exit") << DaemonCommand::FrameType::Exit << QByteArray("\x01\x00\x00\x00", 4)
+        << QByteArray("\x03\x04\x00\x00\x00\x01\x00\x00\x00", 9);
+}
+
+void TestDaemonCommand::encodeFrame()
+{
+    QFETCH(DaemonCommand::FrameType, type);
+    QFETCH(QByteArray, payload);
+    QFETCH(QByteArray, expected);
+    const QByteArray frame = DaemonCommand::encodeFrame(type, payload);
+    QCOMPARE(frame, expected);
+    QCOMPARE(frame.size(), DaemonCommand::frameHeaderSize + payload.size());
+}
+
+void TestDaemonCommand::encodeRequest()
+{
+    const QStringList arguments{ QStringLiteral("meter"), QStringLiteral("--mode"),
+                                 QStringLiteral("DC \"Voltage\"") };
+    const QByteArray request = DaemonCommand::encodeRequest(arguments);
+    QCOMPARE(request, QByteArray("[\"meter\",\"--mode\",\"DC \\\"Voltage\\\"\"]\n"));
+
+    QString error;
+    QCOMPARE(DaemonCommand::parseRequest(request, error), arguments);
+    QVERIFY(error.isEmpty());
+}
+
+void TestDaemonCommand::parseRequest_data()
+{
+    QTest::addColumn<QByteArray>("line");
+    QTest::addColumn<QStringList>("expected");
+    QTest::addColumn<bool>("expectError");
+
+    QTest::addRow("status") << QByteArray("[\"status\"]\n")
+        << QStringList{ QStringLiteral("status") } << false;
+    QTest::addRow("options") << QByteArray("[\"dso\",\"--samples\",\"10\"]")
+        << QStringList{ QStringLiteral("dso"), QStringLiteral("--samples"), QStringLiteral("10") }
+        << false;
+    QTest::addRow("empty") << QByteArray("[]\n") << QStringList() << true;
+    QTest::addRow("object") << QByteArray("{\"status\":1}\n") << QStringList() << true;
+    QTest::addRow("number") << QByteArray("[\"meter\",1]\n") << QStringList() << true;
+    QTest::addRow("invalid") << QByteArray("status\n") << QStringList() << true;
+}
+
+void TestDaemonCommand::parseRequest()
+{
+    QFETCH(QByteArray, line);
+    QFETCH(QStringList, expected);
+    QFETCH(bool, expectError);
+    QString error;
+    QCOMPARE(DaemonCommand::parseRequest(line, error), expected);
+    QCOMPARE(!error.isEmpty(), expectError);
+}
+
+void TestDaemonCommand::processOptions()
+{
+    DaemonCommand command(nullptr, nullptr);
+    QCOMPARE(command.serverName, DaemonCommand::defaultServerName());
+
+    QCommandLineParser parser;
+    parser.addOptions({
+        {{QStringLiteral("socket")}, QStringLiteral("description"), QStringLiteral("name")},
+    });
+    parser.process(QStringList{ QStringLiteral("pokit"), QStringLiteral("daemon"),
+                                QStringLiteral("--socket"), QStringLiteral("/tmp/pokit-test") });
+    QCOMPARE(command.processOptions(parser), QStringList());
+    QCOMPARE(command.serverName, QStringLiteral("/tmp/pokit-test"));
+}
+
+void TestDaemonCommand::clientDisconnected()
+{
+    DaemonCommand daemon(nullptr, nullptr);
+    daemon.serverName = QStringLiteral("qtpokit-test-%1").arg(QCoreApplication::applicationPid());
+    QVERIFY(daemon.listen());
+
+    // Queue a request (the daemon is not ready, so it waits in the queue).
+    QLocalSocket client;
+    client.connectToServer(daemon.server->fullServerName());
+    QVERIFY(client.waitForConnected(1000));
+    client.write(DaemonCommand::encodeRequest({ QStringLiteral("meter") }));
+    QTRY_COMPARE(daemon.requests.size(), 1);
+
+    // Run the request, as runNextRequest() would, then stream some of its output.
+    const DaemonCommand::Request request = daemon.requests.dequeue();
+    QVERIFY(request.socket);
+    MockDeviceCommand * const command = new MockDeviceCommand(&daemon);
+    int exitCode = -1;
+    command->setFinishedHandler([&daemon, &exitCode](DeviceCommand * const finished,
+                                                     const int code) {
+        exitCode = code;
+        daemon.requestFinished(finished, code);
+    });
+    daemon.current = command;
+    daemon.currentSocket = request.socket;
+    request.socket->write(DaemonCommand::encodeFrame(DaemonCommand::FrameType::Output, "1.0\n"));
+    request.socket->flush();
+    QTRY_VERIFY(client.bytesAvailable() > 0);
+
+    // The client going away mid-stream aborts the request, and frees the daemon for the next one.
+    client.disconnectFromServer();
+    QTRY_VERIFY(daemon.current == nullptr);
+    QVERIFY(daemon.currentSocket.isNull());
+    QCOMPARE(exitCode, EXIT_FAILURE);
+}
+
+QTEST_MAIN(TestDaemonCommand)
@@ -0,0 +1,22 @@
+// SPDX-FileCopyrightText: 2022 Paul Colby <git@colby.id.au>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include <QTest>
+
+class TestDaemonCommand : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void encodeFrame_data();
+    void encodeFrame();
+
+    void encodeRequest();
+
+    void parseRequest_data();
+    void parseRequest();
+
+    void processOptions();
+
+    void clientDisconnected();
+};
@@ -7,6 +7,7 @@
 #include "dataloggerservice_p.h"
 
 #include <QRegularExpression>
+#include <QSignalSpy>
 
 Q_DECLARE_METATYPE(DataLoggerService::Mode);
 Q_DECLARE_METATYPE(DataLoggerService::VoltageRange);
@@ -303,6 +304,21 @@ void TestDataLoggerService::disableReadingNotifications()
     QVERIFY(!service.disableReadingNotifications());
 }
 
+void TestDataLoggerService::coalescingSettings()
+{
+    DataLoggerService service(nullptr);
+    DataLoggerService::CoalescingSettings settings = service.coalescingSettings();
+    QCOMPARE(settings.enabled, false);
+    QCOMPARE(settings.chunkSize, 0);
+    QCOMPARE(settings.maxLatency, 0);
+
+    service.setCoalescingSettings({ true, 100, 20 });
+    settings = service.coalescingSettings();
+    QCOMPARE(settings.enabled, true);
+    QCOMPARE(settings.chunkSize, 100);
+    QCOMPARE(settings.maxLatency, 20);
+}
+
 void TestDataLoggerService::encodeSettings_data()
 {
     QTest::addColumn<DataLoggerService::Settings>("settings");
@@ -501,6 +517,146 @@ void TestDataLoggerService::parseSamples()
     QCOMPARE(DataLoggerServicePrivate::parseSamples(data), expected);
 }
 
+void TestDataLoggerService::parseSamples_buffer_data()
+{
+    QTest::addColumn<QByteArray>("data");
+    QTest::addColumn<int>("maxSamples");
+    QTest::addColumn<int>("expectedCount");
+    QTest::addColumn<DataLoggerService::Samples>("expected");
+
+    QTest::addRow("empty") << QByteArray() << 10 << 0 << DataLoggerService::Samples();
+
+    // Real, albeit boring, sample from a Pokit Pro device.
+    QTest::addRow("PokitPro")
+        << QByteArray("\xff\x7f\xff\x7f\xff\x7f\xff\x7f\xff\x7f", 10) << 5 << 5
+        << DataLoggerService::Samples({32767,32767,32767,32767,32767});
+
+    // Buffer too small, so only the leading samples are parsed.
+    QTest::addRow("truncated")
+        << QByteArray("\x00\x00\x00\xff\xff\x00\xff\xff", 8) << 3 << 3
+        << DataLoggerService::Samples({0,-256,255});
+
+    // Data must be even-length to be parsed.
+    QTest::addRow("odd") << QByteArray(3, '\xff') << 10 << -1 << DataLoggerService::Samples();
+}
+
+void TestDataLoggerService::parseSamples_buffer()
+{
+    QFETCH(QByteArray, data);
+    QFETCH(int, maxSamples);
+    QFETCH(int, expectedCount);
+    QFETCH(DataLoggerService::Samples, expected);
+    if ((data.size()%2) != 0) {
+        QTest::ignoreMessage(QtWarningMsg, QRegularExpression(QStringLiteral(
+            "^Samples value has odd size \\d+ \\(should be even\\): 0x[a-zA-Z0-9,]*$")));
+    } else if (maxSamples < data.size()/2) {
+        QTest::ignoreMessage(QtWarningMsg, QRegularExpression(QStringLiteral(
+            "^Samples buffer too small; discarding \\d+ of \\d+ samples.$")));
+    }
+    DataLoggerService::Samples samples(maxSamples);
+    QCOMPARE(DataLoggerServicePrivate::parseSamples(data, samples.data(), maxSamples), expectedCount);
+    samples.resize(qMax(expectedCount, 0));
+    QCOMPARE(samples, expected);
+}
+
+void TestDataLoggerService::parseScaledSamples_data()
+{
+    QTest::addColumn<QByteArray>("data");
+    QTest::addColumn<float>("scale");
+    QTest::addColumn<DataLoggerService::ScaledSamples>("expected");
+
+    QTest::addRow("empty") << QByteArray() << 1.0f << DataLoggerService::ScaledSamples();
+
+    QTest::addRow("unscaled")
+        << QByteArray("\x00\x00\x00\xff\xff\x00\xff\xff", 8) << 1.0f
+        << DataLoggerService::ScaledSamples({0.0f,-256.0f,255.0f,-1.0f});
+
+    QTest::addRow("scaled")
+        << QByteArray("\x00\x00\x00\xff\xff\x00\xff\xff", 8) << 0.5f
+        << DataLoggerService::ScaledSamples({0.0f,-128.0f,127.5f,-0.5f});
+
+    // Data must be even-length to be parsed.
+    QTest::addRow("odd") << QByteArray(3, '\xff') << 1.0f << DataLoggerService::ScaledSamples();
+}
+
+void TestDataLoggerService::parseScaledSamples()
+{
+    QFETCH(QByteArray, data);
+    QFETCH(float, scale);
+    QFETCH(DataLoggerService::ScaledSamples, expected);
+    if ((data.size()%2) != 0) {
+        QTest::ignoreMessage(QtWarningMsg, QRegularExpression(QStringLiteral(
+            "^Samples value has odd size \\d+ \\(should be even\\): 0x[a-zA-Z0-9,]*$")));
+    }
+    QCOMPARE(DataLoggerServicePrivate::parseScaledSamples(data, scale), expected);
+}
+
+void TestDataLoggerService::processMetadata()
+{
+    DataLoggerService service(nullptr);
+    QVERIFY(qIsNaN(service.d_func()->scale));
+    qRegisterMetaType<DataLoggerService::Metadata>("DataLoggerService::Metadata");
+    QSignalSpy spy(&service, &DataLoggerService::metadataRead);
+    service.d_func()->processMetadata(QByteArray(
+        "\x00\x9f\x0f\x49\x37\x00\x04\x3c\x00\x00\x00\xe9\xbb\x8c\x62", 15));
+    QCOMPARE(spy.count(), 1);
+    QCOMPARE(service.d_func()->scale, 1.198417067e-05f);
+}
+
+void TestDataLoggerService::processSamples()
+{
+    DataLoggerService service(nullptr);
+    const QByteArray value("\x00\x00\x00\xff\xff\x00\xff\xff", 8);
+    qRegisterMetaType<DataLoggerService::Samples>("DataLoggerService::Samples");
+    qRegisterMetaType<DataLoggerService::ScaledSamples>("DataLoggerService::ScaledSamples");
+
+    // Nothing connected, so nothing to parse (or emit).
+    service.d_func()->processSamples(value);
+
+    // Only the raw samples are connected.
+    QSignalSpy samplesSpy(&service, &DataLoggerService::samplesRead);
+    service.d_func()->processSamples(value);
+    QCOMPARE(samplesSpy.count(), 1);
+    QCOMPARE(samplesSpy.at(0).at(0).value<DataLoggerService::Samples>(), DataLoggerService::Samples({0,-256,255,-1}));
+
+    // Both raw and scaled samples are connected.
+    QSignalSpy scaledSpy(&service, &DataLoggerService::scaledSamplesRead);
+    service.d_func()->scale = 2.0f;
+    service.d_func()->processSamples(value);
+    QCOMPARE(samplesSpy.count(), 2);
+    QCOMPARE(scaledSpy.count(), 1);
+    QCOMPARE(scaledSpy.at(0).at(0).value<DataLoggerService::ScaledSamples>(),
+             DataLoggerService::ScaledSamples({0.0f,-512.0f,510.0f,-2.0f}));
+}
+
+void TestDataLoggerService::processSamples_coalesced()
+{
+    DataLoggerService service(nullptr);
+    service.setCoalescingSettings({ true, 0, 0 });
+    qRegisterMetaType<DataLoggerService::Samples>("DataLoggerService::Samples");
+    qRegisterMetaType<DataLoggerService::ScaledSamples>("DataLoggerService::ScaledSamples");
+    QSignalSpy samplesSpy(&service, &DataLoggerService::samplesRead);
+    QSignalSpy scaledSpy(&service, &DataLoggerService::scaledSamplesRead);
+
+    // Metadata for a 10 sample capture, so expect just one emission, once all 10 have arrived.
+    service.d_func()->processMetadata(QByteArray(
+        "\x00\x9f\x0f\x49\x37\x00\x04\x3c\x00\x0a\x00\xe9\xbb\x8c\x62", 15));
+    service.d_func()->scale = 2.0f;
+    const QByteArray value("\x00\x00\x00\xff\xff\x00\xff\xff", 8);
+    service.d_func()->processSamples(value);
+    service.d_func()->processSamples(value);
+    QCOMPARE(samplesSpy.count(), 0);
+    QCOMPARE(scaledSpy.count(), 0);
+    service.d_func()->processSamples(value.left(4));
+    QCOMPARE(samplesSpy.count(), 1);
+    QCOMPARE(scaledSpy.count(), 1);
+    QCOMPARE(samplesSpy.at(0).at(0).value<DataLoggerService::Samples>(),
+             DataLoggerService::Samples({0,-256,255,-1,0,-256,255,-1,0,-256}));
+    QCOMPARE(scaledSpy.at(0).at(0).value<DataLoggerService::ScaledSamples>(),
+             DataLoggerService::ScaledSamples({0.0f,-512.0f,510.0f,-2.0f,0.0f,-512.0f,510.0f,-2.0f,
+                                     0.0f,-512.0f}));
+}
+
 void TestDataLoggerService::characteristicRead()
 {
     // Unfortunately we cannot construct QLowEnergyCharacteristic objects to test signal emissions.
@@ -0,0 +1,90 @@
+// SPDX-FileCopyrightText: 2022 Paul Colby <git@colby.id.au>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "testdevicecache.h"
+
+#include "devicecache.h"
+
+#include <QTemporaryDir>
+
+void TestDeviceCache::key_data()
+{
+    QTest::addColumn<QString>("device");
+    QTest::addColumn<QString>("expected");
+
+    QTest::addRow("address") << QStringLiteral("01:23:45:67:89:AB")
+        << QStringLiteral("01:23:45:67:89:AB");
+    QTest::addRow("lowercase") << QStringLiteral("01:23:45:67:89:ab")
+        << QStringLiteral("01:23:45:67:89:AB");
+    QTest::addRow("uuid") << QStringLiteral("{12345678-1234-1234-1234-1234567890ab}")
+        << QStringLiteral("{12345678-1234-1234-1234-1234567890ab}");
+    QTest::addRow("name") << QStringLiteral("PokitMeter") << QString();
+    QTest::addRow("empty") << QString() << QString();
+}
+
+void TestDeviceCache::key()
+{
+    QFETCH(QString, device);
+    QFETCH(QString, expected);
+    QCOMPARE(DeviceCache::key(device), expected);
+}
+
+void TestDeviceCache::insert()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QBluetoothAddress address(QStringLiteral("01:23:45:67:89:AB"));
+    {
+        DeviceCache cache(dir.filePath(QStringLiteral("devices.ini")));
+        cache.insert(QBluetoothDeviceInfo(address, QStringLiteral("Meter"), 0));
+    }
+
+    // Entries persist across cache instances, and may be looked up by any form of address.
+    const DeviceCache cache(dir.filePath(QStringLiteral("devices.ini")));
+    const QBluetoothDeviceInfo info = cache.lookup(QStringLiteral("01:23:45:67:89:ab"));
+    QVERIFY(info.isValid());
+    QCOMPARE(info.address(), address);
+    QCOMPARE(info.name(), QStringLiteral("Meter"));
+    QCOMPARE(info.coreConfigurations(), QBluetoothDeviceInfo::LowEnergyCoreConfiguration);
+}
+
+void TestDeviceCache::lookup_expired()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    DeviceCache cache(dir.filePath(QStringLiteral("devices.ini")));
+    const QBluetoothUuid uuid(QStringLiteral("{12345678-1234-1234-1234-1234567890ab}"));
+    const QDateTime now = QDateTime::currentDateTimeUtc();
+    cache.insert(QBluetoothDeviceInfo(uuid, QStringLiteral("Meter"), 0), now);
+
+    QVERIFY(cache.lookup(uuid.toString(), now.addSecs(cache.maxAge())).isValid());
+    QVERIFY(!cache.lookup(uuid.toString(), now.addSecs(cache.maxAge() + 1)).isValid());
+    cache.setMaxAge(cache.maxAge() * 2);
+    QCOMPARE(cache.lookup(uuid.toString(), now.addSecs(cache.maxAge())).deviceUuid(), uuid);
+}
+
+void TestDeviceCache::lookup_name()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    DeviceCache cache(dir.filePath(QStringLiteral("devices.ini")));
+    const QBluetoothAddress address(QStringLiteral("01:23:45:67:89:AB"));
+    cache.insert(QBluetoothDeviceInfo(address, QStringLiteral("Meter"), 0));
+
+    // Names need not be unique, so are never used for lookups.
+    QVERIFY(!cache.lookup(QStringLiteral("Meter")).isValid());
+}
+
+void TestDeviceCache::remove()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    DeviceCache cache(dir.filePath(QStringLiteral("devices.ini")));
+    const QBluetoothAddress address(QStringLiteral("01:23:45:67:89:AB"));
+    cache.insert(QBluetoothDeviceInfo(address, QStringLiteral("Meter"), 0));
+    QVERIFY(cache.lookup(address.toString()).isValid());
+    cache.remove(QStringLiteral("01:23:45:67:89:ab"));
+    QVERIFY(!cache.lookup(address.toString()).isValid());
+}
+
+QTEST_MAIN(TestDeviceCache)
@@ -0,0 +1,18 @@
+// SPDX-FileCopyrightText: 2022 Paul Colby <git@colby.id.au>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include <QTest>
+
+class TestDeviceCache : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void key_data();
+    void key();
+
+    void insert();
+    void lookup_expired();
+    void lookup_name();
+    void remove();
+};
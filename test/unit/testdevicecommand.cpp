@@ -5,6 +5,20 @@
 
 #include "devicecommand.h"
 
+#include <qtpokit/dsoservice.h>
+
+#include <QRegularExpression>
+
+// Minimal device command, for exercising DeviceCommand's own behaviour.
+class MockDeviceCommand : public DeviceCommand
+{
+public:
+    explicit MockDeviceCommand(QObject * const parent) : DeviceCommand(parent) { }
+
+protected:
+    AbstractPokitService * getService() override { return nullptr; }
+};
+
 void TestDeviceCommand::test1_data()
 {
     QTest::addColumn<int>("input");
@@ -21,4 +35,47 @@ void TestDeviceCommand::test1()
     QCOMPARE(actual, expected);
 }
 
+void TestDeviceCommand::formatStatistics()
+{
+    QVERIFY(DeviceCommand::formatStatistics(AbstractPokitService::Statistics()).isEmpty());
+
+    AbstractPokitService::Statistics statistics;
+    AbstractPokitService::CharacteristicStatistics &reading =
+        statistics[DsoService::CharacteristicUuids::reading];
+    reading.notifications = 3;
+    reading.bytesNotified = 600;
+    reading.notificationInterval.record(10);
+    reading.notificationInterval.record(20);
+    AbstractPokitService::CharacteristicStatistics &settings =
+        statistics[DsoService::CharacteristicUuids::settings];
+    settings.writes = 1;
+    settings.bytesWritten = 13;
+
+    const QStringList lines = DeviceCommand::formatStatistics(statistics).split(QLatin1Char('\n'));
+    QCOMPARE(lines.size(), 3); // Operations with zero counts are omitted.
+    QVERIFY(lines.at(0).contains(QLatin1String("notifications: 3 (600 bytes)")));
+    QVERIFY(lines.at(0).contains(QLatin1String("interval min 10, mean 15")));
+    QVERIFY(lines.at(0).endsWith(QLatin1String("max 20 us")));
+    QVERIFY(lines.at(1).endsWith(QLatin1String("writes: 1 (13 bytes)"))); // No latency recorded.
+    QVERIFY(lines.at(2).isEmpty());
+}
+
+void TestDeviceCommand::serviceError()
+{
+    MockDeviceCommand command(nullptr);
+    int exitCode = -1;
+    command.setFinishedHandler([&exitCode](DeviceCommand * const, const int code) {
+        exitCode = code;
+    });
+
+    // A service error abandons any refresh in progress, and fails the command.
+    command.pendingRefreshReads = { DsoService::CharacteristicUuids::metadata };
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression(QStringLiteral(
+        "^Bluetooth service error: .*CharacteristicReadError$")));
+    QTest::ignoreMessage(QtWarningMsg, "Failed to refresh 1 characteristic(s).");
+    command.serviceError(QLowEnergyService::ServiceError::CharacteristicReadError);
+    QVERIFY(command.pendingRefreshReads.isEmpty());
+    QCOMPARE(exitCode, EXIT_FAILURE);
+}
+
 QTEST_MAIN(TestDeviceCommand)
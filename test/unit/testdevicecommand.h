@@ -10,4 +10,8 @@ class TestDeviceCommand : public QObject
 private slots:
     void test1_data();
     void test1();
+
+    void formatStatistics();
+
+    void serviceError();
 };
@@ -0,0 +1,111 @@
+// SPDX-FileCopyrightText: 2022 Paul Colby <git@colby.id.au>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "testdevicematcher.h"
+
+#include "devicematcher.h"
+
+void TestDeviceMatcher::construct()
+{
+    const DeviceMatcher empty;
+    QVERIFY(empty.isEmpty());
+    QCOMPARE(empty.size(), 0);
+    QVERIFY(!empty.hasPatterns());
+
+    // Empty targets are ignored.
+    const DeviceMatcher matcher(QStringList{ QStringLiteral("Meter"), QString(),
+        QStringLiteral("Pokit*"), QStringLiteral("/^Pro$/") });
+    QVERIFY(!matcher.isEmpty());
+    QCOMPARE(matcher.size(), 3);
+    QCOMPARE(matcher.targets(), (QStringList{ QStringLiteral("Meter"), QStringLiteral("Pokit*"),
+        QStringLiteral("/^Pro$/") }));
+    QVERIFY(!matcher.isPattern(0));
+    QVERIFY(matcher.isPattern(1));
+    QVERIFY(matcher.isPattern(2));
+    QVERIFY(matcher.hasPatterns());
+    QVERIFY(matcher.errorString().isNull());
+}
+
+void TestDeviceMatcher::errorString()
+{
+    const DeviceMatcher matcher(QStringList{ QStringLiteral("/(/"), QStringLiteral("/[/") });
+    QVERIFY(!matcher.errorString().isEmpty());
+    QVERIFY(matcher.errorString().contains(QStringLiteral("/(/")));
+}
+
+void TestDeviceMatcher::globToRegularExpression_data()
+{
+    QTest::addColumn<QString>("glob");
+    QTest::addColumn<QString>("expected");
+
+    QTest::addRow("literal") << QStringLiteral("Meter") << QStringLiteral("\\A(?:Meter)\\z");
+    QTest::addRow("escaped") << QStringLiteral("a.b") << QStringLiteral("\\A(?:a\\.b)\\z");
+    QTest::addRow("star") << QStringLiteral("Pokit*") << QStringLiteral("\\A(?:Pokit.*)\\z");
+    QTest::addRow("question") << QStringLiteral("P?o") << QStringLiteral("\\A(?:P.o)\\z");
+    QTest::addRow("set") << QStringLiteral("[AB]1") << QStringLiteral("\\A(?:[AB]1)\\z");
+    QTest::addRow("negated") << QStringLiteral("[!AB]") << QStringLiteral("\\A(?:[^AB])\\z");
+    QTest::addRow("unclosed") << QStringLiteral("[AB") << QStringLiteral("\\A(?:\\[AB)\\z");
+}
+
+void TestDeviceMatcher::globToRegularExpression()
+{
+    QFETCH(QString, glob);
+    QFETCH(QString, expected);
+    QCOMPARE(DeviceMatcher::globToRegularExpression(glob), expected);
+}
+
+void TestDeviceMatcher::isMatch_data()
+{
+    QTest::addColumn<QStringList>("targets");
+    QTest::addColumn<QBluetoothDeviceInfo>("info");
+    QTest::addColumn<bool>("expected");
+
+    const QBluetoothAddress address(QStringLiteral("01:23:45:67:89:AB"));
+    const QBluetoothUuid uuid(QStringLiteral("{12345678-1234-1234-1234-1234567890ab}"));
+    const QBluetoothDeviceInfo byAddress(address, QStringLiteral("PokitMeter"), 0);
+    const QBluetoothDeviceInfo byUuid(uuid, QStringLiteral("PokitPro"), 0);
+
+    QTest::addRow("empty") << QStringList{ } << byAddress << true;
+    QTest::addRow("name") << QStringList{ QStringLiteral("PokitMeter") } << byAddress << true;
+    QTest::addRow("name:other") << QStringList{ QStringLiteral("PokitPro") } << byAddress << false;
+    QTest::addRow("name:case") << QStringList{ QStringLiteral("pokitmeter") } << byAddress << false;
+    QTest::addRow("address") << QStringList{ QStringLiteral("01:23:45:67:89:ab") } << byAddress
+        << true;
+    QTest::addRow("address:other") << QStringList{ QStringLiteral("01:23:45:67:89:AC") }
+        << byAddress << false;
+    QTest::addRow("uuid") << QStringList{ uuid.toString() } << byUuid << true;
+    QTest::addRow("uuid:other")
+        << QStringList{ QStringLiteral("{12345678-1234-1234-1234-1234567890ac}") } << byUuid
+        << false;
+    QTest::addRow("glob") << QStringList{ QStringLiteral("Pokit*") } << byAddress << true;
+    QTest::addRow("glob:partial") << QStringList{ QStringLiteral("Pokit") } << byAddress << false;
+    QTest::addRow("glob:other") << QStringList{ QStringLiteral("*Pro") } << byAddress << false;
+    QTest::addRow("regex") << QStringList{ QStringLiteral("/Meter$/") } << byAddress << true;
+    QTest::addRow("regex:other") << QStringList{ QStringLiteral("/^Meter/") } << byAddress << false;
+    QTest::addRow("any") << QStringList{ QStringLiteral("PokitPro"), QStringLiteral("*Meter") }
+        << byAddress << true;
+    QTest::addRow("none") << QStringList{ QStringLiteral("PokitPro"), QStringLiteral("Meter") }
+        << byAddress << false;
+}
+
+void TestDeviceMatcher::isMatch()
+{
+    QFETCH(QStringList, targets);
+    QFETCH(QBluetoothDeviceInfo, info);
+    QFETCH(bool, expected);
+    QCOMPARE(DeviceMatcher(targets).isMatch(info), expected);
+}
+
+void TestDeviceMatcher::indexOf()
+{
+    const QBluetoothDeviceInfo info(QBluetoothAddress(QStringLiteral("01:23:45:67:89:AB")),
+                                    QStringLiteral("PokitMeter"), 0);
+    const DeviceMatcher matcher(QStringList{ QStringLiteral("01:23:45:67:89:AB"),
+        QStringLiteral("PokitPro"), QStringLiteral("Pokit*") });
+    QCOMPARE(matcher.indexOf(info), 0);
+    QCOMPARE(matcher.indexOf(info, 1), 2);
+    QCOMPARE(matcher.indexOf(info, 3), -1);
+    QCOMPARE(DeviceMatcher().indexOf(info), -1);
+}
+
+QTEST_MAIN(TestDeviceMatcher)
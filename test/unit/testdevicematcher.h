@@ -0,0 +1,21 @@
+// SPDX-FileCopyrightText: 2022 Paul Colby <git@colby.id.au>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include <QTest>
+
+class TestDeviceMatcher : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void construct();
+    void errorString();
+
+    void globToRegularExpression_data();
+    void globToRegularExpression();
+
+    void isMatch_data();
+    void isMatch();
+
+    void indexOf();
+};
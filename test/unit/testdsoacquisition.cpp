@@ -0,0 +1,254 @@
+// SPDX-FileCopyrightText: 2022 Paul Colby <git@colby.id.au>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "testdsoacquisition.h"
+
+#include <qtpokit/dsoacquisition.h>
+#include "dsoacquisition_p.h"
+
+#include <QRegularExpression>
+#include <QSignalSpy>
+
+Q_DECLARE_METATYPE(DsoService::Metadata);
+
+void TestDsoAcquisition::capacity_data()
+{
+    QTest::addColumn<int>("capacity");
+    QTest::addColumn<int>("expected");
+    QTest::addRow("negative") << -1 << 2;
+    QTest::addRow("zero")     <<  0 << 2;
+    QTest::addRow("1")        <<  1 << 2;
+    QTest::addRow("2")        <<  2 << 2;
+    QTest::addRow("3")        <<  3 << 4;
+    QTest::addRow("1000")     << 1000 << 1024;
+    QTest::addRow("65536")    << 65536 << 65536;
+}
+
+void TestDsoAcquisition::capacity()
+{
+    QFETCH(int, capacity);
+    QFETCH(int, expected);
+    QCOMPARE(DsoAcquisitionPrivate::roundUpCapacity(capacity), expected);
+    const DsoAcquisition acquisition(nullptr, capacity);
+    QCOMPARE(acquisition.capacity(), expected);
+    QCOMPARE(acquisition.available(), 0);
+}
+
+void TestDsoAcquisition::readWrite()
+{
+    DsoAcquisition acquisition(nullptr, 8);
+    const float values[] = { 1.0f, 2.0f, 3.0f, 4.0f, 5.0f };
+    QCOMPARE(acquisition.d_func()->write(values, 5), 5);
+    QCOMPARE(acquisition.available(), 5);
+
+    float result[8];
+    QCOMPARE(acquisition.read(result, 3), 3);
+    QCOMPARE(result[0], 1.0f);
+    QCOMPARE(result[2], 3.0f);
+    QCOMPARE(acquisition.available(), 2);
+
+    QCOMPARE(acquisition.read(result, 8), 2);
+    QCOMPARE(result[0], 4.0f);
+    QCOMPARE(result[1], 5.0f);
+    QCOMPARE(acquisition.available(), 0);
+    QCOMPARE(acquisition.read(result, 8), 0);
+}
+
+void TestDsoAcquisition::wrapAround()
+{
+    DsoAcquisition acquisition(nullptr, 4);
+    const float values[] = { 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f };
+    float result[4];
+
+    QCOMPARE(acquisition.d_func()->write(values, 3), 3);
+    QCOMPARE(acquisition.read(result, 2), 2);
+
+    // Writes wrap around the end of the buffer, and never overwrite unread values.
+    QCOMPARE(acquisition.d_func()->write(values + 3, 3), 3);
+    QCOMPARE(acquisition.d_func()->write(values, 1), 0);
+    QCOMPARE(acquisition.available(), 4);
+
+    QCOMPARE(acquisition.read(result, 4), 4);
+    QCOMPARE(result[0], 3.0f);
+    QCOMPARE(result[1], 4.0f);
+    QCOMPARE(result[2], 5.0f);
+    QCOMPARE(result[3], 6.0f);
+}
+
+void TestDsoAcquisition::start()
+{
+    // Without a DSO service, there is nothing to arm.
+    DsoAcquisition acquisition(nullptr);
+    QSignalSpy spy(&acquisition, &DsoAcquisition::started);
+    QTest::ignoreMessage(QtWarningMsg, "Cannot arm the DSO without a DSO service.");
+    QVERIFY(!acquisition.start({ DsoService::Command::FreeRunning, 0.0f,
+        DsoService::Mode::DcVoltage, { DsoService::VoltageRange::_0_to_300mV }, 1000, 10 }));
+    QVERIFY(!acquisition.isRunning());
+    QCOMPARE(spy.count(), 0);
+}
+
+void TestDsoAcquisition::stop()
+{
+    DsoAcquisition acquisition(nullptr);
+    QSignalSpy spy(&acquisition, &DsoAcquisition::stopped);
+
+    // Not running, so nothing to stop.
+    acquisition.stop();
+    QCOMPARE(spy.count(), 0);
+
+    // Running, but idle, so stops immediately.
+    acquisition.d_func()->running = true;
+    acquisition.stop();
+    QVERIFY(!acquisition.isRunning());
+    QCOMPARE(spy.count(), 1);
+
+    // Running, and mid-capture, so stops once the capture has finished.
+    acquisition.d_func()->running = true;
+    acquisition.d_func()->sampling = true;
+    acquisition.stop();
+    QCOMPARE(spy.count(), 1);
+    acquisition.d_func()->metadataRead({ DsoService::DsoStatus::Done, 1.0f,
+        DsoService::Mode::DcVoltage, { DsoService::VoltageRange::_0_to_300mV }, 1000, 0, 1000 });
+    QCOMPARE(spy.count(), 2);
+}
+
+void TestDsoAcquisition::metadataRead()
+{
+    DsoAcquisition acquisition(nullptr);
+    qRegisterMetaType<DsoService::Metadata>("DsoService::Metadata");
+    QSignalSpy finishedSpy(&acquisition, &DsoAcquisition::captureFinished);
+    QSignalSpy stoppedSpy(&acquisition, &DsoAcquisition::stopped);
+    DsoService::Metadata metadata{ DsoService::DsoStatus::Sampling, 1.0f,
+        DsoService::Mode::DcVoltage, { DsoService::VoltageRange::_0_to_300mV }, 1000, 10, 1000 };
+
+    // Ignored when not sampling.
+    acquisition.d_func()->metadataRead(metadata);
+    QCOMPARE(acquisition.d_func()->samplesToGo, 0);
+
+    // Sampling status leaves the capture in progress.
+    acquisition.d_func()->sampling = true;
+    acquisition.d_func()->metadataRead(metadata);
+    QVERIFY(acquisition.d_func()->sampling);
+
+    // Done status marks the end of sampling, with samples to follow.
+    metadata.status = DsoService::DsoStatus::Done;
+    acquisition.d_func()->metadataRead(metadata);
+    QVERIFY(!acquisition.d_func()->sampling);
+    QCOMPARE(acquisition.d_func()->samplesToGo, 10);
+    QVERIFY(acquisition.d_func()->deadTimer.isValid());
+    QCOMPARE(finishedSpy.count(), 0);
+
+    // Error status stops the acquisition.
+    acquisition.d_func()->sampling = true;
+    acquisition.d_func()->running = true;
+    metadata.status = DsoService::DsoStatus::Error;
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression(QStringLiteral(
+        "^DSO reported error status 255; stopping acquisition.$")));
+    acquisition.d_func()->metadataRead(metadata);
+    QVERIFY(!acquisition.isRunning());
+    QCOMPARE(stoppedSpy.count(), 1);
+}
+
+void TestDsoAcquisition::samplesRead()
+{
+    DsoAcquisition acquisition(nullptr, 16);
+    qRegisterMetaType<DsoService::Metadata>("DsoService::Metadata");
+    QSignalSpy availableSpy(&acquisition, &DsoAcquisition::samplesAvailable);
+    QSignalSpy finishedSpy(&acquisition, &DsoAcquisition::captureFinished);
+
+    // Unexpected samples are ignored.
+    acquisition.d_func()->samplesRead({ 1.0f, 2.0f });
+    QCOMPARE(acquisition.available(), 0);
+    QCOMPARE(availableSpy.count(), 0);
+
+    acquisition.d_func()->samplesToGo = 4;
+    acquisition.d_func()->samplesRead({ 1.0f, 2.0f });
+    QCOMPARE(acquisition.available(), 2);
+    QCOMPARE(availableSpy.count(), 1);
+    QCOMPARE(availableSpy.at(0).at(0).toInt(), 2);
+    QCOMPARE(finishedSpy.count(), 0);
+
+    acquisition.d_func()->samplesRead({ 3.0f, 4.0f });
+    QCOMPARE(acquisition.available(), 4);
+    QCOMPARE(finishedSpy.count(), 1);
+
+    const DsoAcquisition::Metrics metrics = acquisition.metrics();
+    QCOMPARE(metrics.captures, (quint64)1);
+    QCOMPARE(metrics.samples, (quint64)4);
+    QCOMPARE(metrics.droppedSamples, (quint64)0);
+    QCOMPARE(metrics.droppedNotifications, (quint64)0);
+}
+
+void TestDsoAcquisition::droppedSamples()
+{
+    DsoAcquisition acquisition(nullptr, 4);
+    acquisition.d_func()->samplesToGo = 10;
+    acquisition.d_func()->samplesRead({ 1.0f, 2.0f, 3.0f });
+    acquisition.d_func()->samplesRead({ 4.0f, 5.0f, 6.0f });
+    acquisition.d_func()->samplesRead({ 7.0f, 8.0f, 9.0f });
+
+    const DsoAcquisition::Metrics metrics = acquisition.metrics();
+    QCOMPARE(metrics.samples, (quint64)4);
+    QCOMPARE(metrics.droppedSamples, (quint64)5);
+    QCOMPARE(metrics.droppedNotifications, (quint64)2);
+    QCOMPARE(acquisition.d_func()->samplesToGo, 1);
+}
+
+void TestDsoAcquisition::lostNotification()
+{
+    DsoAcquisition acquisition(nullptr, 16);
+    qRegisterMetaType<DsoService::Metadata>("DsoService::Metadata");
+    QSignalSpy finishedSpy(&acquisition, &DsoAcquisition::captureFinished);
+    QSignalSpy stoppedSpy(&acquisition, &DsoAcquisition::stopped);
+    acquisition.setShortfallTimeout(10);
+    QCOMPARE(acquisition.shortfallTimeout(), 10);
+
+    // Expect 6 samples, but lose the last of three notifications.
+    acquisition.d_func()->running = true;
+    acquisition.d_func()->sampling = true;
+    acquisition.d_func()->metadataRead({ DsoService::DsoStatus::Done, 1.0f,
+        DsoService::Mode::DcVoltage, { DsoService::VoltageRange::_0_to_300mV }, 1000, 6, 1000 });
+    QVERIFY(acquisition.d_func()->shortfallTimer.isActive());
+    acquisition.d_func()->samplesRead({ 1.0f, 2.0f });
+    acquisition.d_func()->samplesRead({ 3.0f, 4.0f });
+    QCOMPARE(acquisition.d_func()->samplesToGo, 2);
+    QVERIFY(acquisition.d_func()->shortfallTimer.isActive());
+    QCOMPARE(finishedSpy.count(), 0);
+
+    // The capture is abandoned, and the DSO re-armed (which fails here, without a service).
+    QTest::ignoreMessage(QtWarningMsg, "Timed out waiting for 2 sample(s); abandoning capture.");
+    QTest::ignoreMessage(QtWarningMsg, "Cannot arm the DSO without a DSO service.");
+    QTRY_COMPARE(finishedSpy.count(), 1);
+    QCOMPARE(stoppedSpy.count(), 1);
+    QCOMPARE(acquisition.d_func()->samplesToGo, 0);
+    QVERIFY(!acquisition.d_func()->shortfallTimer.isActive());
+    QCOMPARE(acquisition.available(), 4);
+
+    const DsoAcquisition::Metrics metrics = acquisition.metrics();
+    QCOMPARE(metrics.captures, (quint64)1);
+    QCOMPARE(metrics.samples, (quint64)4);
+    QCOMPARE(metrics.droppedSamples, (quint64)0);
+    QCOMPARE(metrics.lostSamples, (quint64)2);
+    QCOMPARE(metrics.lostCaptures, (quint64)1);
+}
+
+void TestDsoAcquisition::resetMetrics()
+{
+    DsoAcquisition acquisition(nullptr, 2);
+    acquisition.d_func()->samplesToGo = 3;
+    acquisition.d_func()->samplesRead({ 1.0f, 2.0f, 3.0f });
+    QCOMPARE(acquisition.metrics().droppedSamples, (quint64)1);
+    acquisition.resetMetrics();
+    const DsoAcquisition::Metrics metrics = acquisition.metrics();
+    QCOMPARE(metrics.captures, (quint64)0);
+    QCOMPARE(metrics.samples, (quint64)0);
+    QCOMPARE(metrics.droppedSamples, (quint64)0);
+    QCOMPARE(metrics.droppedNotifications, (quint64)0);
+    QCOMPARE(metrics.lostSamples, (quint64)0);
+    QCOMPARE(metrics.lostCaptures, (quint64)0);
+    QCOMPARE(metrics.lastDeadTime, (qint64)0);
+    QCOMPARE(metrics.maxDeadTime, (qint64)0);
+    QCOMPARE(metrics.totalDeadTime, (qint64)0);
+}
+
+QTEST_MAIN(TestDsoAcquisition)
@@ -0,0 +1,26 @@
+// SPDX-FileCopyrightText: 2022 Paul Colby <git@colby.id.au>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include <QTest>
+
+class TestDsoAcquisition : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void capacity_data();
+    void capacity();
+
+    void readWrite();
+    void wrapAround();
+
+    void start();
+    void stop();
+
+    void metadataRead();
+    void samplesRead();
+    void droppedSamples();
+    void lostNotification();
+
+    void resetMetrics();
+};
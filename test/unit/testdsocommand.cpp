@@ -21,4 +21,25 @@ void TestDsoCommand::test1()
     QCOMPARE(actual, expected);
 }
 
+void TestDsoCommand::metadataRead()
+{
+    DsoCommand command(nullptr);
+    command.format = AbstractCommand::OutputFormat::Binary;
+    DsoService::Metadata metadata{
+        DsoService::DsoStatus::Sampling, 0.001f, DsoService::Mode::DcVoltage,
+        { DsoService::VoltageRange::_6V_to_12V }, 1000000, 1000, 1000
+    };
+
+    // Metadata notified while still sampling neither arms the command, nor writes a header.
+    command.metadataRead(metadata);
+    QCOMPARE(command.samplesToGo, 0);
+    QCOMPARE(command.outputBuffer.size(), 0);
+
+    // Only once the acquisition is done is the command armed, with one binary header written.
+    metadata.status = DsoService::DsoStatus::Done;
+    command.metadataRead(metadata);
+    QCOMPARE(command.samplesToGo, 1000);
+    QCOMPARE(command.outputBuffer.size(), 32);
+}
+
 QTEST_MAIN(TestDsoCommand)
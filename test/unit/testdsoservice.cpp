@@ -7,6 +7,7 @@
 #include "dsoservice_p.h"
 
 #include <QRegularExpression>
+#include <QSignalSpy>
 
 Q_DECLARE_METATYPE(DsoService::Mode);
 Q_DECLARE_METATYPE(DsoService::VoltageRange);
@@ -296,6 +297,21 @@ void TestDsoService::disableReadingNotifications()
     QVERIFY(!service.disableReadingNotifications());
 }
 
+void TestDsoService::coalescingSettings()
+{
+    DsoService service(nullptr);
+    DsoService::CoalescingSettings settings = service.coalescingSettings();
+    QCOMPARE(settings.enabled, false);
+    QCOMPARE(settings.chunkSize, 0);
+    QCOMPARE(settings.maxLatency, 0);
+
+    service.setCoalescingSettings({ true, 100, 20 });
+    settings = service.coalescingSettings();
+    QCOMPARE(settings.enabled, true);
+    QCOMPARE(settings.chunkSize, 100);
+    QCOMPARE(settings.maxLatency, 20);
+}
+
 void TestDsoService::encodeSettings_data()
 {
     QTest::addColumn<DsoService::Settings>("settings");
@@ -443,6 +459,147 @@ void TestDsoService::parseSamples()
     QCOMPARE(DsoServicePrivate::parseSamples(data), expected);
 }
 
+void TestDsoService::parseSamples_buffer_data()
+{
+    QTest::addColumn<QByteArray>("data");
+    QTest::addColumn<int>("maxSamples");
+    QTest::addColumn<int>("expectedCount");
+    QTest::addColumn<DsoService::Samples>("expected");
+
+    QTest::addRow("empty") << QByteArray() << 10 << 0 << DsoService::Samples();
+
+    // Sample from a real Pokit Pro device.
+    QTest::addRow("PokitPro")
+        << QByteArray("\xda\x36\x91\x24\x24\x09\x02\x80\x91\x64"
+                      "\x48\x12\x23\x49\x01\xc0\x4a\x92\xdc\xf6", 20) << 10 << 10
+        << DsoService::Samples({14042,9361,2340,-32766,25745,4680,18723,-16383,-28086,-2340});
+
+    // Buffer too small, so only the leading samples are parsed.
+    QTest::addRow("truncated")
+        << QByteArray("\x00\x00\x00\xff\xff\x00\xff\xff", 8) << 2 << 2
+        << DsoService::Samples({0,-256});
+
+    // Data must be even-length to be parsed.
+    QTest::addRow("odd") << QByteArray(3, '\xff') << 10 << -1 << DsoService::Samples();
+}
+
+void TestDsoService::parseSamples_buffer()
+{
+    QFETCH(QByteArray, data);
+    QFETCH(int, maxSamples);
+    QFETCH(int, expectedCount);
+    QFETCH(DsoService::Samples, expected);
+    if ((data.size()%2) != 0) {
+        QTest::ignoreMessage(QtWarningMsg, QRegularExpression(QStringLiteral(
+            "^Samples value has odd size \\d+ \\(should be even\\): 0x[a-zA-Z0-9,]*$")));
+    } else if (maxSamples < data.size()/2) {
+        QTest::ignoreMessage(QtWarningMsg, QRegularExpression(QStringLiteral(
+            "^Samples buffer too small; discarding \\d+ of \\d+ samples.$")));
+    }
+    DsoService::Samples samples(maxSamples);
+    QCOMPARE(DsoServicePrivate::parseSamples(data, samples.data(), maxSamples), expectedCount);
+    samples.resize(qMax(expectedCount, 0));
+    QCOMPARE(samples, expected);
+}
+
+void TestDsoService::parseScaledSamples_data()
+{
+    QTest::addColumn<QByteArray>("data");
+    QTest::addColumn<float>("scale");
+    QTest::addColumn<DsoService::ScaledSamples>("expected");
+
+    QTest::addRow("empty") << QByteArray() << 1.0f << DsoService::ScaledSamples();
+
+    QTest::addRow("unscaled")
+        << QByteArray("\x00\x00\x00\xff\xff\x00\xff\xff", 8) << 1.0f
+        << DsoService::ScaledSamples({0.0f,-256.0f,255.0f,-1.0f});
+
+    QTest::addRow("scaled")
+        << QByteArray("\x00\x00\x00\xff\xff\x00\xff\xff", 8) << 0.5f
+        << DsoService::ScaledSamples({0.0f,-128.0f,127.5f,-0.5f});
+
+    // Data must be even-length to be parsed.
+    QTest::addRow("odd") << QByteArray(3, '\xff') << 1.0f << DsoService::ScaledSamples();
+}
+
+void TestDsoService::parseScaledSamples()
+{
+    QFETCH(QByteArray, data);
+    QFETCH(float, scale);
+    QFETCH(DsoService::ScaledSamples, expected);
+    if ((data.size()%2) != 0) {
+        QTest::ignoreMessage(QtWarningMsg, QRegularExpression(QStringLiteral(
+            "^Samples value has odd size \\d+ \\(should be even\\): 0x[a-zA-Z0-9,]*$")));
+    }
+    QCOMPARE(DsoServicePrivate::parseScaledSamples(data, scale), expected);
+}
+
+void TestDsoService::processMetadata()
+{
+    DsoService service(nullptr);
+    QVERIFY(qIsNaN(service.d_func()->scale));
+    qRegisterMetaType<DsoService::Metadata>("DsoService::Metadata");
+    QSignalSpy spy(&service, &DsoService::metadataRead);
+    service.d_func()->processMetadata(QByteArray(
+        "\x00\x98\xf7\x8b\x33\x02\x00\x40\x42\x0f\x00\x0a\x00\x0a\x00\x00\x00", 17));
+    QCOMPARE(spy.count(), 1);
+    QCOMPARE(service.d_func()->scale, 6.517728934e-08f);
+}
+
+void TestDsoService::processSamples()
+{
+    DsoService service(nullptr);
+    const QByteArray value("\x00\x00\x00\xff\xff\x00\xff\xff", 8);
+    qRegisterMetaType<DsoService::Samples>("DsoService::Samples");
+    qRegisterMetaType<DsoService::ScaledSamples>("DsoService::ScaledSamples");
+
+    // Nothing connected, so nothing to parse (or emit).
+    service.d_func()->processSamples(value);
+
+    // Only the raw samples are connected.
+    QSignalSpy samplesSpy(&service, &DsoService::samplesRead);
+    service.d_func()->processSamples(value);
+    QCOMPARE(samplesSpy.count(), 1);
+    QCOMPARE(samplesSpy.at(0).at(0).value<DsoService::Samples>(), DsoService::Samples({0,-256,255,-1}));
+
+    // Both raw and scaled samples are connected.
+    QSignalSpy scaledSpy(&service, &DsoService::scaledSamplesRead);
+    service.d_func()->scale = 2.0f;
+    service.d_func()->processSamples(value);
+    QCOMPARE(samplesSpy.count(), 2);
+    QCOMPARE(scaledSpy.count(), 1);
+    QCOMPARE(scaledSpy.at(0).at(0).value<DsoService::ScaledSamples>(),
+             DsoService::ScaledSamples({0.0f,-512.0f,510.0f,-2.0f}));
+}
+
+void TestDsoService::processSamples_coalesced()
+{
+    DsoService service(nullptr);
+    service.setCoalescingSettings({ true, 0, 0 });
+    qRegisterMetaType<DsoService::Samples>("DsoService::Samples");
+    qRegisterMetaType<DsoService::ScaledSamples>("DsoService::ScaledSamples");
+    QSignalSpy samplesSpy(&service, &DsoService::samplesRead);
+    QSignalSpy scaledSpy(&service, &DsoService::scaledSamplesRead);
+
+    // Metadata for a 10 sample capture, so expect just one emission, once all 10 have arrived.
+    service.d_func()->processMetadata(QByteArray(
+        "\x00\x98\xf7\x8b\x33\x02\x00\x40\x42\x0f\x00\x0a\x00\x0a\x00\x00\x00", 17));
+    service.d_func()->scale = 2.0f;
+    const QByteArray value("\x00\x00\x00\xff\xff\x00\xff\xff", 8);
+    service.d_func()->processSamples(value);
+    service.d_func()->processSamples(value);
+    QCOMPARE(samplesSpy.count(), 0);
+    QCOMPARE(scaledSpy.count(), 0);
+    service.d_func()->processSamples(value.left(4));
+    QCOMPARE(samplesSpy.count(), 1);
+    QCOMPARE(scaledSpy.count(), 1);
+    QCOMPARE(samplesSpy.at(0).at(0).value<DsoService::Samples>(),
+             DsoService::Samples({0,-256,255,-1,0,-256,255,-1,0,-256}));
+    QCOMPARE(scaledSpy.at(0).at(0).value<DsoService::ScaledSamples>(),
+             DsoService::ScaledSamples({0.0f,-512.0f,510.0f,-2.0f,0.0f,-512.0f,510.0f,-2.0f,
+                                     0.0f,-512.0f}));
+}
+
 void TestDsoService::characteristicRead()
 {
     // Unfortunately we cannot construct QLowEnergyCharacteristic objects to test signal emissions.
@@ -46,6 +46,8 @@ private slots:
     void enableReadingNotifications();
     void disableReadingNotifications();
 
+    void coalescingSettings();
+
     void encodeSettings_data();
     void encodeSettings();
 
@@ -55,6 +57,16 @@ private slots:
     void parseSamples_data();
     void parseSamples();
 
+    void parseSamples_buffer_data();
+    void parseSamples_buffer();
+
+    void parseScaledSamples_data();
+    void parseScaledSamples();
+
+    void processMetadata();
+    void processSamples();
+    void processSamples_coalesced();
+
     void characteristicRead();
     void characteristicWritten();
     void characteristicChanged();
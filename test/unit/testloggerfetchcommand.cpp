@@ -21,4 +21,25 @@ void TestLoggerFetchCommand::test1()
     QCOMPARE(actual, expected);
 }
 
+void TestLoggerFetchCommand::metadataRead()
+{
+    LoggerFetchCommand command(nullptr);
+    command.format = AbstractCommand::OutputFormat::Binary;
+    DataLoggerService::Metadata metadata{
+        DataLoggerService::LoggerStatus::Sampling, 0.001f, DataLoggerService::Mode::DcVoltage,
+        { DataLoggerService::VoltageRange::_6V_to_12V }, 1000, 100, 0
+    };
+
+    // The first metadata arms the command, and writes one binary header.
+    command.metadataRead(metadata);
+    QCOMPARE(command.samplesToGo, 100);
+    QCOMPARE(command.outputBuffer.size(), 32);
+
+    // Further metadata, before all of the samples have arrived, is ignored.
+    metadata.numberOfSamples = 200;
+    command.metadataRead(metadata);
+    QCOMPARE(command.samplesToGo, 100);
+    QCOMPARE(command.outputBuffer.size(), 32);
+}
+
 QTEST_MAIN(TestLoggerFetchCommand)
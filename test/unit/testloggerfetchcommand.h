@@ -10,4 +10,6 @@ class TestLoggerFetchCommand : public QObject
 private slots:
     void test1_data();
     void test1();
+
+    void metadataRead();
 };
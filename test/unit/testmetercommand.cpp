@@ -5,6 +5,9 @@
 
 #include "metercommand.h"
 
+#include <cmath>
+#include <limits>
+
 void TestMeterCommand::test1_data()
 {
     QTest::addColumn<int>("input");
@@ -21,4 +24,207 @@ void TestMeterCommand::test1()
     QCOMPARE(actual, expected);
 }
 
+void TestMeterCommand::outputReading_csv()
+{
+    MeterCommand command(nullptr);
+    command.format = AbstractCommand::OutputFormat::Csv;
+    QByteArray output;
+    command.setOutputHandler([&output](const QByteArray &data) { output.append(data); });
+
+    MultimeterService::Reading reading{
+        MultimeterService::MeterStatus::AutoRangeOn, 1.5f, MultimeterService::Mode::DcVoltage,
+        { MultimeterService::VoltageRange::_2V_to_6V }
+    };
+    command.outputReading(reading);
+    reading.value = 2.25f;
+    command.outputReading(reading);
+    QCOMPARE(output, QByteArray("mode,value,units,status,range_min_milli,range_max_milli\n"
+        "DC voltage,1.500000,Vdc,Auto Range On,2000,6000\n"
+        "DC voltage,2.250000,Vdc,Auto Range On,2000,6000\n"));
+
+    // Each command outputs its own header, regardless of what other commands have output.
+    MeterCommand another(nullptr);
+    another.format = AbstractCommand::OutputFormat::Csv;
+    output.clear();
+    another.setOutputHandler([&output](const QByteArray &data) { output.append(data); });
+    another.outputReading(reading);
+    QCOMPARE(output, QByteArray("mode,value,units,status,range_min_milli,range_max_milli\n"
+        "DC voltage,2.250000,Vdc,Auto Range On,2000,6000\n"));
+}
+
+void TestMeterCommand::outputReading_jsonLines()
+{
+    MeterCommand command(nullptr);
+    command.format = AbstractCommand::OutputFormat::JsonLines;
+    QByteArray output;
+    command.setOutputHandler([&output](const QByteArray &data) { output.append(data); });
+
+    MultimeterService::Reading reading{
+        MultimeterService::MeterStatus::AutoRangeOn, 1.5f, MultimeterService::Mode::DcVoltage,
+        { MultimeterService::VoltageRange::_2V_to_6V }
+    };
+    command.outputReading(reading);
+    QCOMPARE(output, QByteArray("{\"mode\":\"DC voltage\",\"range\":{\"max\":6,\"min\":2},"
+        "\"status\":\"Auto Range On\",\"value\":1.5}\n"));
+
+    // Overloaded readings are output as strings, since JSON has no infinities.
+    output.clear();
+    reading.value = std::numeric_limits<float>::infinity();
+    command.outputReading(reading);
+    QCOMPARE(output, QByteArray("{\"mode\":\"DC voltage\",\"range\":{\"max\":6,\"min\":2},"
+        "\"status\":\"Auto Range On\",\"value\":\"Infinity\"}\n"));
+}
+
+void TestMeterCommand::outputReading_text()
+{
+    MeterCommand command(nullptr);
+    command.format = AbstractCommand::OutputFormat::Text;
+    QByteArray output;
+    command.setOutputHandler([&output](const QByteArray &data) { output.append(data); });
+
+    MultimeterService::Reading reading{
+        MultimeterService::MeterStatus::AutoRangeOn, 1.5f, MultimeterService::Mode::DcVoltage,
+        { MultimeterService::VoltageRange::_2V_to_6V }
+    };
+    command.outputReading(reading);
+    QCOMPARE(output, QByteArray("Mode:   DC voltage (0x01)\nValue:  1.500000 Vdc\n"
+        "Status: Auto Range On (0x01)\nRange:  2V to 6V (0x02)\n"));
+    QVERIFY(command.outputMetadata.valid);
+
+    // Output metadata is re-resolved when the status (or mode, or range) changes.
+    output.clear();
+    reading.status = MultimeterService::MeterStatus::AutoRangeOff;
+    reading.range.voltageRange = MultimeterService::VoltageRange::_6V_to_12V;
+    reading.value = 7.0f;
+    command.outputReading(reading);
+    QCOMPARE(output, QByteArray("Mode:   DC voltage (0x01)\nValue:  7.000000 Vdc\n"
+        "Status: Auto Range Off (0x00)\nRange:  6V to 12V (0x03)\n"));
+    QCOMPARE(command.outputMetadata.status, MultimeterService::MeterStatus::AutoRangeOff);
+    QCOMPARE(command.outputMetadata.range, (quint8)3);
+}
+
+void TestMeterCommand::processOptions_aggregate()
+{
+    QCommandLineParser parser;
+    parser.addOptions({
+        {{QStringLiteral("aggregate")}, QStringLiteral("description"), QStringLiteral("window")},
+        {{QStringLiteral("interval")}, QStringLiteral("description"), QStringLiteral("interval")},
+        {{QStringLiteral("mode")}, QStringLiteral("description"), QStringLiteral("mode")},
+    });
+
+    // Not aggregating by default.
+    MeterCommand command(nullptr);
+    parser.process(QStringList{ QStringLiteral("pokit"), QStringLiteral("--mode"),
+        QStringLiteral("Vdc") });
+    QCOMPARE(command.processOptions(parser), QStringList());
+    QCOMPARE(command.aggregateWindow, (quint32)0);
+
+    // The window is converted to a whole number of readings at the update interval.
+    parser.process(QStringList{ QStringLiteral("pokit"), QStringLiteral("--mode"),
+        QStringLiteral("Vdc"), QStringLiteral("--interval"), QStringLiteral("300ms"),
+        QStringLiteral("--aggregate"), QStringLiteral("2s") });
+    QCOMPARE(command.processOptions(parser), QStringList());
+    QCOMPARE(command.aggregateWindow, (quint32)2000);
+    QCOMPARE(command.readingsPerWindow, 7);
+
+    // Windows shorter than the update interval still hold one reading.
+    parser.process(QStringList{ QStringLiteral("pokit"), QStringLiteral("--mode"),
+        QStringLiteral("Vdc"), QStringLiteral("--interval"), QStringLiteral("1s"),
+        QStringLiteral("--aggregate"), QStringLiteral("100ms") });
+    QCOMPARE(command.processOptions(parser), QStringList());
+    QCOMPARE(command.readingsPerWindow, 1);
+
+    parser.process(QStringList{ QStringLiteral("pokit"), QStringLiteral("--mode"),
+        QStringLiteral("Vdc"), QStringLiteral("--aggregate"), QStringLiteral("invalid") });
+    QCOMPARE(command.processOptions(parser).size(), 1);
+}
+
+void TestMeterCommand::accumulate()
+{
+    MeterCommand::Aggregate aggregate{};
+    QVERIFY(qIsNaN(MeterCommand::rms(aggregate)));
+    QVERIFY(qIsNaN(MeterCommand::standardDeviation(aggregate)));
+
+    MultimeterService::Reading reading{
+        MultimeterService::MeterStatus::AutoRangeOn, 0.0f, MultimeterService::Mode::DcVoltage,
+        { MultimeterService::VoltageRange::AutoRange }
+    };
+    for (const float value: { 1.0f, 2.0f, 3.0f, 4.0f, std::numeric_limits<float>::infinity() }) {
+        reading.value = value;
+        MeterCommand::accumulate(aggregate, reading);
+    }
+    reading.status = MultimeterService::MeterStatus::Error;
+    reading.value = 100.0f;
+    MeterCommand::accumulate(aggregate, reading);
+
+    // Errors, and overloads, are counted, but excluded from the statistics.
+    QCOMPARE(aggregate.readings, 6);
+    QCOMPARE(aggregate.errors, 2);
+    QCOMPARE(aggregate.count, 4);
+    QCOMPARE(aggregate.minimum, 1.0);
+    QCOMPARE(aggregate.maximum, 4.0);
+    QCOMPARE(aggregate.mean, 2.5);
+    QCOMPARE(MeterCommand::rms(aggregate), std::sqrt(7.5));
+    QCOMPARE(MeterCommand::standardDeviation(aggregate), std::sqrt(1.25));
+}
+
+void TestMeterCommand::aggregateReading_csv()
+{
+    MeterCommand command(nullptr);
+    command.format = AbstractCommand::OutputFormat::Csv;
+    command.aggregateWindow = 2000;
+    command.readingsPerWindow = 2;
+    QByteArray output;
+    command.setOutputHandler([&output](const QByteArray &data) { output.append(data); });
+
+    MultimeterService::Reading reading{
+        MultimeterService::MeterStatus::AutoRangeOn, 1.0f, MultimeterService::Mode::DcVoltage,
+        { MultimeterService::VoltageRange::AutoRange }
+    };
+    command.aggregateReading(reading);
+    QCOMPARE(output, QByteArray()); // Nothing is output until the window is complete.
+
+    reading.value = 3.0f;
+    command.aggregateReading(reading);
+    QCOMPARE(output, QByteArray("mode,readings,errors,min,max,mean,rms,stddev,units\n"
+        "DC voltage,2,0,1.000000,3.000000,2.000000,2.236068,1.000000,Vdc\n"));
+    QCOMPARE(command.aggregate.readings, 0);
+    QCOMPARE(command.samplesOutput, (quint64)2);
+
+    // A window of only errors has no statistics, so outputs empty fields.
+    output.clear();
+    reading.status = MultimeterService::MeterStatus::Error;
+    command.aggregateReading(reading);
+    command.aggregateReading(reading);
+    QCOMPARE(output, QByteArray("DC voltage,2,2,,,,,,Vdc\n"));
+}
+
+void TestMeterCommand::aggregateReading_jsonLines()
+{
+    MeterCommand command(nullptr);
+    command.format = AbstractCommand::OutputFormat::JsonLines;
+    command.aggregateWindow = 1000;
+    command.readingsPerWindow = 10;
+    QByteArray output;
+    command.setOutputHandler([&output](const QByteArray &data) { output.append(data); });
+
+    // A change of mode completes the current window early.
+    MultimeterService::Reading reading{
+        MultimeterService::MeterStatus::Error, 1.0f, MultimeterService::Mode::DcVoltage,
+        { MultimeterService::VoltageRange::AutoRange }
+    };
+    command.aggregateReading(reading);
+    QCOMPARE(output, QByteArray());
+    reading.mode = MultimeterService::Mode::AcVoltage;
+    command.aggregateReading(reading);
+    QVERIFY(output.startsWith('{'));
+    QVERIFY(output.endsWith("}\n"));
+    QVERIFY(output.contains("\"readings\":1"));
+    QVERIFY(output.contains("\"errors\":1"));
+    QVERIFY(output.contains("\"min\":null")); // No valid readings, so no statistics.
+    QVERIFY(output.contains("\"units\":\"Vdc\""));
+    QCOMPARE(command.aggregate.readings, 1);
+    QCOMPARE(command.aggregateMode, MultimeterService::Mode::AcVoltage);
+}
+
 QTEST_MAIN(TestMeterCommand)
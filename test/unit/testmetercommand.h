@@ -10,4 +10,13 @@ class TestMeterCommand : public QObject
 private slots:
     void test1_data();
     void test1();
+
+    void outputReading_csv();
+    void outputReading_jsonLines();
+    void outputReading_text();
+
+    void processOptions_aggregate();
+    void accumulate();
+    void aggregateReading_csv();
+    void aggregateReading_jsonLines();
 };
@@ -0,0 +1,58 @@
+// SPDX-FileCopyrightText: 2022 Paul Colby <git@colby.id.au>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "testmultidevicecommand.h"
+
+#include "metercommand.h"
+#include "multidevicecommand.h"
+
+void TestMultiDeviceCommand::deviceId_data()
+{
+    QTest::addColumn<QBluetoothDeviceInfo>("info");
+    QTest::addColumn<QString>("expected");
+
+    const QBluetoothAddress address(QStringLiteral("01:23:45:67:89:AB"));
+    QTest::addRow("address") << QBluetoothDeviceInfo(address, QStringLiteral("Meter"), 0)
+        << QStringLiteral("01:23:45:67:89:AB");
+
+    const QBluetoothUuid uuid(QStringLiteral("{12345678-1234-1234-1234-1234567890ab}"));
+    QTest::addRow("uuid") << QBluetoothDeviceInfo(uuid, QStringLiteral("Meter"), 0)
+        << uuid.toString();
+}
+
+void TestMultiDeviceCommand::deviceId()
+{
+    QFETCH(QBluetoothDeviceInfo, info);
+    QFETCH(QString, expected);
+    QCOMPARE(MultiDeviceCommand::deviceId(info), expected);
+}
+
+void TestMultiDeviceCommand::processOptions()
+{
+    MultiDeviceCommand command([](QObject * const parent) {
+        return new MeterCommand(parent);
+    }, nullptr);
+    QCommandLineParser parser;
+    parser.addOptions({
+        {{QStringLiteral("all-devices")}, QStringLiteral("description")},
+        {{QStringLiteral("device")}, QStringLiteral("description"), QStringLiteral("device")},
+        {{QStringLiteral("mode")}, QStringLiteral("description"), QStringLiteral("mode")},
+        {{QStringLiteral("output")}, QStringLiteral("description"), QStringLiteral("format")},
+    });
+
+    // Binary output cannot be multiplexed.
+    parser.process(QStringList{ QStringLiteral("pokit"), QStringLiteral("--all-devices"),
+        QStringLiteral("--mode"), QStringLiteral("Vdc"), QStringLiteral("--output"),
+        QStringLiteral("binary") });
+    QCOMPARE(command.processOptions(parser).size(), 1);
+
+    // Multiple devices may be given.
+    parser.process(QStringList{ QStringLiteral("pokit"), QStringLiteral("--all-devices"),
+        QStringLiteral("--mode"), QStringLiteral("Vdc"), QStringLiteral("--device"),
+        QStringLiteral("a"), QStringLiteral("--device"), QStringLiteral("b") });
+    command.processOptions(parser);
+    QCOMPARE(command.deviceMatcher.targets(),
+             (QStringList{ QStringLiteral("a"), QStringLiteral("b") }));
+}
+
+QTEST_MAIN(TestMultiDeviceCommand)
@@ -0,0 +1,15 @@
+// SPDX-FileCopyrightText: 2022 Paul Colby <git@colby.id.au>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include <QTest>
+
+class TestMultiDeviceCommand : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void deviceId_data();
+    void deviceId();
+
+    void processOptions();
+};
@@ -14,6 +14,8 @@
 #include <qtpokit/multimeterservice.h>
 #include <qtpokit/statusservice.h>
 
+#include <QSignalSpy>
+
 void TestPokitDevice::controller()
 {
     PokitDevice device(nullptr);
@@ -171,6 +173,97 @@ void TestPokitDevice::charcteristicToString()
     QCOMPARE(PokitDevice::charcteristicToString(uuid), expected);
 }
 
+Q_DECLARE_METATYPE(PokitDevice::ConnectionProfile)
+
+void TestPokitDevice::toString_data()
+{
+    QTest::addColumn<PokitDevice::ConnectionProfile>("profile");
+    QTest::addColumn<QString>("expected");
+    #define QTPOKIT_ADD_TEST_ROW(profile, expected) \
+        QTest::addRow(#profile) << PokitDevice::ConnectionProfile::profile \
+                                << QStringLiteral(expected)
+    QTPOKIT_ADD_TEST_ROW(Balanced,   "Balanced");
+    QTPOKIT_ADD_TEST_ROW(Throughput, "Throughput");
+    QTPOKIT_ADD_TEST_ROW(LowPower,   "Low power");
+    #undef QTPOKIT_ADD_TEST_ROW
+    QTest::addRow("invalid") << (PokitDevice::ConnectionProfile)255 << QString();
+}
+
+void TestPokitDevice::toString()
+{
+    QFETCH(PokitDevice::ConnectionProfile, profile);
+    QFETCH(QString, expected);
+    QCOMPARE(PokitDevice::toString(profile), expected);
+}
+
+void TestPokitDevice::profileParameters_data()
+{
+    QTest::addColumn<PokitDevice::ConnectionProfile>("profile");
+    QTest::addRow("Balanced")   << PokitDevice::ConnectionProfile::Balanced;
+    QTest::addRow("Throughput") << PokitDevice::ConnectionProfile::Throughput;
+    QTest::addRow("LowPower")   << PokitDevice::ConnectionProfile::LowPower;
+}
+
+void TestPokitDevice::profileParameters()
+{
+    // Verify the parameters are within the ranges allowed by the Bluetooth Core Specification.
+    QFETCH(PokitDevice::ConnectionProfile, profile);
+    const QLowEnergyConnectionParameters parameters = PokitDevice::profileParameters(profile);
+    QVERIFY(parameters.minimumInterval() >= 7.5);
+    QVERIFY(parameters.minimumInterval() <= parameters.maximumInterval());
+    QVERIFY(parameters.maximumInterval() <= 4000.0);
+    QVERIFY(parameters.latency() >= 0);
+    QVERIFY(parameters.latency() <= 499);
+    QVERIFY(parameters.supervisionTimeout() >= 100);
+    QVERIFY(parameters.supervisionTimeout() <= 32000);
+    QVERIFY(parameters.supervisionTimeout() >
+            (1 + parameters.latency()) * parameters.maximumInterval() * 2);
+}
+
+void TestPokitDevice::connectionProfile()
+{
+    PokitDevice device(nullptr);
+    QCOMPARE(device.connectionProfile(), PokitDevice::ConnectionProfile::Balanced); // Default.
+
+    // Without a connected controller, the profile is recorded, to be requested once connected.
+    device.setConnectionProfile(PokitDevice::ConnectionProfile::Throughput);
+    QCOMPARE(device.connectionProfile(), PokitDevice::ConnectionProfile::Throughput);
+    QVERIFY(!device.d_func()->requestConnectionProfile());
+
+    QLowEnergyController * const controller =
+        QLowEnergyController::createCentral(QBluetoothDeviceInfo());
+    device.d_func()->setController(controller);
+    QVERIFY(!device.d_func()->requestConnectionProfile()); // Not connected.
+    device.setConnectionProfile(PokitDevice::ConnectionProfile::Balanced);
+    QCOMPARE(device.connectionProfile(), PokitDevice::ConnectionProfile::Balanced);
+    device.d_func()->setController(nullptr);
+    delete controller;
+}
+
+void TestPokitDevice::maximumNotificationPayload_data()
+{
+    QTest::addColumn<int>("mtu");
+    QTest::addColumn<int>("expected");
+    QTest::addRow("unknown") << -1  << 20;
+    QTest::addRow("default") << 23  << 20;
+    QTest::addRow("247")     << 247 << 244;
+    QTest::addRow("515")     << 515 << 512;
+    QTest::addRow("517")     << 517 << 512; // Capped at the maximum attribute value length.
+}
+
+void TestPokitDevice::maximumNotificationPayload()
+{
+    QFETCH(int, mtu);
+    QFETCH(int, expected);
+    QCOMPARE(PokitDevice::maximumNotificationPayload(mtu), expected);
+}
+
+void TestPokitDevice::mtu()
+{
+    PokitDevice device(nullptr);
+    QCOMPARE(device.mtu(), -1);
+}
+
 void TestPokitDevice::setController()
 {
     // Verify safe error handling (can't do much else without a Bluetooth device).
@@ -225,9 +318,13 @@ void TestPokitDevice::connected()
 
 void TestPokitDevice::connectionUpdated()
 {
-    // Verify safe error handling (can't do much else without a Bluetooth device).
     PokitDevice device(nullptr);
-    device.d_func()->connectionUpdated(QLowEnergyConnectionParameters());
+    QSignalSpy spy(&device, &PokitDevice::connectionParametersUpdated);
+    const QLowEnergyConnectionParameters parameters =
+        PokitDevice::profileParameters(PokitDevice::ConnectionProfile::Throughput);
+    device.d_func()->connectionUpdated(parameters);
+    QCOMPARE(spy.count(), 1);
+    QCOMPARE(device.connectionParameters(), parameters);
 }
 
 void TestPokitDevice::disconnected()
@@ -251,6 +348,18 @@ void TestPokitDevice::errorOccurred()
     device.d_func()->errorOccurred(QLowEnergyController::Error::UnknownError);
 }
 
+void TestPokitDevice::mtuChanged()
+{
+    PokitDevice device(nullptr);
+    QSignalSpy spy(&device, &PokitDevice::mtuChanged);
+    device.d_func()->mtuChanged(247);
+    QCOMPARE(spy.count(), 1);
+    QCOMPARE(spy.at(0).at(0).toInt(), 247);
+    QCOMPARE(device.mtu(), 247);
+    device.d_func()->mtuChanged(247); // Unchanged, so no signal.
+    QCOMPARE(spy.count(), 1);
+}
+
 void TestPokitDevice::serviceDiscovered()
 {
     // Verify safe error handling (can't do much else without a Bluetooth device).
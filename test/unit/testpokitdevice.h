@@ -25,6 +25,19 @@ private slots:
     void charcteristicToString_data();
     void charcteristicToString();
 
+    void toString_data();
+    void toString();
+
+    void profileParameters_data();
+    void profileParameters();
+
+    void connectionProfile();
+
+    void maximumNotificationPayload_data();
+    void maximumNotificationPayload();
+
+    void mtu();
+
     void setController();
 
     void connected();
@@ -32,6 +45,7 @@ private slots:
     void disconnected();
     void discoveryFinished();
     void errorOccurred();
+    void mtuChanged();
     void serviceDiscovered();
     void stateChanged();
 };
@@ -142,6 +142,36 @@ void TestPokitDiscoveryAgent::isPokitPro()
 //    QSKIP("Cannot test without impacting Bluetooth devices.");
 //}
 
+void TestPokitDiscoveryAgent::presenceSettings()
+{
+    PokitDiscoveryAgent service(nullptr);
+    PokitDiscoveryAgent::PresenceSettings settings = service.presenceSettings();
+    QCOMPARE(settings.scanDuration,  4000);
+    QCOMPARE(settings.scanInterval,  20000);
+    QCOMPARE(settings.lostTimeout,   60000);
+    QCOMPARE(settings.rssiThreshold, 6);
+    QCOMPARE(service.isMonitoring(), false);
+
+    service.setPresenceSettings({ 1000, 5000, 15000, 3 });
+    settings = service.presenceSettings();
+    QCOMPARE(settings.scanDuration,  1000);
+    QCOMPARE(settings.scanInterval,  5000);
+    QCOMPARE(settings.lostTimeout,   15000);
+    QCOMPARE(settings.rssiThreshold, 3);
+
+    // Scans are limited to the scan interval.
+    service.setPresenceSettings({ 9000, 5000, 15000, 3 });
+    QCOMPARE(service.presenceSettings().scanDuration, 5000);
+}
+
+void TestPokitDiscoveryAgent::stopMonitoring()
+{
+    // Verify safe handling when not monitoring (can't start without impacting Bluetooth devices).
+    PokitDiscoveryAgent service(nullptr);
+    service.stopMonitoring();
+    QCOMPARE(service.isMonitoring(), false);
+}
+
 void TestPokitDiscoveryAgent::cancelled()
 {
     // Verify safe error handling (can't do much else without a Bluetooth device).
@@ -203,4 +233,88 @@ void TestPokitDiscoveryAgent::finished()
     service.d_func()->finished();
 }
 
+void TestPokitDiscoveryAgent::deviceKey()
+{
+    const QBluetoothAddress address(QStringLiteral("01:02:03:04:05:06"));
+    QCOMPARE(PokitDiscoveryAgent::deviceKey(QBluetoothDeviceInfo(
+        address, QStringLiteral("Pokit"), 0)), address.toString());
+    const QBluetoothUuid uuid(QStringLiteral("{11111111-2222-3333-4444-555555555555}"));
+    QCOMPARE(PokitDiscoveryAgent::deviceKey(QBluetoothDeviceInfo(
+        uuid, QStringLiteral("Pokit"), 0)), uuid.toString());
+}
+
+void TestPokitDiscoveryAgent::updatePresence()
+{
+    PokitDiscoveryAgent service(nullptr);
+    QSignalSpy appeared(&service, &PokitDiscoveryAgent::pokitDeviceAppeared);
+    QSignalSpy moved(&service, &PokitDiscoveryAgent::pokitDeviceMoved);
+    QBluetoothDeviceInfo info(QBluetoothAddress(QStringLiteral("01:02:03:04:05:06")),
+                              QStringLiteral("Pokit"), 0);
+    const QDateTime now = QDateTime::currentDateTimeUtc();
+
+    // First sighting appears.
+    info.setRssi(-60);
+    service.d_func()->updatePresence(info, now);
+    QCOMPARE(appeared.count(), 1);
+    QCOMPARE(moved.count(), 0);
+    QCOMPARE(service.presentDevices().size(), 1);
+    QCOMPARE(service.presentDevices().first().firstSeen, now);
+
+    // A single outlier is smoothed away (-60 + 0.25 * -16 = -64, within 6 dBm).
+    info.setRssi(-76);
+    service.d_func()->updatePresence(info, now.addSecs(1));
+    QCOMPARE(appeared.count(), 1);
+    QCOMPARE(moved.count(), 0);
+    QCOMPARE(service.presentDevices().first().lastSeen, now.addSecs(1));
+
+    // A sustained change moves (-64 + 0.25 * -16 = -68, beyond 6 dBm).
+    info.setRssi(-80);
+    service.d_func()->updatePresence(info, now.addSecs(2));
+    QCOMPARE(appeared.count(), 1);
+    QCOMPARE(moved.count(), 1);
+    QCOMPARE(moved.first().at(1).value<qint16>(), (qint16)-68);
+    QCOMPARE(service.presentDevices().first().signalStrength.reported(), (qint16)-68);
+}
+
+void TestPokitDiscoveryAgent::updatePresence_unknownRssi()
+{
+    PokitDiscoveryAgent service(nullptr);
+    QSignalSpy appeared(&service, &PokitDiscoveryAgent::pokitDeviceAppeared);
+    QSignalSpy moved(&service, &PokitDiscoveryAgent::pokitDeviceMoved);
+    QBluetoothDeviceInfo info(QBluetoothAddress(QStringLiteral("01:02:03:04:05:06")),
+                              QStringLiteral("Pokit"), 0);
+    const QDateTime now = QDateTime::currentDateTimeUtc();
+
+    // First sighting, with unknown (0) RSSI, appears.
+    service.d_func()->updatePresence(info, now);
+    QCOMPARE(appeared.count(), 1);
+    QVERIFY(!service.presentDevices().first().signalStrength.isValid());
+
+    // The first known RSSI seeds the smoothed RSSI, rather than moving it away from 0.
+    info.setRssi(-60);
+    service.d_func()->updatePresence(info, now.addSecs(1));
+    info.setRssi(-62);
+    service.d_func()->updatePresence(info, now.addSecs(2));
+    QCOMPARE(moved.count(), 0);
+    QCOMPARE(service.presentDevices().first().signalStrength.reported(), (qint16)-60);
+}
+
+void TestPokitDiscoveryAgent::checkForLostDevices()
+{
+    PokitDiscoveryAgent service(nullptr);
+    QSignalSpy lost(&service, &PokitDiscoveryAgent::pokitDeviceLost);
+    const QBluetoothDeviceInfo info(QBluetoothAddress(QStringLiteral("01:02:03:04:05:06")),
+                                    QStringLiteral("Pokit"), 0);
+    const QDateTime now = QDateTime::currentDateTimeUtc();
+    service.d_func()->updatePresence(info, now);
+
+    // Not lost until unseen for the whole lost timeout.
+    service.d_func()->checkForLostDevices(now.addMSecs(59999));
+    QCOMPARE(lost.count(), 0);
+    QCOMPARE(service.presentDevices().size(), 1);
+    service.d_func()->checkForLostDevices(now.addMSecs(60000));
+    QCOMPARE(lost.count(), 1);
+    QCOMPARE(service.presentDevices().size(), 0);
+}
+
 QTEST_MAIN(TestPokitDiscoveryAgent)
@@ -19,6 +19,9 @@ private slots:
 
     //void start(); // Cannot test without impacting Bluetooth devices.
 
+    void presenceSettings();
+    void stopMonitoring();
+
     void cancelled();
 
     void deviceDiscovered_data();
@@ -30,4 +33,9 @@ private slots:
     void error();
 
     void finished();
+
+    void deviceKey();
+    void updatePresence();
+    void updatePresence_unknownRssi();
+    void checkForLostDevices();
 };
@@ -0,0 +1,111 @@
+// SPDX-FileCopyrightText: 2022 Paul Colby <git@colby.id.au>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "testpokitranges.h"
+
+#include <qtpokit/pokitranges.h>
+
+Q_DECLARE_METATYPE(PokitRanges::Quantity)
+
+void TestPokitRanges::table_data()
+{
+    QTest::addColumn<PokitRanges::Quantity>("quantity");
+    QTest::addColumn<int>("expected");
+
+    QTest::addRow("Voltage")    << PokitRanges::Quantity::Voltage    << 6;
+    QTest::addRow("Current")    << PokitRanges::Quantity::Current    << 5;
+    QTest::addRow("Resistance") << PokitRanges::Quantity::Resistance << 8;
+}
+
+void TestPokitRanges::table()
+{
+    QFETCH(PokitRanges::Quantity, quantity);
+    QFETCH(int, expected);
+    const PokitRanges::Table table = PokitRanges::table(quantity);
+    QCOMPARE(table.size, expected);
+    QCOMPARE(table.end() - table.begin(), (qptrdiff)expected);
+
+    // Every table must be indexed by value, contiguous, and ascending.
+    int index = 0;
+    for (const PokitRanges::Descriptor &range: table) {
+        QCOMPARE((int)range.value, index);
+        QVERIFY(range.minimum < range.maximum);
+        if (index > 0) {
+            QCOMPARE(range.minimum, table.descriptors[index-1].maximum);
+        }
+        QVERIFY(range.label != nullptr);
+        ++index;
+    }
+}
+
+void TestPokitRanges::find()
+{
+    const PokitRanges::Descriptor * range = PokitRanges::find(PokitRanges::Quantity::Voltage, 2);
+    QVERIFY(range != nullptr);
+    QCOMPARE((int)range->value, 2);
+    QCOMPARE(range->minimum, 2.0);
+    QCOMPARE(range->maximum, 6.0);
+
+    range = PokitRanges::find(PokitRanges::Quantity::Current, 4);
+    QVERIFY(range != nullptr);
+    QCOMPARE(range->maximum, 3.0);
+
+    // AutoRange, and other values beyond the end of the tables.
+    QVERIFY(PokitRanges::find(PokitRanges::Quantity::Voltage, 255) == nullptr);
+    QVERIFY(PokitRanges::find(PokitRanges::Quantity::Current, 5) == nullptr);
+}
+
+void TestPokitRanges::lowest_data()
+{
+    QTest::addColumn<PokitRanges::Quantity>("quantity");
+    QTest::addColumn<double>("maximum");
+    QTest::addColumn<int>("expected"); // -1 for none.
+
+    QTest::addRow("0V")     << PokitRanges::Quantity::Voltage    <<       0.00 <<  0;
+    QTest::addRow("0.3V")   << PokitRanges::Quantity::Voltage    <<       0.30 <<  0;
+    QTest::addRow("0.31V")  << PokitRanges::Quantity::Voltage    <<       0.31 <<  1;
+    QTest::addRow("60V")    << PokitRanges::Quantity::Voltage    <<      60.00 <<  5;
+    QTest::addRow("61V")    << PokitRanges::Quantity::Voltage    <<      61.00 << -1;
+    QTest::addRow("10mA")   << PokitRanges::Quantity::Current    <<       0.01 <<  0;
+    QTest::addRow("200mA")  << PokitRanges::Quantity::Current    <<       0.20 <<  3;
+    QTest::addRow("4A")     << PokitRanges::Quantity::Current    <<       4.00 << -1;
+    QTest::addRow("1K")     << PokitRanges::Quantity::Resistance <<    1000.00 <<  3;
+    QTest::addRow("1M")     << PokitRanges::Quantity::Resistance << 1000000.00 <<  7;
+    QTest::addRow("2M")     << PokitRanges::Quantity::Resistance << 2000000.00 << -1;
+}
+
+void TestPokitRanges::lowest()
+{
+    QFETCH(PokitRanges::Quantity, quantity);
+    QFETCH(double, maximum);
+    QFETCH(int, expected);
+    const PokitRanges::Descriptor * const range = PokitRanges::lowest(quantity, maximum);
+    QCOMPARE((range) ? (int)range->value : -1, expected);
+}
+
+void TestPokitRanges::label()
+{
+    QCOMPARE(PokitRanges::label(PokitRanges::Quantity::Voltage, 2), QStringLiteral("2V to 6V"));
+    QCOMPARE(PokitRanges::label(PokitRanges::Quantity::Current, 0), QStringLiteral("0 to 10mA"));
+    QCOMPARE(PokitRanges::label(PokitRanges::Quantity::Resistance, 7),
+             QStringLiteral("470K to 1M ohms"));
+    QVERIFY(PokitRanges::label(PokitRanges::Quantity::Voltage, 255).isNull());
+}
+
+void TestPokitRanges::minValue()
+{
+    QCOMPARE(PokitRanges::minValue(PokitRanges::Quantity::Voltage, 2), QVariant(2000));
+    QCOMPARE(PokitRanges::minValue(PokitRanges::Quantity::Current, 1), QVariant(10));
+    QCOMPARE(PokitRanges::minValue(PokitRanges::Quantity::Resistance, 4), QVariant(1500));
+    QVERIFY(PokitRanges::minValue(PokitRanges::Quantity::Voltage, 255).isNull());
+}
+
+void TestPokitRanges::maxValue()
+{
+    QCOMPARE(PokitRanges::maxValue(PokitRanges::Quantity::Voltage, 2), QVariant(6000));
+    QCOMPARE(PokitRanges::maxValue(PokitRanges::Quantity::Current, 4), QVariant(3000));
+    QCOMPARE(PokitRanges::maxValue(PokitRanges::Quantity::Resistance, 7), QVariant(1000000));
+    QVERIFY(PokitRanges::maxValue(PokitRanges::Quantity::Voltage, 255).isNull());
+}
+
+QTEST_MAIN(TestPokitRanges)
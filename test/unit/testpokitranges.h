@@ -0,0 +1,22 @@
+// SPDX-FileCopyrightText: 2022 Paul Colby <git@colby.id.au>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include <QTest>
+
+class TestPokitRanges : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void table_data();
+    void table();
+
+    void find();
+
+    void lowest_data();
+    void lowest();
+
+    void label();
+    void minValue();
+    void maxValue();
+};
@@ -0,0 +1,216 @@
+// SPDX-FileCopyrightText: 2022 Paul Colby <git@colby.id.au>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "testpokitsimulator.h"
+
+#include <qtpokit/pokitsimulator.h>
+#include "dataloggerservice_p.h"
+#include "dsoservice_p.h"
+#include "multimeterservice_p.h"
+
+#include <QElapsedTimer>
+
+void TestPokitSimulator::encodeReading()
+{
+    const MultimeterService::Reading reading{
+        MultimeterService::MeterStatus::AutoRangeOn, 1.5f, MultimeterService::Mode::AcVoltage,
+        { MultimeterService::VoltageRange::_2V_to_6V }
+    };
+    const QByteArray value = PokitSimulator::encodeReading(reading);
+    QCOMPARE(value.size(), 7);
+    const MultimeterService::Reading parsed = MultimeterServicePrivate::parseReading(value);
+    QCOMPARE(parsed.status, reading.status);
+    QCOMPARE(parsed.value, reading.value);
+    QCOMPARE(parsed.mode, reading.mode);
+    QCOMPARE(parsed.range.voltageRange, reading.range.voltageRange);
+}
+
+void TestPokitSimulator::encodeMetadata_dso()
+{
+    const DsoService::Metadata metadata{
+        DsoService::DsoStatus::Sampling, 0.25f, DsoService::Mode::DcCurrent,
+        { DsoService::VoltageRange::_6V_to_12V }, 123456, 1000, 5000
+    };
+    const QByteArray value = PokitSimulator::encodeMetadata(metadata);
+    QCOMPARE(value.size(), 17);
+    const DsoService::Metadata parsed = DsoServicePrivate::parseMetadata(value);
+    QCOMPARE(parsed.status, metadata.status);
+    QCOMPARE(parsed.scale, metadata.scale);
+    QCOMPARE(parsed.mode, metadata.mode);
+    QCOMPARE(parsed.range.voltageRange, metadata.range.voltageRange);
+    QCOMPARE(parsed.samplingWindow, metadata.samplingWindow);
+    QCOMPARE(parsed.numberOfSamples, metadata.numberOfSamples);
+    QCOMPARE(parsed.samplingRate, metadata.samplingRate);
+}
+
+void TestPokitSimulator::encodeMetadata_logger()
+{
+    const DataLoggerService::Metadata metadata{
+        DataLoggerService::LoggerStatus::Done, 0.5f, DataLoggerService::Mode::AcVoltage,
+        { DataLoggerService::VoltageRange::_12V_to_30V }, 60000, 1234, 1650000000
+    };
+    const QByteArray value = PokitSimulator::encodeMetadata(metadata);
+    QCOMPARE(value.size(), 15);
+    const DataLoggerService::Metadata parsed = DataLoggerServicePrivate::parseMetadata(value);
+    QCOMPARE(parsed.status, metadata.status);
+    QCOMPARE(parsed.scale, metadata.scale);
+    QCOMPARE(parsed.mode, metadata.mode);
+    QCOMPARE(parsed.range.voltageRange, metadata.range.voltageRange);
+    QCOMPARE(parsed.updateInterval, metadata.updateInterval);
+    QCOMPARE(parsed.numberOfSamples, metadata.numberOfSamples);
+    QCOMPARE(parsed.timestamp, metadata.timestamp);
+}
+
+void TestPokitSimulator::encodeSamples()
+{
+    const QByteArray value = PokitSimulator::encodeSamples(64);
+    QCOMPARE(value.size(), 128);
+    const DsoService::Samples samples = DsoServicePrivate::parseSamples(value);
+    QCOMPARE(samples.size(), 64);
+    QCOMPARE(samples.at(0), (qint16)0);
+    QCOMPARE(samples.at(16), (qint16)10000); // Peak, a quarter of the way through the period.
+    QCOMPARE(samples.at(48), (qint16)-10000); // Trough, three quarters of the way through.
+
+    // Phase offsets continue the same wave.
+    QCOMPARE(PokitSimulator::encodeSamples(16, 48), value.mid(96));
+    QVERIFY(PokitSimulator::encodeSamples(0).isEmpty());
+}
+
+void TestPokitSimulator::multimeterStream()
+{
+    MultimeterService service(nullptr);
+    int readings = 0;
+    connect(&service, &MultimeterService::readingRead,
+            [&readings](const MultimeterService::Reading &reading) {
+        QCOMPARE(reading.mode, MultimeterService::Mode::DcVoltage);
+        ++readings;
+    });
+
+    PokitSimulator simulator;
+    simulator.addStream(&service, { 0, 0, 100 });
+    int finished = 0;
+    connect(&simulator, &PokitSimulator::finished, [&finished]() { ++finished; });
+    simulator.start();
+    QVERIFY(simulator.isActive());
+    QTRY_COMPARE(finished, 1);
+    QCOMPARE(readings, 100);
+    QCOMPARE(simulator.notificationCount(), (qint64)100);
+    QCOMPARE(simulator.bytesNotified(), (qint64)700);
+    QVERIFY(!simulator.isActive());
+}
+
+void TestPokitSimulator::dsoStream()
+{
+    DsoService service(nullptr);
+    int metadataCount = 0, samplesCount = 0;
+    connect(&service, &DsoService::metadataRead,
+            [&metadataCount](const DsoService::Metadata &metadata) {
+        QCOMPARE(metadata.numberOfSamples, (quint16)1000);
+        ++metadataCount;
+    });
+    connect(&service, &DsoService::samplesRead,
+            [&samplesCount](const DsoService::Samples &samples) {
+        samplesCount += samples.size();
+    });
+
+    PokitSimulator simulator;
+    simulator.addStream(&service, { 0, 20, 100 }); // 100 notifications of 10 samples each.
+    simulator.start();
+    QCOMPARE(metadataCount, 1); // Metadata is delivered immediately.
+    QTRY_VERIFY(!simulator.isActive());
+    QCOMPARE(samplesCount, 1000);
+    QCOMPARE(simulator.notificationCount(), (qint64)101);
+    QCOMPARE(simulator.bytesNotified(), (qint64)(17 + 2000));
+}
+
+void TestPokitSimulator::dataLoggerStream()
+{
+    DataLoggerService service(nullptr);
+    int metadataCount = 0, samplesCount = 0;
+    connect(&service, &DataLoggerService::metadataRead,
+            [&metadataCount](const DataLoggerService::Metadata &) { ++metadataCount; });
+    connect(&service, &DataLoggerService::samplesRead,
+            [&samplesCount](const DataLoggerService::Samples &samples) {
+        samplesCount += samples.size();
+    });
+
+    PokitSimulator simulator;
+    simulator.addStream(&service, { 0, 244, 10 });
+    simulator.start();
+    QTRY_VERIFY(!simulator.isActive());
+    QCOMPARE(metadataCount, 1);
+    QCOMPARE(samplesCount, 1220);
+}
+
+void TestPokitSimulator::rateLimited()
+{
+    MultimeterService service(nullptr);
+    int readings = 0;
+    connect(&service, &MultimeterService::readingRead,
+            [&readings](const MultimeterService::Reading &) { ++readings; });
+
+    PokitSimulator simulator;
+    simulator.addStream(&service, { 100, 0, 10 }); // 10 readings at 100 Hz, ie ~90ms.
+    QElapsedTimer timer;
+    timer.start();
+    simulator.start();
+    QTRY_VERIFY(!simulator.isActive());
+    QCOMPARE(readings, 10);
+    QVERIFY(timer.elapsed() >= 80);
+}
+
+void TestPokitSimulator::stop()
+{
+    MultimeterService service(nullptr);
+    PokitSimulator simulator;
+    simulator.addStream(&service, { 0, 0, 0 }); // Unlimited.
+    simulator.start();
+    QTest::qWait(10);
+    QVERIFY(simulator.isActive());
+    QVERIFY(simulator.notificationCount() > 0);
+    simulator.stop();
+    QVERIFY(!simulator.isActive());
+    const qint64 count = simulator.notificationCount();
+    QTest::qWait(10);
+    QCOMPARE(simulator.notificationCount(), count);
+
+    simulator.clearStreams();
+    simulator.start();
+    QTRY_VERIFY(!simulator.isActive()); // Nothing to simulate, so finishes immediately.
+    QCOMPARE(simulator.notificationCount(), (qint64)0);
+}
+
+void TestPokitSimulator::modifyStreams()
+{
+    // Receivers may add streams during delivery.
+    MultimeterService service(nullptr);
+    PokitSimulator simulator;
+    int readings = 0;
+    connect(&service, &MultimeterService::readingRead, [&]() {
+        if (++readings == 1) {
+            for (int count = 0; count < 100; ++count) { // Enough to reallocate the streams.
+                simulator.addStream(&service, { 0, 0, 1 });
+            }
+        }
+    });
+    simulator.addStream(&service, { 0, 0, 2 });
+    simulator.start();
+    QTRY_VERIFY(!simulator.isActive());
+    QCOMPARE(readings, 102);
+
+    // Receivers may also clear streams during delivery.
+    MultimeterService other(nullptr);
+    PokitSimulator clearing;
+    int cleared = 0;
+    connect(&other, &MultimeterService::readingRead, [&]() {
+        ++cleared;
+        clearing.clearStreams();
+    });
+    clearing.addStream(&other, { 0, 0, 10 });
+    clearing.addStream(&other, { 0, 0, 10 });
+    clearing.start();
+    QTRY_VERIFY(!clearing.isActive());
+    QCOMPARE(cleared, 1);
+}
+
+QTEST_MAIN(TestPokitSimulator)
@@ -0,0 +1,22 @@
+// SPDX-FileCopyrightText: 2022 Paul Colby <git@colby.id.au>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include <QTest>
+
+class TestPokitSimulator : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void encodeReading();
+    void encodeMetadata_dso();
+    void encodeMetadata_logger();
+    void encodeSamples();
+
+    void multimeterStream();
+    void dsoStream();
+    void dataLoggerStream();
+    void rateLimited();
+    void stop();
+    void modifyStreams();
+};
@@ -0,0 +1,66 @@
+// SPDX-FileCopyrightText: 2022 Paul Colby <git@colby.id.au>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "testrssitracker.h"
+
+#include <qtpokit/rssitracker.h>
+
+void TestRssiTracker::construct()
+{
+    const RssiTracker tracker;
+    QVERIFY(!tracker.isValid());
+    QCOMPARE(tracker.average(), 0.0);
+    QCOMPARE(tracker.latest(), (qint16)0);
+    QCOMPARE(tracker.minimum(), (qint16)0);
+    QCOMPARE(tracker.maximum(), (qint16)0);
+    QCOMPARE(tracker.reported(), (qint16)0);
+}
+
+void TestRssiTracker::seed()
+{
+    RssiTracker tracker;
+
+    // Unknown (0) values never seed the tracker.
+    QVERIFY(!tracker.update(0, 3));
+    QVERIFY(!tracker.isValid());
+
+    // The first known value seeds the tracker, without being reported as a change.
+    QVERIFY(!tracker.update(-60, 3));
+    QVERIFY(tracker.isValid());
+    QCOMPARE(tracker.average(), -60.0);
+    QCOMPARE(tracker.latest(), (qint16)-60);
+    QCOMPARE(tracker.minimum(), (qint16)-60);
+    QCOMPARE(tracker.maximum(), (qint16)-60);
+    QCOMPARE(tracker.reported(), (qint16)-60);
+
+    // Nor does the next value, near the first, drift the average (as seeding with 0 would).
+    QVERIFY(!tracker.update(-61, 3));
+    QCOMPARE(tracker.average(), -60.25);
+    QCOMPARE(tracker.maximum(), (qint16)-60);
+}
+
+void TestRssiTracker::update()
+{
+    RssiTracker tracker;
+    tracker.update(-60, 3);
+
+    // Unknown (0) values are ignored.
+    QVERIFY(!tracker.update(0, 3));
+    QCOMPARE(tracker.latest(), (qint16)-60);
+
+    // Small changes to the average are folded in, but not reported.
+    QVERIFY(!tracker.update(-64, 3));
+    QCOMPARE(tracker.average(), -61.0);
+    QCOMPARE(tracker.latest(), (qint16)-64);
+    QCOMPARE(tracker.minimum(), (qint16)-64);
+    QCOMPARE(tracker.maximum(), (qint16)-60);
+    QCOMPARE(tracker.reported(), (qint16)-60);
+
+    // Larger changes are reported.
+    QVERIFY(tracker.update(-69, 3));
+    QCOMPARE(tracker.average(), -63.0);
+    QCOMPARE(tracker.minimum(), (qint16)-69);
+    QCOMPARE(tracker.reported(), (qint16)-63);
+}
+
+QTEST_MAIN(TestRssiTracker)
@@ -0,0 +1,14 @@
+// SPDX-FileCopyrightText: 2022 Paul Colby <git@colby.id.au>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include <QTest>
+
+class TestRssiTracker : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void construct();
+    void seed();
+    void update();
+};
@@ -0,0 +1,168 @@
+// SPDX-FileCopyrightText: 2022 Paul Colby <git@colby.id.au>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "testsamplecoalescer.h"
+
+#include "samplecoalescer_p.h"
+
+#include <QSignalSpy>
+#include <QtEndian>
+
+typedef QVector<qint16> Samples;
+
+// Returns a `Reading` value of count little-endian samples, counting up from first.
+static QByteArray readingValue(const int count, const qint16 first = 0)
+{
+    QByteArray value(count*2, '\0');
+    for (int index = 0; index < count; ++index) {
+        qToLittleEndian<qint16>(first + index, value.data() + index*2);
+    }
+    return value;
+}
+
+// Returns count samples, counting up from first.
+static Samples samples(const int count, const qint16 first = 0)
+{
+    Samples samples(count);
+    for (int index = 0; index < count; ++index) {
+        samples[index] = first + index;
+    }
+    return samples;
+}
+
+void TestSampleCoalescer::defaults()
+{
+    const SampleCoalescer coalescer;
+    QCOMPARE(coalescer.isEnabled(), false);
+    QCOMPARE(coalescer.chunkSize(), 0);
+    QCOMPARE(coalescer.maxLatency(), 0);
+    QCOMPARE(coalescer.pending(), 0);
+    QCOMPARE(coalescer.samplesToGo(), 0);
+}
+
+void TestSampleCoalescer::settings()
+{
+    SampleCoalescer coalescer;
+    coalescer.setEnabled(true);
+    coalescer.setChunkSize(100);
+    coalescer.setMaxLatency(20);
+    QCOMPARE(coalescer.isEnabled(), true);
+    QCOMPARE(coalescer.chunkSize(), 100);
+    QCOMPARE(coalescer.maxLatency(), 20);
+
+    // Negative values are treated as 0.
+    coalescer.setChunkSize(-1);
+    coalescer.setMaxLatency(-1);
+    QCOMPARE(coalescer.chunkSize(), 0);
+    QCOMPARE(coalescer.maxLatency(), 0);
+}
+
+void TestSampleCoalescer::beginCapture()
+{
+    SampleCoalescer coalescer;
+    coalescer.setEnabled(true);
+
+    // Without a chunk size, the buffer is preallocated for the whole capture.
+    coalescer.beginCapture(8192);
+    QCOMPARE(coalescer.samplesToGo(), 8192);
+    QVERIFY(coalescer.capacity() >= 8192);
+
+    // Beginning a new capture flushes any samples held from the last.
+    QSignalSpy spy(&coalescer, &SampleCoalescer::samplesReady);
+    QVERIFY(coalescer.append(readingValue(10)));
+    QCOMPARE(spy.count(), 0);
+    coalescer.beginCapture(20);
+    QCOMPARE(spy.count(), 1);
+    QCOMPARE(spy.at(0).at(0).value<Samples>(), samples(10));
+    QCOMPARE(coalescer.samplesToGo(), 20);
+    QCOMPARE(coalescer.pending(), 0);
+}
+
+void TestSampleCoalescer::append_oddSize()
+{
+    SampleCoalescer coalescer;
+    coalescer.setEnabled(true);
+    QCOMPARE(coalescer.append(QByteArray(3, '\0')), false);
+    QCOMPARE(coalescer.pending(), 0);
+}
+
+void TestSampleCoalescer::append_perCapture()
+{
+    SampleCoalescer coalescer;
+    coalescer.setEnabled(true);
+    coalescer.beginCapture(25);
+    QSignalSpy spy(&coalescer, &SampleCoalescer::samplesReady);
+    QVERIFY(coalescer.append(readingValue(10, 0)));
+    QVERIFY(coalescer.append(readingValue(10, 10)));
+    QCOMPARE(spy.count(), 0);
+    QCOMPARE(coalescer.pending(), 20);
+    QVERIFY(coalescer.append(readingValue(5, 20)));
+    QCOMPARE(spy.count(), 1);
+    QCOMPARE(spy.at(0).at(0).value<Samples>(), samples(25));
+    QCOMPARE(coalescer.pending(), 0);
+    QCOMPARE(coalescer.samplesToGo(), 0);
+}
+
+void TestSampleCoalescer::append_chunked()
+{
+    SampleCoalescer coalescer;
+    coalescer.setEnabled(true);
+    coalescer.setChunkSize(10);
+    coalescer.beginCapture(25);
+    QVERIFY(coalescer.capacity() >= 10);
+    QSignalSpy spy(&coalescer, &SampleCoalescer::samplesReady);
+    for (int first = 0; first < 25; first += 5) {
+        QVERIFY(coalescer.append(readingValue(5, first)));
+    }
+    QCOMPARE(spy.count(), 3); // 10, 10, then the final 5 at the end of the capture.
+    QCOMPARE(spy.at(0).at(0).value<Samples>(), samples(10, 0));
+    QCOMPARE(spy.at(1).at(0).value<Samples>(), samples(10, 10));
+    QCOMPARE(spy.at(2).at(0).value<Samples>(), samples(5, 20));
+}
+
+void TestSampleCoalescer::append_unbounded()
+{
+    // With no chunk size, no deadline, and no capture, there's nothing to wait for.
+    SampleCoalescer coalescer;
+    coalescer.setEnabled(true);
+    QSignalSpy spy(&coalescer, &SampleCoalescer::samplesReady);
+    QVERIFY(coalescer.append(readingValue(10)));
+    QCOMPARE(spy.count(), 1);
+    QCOMPARE(coalescer.pending(), 0);
+}
+
+void TestSampleCoalescer::append_maxLatency()
+{
+    SampleCoalescer coalescer;
+    coalescer.setEnabled(true);
+    coalescer.setMaxLatency(10);
+    coalescer.beginCapture(100);
+    QSignalSpy spy(&coalescer, &SampleCoalescer::samplesReady);
+    QVERIFY(coalescer.append(readingValue(10)));
+    QCOMPARE(spy.count(), 0);
+    QVERIFY(spy.wait(1000));
+    QCOMPARE(spy.count(), 1);
+    QCOMPARE(spy.at(0).at(0).value<Samples>(), samples(10));
+    QCOMPARE(coalescer.samplesToGo(), 90);
+}
+
+void TestSampleCoalescer::flush()
+{
+    SampleCoalescer coalescer;
+    coalescer.setEnabled(true);
+    coalescer.beginCapture(100);
+    QSignalSpy spy(&coalescer, &SampleCoalescer::samplesReady);
+
+    // Nothing held, so nothing to emit.
+    coalescer.flush();
+    QCOMPARE(spy.count(), 0);
+
+    // Disabling flushes held samples.
+    QVERIFY(coalescer.append(readingValue(10)));
+    QCOMPARE(spy.count(), 0);
+    coalescer.setEnabled(false);
+    QCOMPARE(spy.count(), 1);
+    QCOMPARE(coalescer.pending(), 0);
+}
+
+QTEST_MAIN(TestSampleCoalescer)
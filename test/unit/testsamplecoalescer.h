@@ -0,0 +1,23 @@
+// SPDX-FileCopyrightText: 2022 Paul Colby <git@colby.id.au>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include <QTest>
+
+class TestSampleCoalescer : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void defaults();
+    void settings();
+
+    void beginCapture();
+
+    void append_oddSize();
+    void append_perCapture();
+    void append_chunked();
+    void append_unbounded();
+    void append_maxLatency();
+
+    void flush();
+};
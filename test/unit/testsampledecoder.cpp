@@ -0,0 +1,156 @@
+// SPDX-FileCopyrightText: 2022 Paul Colby <git@colby.id.au>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include "testsampledecoder.h"
+
+#include "sampledecoder_p.h"
+
+Q_DECLARE_METATYPE(SampleDecoder::Implementation);
+
+typedef QVector<qint16> Samples;
+
+void TestSampleDecoder::toString_Implementation_data()
+{
+    QTest::addColumn<SampleDecoder::Implementation>("implementation");
+    QTest::addColumn<QString>("expected");
+    #define QTPOKIT_ADD_TEST_ROW(implementation, expected) \
+        QTest::addRow(#implementation) << SampleDecoder::Implementation::implementation << QStringLiteral(expected)
+    QTPOKIT_ADD_TEST_ROW(Generic, "Generic");
+    QTPOKIT_ADD_TEST_ROW(Sse2,    "SSE2");
+    QTPOKIT_ADD_TEST_ROW(Avx2,    "AVX2");
+    QTPOKIT_ADD_TEST_ROW(Neon,    "NEON");
+    #undef QTPOKIT_ADD_TEST_ROW
+    QTest::addRow("invalid") << (SampleDecoder::Implementation)255 << QString();
+}
+
+void TestSampleDecoder::toString_Implementation()
+{
+    QFETCH(SampleDecoder::Implementation, implementation);
+    QFETCH(QString, expected);
+    QCOMPARE(SampleDecoder::toString(implementation), expected);
+}
+
+void TestSampleDecoder::supportedImplementations()
+{
+    const QList<SampleDecoder::Implementation> implementations = SampleDecoder::supportedImplementations();
+    QVERIFY(implementations.contains(SampleDecoder::Implementation::Generic));
+    QVERIFY(implementations.contains(SampleDecoder::implementation()));
+    for (const SampleDecoder::Implementation implementation: implementations) {
+        QVERIFY(SampleDecoder::isSupported(implementation));
+    }
+    QVERIFY(!SampleDecoder::isSupported((SampleDecoder::Implementation)255));
+}
+
+void TestSampleDecoder::decode_data()
+{
+    QTest::addColumn<QByteArray>("data");
+    QTest::addColumn<int>("maxSamples");
+    QTest::addColumn<Samples>("expected");
+
+    QTest::addRow("empty") << QByteArray() << 10 << Samples();
+
+    // Sample from a real Pokit Pro device.
+    QTest::addRow("PokitPro")
+        << QByteArray("\xda\x36\x91\x24\x24\x09\x02\x80\x91\x64"
+                      "\x48\x12\x23\x49\x01\xc0\x4a\x92\xdc\xf6", 20) << 10
+        << Samples({14042,9361,2340,-32766,25745,4680,18723,-16383,-28086,-2340});
+
+    // Check bytes are parsed in the correct (little-endian) order.
+    QTest::addRow("endianness")
+        << QByteArray("\x00\x00\x00\xff\xff\x00\xff\xff", 8) << 4
+        << Samples({0,-256,255,-1});
+
+    // Buffer too small, so only the leading samples are decoded.
+    QTest::addRow("truncated")
+        << QByteArray("\x00\x00\x00\xff\xff\x00\xff\xff", 8) << 2
+        << Samples({0,-256});
+
+    // Trailing odd bytes are ignored.
+    QTest::addRow("odd") << QByteArray("\x01\x00\xff", 3) << 10 << Samples({1});
+}
+
+void TestSampleDecoder::decode()
+{
+    QFETCH(QByteArray, data);
+    QFETCH(int, maxSamples);
+    QFETCH(Samples, expected);
+    Samples samples(maxSamples);
+    QCOMPARE(SampleDecoder::decode(data, samples.data(), maxSamples), (int)expected.size());
+    samples.resize(expected.size());
+    QCOMPARE(samples, expected);
+}
+
+void TestSampleDecoder::decode_float_data()
+{
+    decode_data();
+}
+
+void TestSampleDecoder::decode_float()
+{
+    QFETCH(QByteArray, data);
+    QFETCH(int, maxSamples);
+    QFETCH(Samples, expected);
+    QVector<float> values(maxSamples);
+    QCOMPARE(SampleDecoder::decode(data, 0.5f, values.data(), maxSamples), (int)expected.size());
+    for (int index = 0; index < expected.size(); ++index) {
+        QCOMPARE(values.at(index), expected.at(index) * 0.5f);
+    }
+}
+
+void TestSampleDecoder::decode_double_data()
+{
+    decode_data();
+}
+
+void TestSampleDecoder::decode_double()
+{
+    QFETCH(QByteArray, data);
+    QFETCH(int, maxSamples);
+    QFETCH(Samples, expected);
+    QVector<double> values(maxSamples);
+    QCOMPARE(SampleDecoder::decode(data, 0.25, values.data(), maxSamples), (int)expected.size());
+    for (int index = 0; index < expected.size(); ++index) {
+        QCOMPARE(values.at(index), expected.at(index) * 0.25);
+    }
+}
+
+void TestSampleDecoder::scale_data()
+{
+    QTest::addColumn<SampleDecoder::Implementation>("implementation");
+    QTest::addColumn<int>("count");
+
+    // Odd counts exercise each implementation's scalar tail handling too.
+    for (const SampleDecoder::Implementation implementation: SampleDecoder::supportedImplementations()) {
+        for (const int count: { 0, 1, 7, 8, 15, 16, 17, 1000, 1001 }) {
+            QTest::addRow("%s:%d", qPrintable(SampleDecoder::toString(implementation)), count)
+                << implementation << count;
+        }
+    }
+}
+
+void TestSampleDecoder::scale()
+{
+    QFETCH(SampleDecoder::Implementation, implementation);
+    QFETCH(int, count);
+
+    // Cover the full range of sample values, including both extremes.
+    Samples samples(count);
+    for (int index = 0; index < count; ++index) {
+        samples[index] = static_cast<qint16>(-32768 + (index * 65535) / qMax(count - 1, 1));
+    }
+
+    // Each implementation must match the generic implementation exactly.
+    QVector<float> floats(count), expectedFloats(count);
+    SampleDecoder::scale(samples.constData(), count, 0.123f, expectedFloats.data(),
+                         SampleDecoder::Implementation::Generic);
+    SampleDecoder::scale(samples.constData(), count, 0.123f, floats.data(), implementation);
+    QCOMPARE(floats, expectedFloats);
+
+    QVector<double> doubles(count), expectedDoubles(count);
+    SampleDecoder::scale(samples.constData(), count, 0.123, expectedDoubles.data(),
+                         SampleDecoder::Implementation::Generic);
+    SampleDecoder::scale(samples.constData(), count, 0.123, doubles.data(), implementation);
+    QCOMPARE(doubles, expectedDoubles);
+}
+
+QTEST_MAIN(TestSampleDecoder)
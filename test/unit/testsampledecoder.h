@@ -0,0 +1,27 @@
+// SPDX-FileCopyrightText: 2022 Paul Colby <git@colby.id.au>
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#include <QTest>
+
+class TestSampleDecoder : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void toString_Implementation_data();
+    void toString_Implementation();
+
+    void supportedImplementations();
+
+    void decode_data();
+    void decode();
+
+    void decode_float_data();
+    void decode_float();
+
+    void decode_double_data();
+    void decode_double();
+
+    void scale_data();
+    void scale();
+};
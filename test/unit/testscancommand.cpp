@@ -19,6 +19,114 @@ Q_DECLARE_METATYPE(ManufacturerData)
 Q_DECLARE_METATYPE(QBluetoothDeviceInfo::CoreConfiguration)
 Q_DECLARE_METATYPE(QBluetoothDeviceInfo::ServiceClasses)
 
+void TestScanCommand::deviceDiscovered_csv()
+{
+    QBluetoothDeviceInfo info(QBluetoothAddress(QStringLiteral("01:02:03:04:05:06")),
+                              QStringLiteral("Pokit Meter"), 0);
+    info.setRssi(-60);
+
+    // Each command outputs its own CSV header, once, ahead of its first device.
+    for (int run = 0; run < 2; ++run) {
+        ScanCommand command(nullptr);
+        command.format = AbstractCommand::OutputFormat::Csv;
+        QByteArray output;
+        command.setOutputHandler([&output](const QByteArray &data) { output.append(data); });
+        command.deviceDiscovered(info);
+        command.deviceDiscovered(info);
+        const QList<QByteArray> lines = output.split('\n');
+        QCOMPARE(lines.size(), 4); // Header, two devices, then the empty remainder.
+        QVERIFY(lines.at(0).startsWith("uuid,"));
+        QVERIFY(lines.at(1).contains(",01:02:03:04:05:06,Pokit Meter,"));
+        QVERIFY(lines.at(1).endsWith(",-60"));
+        QCOMPARE(lines.at(2), lines.at(1));
+    }
+}
+
+void TestScanCommand::incremental_text()
+{
+    ScanCommand command(nullptr);
+    command.incremental = true;
+    command.format = AbstractCommand::OutputFormat::Text;
+    QByteArray output;
+    command.setOutputHandler([&output](const QByteArray &data) { output.append(data); });
+
+    QBluetoothDeviceInfo info(QBluetoothAddress(QStringLiteral("01:02:03:04:05:06")),
+                              QStringLiteral("Pokit Meter"), 0);
+    info.setRssi(-60);
+    command.deviceDiscovered(info);
+    QCOMPARE(output, QByteArray("{00000000-0000-0000-0000-000000000000} 01:02:03:04:05:06 "
+                                "Pokit Meter -60 (average -60.0, min -60, max -60)\n"));
+
+    // Rediscovering an unchanged device outputs nothing.
+    output.clear();
+    command.deviceDiscovered(info);
+    QCOMPARE(output, QByteArray());
+    QCOMPARE(command.devices.size(), 1);
+}
+
+void TestScanCommand::incremental_jsonLines()
+{
+    ScanCommand command(nullptr);
+    command.incremental = true;
+    command.format = AbstractCommand::OutputFormat::JsonLines;
+    QByteArray output;
+    command.setOutputHandler([&output](const QByteArray &data) { output.append(data); });
+
+    QBluetoothDeviceInfo info(QBluetoothAddress(QStringLiteral("01:02:03:04:05:06")),
+                              QStringLiteral("Pokit Meter"), 0);
+    info.setRssi(-60);
+    command.updateDevice(info, false);
+    QVERIFY(output.startsWith('{'));
+    QVERIFY(output.endsWith("}\n"));
+
+    // A small signal strength change outputs nothing.
+    output.clear();
+    info.setRssi(-64);
+    command.updateDevice(info, true);
+    QCOMPARE(output, QByteArray());
+
+    // A larger signal strength change outputs just the identifying fields, and signal strength.
+    info.setRssi(-69);
+    command.updateDevice(info, true);
+    QCOMPARE(output, QByteArray("{\"address\":\"01:02:03:04:05:06\",\"signalStrength\":"
+        "{\"average\":-63,\"latest\":-69,\"maximum\":-60,\"minimum\":-69}}\n"));
+
+    // A name change outputs just the identifying fields, and name.
+    output.clear();
+    info.setName(QStringLiteral("Pokit Pro"));
+    command.updateDevice(info, false);
+    QCOMPARE(output, QByteArray(
+        "{\"address\":\"01:02:03:04:05:06\",\"name\":\"Pokit Pro\"}\n"));
+}
+
+void TestScanCommand::incremental_unknownRssi()
+{
+    ScanCommand command(nullptr);
+    command.incremental = true;
+    command.format = AbstractCommand::OutputFormat::JsonLines;
+    QByteArray output;
+    command.setOutputHandler([&output](const QByteArray &data) { output.append(data); });
+
+    // A device first discovered with an unknown (0) signal strength.
+    QBluetoothDeviceInfo info(QBluetoothAddress(QStringLiteral("01:02:03:04:05:06")),
+                              QStringLiteral("Pokit Meter"), 0);
+    command.updateDevice(info, false);
+    QVERIFY(!command.devices.first().signalStrength.isValid());
+
+    // The first known signal strength is reported, as is, without any drift from 0.
+    output.clear();
+    info.setRssi(-60);
+    command.updateDevice(info, true);
+    QCOMPARE(output, QByteArray("{\"address\":\"01:02:03:04:05:06\",\"signalStrength\":"
+        "{\"average\":-60,\"latest\":-60,\"maximum\":-60,\"minimum\":-60}}\n"));
+
+    // Thereafter, small changes are not reported.
+    output.clear();
+    info.setRssi(-62);
+    command.updateDevice(info, true);
+    QCOMPARE(output, QByteArray());
+}
+
 // Serialiser for QCOMPARE to output QJsonArray objects on test failures.
 char *toString(const QJsonArray &array)
 {
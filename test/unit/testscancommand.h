@@ -8,6 +8,12 @@ class TestScanCommand : public QObject
     Q_OBJECT
 
 private slots:
+    void deviceDiscovered_csv();
+
+    void incremental_text();
+    void incremental_jsonLines();
+    void incremental_unknownRssi();
+
     void toJson_info_data();
     void toJson_info();
 